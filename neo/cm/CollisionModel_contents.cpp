@@ -55,13 +55,14 @@ idCollisionModelManagerLocal::TestTrmVertsInBrush
 */
 bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_brush_t *b ) {
 	int i, j, numVerts, bestPlane;
+	unsigned int inside;
 	float d, bestd;
 	idVec3 *p;
 
-	if ( b->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( tw->state->brushes[b->checkNum] == tw->checkCount ) {
 		return false;
 	}
-	b->checkcount = idCollisionModelManagerLocal::checkCount;
+	tw->state->brushes[b->checkNum] = tw->checkCount;
 
 	if ( !(b->contents & tw->contents) ) {
 		return false;
@@ -79,36 +80,41 @@ bool idCollisionModelManagerLocal::TestTrmVertsInBrush( cm_traceWork_t *tw, cm_b
 		numVerts = tw->numVerts;
 	}
 
-	for ( j = 0; j < numVerts; j++ ) {
-		p = &tw->vertices[j].p;
-
-		// see if the point is inside the brush
-		bestPlane = 0;
-		bestd = -idMath::INFINITY;
-		for ( i = 0; i < b->numPlanes; i++ ) {
-			d = b->planes[i].Distance( *p );
-			if ( d >= 0.0f ) {
-				break;
-			}
-			if ( d > bestd ) {
-				bestd = d;
-				bestPlane = i;
-			}
+	// test all trm vertices at once against each brush plane
+	inside = ( numVerts < 32 ) ? ( 1u << numVerts ) - 1 : ~0u;
+	for ( i = 0; i < b->numPlanes; i++ ) {
+		inside &= SIMDProcessor->PointsBehindPlane( b->planes[i], tw->vertexPoints[0], MAX_TRACEMODEL_VERTS, numVerts );
+		if ( !inside ) {
+			return false;
 		}
-		if ( i >= b->numPlanes ) {
-			tw->trace.fraction = 0.0f;
-			tw->trace.c.type = CONTACT_TRMVERTEX;
-			tw->trace.c.normal = b->planes[bestPlane].Normal();
-			tw->trace.c.dist = b->planes[bestPlane].Dist();
-			tw->trace.c.contents = b->contents;
-			tw->trace.c.material = b->material;
-			tw->trace.c.point = *p;
-			tw->trace.c.modelFeature = 0;
-			tw->trace.c.trmFeature = j;
-			return true;
+	}
+
+	// the first vertex inside the brush
+	for ( j = 0; !( inside & ( 1u << j ) ); j++ ) {
+	}
+	p = &tw->vertices[j].p;
+
+	// find the plane the vertex is closest to
+	bestPlane = 0;
+	bestd = -idMath::INFINITY;
+	for ( i = 0; i < b->numPlanes; i++ ) {
+		d = b->planes[i].Distance( *p );
+		if ( d > bestd ) {
+			bestd = d;
+			bestPlane = i;
 		}
 	}
-	return false;
+
+	tw->trace.fraction = 0.0f;
+	tw->trace.c.type = CONTACT_TRMVERTEX;
+	tw->trace.c.normal = b->planes[bestPlane].Normal();
+	tw->trace.c.dist = b->planes[bestPlane].Dist();
+	tw->trace.c.contents = b->contents;
+	tw->trace.c.material = b->material;
+	tw->trace.c.point = *p;
+	tw->trace.c.modelFeature = 0;
+	tw->trace.c.trmFeature = j;
+	return true;
 }
 
 /*
@@ -130,10 +136,10 @@ CM_SetTrmEdgeSidedness
 CM_SetTrmPolygonSidedness
 ================
 */
-#define CM_SetTrmPolygonSidedness( v, plane, bitNum ) {								\
+#define CM_SetTrmPolygonSidedness( v, point, plane, bitNum ) {						\
 	if ( !((v)->sideSet & (1<<bitNum)) ) {											\
 		float fl;																	\
-		fl = plane.Distance( (v)->p );												\
+		fl = plane.Distance( point );												\
 		/* cannot use float sign bit because it is undetermined when fl == 0.0f */	\
 		if ( fl < 0.0f ) {															\
 			(v)->side |= (1 << bitNum);												\
@@ -158,13 +164,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	float d, bestd;
 	cm_trmEdge_t *trmEdge;
 	cm_edge_t *edge;
-	cm_vertex_t *v, *v1, *v2;
+	cm_vertex_t *v;
+	cm_sideCheck_t *edgeCheck, *vc, *v1, *v2;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( tw->state->polygons[p->checkNum] == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	tw->state->polygons[p->checkNum] = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -196,14 +203,14 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 			edgeNum = p->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
 			// if this edge is already tested
-			if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( tw->state->edges[abs(edgeNum)].checkcount == tw->checkCount ) {
 				continue;
 			}
 
 			for ( j = 0; j < 2; j++ ) {
 				v = &tw->model->vertices[edge->vertexNum[j]];
 				// if this vertex is already tested
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( tw->state->vertices[edge->vertexNum[j]].checkcount == tw->checkCount ) {
 					continue;
 				}
 
@@ -238,19 +245,20 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		edgeCheck = tw->state->edges + abs(edgeNum);
 		// reset sidedness cache if this is the first time we encounter this edge
-		if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			edge->sideSet = 0;
+		if ( edgeCheck->checkcount != tw->checkCount ) {
+			edgeCheck->sideSet = 0;
 		}
 		// pluecker coordinate for edge
 		tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[edge->vertexNum[0]].p,
 													tw->model->vertices[edge->vertexNum[1]].p );
-		v = &tw->model->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
+		vc = &tw->state->vertices[edge->vertexNum[INTSIGNBITSET(edgeNum)]];
 		// reset sidedness cache if this is the first time we encounter this vertex
-		if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-			v->sideSet = 0;
+		if ( vc->checkcount != tw->checkCount ) {
+			vc->sideSet = 0;
 		}
-		v->checkcount = idCollisionModelManagerLocal::checkCount;
+		vc->checkcount = tw->checkCount;
 	}
 
 	// get side of polygon for each trm vertex
@@ -270,10 +278,10 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 		// test if trm edge goes through the polygon between the polygon edges
 		for ( j = 0; j < p->numEdges; j++ ) {
 			edgeNum = p->edges[j];
-			edge = tw->model->edges + abs(edgeNum);
+			edgeCheck = tw->state->edges + abs(edgeNum);
 #if 1
-			CM_SetTrmEdgeSidedness( edge, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
-			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> i) & 1) ^ flip ) {
+			CM_SetTrmEdgeSidedness( edgeCheck, tw->edges[i].pl, tw->polygonEdgePlueckerCache[j], i );
+			if ( INTSIGNBITSET(edgeNum) ^ ((edgeCheck->side >> i) & 1) ^ flip ) {
 				break;
 			}
 #else
@@ -311,17 +319,18 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 	for ( i = 0; i < p->numEdges; i++ ) {
 		edgeNum = p->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		edgeCheck = tw->state->edges + abs(edgeNum);
+		if ( edgeCheck->checkcount == tw->checkCount ) {
 			continue;
 		}
-		edge->checkcount = idCollisionModelManagerLocal::checkCount;
+		edgeCheck->checkcount = tw->checkCount;
 
 		for ( j = 0; j < tw->numPolys; j++ ) {
 #if 1
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			CM_SetTrmPolygonSidedness( v1, tw->polys[j].plane, j );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			CM_SetTrmPolygonSidedness( v2, tw->polys[j].plane, j );
+			v1 = tw->state->vertices + edge->vertexNum[0];
+			CM_SetTrmPolygonSidedness( v1, tw->model->vertices[edge->vertexNum[0]].p, tw->polys[j].plane, j );
+			v2 = tw->state->vertices + edge->vertexNum[1];
+			CM_SetTrmPolygonSidedness( v2, tw->model->vertices[edge->vertexNum[1]].p, tw->polys[j].plane, j );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( !(((v1->side ^ v2->side) >> j) & 1) ) {
 				continue;
@@ -330,10 +339,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 #else
 			float d1, d2;
 
-			v1 = tw->model->vertices + edge->vertexNum[0];
-			d1 = tw->polys[j].plane.Distance( v1->p );
-			v2 = tw->model->vertices + edge->vertexNum[1];
-			d2 = tw->polys[j].plane.Distance( v2->p );
+			d1 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[0]].p );
+			d2 = tw->polys[j].plane.Distance( tw->model->vertices[edge->vertexNum[1]].p );
 			// if the polygon edge does not cross the trm polygon plane
 			if ( (d1 >= 0.0f && d2 >= 0.0f) || (d1 <= 0.0f && d2 <= 0.0f) ) {
 				continue;
@@ -349,8 +356,8 @@ bool idCollisionModelManagerLocal::TestTrmInPolygon( cm_traceWork_t *tw, cm_poly
 				trmEdge = tw->edges + abs(trmEdgeNum);
 #if 1
 				bitNum = abs(trmEdgeNum);
-				CM_SetTrmEdgeSidedness( edge, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
-				if ( INTSIGNBITSET(trmEdgeNum) ^ ((edge->side >> bitNum) & 1) ^ flip ) {
+				CM_SetTrmEdgeSidedness( edgeCheck, trmEdge->pl, tw->polygonEdgePlueckerCache[i], bitNum );
+				if ( INTSIGNBITSET(trmEdgeNum) ^ ((edgeCheck->side >> bitNum) & 1) ^ flip ) {
 					break;
 				}
 #else
@@ -422,7 +429,7 @@ int idCollisionModelManagerLocal::PointContents( const idVec3 p, cmHandle_t mode
 	cm_brush_t *b;
 	idPlane *plane;
 
-	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::models[model] );
+	node = idCollisionModelManagerLocal::PointNode( p, idCollisionModelManagerLocal::ModelForHandle( model, GetThreadState() ) );
 	for ( bref = node->brushes; bref; bref = bref->next ) {
 		b = bref->b;
 		// test if the point is within the brush bounds
@@ -477,7 +484,7 @@ idCollisionModelManagerLocal::ContentsTrm
 int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &start,
 									const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 									cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
-	int i;
+	int i, j;
 	bool model_rotated, trm_rotated;
 	idMat3 invModelAxis, tmpAxis;
 	idVec3 dir;
@@ -496,7 +503,8 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		return results->c.contents;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.state = idCollisionModelManagerLocal::GetThreadState();
+	tw.checkCount = ++tw.state->checkCount;
 
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
@@ -508,7 +516,7 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 	tw.pointTrace = false;
 	tw.quickExit = false;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::ModelForHandle( model, tw.state );
 	tw.start = start - modelOrigin;
 	tw.end = tw.start;
 
@@ -563,6 +571,13 @@ int idCollisionModelManagerLocal::ContentsTrm( trace_t *results, const idVec3 &s
 		tw.size.AddPoint( tw.vertices[i].p - tw.start );
 	}
 
+	// trm vertices in SoA form, padded with zeros
+	for ( i = 0; i < ( ( tw.numVerts + 3 ) & ~3 ); i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			tw.vertexPoints[j][i] = ( i < tw.numVerts ) ? tw.vertices[i].p[j] : 0.0f;
+		}
+	}
+
 	// setup trm edges
 	for ( i = 1; i <= tw.numEdges; i++ ) {
 		// edge start, end and pluecker coordinate
@@ -631,7 +646,7 @@ int idCollisionModelManagerLocal::Contents( const idVec3 &start,
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model handle\n");
 		return 0;
 	}
-	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::models[model] ) {
+	if ( !idCollisionModelManagerLocal::models || !idCollisionModelManagerLocal::ModelForHandle( model, GetThreadState() ) ) {
 		common->Printf("idCollisionModelManagerLocal::Contents: invalid model\n");
 		return 0;
 	}
@@ -354,6 +354,7 @@ static idCVar cm_testWalk(			"cm_testWalk",			"1",					CVAR_GAME | CVAR_BOOL,		"
 static idCVar cm_testLength(		"cm_testLength",		"1024",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testRadius(		"cm_testRadius",		"64",					CVAR_GAME | CVAR_FLOAT,		"" );
 static idCVar cm_testAngle(			"cm_testAngle",			"60",					CVAR_GAME | CVAR_FLOAT,		"" );
+static idCVar cm_testParallel(		"cm_testParallel",		"0",					CVAR_GAME | CVAR_BOOL,		"also run the test queries concurrently on the job threads and compare the results with running them serially" );
 
 static unsigned int total_translation;
 static unsigned int min_translation = 999999;
@@ -366,6 +367,129 @@ static int num_rotation = 0;
 static idVec3 start;
 static idVec3 *testend;
 
+#define CM_NUM_TEST_QUERIES		4
+#define CM_TESTS_PER_JOB		16
+
+typedef struct cm_parallelTest_s {
+	const idTraceModel *	trm;
+	idMat3					trmAxis;
+	idVec3					start;
+	const idVec3 *			ends;
+	int						numTests;
+	cmHandle_t				model;
+	float					angle;
+	trace_t *				results;			// CM_NUM_TEST_QUERIES per test
+} cm_parallelTest_t;
+
+/*
+================
+CM_RunTestQueries
+
+  translation, rotation and contents against the test model and a translation against
+  a trace model, so the per thread trace model gets exercised as well
+================
+*/
+static void CM_RunTestQueries( const cm_parallelTest_t *test, int first, int last ) {
+	idTraceModel box( idBounds( idVec3( -8.0f, -8.0f, -8.0f ), idVec3( 8.0f, 8.0f, 8.0f ) ) );
+	idRotation rotation( vec3_origin, idVec3( 0.0f, 0.0f, 1.0f ), test->angle );
+	cmHandle_t handle;
+
+	for ( int i = first; i < last; i++ ) {
+		trace_t *results = test->results + i * CM_NUM_TEST_QUERIES;
+		const idVec3 &end = test->ends[i];
+
+		collisionModelManager->Translation( &results[0], test->start, end, test->trm, test->trmAxis, CONTENTS_SOLID|CONTENTS_PLAYERCLIP, test->model, vec3_origin, mat3_identity );
+
+		rotation.SetOrigin( end );
+		collisionModelManager->Rotation( &results[1], test->start, rotation, test->trm, test->trmAxis, CONTENTS_SOLID|CONTENTS_PLAYERCLIP, test->model, vec3_origin, mat3_identity );
+
+		results[2].c.contents = collisionModelManager->Contents( end, test->trm, test->trmAxis, -1, test->model, vec3_origin, mat3_identity );
+
+		handle = collisionModelManager->SetupTrmModel( box, NULL );
+		collisionModelManager->Translation( &results[3], test->start, end, test->trm, test->trmAxis, -1, handle, ( test->start + end ) * 0.5f, mat3_identity );
+	}
+}
+
+/*
+================
+CM_TestQueriesJob
+================
+*/
+static void CM_TestQueriesJob( void *data, int jobNum ) {
+	const cm_parallelTest_t *test = (const cm_parallelTest_t *) data;
+	int first = jobNum * CM_TESTS_PER_JOB;
+
+	CM_RunTestQueries( test, first, Min( first + CM_TESTS_PER_JOB, test->numTests ) );
+}
+
+/*
+================
+CM_TracesEqual
+
+  the contact is only filled in when there was a collision
+================
+*/
+static bool CM_TracesEqual( const trace_t &a, const trace_t &b ) {
+	if ( a.fraction != b.fraction || a.c.contents != b.c.contents || a.endpos != b.endpos ) {
+		return false;
+	}
+	if ( a.fraction >= 1.0f ) {
+		return true;
+	}
+	return ( a.c.type == b.c.type && a.c.point == b.c.point && a.c.normal == b.c.normal && a.c.dist == b.c.dist &&
+				a.c.material == b.c.material && a.c.modelFeature == b.c.modelFeature && a.c.trmFeature == b.c.trmFeature );
+}
+
+/*
+================
+CM_TestParallelQueries
+
+  stress test for concurrent collision queries, runs the same queries serially on the calling thread
+  and spread over the job threads and reports any differences between the results
+================
+*/
+static void CM_TestParallelQueries( cm_parallelTest_t &test ) {
+	int i, numJobs, numResults, numMismatches;
+	unsigned int serialMsec, parallelMsec;
+	trace_t *serial, *parallel;
+	idTimer timer;
+
+	numResults = test.numTests * CM_NUM_TEST_QUERIES;
+	serial = (trace_t *) Mem_ClearedAlloc( numResults * sizeof( trace_t ) );
+	parallel = (trace_t *) Mem_ClearedAlloc( numResults * sizeof( trace_t ) );
+
+	timer.Start();
+	test.results = serial;
+	CM_RunTestQueries( &test, 0, test.numTests );
+	timer.Stop();
+	serialMsec = timer.Milliseconds();
+
+	timer.Clear();
+	timer.Start();
+	test.results = parallel;
+	numJobs = ( test.numTests + CM_TESTS_PER_JOB - 1 ) / CM_TESTS_PER_JOB;
+	Sys_RunJobs( CM_TestQueriesJob, &test, numJobs );
+	timer.Stop();
+	parallelMsec = timer.Milliseconds();
+
+	numMismatches = 0;
+	for ( i = 0; i < numResults; i++ ) {
+		if ( !CM_TracesEqual( serial[i], parallel[i] ) ) {
+			if ( numMismatches == 0 ) {
+				common->Warning( "parallel query %d (type %d) differs: fraction %f instead of %f", i / CM_NUM_TEST_QUERIES,
+									i % CM_NUM_TEST_QUERIES, parallel[i].fraction, serial[i].fraction );
+			}
+			numMismatches++;
+		}
+	}
+
+	common->Printf( "%4d parallel queries: %4u milliseconds serial, %4u milliseconds on %d threads, %d mismatches\n",
+						numResults, serialMsec, parallelMsec, Sys_NumJobThreads() + 1, numMismatches );
+
+	Mem_Free( serial );
+	Mem_Free( parallel );
+}
+
 void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 	int i, k;
 	unsigned int t;
@@ -486,6 +610,19 @@ void idCollisionModelManagerLocal::DebugOutput( const idVec3 &origin ) {
 		common->Printf("%s rotation: %4d milliseconds, (min = %d, max = %d, av = %1.1f)\n", buf, t, min_rotation, max_rotation, (float) total_rotation / num_rotation );
 	}
 
+	if ( cm_testParallel.GetBool() ) {
+		cm_parallelTest_t test;
+
+		test.trm = &itm;
+		test.trmAxis = boxAxis;
+		test.start = start;
+		test.ends = testend;
+		test.numTests = cm_testTimes.GetInteger();
+		test.model = cm_testModel.GetInteger();
+		test.angle = cm_testAngle.GetFloat();
+		CM_TestParallelQueries( test );
+	}
+
 	Mem_Free( testend );
 	testend = NULL;
 }
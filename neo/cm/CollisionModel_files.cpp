@@ -45,6 +45,12 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define CM_BINARY_FILE_EXT		"cmb"
+#define CM_BINARY_FILEID		( ( 'C' << 24 ) | ( 'M' << 16 ) | ( 'B' << 8 ) | 'F' )
+#define CM_BINARY_FILEVERSION	1
+
+idCVar cm_binaryCache( "cm_binaryCache", "1", CVAR_GAME | CVAR_BOOL, "load collision models from and write them to binary .cmb files next to the .cm files" );
+
 /*
 ===============================================================================
 
@@ -259,6 +265,8 @@ void idCollisionModelManagerLocal::WriteCollisionModelsToFile( const char *filen
 	}
 
 	fileSystem->CloseFile( fp );
+
+	WriteBinaryCollisionModelsToFile( filename, firstModel, lastModel, mapFileCRC );
 }
 
 /*
@@ -329,8 +337,6 @@ void idCollisionModelManagerLocal::ParseVertices( idLexer *src, cm_model_t *mode
 	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
 	for ( i = 0; i < model->numVertices; i++ ) {
 		src->Parse1DMatrix( 3, model->vertices[i].p.ToFloatPtr() );
-		model->vertices[i].side = 0;
-		model->vertices[i].sideSet = 0;
 		model->vertices[i].checkcount = 0;
 	}
 	src->ExpectTokenString( "}" );
@@ -353,8 +359,6 @@ void idCollisionModelManagerLocal::ParseEdges( idLexer *src, cm_model_t *model )
 		model->edges[i].vertexNum[0] = src->ParseInt();
 		model->edges[i].vertexNum[1] = src->ParseInt();
 		src->ExpectTokenString( ")" );
-		model->edges[i].side = 0;
-		model->edges[i].sideSet = 0;
 		model->edges[i].internal = src->ParseInt();
 		model->edges[i].numUsers = src->ParseInt();
 		model->edges[i].normal = vec3_origin;
@@ -471,6 +475,7 @@ void idCollisionModelManagerLocal::ParseBrushes( idLexer *src, cm_model_t *model
 		}
 		b->checkcount = 0;
 		b->primitiveNum = 0;
+		b->material = NULL;
 		// filter brush into tree
 		R_FilterBrushIntoTree( model, model->node, NULL, b );
 	}
@@ -558,6 +563,12 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idToken token;
 	idLexer *src;
 	unsigned int crc;
+	int firstModel;
+
+	// use the binary cache if it is up to date
+	if ( LoadBinaryCollisionModelFile( name, mapFileCRC ) ) {
+		return true;
+	}
 
 	// load it
 	fileName = name;
@@ -595,6 +606,7 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	}
 
 	// parse the file
+	firstModel = numModels;
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
 			break;
@@ -613,5 +625,625 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	delete src;
 
+	// write the binary cache so the next load doesn't have to parse the text
+	WriteBinaryCollisionModelsToFile( name, firstModel, numModels, crc );
+
+	return true;
+}
+
+
+/*
+===============================================================================
+
+Binary collision model cache
+
+  The .cmb file is written next to the .cm file and holds the same collision
+  models as flat arrays. Polygons and brushes are stored once and the nodes
+  refer to them by index, so loading doesn't tokenize any text, filter the
+  polygons and brushes into the tree or calculate the edge normals again.
+
+===============================================================================
+*/
+
+/*
+================
+CM_CollectPolygons_r
+================
+*/
+static void CM_CollectPolygons_r( cm_node_t *node, int checkCount, idList<cm_polygon_t *> &polygons ) {
+	cm_polygonRef_t *pref;
+
+	while( 1 ) {
+		for ( pref = node->polygons; pref; pref = pref->next ) {
+			if ( pref->p->checkcount == checkCount ) {
+				continue;
+			}
+			pref->p->checkcount = checkCount;
+			polygons.Append( pref->p );
+		}
+		if ( node->planeType == -1 ) {
+			break;
+		}
+		CM_CollectPolygons_r( node->children[1], checkCount, polygons );
+		node = node->children[0];
+	}
+}
+
+/*
+================
+CM_CollectBrushes_r
+================
+*/
+static void CM_CollectBrushes_r( cm_node_t *node, int checkCount, idList<cm_brush_t *> &brushes ) {
+	cm_brushRef_t *bref;
+
+	while( 1 ) {
+		for ( bref = node->brushes; bref; bref = bref->next ) {
+			if ( bref->b->checkcount == checkCount ) {
+				continue;
+			}
+			bref->b->checkcount = checkCount;
+			brushes.Append( bref->b );
+		}
+		if ( node->planeType == -1 ) {
+			break;
+		}
+		CM_CollectBrushes_r( node->children[1], checkCount, brushes );
+		node = node->children[0];
+	}
+}
+
+/*
+================
+CM_MaterialIndex
+================
+*/
+static int CM_MaterialIndex( const idMaterial *material, idStrList &materials, idHashIndex &materialHash ) {
+	int i, hash;
+
+	if ( !material ) {
+		return -1;
+	}
+	hash = materialHash.GenerateKey( material->GetName(), false );
+	for ( i = materialHash.First( hash ); i != -1; i = materialHash.Next( i ) ) {
+		if ( materials[i].Icmp( material->GetName() ) == 0 ) {
+			return i;
+		}
+	}
+	i = materials.Append( material->GetName() );
+	materialHash.Add( hash, i );
+	return i;
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryNodes
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryNodes( idFile *fp, cm_node_t *node, const idList<int> &polygonRemap, const idList<int> &brushRemap ) {
+	cm_polygonRef_t *pref;
+	cm_brushRef_t *bref;
+	int count;
+
+	fp->WriteInt( node->planeType );
+	fp->WriteFloat( node->planeDist );
+
+	for ( count = 0, pref = node->polygons; pref; pref = pref->next ) {
+		count++;
+	}
+	fp->WriteInt( count );
+	for ( pref = node->polygons; pref; pref = pref->next ) {
+		fp->WriteInt( polygonRemap[pref->p->checkNum] );
+	}
+
+	for ( count = 0, bref = node->brushes; bref; bref = bref->next ) {
+		count++;
+	}
+	fp->WriteInt( count );
+	for ( bref = node->brushes; bref; bref = bref->next ) {
+		fp->WriteInt( brushRemap[bref->b->checkNum] );
+	}
+
+	if ( node->planeType != -1 ) {
+		WriteBinaryNodes( fp, node->children[0], polygonRemap, brushRemap );
+		WriteBinaryNodes( fp, node->children[1], polygonRemap, brushRemap );
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model, idStrList &materials, idHashIndex &materialHash ) {
+	int i, j, numPolygonEdges, numBrushPlanes;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idList<int> polygonRemap, brushRemap;
+
+	checkCount++;
+	CM_CollectPolygons_r( model->node, checkCount, polygons );
+	checkCount++;
+	CM_CollectBrushes_r( model->node, checkCount, brushes );
+
+	polygonRemap.AssureSize( model->numPolygonChecks, -1 );
+	brushRemap.AssureSize( model->numBrushChecks, -1 );
+
+	fp->WriteString( model->name );
+	fp->WriteVec3( model->bounds[0] );
+	fp->WriteVec3( model->bounds[1] );
+	fp->WriteInt( model->contents );
+	fp->WriteBool( model->isConvex );
+	fp->WriteInt( model->numInternalEdges );
+	fp->WriteInt( model->numSharpEdges );
+	fp->WriteInt( model->numNodes );
+
+	// vertices
+	fp->WriteInt( model->numVertices );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->WriteVec3( model->vertices[i].p );
+	}
+
+	// edges with their normals
+	fp->WriteInt( model->numEdges );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		const cm_edge_t &edge = model->edges[i];
+		fp->WriteInt( edge.vertexNum[0] );
+		fp->WriteInt( edge.vertexNum[1] );
+		fp->WriteUnsignedShort( edge.internal );
+		fp->WriteUnsignedShort( edge.numUsers );
+		fp->WriteVec3( edge.normal );
+	}
+
+	// polygons
+	numPolygonEdges = 0;
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		numPolygonEdges += polygons[i]->numEdges;
+	}
+	fp->WriteInt( polygons.Num() );
+	fp->WriteInt( numPolygonEdges );
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		const cm_polygon_t *p = polygons[i];
+		polygonRemap[p->checkNum] = i;
+		fp->WriteInt( p->numEdges );
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->WriteInt( p->edges[j] );
+		}
+		fp->WriteVec3( p->plane.Normal() );
+		fp->WriteFloat( p->plane.Dist() );
+		fp->WriteVec3( p->bounds[0] );
+		fp->WriteVec3( p->bounds[1] );
+		fp->WriteInt( CM_MaterialIndex( p->material, materials, materialHash ) );
+	}
+
+	// brushes
+	numBrushPlanes = 0;
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		numBrushPlanes += brushes[i]->numPlanes;
+	}
+	fp->WriteInt( brushes.Num() );
+	fp->WriteInt( numBrushPlanes );
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		const cm_brush_t *b = brushes[i];
+		brushRemap[b->checkNum] = i;
+		fp->WriteInt( b->numPlanes );
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->WriteVec3( b->planes[j].Normal() );
+			fp->WriteFloat( b->planes[j].Dist() );
+		}
+		fp->WriteVec3( b->bounds[0] );
+		fp->WriteVec3( b->bounds[1] );
+		fp->WriteInt( b->contents );
+		fp->WriteInt( b->primitiveNum );
+		fp->WriteInt( CM_MaterialIndex( b->material, materials, materialHash ) );
+	}
+
+	// nodes with the polygons and brushes linked into them
+	WriteBinaryNodes( fp, model->node, polygonRemap, brushRemap );
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC ) {
+	int i;
+	idFile_Memory modelData( "cmb" );
+	idFile *fp;
+	idStr name;
+	idStrList materials;
+	idHashIndex materialHash;
+
+	if ( !cm_binaryCache.GetBool() ) {
+		return;
+	}
+
+	name = filename;
+	name.SetFileExtension( CM_BINARY_FILE_EXT );
+
+	// the models are written first to get the material table
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( &modelData, models[i], materials, materialHash );
+	}
+
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelsToFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	fp->WriteInt( CM_BINARY_FILEID );
+	fp->WriteInt( CM_BINARY_FILEVERSION );
+	fp->WriteUnsignedInt( mapFileCRC );
+	fp->WriteInt( lastModel - firstModel );
+	fp->WriteInt( materials.Num() );
+	for ( i = 0; i < materials.Num(); i++ ) {
+		fp->WriteString( materials[i] );
+	}
+	fp->Write( modelData.GetDataPtr(), modelData.Length() );
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+CM_BinaryHasData
+
+  returns true if count elements of the given size can still be read
+================
+*/
+static bool CM_BinaryHasData( idFile *fp, int count, int size ) {
+	return ( count >= 0 && count <= ( fp->Length() - fp->Tell() ) / size );
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryNodes
+================
+*/
+cm_node_t *idCollisionModelManagerLocal::ReadBinaryNodes( idFile *fp, cm_model_t *model, cm_node_t *parent, int maxNodes,
+							cm_polygon_t **polygons, int numPolygons, cm_brush_t **brushes, int numBrushes ) {
+	cm_node_t *node;
+	cm_polygonRef_t *pref, *lastPolygonRef;
+	cm_brushRef_t *bref, *lastBrushRef;
+	int i, count, index;
+
+	if ( model->numNodes >= maxNodes || !CM_BinaryHasData( fp, 4, sizeof( int ) ) ) {
+		return NULL;
+	}
+
+	model->numNodes++;
+	node = AllocNode( model, model->numNodes < NODE_BLOCK_SIZE_SMALL ? NODE_BLOCK_SIZE_SMALL : NODE_BLOCK_SIZE_LARGE );
+	node->brushes = NULL;
+	node->polygons = NULL;
+	node->parent = parent;
+	fp->ReadInt( node->planeType );
+	fp->ReadFloat( node->planeDist );
+	if ( node->planeType < -1 || node->planeType > 2 ) {
+		return NULL;
+	}
+
+	// keep the references in the order they were written
+	count = -1;
+	fp->ReadInt( count );
+	if ( !CM_BinaryHasData( fp, count, sizeof( int ) ) ) {
+		return NULL;
+	}
+	lastPolygonRef = NULL;
+	for ( i = 0; i < count; i++ ) {
+		fp->ReadInt( index );
+		if ( index < 0 || index >= numPolygons ) {
+			return NULL;
+		}
+		pref = AllocPolygonReference( model, model->numPolygonRefs < REFERENCE_BLOCK_SIZE_SMALL ? REFERENCE_BLOCK_SIZE_SMALL : REFERENCE_BLOCK_SIZE_LARGE );
+		pref->p = polygons[index];
+		pref->next = NULL;
+		if ( lastPolygonRef ) {
+			lastPolygonRef->next = pref;
+		} else {
+			node->polygons = pref;
+		}
+		lastPolygonRef = pref;
+		model->numPolygonRefs++;
+	}
+
+	count = -1;
+	fp->ReadInt( count );
+	if ( !CM_BinaryHasData( fp, count, sizeof( int ) ) ) {
+		return NULL;
+	}
+	lastBrushRef = NULL;
+	for ( i = 0; i < count; i++ ) {
+		fp->ReadInt( index );
+		if ( index < 0 || index >= numBrushes ) {
+			return NULL;
+		}
+		bref = AllocBrushReference( model, model->numBrushRefs < REFERENCE_BLOCK_SIZE_SMALL ? REFERENCE_BLOCK_SIZE_SMALL : REFERENCE_BLOCK_SIZE_LARGE );
+		bref->b = brushes[index];
+		bref->next = NULL;
+		if ( lastBrushRef ) {
+			lastBrushRef->next = bref;
+		} else {
+			node->brushes = bref;
+		}
+		lastBrushRef = bref;
+		model->numBrushRefs++;
+	}
+
+	if ( node->planeType != -1 ) {
+		node->children[0] = ReadBinaryNodes( fp, model, node, maxNodes, polygons, numPolygons, brushes, numBrushes );
+		if ( !node->children[0] ) {
+			return NULL;
+		}
+		node->children[1] = ReadBinaryNodes( fp, model, node, maxNodes, polygons, numPolygons, brushes, numBrushes );
+		if ( !node->children[1] ) {
+			return NULL;
+		}
+	}
+	return node;
+}
+
+/*
+================
+idCollisionModelManagerLocal::ReadBinaryCollisionModel
+
+  on failure everything read so far is left in the block allocated memory of
+  the model without being linked into the tree, so FreeModel can free it
+================
+*/
+bool idCollisionModelManagerLocal::ReadBinaryCollisionModel( idFile *fp, cm_model_t *model, const idList<const idMaterial *> &materials ) {
+	int i, j, numPolygons, numPolygonEdges, numBrushes, numBrushPlanes, numNodes, numEdges, materialNum;
+	unsigned short internal, numUsers;
+	idList<cm_polygon_t *> polygons;
+	idList<cm_brush_t *> brushes;
+	idVec3 normal;
+	float dist;
+	cm_polygon_t *p;
+	cm_brush_t *b;
+
+	fp->ReadString( model->name );
+	fp->ReadVec3( model->bounds[0] );
+	fp->ReadVec3( model->bounds[1] );
+	fp->ReadInt( model->contents );
+	fp->ReadBool( model->isConvex );
+	fp->ReadInt( model->numInternalEdges );
+	fp->ReadInt( model->numSharpEdges );
+	numNodes = 0;
+	fp->ReadInt( numNodes );
+
+	// vertices
+	model->numVertices = -1;
+	fp->ReadInt( model->numVertices );
+	if ( !CM_BinaryHasData( fp, model->numVertices, 3 * sizeof( float ) ) ) {
+		model->numVertices = 0;
+		return false;
+	}
+	model->maxVertices = model->numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( model->maxVertices * sizeof( cm_vertex_t ) );
+	for ( i = 0; i < model->numVertices; i++ ) {
+		fp->ReadVec3( model->vertices[i].p );
+		model->vertices[i].checkcount = 0;
+	}
+
+	// edges
+	model->numEdges = -1;
+	fp->ReadInt( model->numEdges );
+	if ( !CM_BinaryHasData( fp, model->numEdges, 6 * sizeof( int ) ) ) {
+		model->numEdges = 0;
+		return false;
+	}
+	model->maxEdges = model->numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( model->maxEdges * sizeof( cm_edge_t ) );
+	for ( i = 0; i < model->numEdges; i++ ) {
+		cm_edge_t &edge = model->edges[i];
+		fp->ReadInt( edge.vertexNum[0] );
+		fp->ReadInt( edge.vertexNum[1] );
+		fp->ReadUnsignedShort( internal );
+		fp->ReadUnsignedShort( numUsers );
+		fp->ReadVec3( edge.normal );
+		if ( edge.vertexNum[0] < 0 || edge.vertexNum[0] >= model->numVertices ||
+				edge.vertexNum[1] < 0 || edge.vertexNum[1] >= model->numVertices ) {
+			return false;
+		}
+		edge.internal = internal;
+		edge.numUsers = numUsers;
+		edge.checkcount = 0;
+	}
+	numEdges = model->numEdges;
+
+	// polygons, all allocated from a single block
+	numPolygons = numPolygonEdges = -1;
+	fp->ReadInt( numPolygons );
+	fp->ReadInt( numPolygonEdges );
+	if ( !CM_BinaryHasData( fp, numPolygons, 13 * sizeof( int ) ) || !CM_BinaryHasData( fp, numPolygonEdges, sizeof( int ) ) || numPolygonEdges < numPolygons ) {
+		return false;
+	}
+	j = numPolygons * sizeof( cm_polygon_t ) + ( numPolygonEdges - numPolygons ) * sizeof( p->edges[0] );
+	model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + j );
+	model->polygonBlock->bytesRemaining = j;
+	model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t );
+
+	polygons.SetNum( numPolygons );
+	for ( i = 0; i < numPolygons; i++ ) {
+		j = 0;
+		fp->ReadInt( j );
+		if ( j < 1 || j > numPolygonEdges || !CM_BinaryHasData( fp, j, sizeof( int ) ) ) {
+			return false;
+		}
+		numPolygonEdges -= j;
+		p = AllocPolygon( model, j );
+		p->numEdges = j;
+		for ( j = 0; j < p->numEdges; j++ ) {
+			fp->ReadInt( p->edges[j] );
+			if ( abs( p->edges[j] ) >= numEdges ) {
+				return false;
+			}
+		}
+		fp->ReadVec3( normal );
+		fp->ReadFloat( dist );
+		p->plane.SetNormal( normal );
+		p->plane.SetDist( dist );
+		fp->ReadVec3( p->bounds[0] );
+		fp->ReadVec3( p->bounds[1] );
+		materialNum = -1;
+		fp->ReadInt( materialNum );
+		if ( materialNum < 0 || materialNum >= materials.Num() ) {
+			return false;
+		}
+		p->material = materials[materialNum];
+		p->contents = p->material->GetContentFlags();
+		p->checkcount = 0;
+		polygons[i] = p;
+	}
+
+	// brushes, all allocated from a single block
+	numBrushes = numBrushPlanes = -1;
+	fp->ReadInt( numBrushes );
+	fp->ReadInt( numBrushPlanes );
+	if ( !CM_BinaryHasData( fp, numBrushes, 10 * sizeof( int ) ) || !CM_BinaryHasData( fp, numBrushPlanes, 4 * sizeof( float ) ) || numBrushPlanes < numBrushes ) {
+		return false;
+	}
+	j = numBrushes * sizeof( cm_brush_t ) + ( numBrushPlanes - numBrushes ) * sizeof( b->planes[0] );
+	model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + j );
+	model->brushBlock->bytesRemaining = j;
+	model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t );
+
+	brushes.SetNum( numBrushes );
+	for ( i = 0; i < numBrushes; i++ ) {
+		j = 0;
+		fp->ReadInt( j );
+		if ( j < 1 || j > numBrushPlanes || !CM_BinaryHasData( fp, j, 4 * sizeof( float ) ) ) {
+			return false;
+		}
+		numBrushPlanes -= j;
+		b = AllocBrush( model, j );
+		b->numPlanes = j;
+		for ( j = 0; j < b->numPlanes; j++ ) {
+			fp->ReadVec3( normal );
+			fp->ReadFloat( dist );
+			b->planes[j].SetNormal( normal );
+			b->planes[j].SetDist( dist );
+		}
+		fp->ReadVec3( b->bounds[0] );
+		fp->ReadVec3( b->bounds[1] );
+		fp->ReadInt( b->contents );
+		fp->ReadInt( b->primitiveNum );
+		materialNum = -1;
+		fp->ReadInt( materialNum );
+		if ( materialNum < -1 || materialNum >= materials.Num() ) {
+			return false;
+		}
+		b->material = ( materialNum >= 0 ) ? materials[materialNum] : NULL;
+		b->checkcount = 0;
+		brushes[i] = b;
+	}
+
+	// nodes
+	model->node = ReadBinaryNodes( fp, model, NULL, numNodes, polygons.Ptr(), numPolygons, brushes.Ptr(), numBrushes );
+	if ( !model->node ) {
+		return false;
+	}
+
+	// total memory used by this model
+	model->usedMemory = model->numVertices * sizeof(cm_vertex_t) +
+						model->numEdges * sizeof(cm_edge_t) +
+						model->polygonMemory +
+						model->brushMemory +
+						model->numNodes * sizeof(cm_node_t) +
+						model->numPolygonRefs * sizeof(cm_polygonRef_t) +
+						model->numBrushRefs * sizeof(cm_brushRef_t);
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC ) {
+	idStr fileName, textFileName, materialName;
+	ID_TIME_T timestamp, textTimestamp;
+	int i, length, fileId, version, count, numMaterials, firstModel;
+	unsigned int crc;
+	void *buffer;
+	idList<const idMaterial *> materials;
+	cm_model_t *model;
+
+	if ( !cm_binaryCache.GetBool() ) {
+		return false;
+	}
+
+	fileName = name;
+	fileName.SetFileExtension( CM_BINARY_FILE_EXT );
+	length = fileSystem->ReadFile( fileName, &buffer, &timestamp );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	// don't use the binary file if the text file was changed after it was written
+	textFileName = name;
+	textFileName.SetFileExtension( CM_FILE_EXT );
+	if ( fileSystem->ReadFile( textFileName, NULL, &textTimestamp ) > 0 && textTimestamp > timestamp ) {
+		common->Printf( "%s is older than %s\n", fileName.c_str(), textFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	idFile_Memory fp( fileName, (const char *)buffer, length );
+
+	fileId = version = 0;
+	fp.ReadInt( fileId );
+	fp.ReadInt( version );
+	if ( fileId != CM_BINARY_FILEID || version != CM_BINARY_FILEVERSION ) {
+		common->Printf( "%s has a different version\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	fp.ReadUnsignedInt( crc );
+	if ( mapFileCRC && crc != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	count = numMaterials = -1;
+	fp.ReadInt( count );
+	fp.ReadInt( numMaterials );
+	if ( count < 0 || numModels + count > MAX_SUBMODELS || !CM_BinaryHasData( &fp, numMaterials, sizeof( int ) ) ) {
+		common->Warning( "%s is corrupt", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	materials.SetNum( numMaterials );
+	for ( i = 0; i < numMaterials; i++ ) {
+		fp.ReadString( materialName );
+		materials[i] = declManager->FindMaterial( materialName );
+	}
+
+	firstModel = numModels;
+	for ( i = 0; i < count; i++ ) {
+		model = AllocModel();
+		models[numModels] = model;
+		numModels++;
+		if ( !ReadBinaryCollisionModel( &fp, model, materials ) ) {
+			common->Warning( "%s is corrupt", fileName.c_str() );
+			// nothing was linked into the tree of the model that failed
+			model->node = NULL;
+			while( numModels > firstModel ) {
+				numModels--;
+				FreeModel( models[numModels] );
+				models[numModels] = NULL;
+			}
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+	}
+
+	fileSystem->FreeFile( buffer );
+
 	return true;
 }
@@ -185,15 +185,10 @@ void idCollisionModelManagerLocal::Clear( void ) {
 	maxModels = 0;
 	numModels = 0;
 	models = NULL;
-	memset( trmPolygons, 0, sizeof( trmPolygons ) );
-	trmBrushes[0] = NULL;
 	trmMaterial = NULL;
 	numProcNodes = 0;
 	procNodes = NULL;
-	getContacts = false;
-	contacts = NULL;
-	maxContacts = 0;
-	numContacts = 0;
+	memset( threadStates, 0, sizeof( threadStates ) );
 }
 
 /*
@@ -423,6 +418,8 @@ void idCollisionModelManagerLocal::FreeMap( void ) {
 
 	FreeTrmModelStructure();
 
+	FreeThreadStates();
+
 	Mem_Free( models );
 
 	Clear();
@@ -436,21 +433,129 @@ idCollisionModelManagerLocal::FreeTrmModelStructure
 ================
 */
 void idCollisionModelManagerLocal::FreeTrmModelStructure( void ) {
-	int i;
+	int i, j;
 
 	assert( models );
-	if ( !models[MAX_SUBMODELS] ) {
-		return;
+	for ( i = 0; i < CM_MAX_THREADS; i++ ) {
+		cm_threadState_t *state = &threadStates[i];
+
+		if ( !state->trmModel ) {
+			continue;
+		}
+
+		for ( j = 0; j < MAX_TRACEMODEL_POLYS; j++ ) {
+			FreePolygon( state->trmModel, state->trmPolygons[j]->p );
+		}
+		FreeBrush( state->trmModel, state->trmBrushes[0]->b );
+
+		state->trmModel->node->polygons = NULL;
+		state->trmModel->node->brushes = NULL;
+		FreeModel( state->trmModel );
+		state->trmModel = NULL;
 	}
+	models[MAX_SUBMODELS] = NULL;
+}
+
+/*
+===============================================================================
+
+Per thread query state
 
-	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		FreePolygon( models[MAX_SUBMODELS], trmPolygons[i]->p );
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::GetThreadState
+================
+*/
+cm_threadState_t *idCollisionModelManagerLocal::GetThreadState( void ) {
+	return &threadStates[ Sys_JobThreadNum() ];
+}
+
+/*
+================
+idCollisionModelManagerLocal::ModelForHandle
+
+  the trace model handle refers to the trace model last setup on the calling thread
+================
+*/
+cm_model_t *idCollisionModelManagerLocal::ModelForHandle( cmHandle_t handle, const cm_threadState_t *state ) const {
+	if ( handle == TRACE_MODEL_HANDLE ) {
+		return state->trmModel;
 	}
-	FreeBrush( models[MAX_SUBMODELS], trmBrushes[0]->b );
+	return models[handle];
+}
 
-	models[MAX_SUBMODELS]->node->polygons = NULL;
-	models[MAX_SUBMODELS]->node->brushes = NULL;
-	FreeModel( models[MAX_SUBMODELS] );
+/*
+================
+idCollisionModelManagerLocal::ResizeThreadStates
+
+  makes sure the per thread check arrays can hold the primitives of every model,
+  called on the main thread whenever models are added because the job threads can't allocate memory
+================
+*/
+void idCollisionModelManagerLocal::ResizeThreadStates( void ) {
+	int i, maxVertices, maxEdges, maxPolygons, maxBrushes;
+
+	maxVertices = MAX_TRACEMODEL_VERTS;
+	maxEdges = MAX_TRACEMODEL_EDGES + 1;
+	maxPolygons = MAX_TRACEMODEL_POLYS;
+	maxBrushes = 1;
+	for ( i = 0; i < numModels; i++ ) {
+		if ( !models[i] ) {
+			continue;
+		}
+		maxVertices = Max( maxVertices, models[i]->numVertices );
+		maxEdges = Max( maxEdges, models[i]->numEdges + 1 );
+		maxPolygons = Max( maxPolygons, models[i]->numPolygonChecks );
+		maxBrushes = Max( maxBrushes, models[i]->numBrushChecks );
+	}
+
+	for ( i = 0; i < CM_MAX_THREADS; i++ ) {
+		cm_threadState_t *state = &threadStates[i];
+
+		// new entries are cleared, so they never match the current checkCount
+		if ( state->maxVertices < maxVertices ) {
+			Mem_Free( state->vertices );
+			state->vertices = (cm_sideCheck_t *) Mem_ClearedAlloc( maxVertices * sizeof( state->vertices[0] ) );
+			state->maxVertices = maxVertices;
+		}
+		if ( state->maxEdges < maxEdges ) {
+			Mem_Free( state->edges );
+			state->edges = (cm_sideCheck_t *) Mem_ClearedAlloc( maxEdges * sizeof( state->edges[0] ) );
+			state->maxEdges = maxEdges;
+		}
+		if ( state->maxPolygons < maxPolygons ) {
+			Mem_Free( state->polygons );
+			state->polygons = (int *) Mem_ClearedAlloc( maxPolygons * sizeof( state->polygons[0] ) );
+			state->maxPolygons = maxPolygons;
+		}
+		if ( state->maxBrushes < maxBrushes ) {
+			Mem_Free( state->brushes );
+			state->brushes = (int *) Mem_ClearedAlloc( maxBrushes * sizeof( state->brushes[0] ) );
+			state->maxBrushes = maxBrushes;
+		}
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::FreeThreadStates
+================
+*/
+void idCollisionModelManagerLocal::FreeThreadStates( void ) {
+	int i;
+
+	for ( i = 0; i < CM_MAX_THREADS; i++ ) {
+		cm_threadState_t *state = &threadStates[i];
+
+		Mem_Free( state->vertices );
+		Mem_Free( state->edges );
+		Mem_Free( state->polygons );
+		Mem_Free( state->brushes );
+		memset( state, 0, sizeof( *state ) );
+	}
 }
 
 
@@ -555,6 +660,8 @@ cm_model_t *idCollisionModelManagerLocal::AllocModel( void ) {
 	model->brushRefBlocks = NULL;
 	model->polygonBlock = NULL;
 	model->brushBlock = NULL;
+	model->numPolygonChecks = 0;
+	model->numBrushChecks = 0;
 	model->numPolygons = model->polygonMemory =
 	model->numBrushes = model->brushMemory =
 	model->numNodes = model->numBrushRefs =
@@ -672,6 +779,7 @@ cm_polygon_t *idCollisionModelManagerLocal::AllocPolygon( cm_model_t *model, int
 	} else {
 		poly = (cm_polygon_t *) Mem_Alloc( size );
 	}
+	poly->checkNum = model->numPolygonChecks++;
 	return poly;
 }
 
@@ -694,6 +802,7 @@ cm_brush_t *idCollisionModelManagerLocal::AllocBrush( cm_model_t *model, int num
 	} else {
 		brush = (cm_brush_t *) Mem_Alloc( size );
 	}
+	brush->checkNum = model->numBrushChecks++;
 	return brush;
 }
 
@@ -733,59 +842,67 @@ idCollisionModelManagerLocal::SetupTrmModelStructure
 ================
 */
 void idCollisionModelManagerLocal::SetupTrmModelStructure( void ) {
-	int i;
+	int i, j;
 	cm_node_t *node;
 	cm_model_t *model;
 
-	// setup model
-	model = AllocModel();
-
-	assert( models );
-	models[MAX_SUBMODELS] = model;
-	// create node to hold the collision data
-	node = (cm_node_t *) AllocNode( model, 1 );
-	node->planeType = -1;
-	model->node = node;
-	// allocate vertex and edge arrays
-	model->numVertices = 0;
-	model->maxVertices = MAX_TRACEMODEL_VERTS;
-	model->vertices = (cm_vertex_t *) Mem_ClearedAlloc( model->maxVertices * sizeof(cm_vertex_t) );
-	model->numEdges = 0;
-	model->maxEdges = MAX_TRACEMODEL_EDGES+1;
-	model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t) );
 	// create a material for the trace model polygons
 	trmMaterial = declManager->FindMaterial( "_tracemodel", false );
 	if ( !trmMaterial ) {
 		common->FatalError( "_tracemodel material not found" );
 	}
 
-	// allocate polygons
-	for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
-		trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
-		trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
-		trmPolygons[i]->p->bounds.Clear();
-		trmPolygons[i]->p->plane.Zero();
-		trmPolygons[i]->p->checkcount = 0;
-		trmPolygons[i]->p->contents = -1;		// all contents
-		trmPolygons[i]->p->material = trmMaterial;
-		trmPolygons[i]->p->numEdges = 0;
-	}
-	// allocate brush for position test
-	trmBrushes[0] = AllocBrushReference( model, 1 );
-	trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
-	trmBrushes[0]->b->primitiveNum = 0;
-	trmBrushes[0]->b->bounds.Clear();
-	trmBrushes[0]->b->checkcount = 0;
-	trmBrushes[0]->b->contents = -1;		// all contents
-	trmBrushes[0]->b->numPlanes = 0;
+	// every thread gets its own trace model so they can be setup concurrently
+	for ( j = 0; j < CM_MAX_THREADS; j++ ) {
+		cm_threadState_t *state = &threadStates[j];
+
+		// setup model
+		model = AllocModel();
+		state->trmModel = model;
+		// create node to hold the collision data
+		node = (cm_node_t *) AllocNode( model, 1 );
+		node->planeType = -1;
+		model->node = node;
+		// allocate vertex and edge arrays
+		model->numVertices = 0;
+		model->maxVertices = MAX_TRACEMODEL_VERTS;
+		model->vertices = (cm_vertex_t *) Mem_ClearedAlloc( model->maxVertices * sizeof(cm_vertex_t) );
+		model->numEdges = 0;
+		model->maxEdges = MAX_TRACEMODEL_EDGES+1;
+		model->edges = (cm_edge_t *) Mem_ClearedAlloc( model->maxEdges * sizeof(cm_edge_t) );
+
+		// allocate polygons
+		for ( i = 0; i < MAX_TRACEMODEL_POLYS; i++ ) {
+			state->trmPolygons[i] = AllocPolygonReference( model, MAX_TRACEMODEL_POLYS );
+			state->trmPolygons[i]->p = AllocPolygon( model, MAX_TRACEMODEL_POLYEDGES );
+			state->trmPolygons[i]->p->bounds.Clear();
+			state->trmPolygons[i]->p->plane.Zero();
+			state->trmPolygons[i]->p->checkcount = 0;
+			state->trmPolygons[i]->p->contents = -1;		// all contents
+			state->trmPolygons[i]->p->material = trmMaterial;
+			state->trmPolygons[i]->p->numEdges = 0;
+		}
+		// allocate brush for position test
+		state->trmBrushes[0] = AllocBrushReference( model, 1 );
+		state->trmBrushes[0]->b = AllocBrush( model, MAX_TRACEMODEL_POLYS );
+		state->trmBrushes[0]->b->primitiveNum = 0;
+		state->trmBrushes[0]->b->bounds.Clear();
+		state->trmBrushes[0]->b->checkcount = 0;
+		state->trmBrushes[0]->b->contents = -1;		// all contents
+		state->trmBrushes[0]->b->numPlanes = 0;
+	}
+
+	// for the debug drawing on the main thread
+	assert( models );
+	models[MAX_SUBMODELS] = threadStates[0].trmModel;
 }
 
 /*
 ================
 idCollisionModelManagerLocal::SetupTrmModel
 
-Trace models (item boxes, etc) are converted to collision models on the fly, using the last model slot
-as a reusable temporary buffer
+Trace models (item boxes, etc) are converted to collision models on the fly, using a reusable
+temporary buffer of the calling thread
 ================
 */
 cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm, const idMaterial *material ) {
@@ -794,6 +911,7 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	cm_edge_t *edge;
 	cm_polygon_t *poly;
 	cm_model_t *model;
+	cm_threadState_t *state;
 	const traceModelVert_t *trmVert;
 	const traceModelEdge_t *trmEdge;
 	const traceModelPoly_t *trmPoly;
@@ -804,7 +922,8 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		material = trmMaterial;
 	}
 
-	model = models[MAX_SUBMODELS];
+	state = GetThreadState();
+	model = state->trmModel;
 	model->node->brushes = NULL;
 	model->node->polygons = NULL;
 	// if not a valid trace model
@@ -817,7 +936,6 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 	trmVert = trm.verts;
 	for ( i = 0; i < trm.numVerts; i++, vertex++, trmVert++ ) {
 		vertex->p = *trmVert;
-		vertex->sideSet = 0;
 	}
 	// edges
 	model->numEdges = trm.numEdges;
@@ -828,13 +946,12 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		edge->vertexNum[1] = trmEdge->v[1];
 		edge->normal = trmEdge->normal;
 		edge->internal = false;
-		edge->sideSet = 0;
 	}
 	// polygons
 	model->numPolygons = trm.numPolys;
 	trmPoly = trm.polys;
 	for ( i = 0; i < trm.numPolys; i++, trmPoly++ ) {
-		poly = trmPolygons[i]->p;
+		poly = state->trmPolygons[i]->p;
 		poly->numEdges = trmPoly->numEdges;
 		for ( j = 0; j < trmPoly->numEdges; j++ ) {
 			poly->edges[j] = trmPoly->edges[j];
@@ -844,20 +961,20 @@ cmHandle_t idCollisionModelManagerLocal::SetupTrmModel( const idTraceModel &trm,
 		poly->bounds = trmPoly->bounds;
 		poly->material = material;
 		// link polygon at node
-		trmPolygons[i]->next = model->node->polygons;
-		model->node->polygons = trmPolygons[i];
+		state->trmPolygons[i]->next = model->node->polygons;
+		model->node->polygons = state->trmPolygons[i];
 	}
 	// if the trace model is convex
 	if ( trm.isConvex ) {
 		// setup brush for position test
-		trmBrushes[0]->b->numPlanes = trm.numPolys;
+		state->trmBrushes[0]->b->numPlanes = trm.numPolys;
 		for ( i = 0; i < trm.numPolys; i++ ) {
-			trmBrushes[0]->b->planes[i] = trmPolygons[i]->p->plane;
+			state->trmBrushes[0]->b->planes[i] = state->trmPolygons[i]->p->plane;
 		}
-		trmBrushes[0]->b->bounds = trm.bounds;
+		state->trmBrushes[0]->b->bounds = trm.bounds;
 		// link brush at node
-		trmBrushes[0]->next = model->node->brushes;
-		model->node->brushes = trmBrushes[0];
+		state->trmBrushes[0]->next = model->node->brushes;
+		model->node->brushes = state->trmBrushes[0];
 	}
 	// model bounds
 	model->bounds = trm.bounds;
@@ -3375,6 +3492,9 @@ void idCollisionModelManagerLocal::LoadMap( const idMapFile *mapFile ) {
 	// build collision models
 	BuildModels( mapFile );
 
+	// make room for the query state of all models
+	ResizeThreadStates();
+
 	// save name and time stamp
 	mapName = mapFile->GetName();
 	mapFileTime = mapFile->GetFileTime();
@@ -3528,6 +3648,7 @@ cmHandle_t idCollisionModelManagerLocal::LoadModel( const char *modelName, const
 	if ( LoadCollisionModelFile( modelName, 0 ) ) {
 		handle = FindModel( modelName );
 		if ( handle >= 0 ) {
+			ResizeThreadStates();
 			return handle;
 		} else {
 			common->Warning( "idCollisionModelManagerLocal::LoadModel: collision file for '%s' contains different model", modelName );
@@ -3543,6 +3664,7 @@ cmHandle_t idCollisionModelManagerLocal::LoadModel( const char *modelName, const
 	models[numModels] = LoadRenderModel( modelName );
 	if ( models[numModels] != NULL ) {
 		numModels++;
+		ResizeThreadStates();
 		return ( numModels - 1 );
 	}
 
@@ -34,6 +34,8 @@ If you have questions concerning this license or the applicable additional terms
 ===============================================================================
 */
 
+#include "idlib/containers/HashIndex.h"
+#include "idlib/containers/StrList.h"
 #include "idlib/math/Pluecker.h"
 #include "cm/CollisionModel.h"
 
@@ -79,19 +81,18 @@ Collision model
 ===============================================================================
 */
 
+// the checkcounts in the model primitives are only used while building, writing and drawing
+// models on the main thread, collision queries keep their state in cm_threadState_t instead
+
 typedef struct cm_vertex_s {
 	idVec3					p;					// vertex point
 	int						checkcount;			// for multi-check avoidance
-	unsigned int			side;				// each bit tells at which side this vertex passes one of the trace model edges
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model edge has been calculated yet
 } cm_vertex_t;
 
 typedef struct cm_edge_s {
 	int						checkcount;			// for multi-check avoidance
 	unsigned short			internal;			// a trace model can never collide with internal edges
 	unsigned short			numUsers;			// number of polygons using this edge
-	unsigned int			side;				// each bit tells at which side of this edge one of the trace model vertices passes
-	unsigned int			sideSet;			// each bit tells if sidedness for the trace model vertex has been calculated yet
 	int						vertexNum[2];		// start and end point of edge
 	idVec3					normal;				// edge normal
 } cm_edge_t;
@@ -104,6 +105,7 @@ typedef struct cm_polygonBlock_s {
 typedef struct cm_polygon_s {
 	idBounds				bounds;				// polygon bounds
 	int						checkcount;			// for multi-check avoidance
+	int						checkNum;			// index into the per thread polygon checkcounts
 	int						contents;			// contents behind polygon
 	const idMaterial *		material;			// material
 	idPlane					plane;				// polygon plane
@@ -128,6 +130,7 @@ typedef struct cm_brushBlock_s {
 
 typedef struct cm_brush_s {
 	int						checkcount;			// for multi-check avoidance
+	int						checkNum;			// index into the per thread brush checkcounts
 	idBounds				bounds;				// brush bounds
 	int						contents;			// contents of brush
 	const idMaterial *		material;			// material
@@ -179,6 +182,8 @@ typedef struct cm_model_s {
 	cm_brushRefBlock_t *	brushRefBlocks;		// list with blocks of brush references
 	cm_polygonBlock_t *		polygonBlock;		// memory block with all polygons
 	cm_brushBlock_t *		brushBlock;			// memory block with all brushes
+	int						numPolygonChecks;	// number of polygon checkNums handed out
+	int						numBrushChecks;		// number of brush checkNums handed out
 	// statistics
 	int						numPolygons;
 	int						polygonMemory;
@@ -202,6 +207,37 @@ Data used during collision detection calculations
 ===============================================================================
 */
 
+#define CM_MAX_THREADS						(MAX_JOB_THREADS+1)
+
+typedef struct cm_sideCheck_s {
+	int checkcount;									// for multi-check avoidance
+	unsigned int side;								// each bit tells at which side of this model vertex or edge one of the trace model edges or vertices passes
+	unsigned int sideSet;							// each bit tells if sidedness for the trace model edge or vertex has been calculated yet
+} cm_sideCheck_t;
+
+// everything collision queries modify lives here, there's one per job thread plus one for all other threads,
+// so queries on different job threads can run concurrently as long as no models are loaded or freed meanwhile
+typedef struct cm_threadState_s {
+	int checkCount;									// incremented for every query
+	int maxVertices;
+	cm_sideCheck_t *vertices;						// indexed by model vertex number
+	int maxEdges;
+	cm_sideCheck_t *edges;							// indexed by model edge number
+	int maxPolygons;
+	int *polygons;									// checkcounts indexed by cm_polygon_t::checkNum
+	int maxBrushes;
+	int *brushes;									// checkcounts indexed by cm_brush_t::checkNum
+
+	cm_model_t *trmModel;							// trace model setup with SetupTrmModel on this thread
+	cm_polygonRef_t *trmPolygons[MAX_TRACEMODEL_POLYS];
+	cm_brushRef_t *trmBrushes[1];
+
+	bool getContacts;								// for retrieving contact points
+	contactInfo_t *contacts;
+	int maxContacts;
+	int numContacts;
+} cm_threadState_t;
+
 typedef struct cm_trmVertex_s {
 	int used;										// true if this vertex is used for collision detection
 	idVec3 p;										// vertex position
@@ -239,6 +275,14 @@ typedef struct cm_traceWork_s {
 	cm_trmEdge_t edges[MAX_TRACEMODEL_EDGES+1];		// trm edges
 	int numPolys;
 	cm_trmPolygon_t polys[MAX_TRACEMODEL_POLYS];	// trm polygons
+	// trm data in SoA form to test all trm vertices or edges at once against a model edge, vertex or plane
+	unsigned int vertexBits;						// bit for each trm vertex in vertexPl
+	unsigned int edgeBits;							// bit for the bitNum of each trm edge in edgePl
+	ALIGN16( float vertexPl[6][MAX_TRACEMODEL_VERTS] );	// pluecker coordinates for the trm vertex movement lines
+	ALIGN16( float edgePl[6][MAX_TRACEMODEL_EDGES] );	// pluecker coordinates for the trm edges, edge i is in column i - 1
+	ALIGN16( float vertexPoints[3][MAX_TRACEMODEL_VERTS] );	// trm vertices for position tests
+	cm_threadState_t *state;						// state of the thread running the query
+	int checkCount;									// for multi-check avoidance, same as state->checkCount
 	cm_model_t *model;								// model colliding with
 	idVec3 start;									// start of trace
 	idVec3 end;										// end of trace
@@ -403,6 +447,11 @@ private:			// CollisionMap_trace.cpp
 private:			// CollisionMap_load.cpp
 	void			Clear( void );
 	void			FreeTrmModelStructure( void );
+					// per thread query state
+	cm_threadState_t *GetThreadState( void );
+	cm_model_t *	ModelForHandle( cmHandle_t handle, const cm_threadState_t *state ) const;
+	void			ResizeThreadStates( void );
+	void			FreeThreadStates( void );
 					// model deallocation
 	void			RemovePolygonReferences_r( cm_node_t *node, cm_polygon_t *p );
 	void			RemoveBrushReferences_r( cm_node_t *node, cm_brush_t *b );
@@ -482,6 +531,14 @@ private:			// CollisionMap_files.cpp
 	void			WriteBrushes( idFile *fp, cm_node_t *node );
 	void			WriteCollisionModel( idFile *fp, cm_model_t *model );
 	void			WriteCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+					// binary cache
+	void			WriteBinaryNodes( idFile *fp, cm_node_t *node, const idList<int> &polygonRemap, const idList<int> &brushRemap );
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model, idStrList &materials, idHashIndex &materialHash );
+	void			WriteBinaryCollisionModelsToFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC );
+	cm_node_t *		ReadBinaryNodes( idFile *fp, cm_model_t *model, cm_node_t *parent, int maxNodes,
+								cm_polygon_t **polygons, int numPolygons, cm_brush_t **brushes, int numBrushes );
+	bool			ReadBinaryCollisionModel( idFile *fp, cm_model_t *model, const idList<const idMaterial *> &materials );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC );
 					// loading
 	cm_node_t *		ParseNodes( idLexer *src, cm_model_t *model, cm_node_t *parent );
 	void			ParseVertices( idLexer *src, cm_model_t *model );
@@ -504,24 +561,19 @@ private:			// collision map data
 	idStr			mapName;
 	ID_TIME_T			mapFileTime;
 	int				loaded;
-					// for multi-check avoidance
+					// for multi-check avoidance while building, writing and drawing models
 	int				checkCount;
 					// models
 	int				maxModels;
 	int				numModels;
 	cm_model_t **	models;
-					// polygons and brush for trm model
-	cm_polygonRef_t*trmPolygons[MAX_TRACEMODEL_POLYS];
-	cm_brushRef_t *	trmBrushes[1];
+					// material for trm model polygons
 	const idMaterial *trmMaterial;
 					// for data pruning
 	int				numProcNodes;
 	cm_procNode_t *	procNodes;
-					// for retrieving contact points
-	bool			getContacts;
-	contactInfo_t *	contacts;
-	int				maxContacts;
-	int				numContacts;
+					// query state per thread, indexed by Sys_JobThreadNum()
+	cm_threadState_t threadStates[CM_MAX_THREADS];
 };
 
 // for debugging
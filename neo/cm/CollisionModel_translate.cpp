@@ -198,15 +198,16 @@ ID_INLINE void CM_AddContact( cm_traceWork_t *tw ) {
 ================
 CM_SetVertexSidedness
 
-  stores for the given model vertex at which side of one of the trm edges it passes
+  stores for the given model vertex at which side of the trm edges it passes,
+  the first time the sidedness for one of the trm edges is needed it's calculated for all of them
 ================
 */
-ID_INLINE void CM_SetVertexSidedness( cm_vertex_t *v, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetVertexSidedness( const cm_traceWork_t *tw, cm_sideCheck_t *v, const idPluecker &vpl, const int bitNum ) {
 	if ( !(v->sideSet & (1<<bitNum)) ) {
-		float fl;
-		fl = vpl.PermutedInnerProduct( epl );
-		v->side = (v->side & ~(1<<bitNum)) | (FLOATSIGNBITSET(fl) << bitNum);
-		v->sideSet |= (1 << bitNum);
+		unsigned int bits;
+		bits = SIMDProcessor->PermutedInnerProductSigns( vpl, tw->edgePl[0], MAX_TRACEMODEL_EDGES, tw->numEdges ) << 1;
+		v->side = (v->side & ~tw->edgeBits) | (bits & tw->edgeBits);
+		v->sideSet |= tw->edgeBits;
 	}
 }
 
@@ -214,15 +215,16 @@ ID_INLINE void CM_SetVertexSidedness( cm_vertex_t *v, const idPluecker &vpl, con
 ================
 CM_SetEdgeSidedness
 
-  stores for the given model edge at which side one of the trm vertices
+  stores for the given model edge at which side the trm vertices pass,
+  the first time the sidedness for one of the trm vertices is needed it's calculated for all of them
 ================
 */
-ID_INLINE void CM_SetEdgeSidedness( cm_edge_t *edge, const idPluecker &vpl, const idPluecker &epl, const int bitNum ) {
+ID_INLINE void CM_SetEdgeSidedness( const cm_traceWork_t *tw, cm_sideCheck_t *edge, const idPluecker &epl, const int bitNum ) {
 	if ( !(edge->sideSet & (1<<bitNum)) ) {
-		float fl;
-		fl = vpl.PermutedInnerProduct( epl );
-		edge->side = (edge->side & ~(1<<bitNum)) | (FLOATSIGNBITSET(fl) << bitNum);
-		edge->sideSet |= (1 << bitNum);
+		unsigned int bits;
+		bits = SIMDProcessor->PermutedInnerProductSigns( epl, tw->vertexPl[0], MAX_TRACEMODEL_VERTS, tw->numVerts );
+		edge->side = (edge->side & ~tw->vertexBits) | (bits & tw->vertexBits);
+		edge->sideSet |= tw->vertexBits;
 	}
 }
 
@@ -236,15 +238,16 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 	float f1, f2, dist, d1, d2;
 	idVec3 start, end, normal;
 	cm_edge_t *edge;
-	cm_vertex_t *v1, *v2;
+	cm_sideCheck_t *edgeCheck, *v1, *v2;
 	idPluecker *pl, epsPl;
 
 	// check edges for a collision
 	for ( i = 0; i < poly->numEdges; i++) {
 		edgeNum = poly->edges[i];
 		edge = tw->model->edges + abs(edgeNum);
+		edgeCheck = tw->state->edges + abs(edgeNum);
 		// if this edge is already checked
-		if ( edge->checkcount == idCollisionModelManagerLocal::checkCount ) {
+		if ( edgeCheck->checkcount == tw->checkCount ) {
 			continue;
 		}
 		// can never collide with internal edges
@@ -253,17 +256,17 @@ void idCollisionModelManagerLocal::TranslateTrmEdgeThroughPolygon( cm_traceWork_
 		}
 		pl = &tw->polygonEdgePlueckerCache[i];
 		// get the sides at which the trm edge vertices pass the polygon edge
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[0]].pl, trmEdge->vertexNum[0] );
-		CM_SetEdgeSidedness( edge, *pl, tw->vertices[trmEdge->vertexNum[1]].pl, trmEdge->vertexNum[1] );
+		CM_SetEdgeSidedness( tw, edgeCheck, *pl, trmEdge->vertexNum[0] );
+		CM_SetEdgeSidedness( tw, edgeCheck, *pl, trmEdge->vertexNum[1] );
 		// if the trm edge start and end vertex do not pass the polygon edge at different sides
-		if ( !(((edge->side >> trmEdge->vertexNum[0]) ^ (edge->side >> trmEdge->vertexNum[1])) & 1) ) {
+		if ( !(((edgeCheck->side >> trmEdge->vertexNum[0]) ^ (edgeCheck->side >> trmEdge->vertexNum[1])) & 1) ) {
 			continue;
 		}
 		// get the sides at which the polygon edge vertices pass the trm edge
-		v1 = tw->model->vertices + edge->vertexNum[INTSIGNBITSET(edgeNum)];
-		CM_SetVertexSidedness( v1, tw->polygonVertexPlueckerCache[i], trmEdge->pl, trmEdge->bitNum );
-		v2 = tw->model->vertices + edge->vertexNum[INTSIGNBITNOTSET(edgeNum)];
-		CM_SetVertexSidedness( v2, tw->polygonVertexPlueckerCache[i+1], trmEdge->pl, trmEdge->bitNum );
+		v1 = tw->state->vertices + edge->vertexNum[INTSIGNBITSET(edgeNum)];
+		CM_SetVertexSidedness( tw, v1, tw->polygonVertexPlueckerCache[i], trmEdge->bitNum );
+		v2 = tw->state->vertices + edge->vertexNum[INTSIGNBITNOTSET(edgeNum)];
+		CM_SetVertexSidedness( tw, v2, tw->polygonVertexPlueckerCache[i+1], trmEdge->bitNum );
 		// if the polygon edge start and end vertex do not pass the trm edge at different sides
 		if ( !((v1->side ^ v2->side) & (1<<trmEdge->bitNum)) ) {
 			continue;
@@ -397,15 +400,15 @@ idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon
 void idCollisionModelManagerLocal::TranslateTrmVertexThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *poly, cm_trmVertex_t *v, int bitNum ) {
 	int i, edgeNum;
 	float f;
-	cm_edge_t *edge;
+	cm_sideCheck_t *edge;
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
 	if ( f < tw->trace.fraction ) {
 
 		for ( i = 0; i < poly->numEdges; i++ ) {
 			edgeNum = poly->edges[i];
-			edge = tw->model->edges + abs(edgeNum);
-			CM_SetEdgeSidedness( edge, tw->polygonEdgePlueckerCache[i], v->pl, bitNum );
+			edge = tw->state->edges + abs(edgeNum);
+			CM_SetEdgeSidedness( tw, edge, tw->polygonEdgePlueckerCache[i], bitNum );
 			if ( INTSIGNBITSET(edgeNum) ^ ((edge->side >> bitNum) & 1) ) {
 				return;
 			}
@@ -441,6 +444,7 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 	int i, edgeNum;
 	float f;
 	cm_edge_t *edge;
+	cm_sideCheck_t *edgeCheck;
 	idPluecker pl;
 
 	f = CM_TranslationPlaneFraction( poly->plane, v->p, v->endp );
@@ -449,17 +453,18 @@ void idCollisionModelManagerLocal::TranslatePointThroughPolygon( cm_traceWork_t
 		for ( i = 0; i < poly->numEdges; i++ ) {
 			edgeNum = poly->edges[i];
 			edge = tw->model->edges + abs(edgeNum);
+			edgeCheck = tw->state->edges + abs(edgeNum);
 			// if we didn't yet calculate the sidedness for this edge
-			if ( edge->checkcount != idCollisionModelManagerLocal::checkCount ) {
+			if ( edgeCheck->checkcount != tw->checkCount ) {
 				float fl;
-				edge->checkcount = idCollisionModelManagerLocal::checkCount;
+				edgeCheck->checkcount = tw->checkCount;
 				pl.FromLine(tw->model->vertices[edge->vertexNum[0]].p, tw->model->vertices[edge->vertexNum[1]].p);
 				fl = v->pl.PermutedInnerProduct( pl );
-				edge->side = FLOATSIGNBITSET(fl);
+				edgeCheck->side = FLOATSIGNBITSET(fl);
 			}
 			// if the point passes the edge at the wrong side
 			//if ( (edgeNum > 0) == edge->side ) {
-			if ( INTSIGNBITSET(edgeNum) ^ edge->side ) {
+			if ( INTSIGNBITSET(edgeNum) ^ edgeCheck->side ) {
 				return;
 			}
 		}
@@ -494,16 +499,18 @@ void idCollisionModelManagerLocal::TranslateVertexThroughTrmPolygon( cm_traceWor
 	int i, edgeNum;
 	float f;
 	cm_trmEdge_t *edge;
+	cm_sideCheck_t *vertexCheck;
 
 	f = CM_TranslationPlaneFraction( trmpoly->plane, v->p, endp );
 	if ( f < tw->trace.fraction ) {
 
+		vertexCheck = tw->state->vertices + ( v - tw->model->vertices );
 		for ( i = 0; i < trmpoly->numEdges; i++ ) {
 			edgeNum = trmpoly->edges[i];
 			edge = tw->edges + abs(edgeNum);
 
-			CM_SetVertexSidedness( v, pl, edge->pl, edge->bitNum );
-			if ( INTSIGNBITSET(edgeNum) ^ ((v->side >> edge->bitNum) & 1) ) {
+			CM_SetVertexSidedness( tw, vertexCheck, pl, edge->bitNum );
+			if ( INTSIGNBITSET(edgeNum) ^ ((vertexCheck->side >> edge->bitNum) & 1) ) {
 				return;
 			}
 		}
@@ -544,12 +551,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 	cm_trmPolygon_t *bp;
 	cm_vertex_t *v;
 	cm_edge_t *e;
+	cm_sideCheck_t *vc, *ec;
 
 	// if already checked this polygon
-	if ( p->checkcount == idCollisionModelManagerLocal::checkCount ) {
+	if ( tw->state->polygons[p->checkNum] == tw->checkCount ) {
 		return false;
 	}
-	p->checkcount = idCollisionModelManagerLocal::checkCount;
+	tw->state->polygons[p->checkNum] = tw->checkCount;
 
 	// if this polygon does not have the right contents behind it
 	if ( !(p->contents & tw->contents) ) {
@@ -602,18 +610,20 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
+			ec = tw->state->edges + abs(edgeNum);
 			// reset sidedness cache if this is the first time we encounter this edge during this trace
-			if ( e->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				e->sideSet = 0;
+			if ( ec->checkcount != tw->checkCount ) {
+				ec->sideSet = 0;
 			}
 			// pluecker coordinate for edge
 			tw->polygonEdgePlueckerCache[i].FromLine( tw->model->vertices[e->vertexNum[0]].p,
 														tw->model->vertices[e->vertexNum[1]].p );
 
 			v = &tw->model->vertices[e->vertexNum[INTSIGNBITSET(edgeNum)]];
+			vc = &tw->state->vertices[e->vertexNum[INTSIGNBITSET(edgeNum)]];
 			// reset sidedness cache if this is the first time we encounter this vertex during this trace
-			if ( v->checkcount != idCollisionModelManagerLocal::checkCount ) {
-				v->sideSet = 0;
+			if ( vc->checkcount != tw->checkCount ) {
+				vc->sideSet = 0;
 			}
 			// pluecker coordinate for vertex movement vector
 			tw->polygonVertexPlueckerCache[i].FromRay( v->p, -tw->dir );
@@ -641,12 +651,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 		for ( i = 0; i < p->numEdges; i++ ) {
 			edgeNum = p->edges[i];
 			e = tw->model->edges + abs(edgeNum);
+			ec = tw->state->edges + abs(edgeNum);
 
-			if ( e->checkcount == idCollisionModelManagerLocal::checkCount ) {
+			if ( ec->checkcount == tw->checkCount ) {
 				continue;
 			}
 			// set edge check count
-			e->checkcount = idCollisionModelManagerLocal::checkCount;
+			ec->checkcount = tw->checkCount;
 			// can never collide with internal edges
 			if ( e->internal ) {
 				continue;
@@ -655,12 +666,13 @@ bool idCollisionModelManagerLocal::TranslateTrmThroughPolygon( cm_traceWork_t *t
 			for ( k = 0; k < 2; k++ ) {
 
 				v = tw->model->vertices + e->vertexNum[k ^ INTSIGNBITSET(edgeNum)];
+				vc = tw->state->vertices + e->vertexNum[k ^ INTSIGNBITSET(edgeNum)];
 				// if this vertex is already checked
-				if ( v->checkcount == idCollisionModelManagerLocal::checkCount ) {
+				if ( vc->checkcount == tw->checkCount ) {
 					continue;
 				}
 				// set vertex check count
-				v->checkcount = idCollisionModelManagerLocal::checkCount;
+				vc->checkcount = tw->checkCount;
 
 				// if the vertex is outside the trace bounds
 				if ( !tw->bounds.ContainsPoint( v->p ) ) {
@@ -772,7 +784,8 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	cm_trmPolygon_t *poly;
 	cm_trmEdge_t *edge;
 	cm_trmVertex_t *vert;
-	ALIGN16( static cm_traceWork_t tw );
+	ALIGN16( cm_traceWork_t tw );
+	cm_threadState_t *state;
 
 	assert( ((byte *)&start) < ((byte *)results) || ((byte *)&start) >= (((byte *)results) + sizeof( trace_t )) );
 	assert( ((byte *)&end) < ((byte *)results) || ((byte *)&end) >= (((byte *)results) + sizeof( trace_t )) );
@@ -784,7 +797,8 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 		common->Printf("idCollisionModelManagerLocal::Translation: invalid model handle\n");
 		return;
 	}
-	if ( !idCollisionModelManagerLocal::models[model] ) {
+	state = idCollisionModelManagerLocal::GetThreadState();
+	if ( !idCollisionModelManagerLocal::ModelForHandle( model, state ) ) {
 		common->Printf("idCollisionModelManagerLocal::Translation: invalid model\n");
 		return;
 	}
@@ -795,7 +809,8 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 		return;
 	}
 
-	idCollisionModelManagerLocal::checkCount++;
+	tw.state = state;
+	tw.checkCount = ++state->checkCount;
 
 	tw.trace.fraction = 1.0f;
 	tw.trace.c.contents = 0;
@@ -805,11 +820,11 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 	tw.rotation = false;
 	tw.positionTest = false;
 	tw.quickExit = false;
-	tw.getContacts = idCollisionModelManagerLocal::getContacts;
-	tw.contacts = idCollisionModelManagerLocal::contacts;
-	tw.maxContacts = idCollisionModelManagerLocal::maxContacts;
+	tw.getContacts = state->getContacts;
+	tw.contacts = state->contacts;
+	tw.maxContacts = state->maxContacts;
 	tw.numContacts = 0;
-	tw.model = idCollisionModelManagerLocal::models[model];
+	tw.model = idCollisionModelManagerLocal::ModelForHandle( model, state );
 	tw.start = start - modelOrigin;
 	tw.end = end - modelOrigin;
 	tw.dir = end - start;
@@ -872,7 +887,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 			results->c.point += modelOrigin;
 			results->c.dist += modelOrigin * results->c.normal;
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		state->numContacts = tw.numContacts;
 		return;
 	}
 
@@ -997,6 +1012,34 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 		edge->bitNum = i;
 	}
 
+	// pluecker coordinates of the used trm vertices and edges in SoA form, padded with zeros
+	tw.vertexBits = 0;
+	for ( i = 0; i < ( ( tw.numVerts + 3 ) & ~3 ); i++ ) {
+		if ( i < tw.numVerts && tw.vertices[i].used ) {
+			for ( j = 0; j < 6; j++ ) {
+				tw.vertexPl[j][i] = tw.vertices[i].pl[j];
+			}
+			tw.vertexBits |= 1u << i;
+		} else {
+			for ( j = 0; j < 6; j++ ) {
+				tw.vertexPl[j][i] = 0.0f;
+			}
+		}
+	}
+	tw.edgeBits = 0;
+	for ( i = 0; i < ( ( tw.numEdges + 3 ) & ~3 ); i++ ) {
+		if ( i < tw.numEdges && tw.edges[i+1].used ) {
+			for ( j = 0; j < 6; j++ ) {
+				tw.edgePl[j][i] = tw.edges[i+1].pl[j];
+			}
+			tw.edgeBits |= ( 1u << i ) << 1;
+		} else {
+			for ( j = 0; j < 6; j++ ) {
+				tw.edgePl[j][i] = 0.0f;
+			}
+		}
+	}
+
 	// set trm plane distances
 	for ( poly = tw.polys, i = 0; i < tw.numPolys; i++, poly++ ) {
 		if ( poly->used ) {
@@ -1060,7 +1103,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 				tw.contacts[i].dist += modelOrigin * tw.contacts[i].normal;
 			}
 		}
-		idCollisionModelManagerLocal::numContacts = tw.numContacts;
+		state->numContacts = tw.numContacts;
 	} else {
 		// store results
 		*results = tw.trace;
@@ -1085,7 +1128,7 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
 #ifdef _DEBUG
 	// test for collisions
 	if ( cm_debugCollision.GetBool() ) {
-		if (!idCollisionModelManagerLocal::getContacts ) {
+		if ( !state->getContacts ) {
 			// if the trm is stuck in the model
 			if ( idCollisionModelManagerLocal::Contents( results->endpos, trm, trmAxis, -1, model, modelOrigin, modelAxis ) & contentMask ) {
 				trace_t tr;
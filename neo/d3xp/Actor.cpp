@@ -33,6 +33,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "Light.h"
 #include "Projectile.h"
 #include "WorldSpawn.h"
+#include "ai/AI.h"
 
 #include "Actor.h"
 
@@ -648,6 +649,9 @@ void idActor::Spawn( void ) {
 	finalBoss = spawnArgs.GetBool( "finalBoss" );
 
 	FinishSetup();
+
+	// add the actor to the obstacles found by monsters this frame
+	idAI::InvalidateObstacleHash();
 }
 
 /*
@@ -1531,6 +1535,66 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const {
 	return false;
 }
 
+static idList<clipTrace_t>	canSeeTraces;
+static idList<int>			canSeeEntities;
+
+/*
+=====================
+idActor::CanSeeBatch
+
+Same as calling CanSee for each entity, but traces all the lines of sight as one batch.
+visible[ i ] is set for entities[ i ], whatever order TraceBatch handles the traces in.
+=====================
+*/
+void idActor::CanSeeBatch( idEntity * const *entities, int numEntities, bool useFov, bool *visible ) const {
+	int			i;
+	idEntity	*ent;
+	idVec3		eye;
+	idVec3		toPos;
+
+	canSeeTraces.SetNum( 0, false );
+	canSeeEntities.SetNum( 0, false );
+
+	eye = GetEyePosition();
+
+	for ( i = 0; i < numEntities; i++ ) {
+		ent = entities[ i ];
+		visible[ i ] = false;
+
+		if ( ent->IsHidden() ) {
+			continue;
+		}
+
+		if ( ent->IsType( idActor::Type ) ) {
+			toPos = ( ( idActor * )ent )->GetEyePosition();
+		} else {
+			toPos = ent->GetPhysics()->GetOrigin();
+		}
+
+		if ( useFov && !CheckFOV( toPos ) ) {
+			continue;
+		}
+
+		clipTrace_t &trace = canSeeTraces.Alloc();
+		trace.start = eye;
+		trace.end = toPos;
+		trace.bounds.Clear();
+		trace.contentMask = MASK_OPAQUE;
+		trace.passEntity = this;
+		canSeeEntities.Append( i );
+	}
+
+	gameLocal.clip.TraceBatch( canSeeTraces.Ptr(), canSeeTraces.Num() );
+
+	for ( i = 0; i < canSeeTraces.Num(); i++ ) {
+		const trace_t &tr = canSeeTraces[ i ].results;
+		ent = entities[ canSeeEntities[ i ] ];
+		if ( tr.fraction >= 1.0f || ( gameLocal.GetTraceEntity( tr ) == ent ) ) {
+			visible[ canSeeEntities[ i ] ] = true;
+		}
+	}
+}
+
 /*
 =====================
 idActor::PointVisible
@@ -1803,6 +1867,8 @@ void idActor::Teleport( const idVec3 &origin, const idAngles &angles, idEntity *
 
 	UpdateVisuals();
 
+	idAI::InvalidateObstacleHash();
+
 	if ( !IsHidden() ) {
 		// kill anything at the new position
 		gameLocal.KillBox( this );
@@ -43,6 +43,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "Mover.h"
 #include "WorldSpawn.h"
 #include "SmokeParticles.h"
+#include "ai/AI.h"
 
 #include "Entity.h"
 
@@ -1546,7 +1547,12 @@ bool idEntity::UpdateRenderEntity( renderEntity_s *renderEntity, const renderVie
 		SetTimeState ts( timeGroup );
 #endif
 
-		return animator->CreateFrame( gameLocal.time, false );
+		bool skipDetail;
+		int animTime = gameLocal.AnimationLODTime( this, skipDetail );
+		animator->SetLastRenderFrame( gameLocal.framenum );
+		// a frame created ahead of time by idGameLocal::CreateAnimationFrames is reported once
+		bool createdAhead = animator->TakeFrameCreatedAhead();
+		return animator->CreateFrame( animTime, false, skipDetail ) || createdAhead;
 	}
 
 	return false;
@@ -2622,6 +2628,18 @@ idPhysics *idEntity::GetPhysics( void ) const {
 	return physics;
 }
 
+/*
+================
+idEntity::RunsPhysicsFirst
+
+  Entities returning true may have their articulated figure solved ahead
+  of the think, see idPhysics_AF::StartConcurrentStep.
+================
+*/
+bool idEntity::RunsPhysicsFirst( void ) {
+	return false;
+}
+
 /*
 ================
 idEntity::RunPhysics
@@ -3697,6 +3715,8 @@ void idEntity::Teleport( const idVec3 &origin, const idAngles &angles, idEntity
 	GetPhysics()->SetAxis( angles.ToMat3() );
 
 	UpdateVisuals();
+
+	idAI::InvalidateObstacleHash();
 }
 
 /*
@@ -189,6 +189,9 @@ void idMoveable::Spawn( void ) {
 	allowStep = spawnArgs.GetBool( "allowStep", "1" );
 
 	PostEventMS( &EV_SetOwnerFromSpawnArgs, 0 );
+
+	// add the moveable to the obstacles found by monsters this frame
+	idAI::InvalidateObstacleHash();
 }
 
 /*
@@ -8279,6 +8279,8 @@ void idPlayer::Teleport( const idVec3 &origin, const idAngles &angles, idEntity
 
 	UpdateVisuals();
 
+	idAI::InvalidateObstacleHash();
+
 	teleportEntity = destination;
 
 	if ( !gameLocal.isClient && !noclip ) {
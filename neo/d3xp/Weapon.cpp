@@ -3392,6 +3392,9 @@ void idWeapon::Event_LaunchProjectiles( int num_projectiles, float spread, float
 
 		// predict instant hit projectiles
 		if ( projectileDict.GetBool( "net_instanthit" ) ) {
+			const int maxPellets = 16;
+			clipTrace_t pellets[ maxPellets ];
+			int numPellets = 0;
 			float spreadRad = DEG2RAD( spread );
 			muzzle_pos = muzzleOrigin + playerViewAxis[ 0 ] * 2.0f;
 			for( i = 0; i < num_projectiles; i++ ) {
@@ -3399,9 +3402,23 @@ void idWeapon::Event_LaunchProjectiles( int num_projectiles, float spread, float
 				spin = (float)DEG2RAD( 360.0f ) * gameLocal.random.RandomFloat();
 				dir = playerViewAxis[ 0 ] + playerViewAxis[ 2 ] * ( ang * idMath::Sin( spin ) ) - playerViewAxis[ 1 ] * ( ang * idMath::Cos( spin ) );
 				dir.Normalize();
-				gameLocal.clip.Translation( tr, muzzle_pos, muzzle_pos + dir * 4096.0f, NULL, mat3_identity, MASK_SHOT_RENDERMODEL, owner );
-				if ( tr.fraction < 1.0f ) {
-					idProjectile::ClientPredictionCollide( this, projectileDict, tr, vec3_origin, true );
+
+				// all pellets leave the same muzzle so trace them as one batch
+				clipTrace_t &pellet = pellets[ numPellets++ ];
+				pellet.start = muzzle_pos;
+				pellet.end = muzzle_pos + dir * 4096.0f;
+				pellet.bounds.Clear();
+				pellet.contentMask = MASK_SHOT_RENDERMODEL;
+				pellet.passEntity = owner;
+
+				if ( numPellets == maxPellets || i == num_projectiles - 1 ) {
+					gameLocal.clip.TraceBatch( pellets, numPellets );
+					for ( int j = 0; j < numPellets; j++ ) {
+						if ( pellets[ j ].results.fraction < 1.0f ) {
+							idProjectile::ClientPredictionCollide( this, projectileDict, pellets[ j ].results, vec3_origin, true );
+						}
+					}
+					numPellets = 0;
 				}
 			}
 		}
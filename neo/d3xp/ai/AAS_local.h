@@ -40,6 +40,7 @@ public:
 								~idRoutingCache( void );
 
 	int							Size( void ) const;
+	void						Clear( void );
 
 private:
 	int							type;					// portal or area cache
@@ -54,6 +55,8 @@ private:
 	unsigned short				startTravelTime;		// travel time to start with
 	unsigned char *				reachabilities;			// reachabilities used for routing
 	unsigned short *			travelTimes;			// travel time for every area
+	bool						precomputed;			// precomputed when the map is loaded and never deleted
+	bool						dirty;					// travel times are outdated and must be updated before use
 };
 
 
@@ -72,6 +75,36 @@ private:
 };
 
 
+#define GOALROUTE_CALCULATED		1				// the route is calculated
+#define GOALROUTE_CLUSTER			2				// the goal can be reached through the cluster of the area
+#define GOALROUTE_PORTAL			4				// the goal can be reached through a portal of the cluster of the area
+#define GOALROUTE_UNREACHABLE		8				// the goal cannot be reached from the area
+
+#define MAX_GOAL_ROUTE_TABLES		8
+
+class idGoalRoute {
+	friend class idAASLocal;
+
+private:
+	unsigned short				clusterTravelTime;		// travel time through the cluster towards the goal
+	unsigned short				portalTravelTime;		// travel time through the best cluster portal towards the goal
+	unsigned char				clusterReachability;	// reachability used to travel through the cluster
+	unsigned char				portalReachability;		// reachability used to travel towards the best cluster portal
+	unsigned char				flags;					// GOALROUTE_?
+};
+
+
+class idGoalRouteTable {
+	friend class idAASLocal;
+
+private:
+	int							goalAreaNum;			// goal area of the routes, zero if the table is not used
+	int							travelFlags;			// travel flags used for the routes
+	int							lastUsed;				// used to replace the least recently used table
+	idGoalRoute *				routes;					// route from every area in the world, calculated when first used
+};
+
+
 class idRoutingObstacle {
 	friend class idAASLocal;
 								idRoutingObstacle( void ) { }
@@ -117,6 +150,9 @@ public:
 	virtual void				ShowWalkPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const;
+	virtual void				QueuePathQuery( aasPathQuery_t *query );
+	virtual void				CancelPathQuery( aasPathQuery_t *query );
+	virtual int					ProcessPathQueries( int maxQueries );
 
 private:
 	idAASFile *					file;
@@ -135,7 +171,14 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListStart;			// start of list with cache sorted from oldest to newest
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
+	idList<idRoutingCache *>	precomputedCache;		// cache precomputed when the map is loaded
+	int							precomputedCacheMemory;	// memory used by the precomputed cache
 	idList<idRoutingObstacle *>	obstacleList;			// list with obstacles
+	mutable idGoalRouteTable	goalRouteTables[MAX_GOAL_ROUTE_TABLES];	// routes from all areas towards recently used goal areas
+	mutable int					goalRouteUseCount;		// number of times a goal route table was used
+	mutable int					numGoalRouteHits;		// number of routes found in the goal route tables
+	mutable int					numGoalRouteMisses;		// number of routes calculated for the goal route tables
+	idList<aasPathQuery_t *>	pathQueries;			// queued path queries
 
 private:	// routing
 	bool						SetupRouting( void );
@@ -150,13 +193,26 @@ private:	// routing
 	void						RoutingStats( void ) const;
 	void						LinkCache( idRoutingCache *cache ) const;
 	void						UnlinkCache( idRoutingCache *cache ) const;
+	void						DeleteCache( idRoutingCache *cache ) const;
 	void						DeleteOldestCache( void ) const;
 	idReachability *			GetAreaReachability( int areaNum, int reachabilityNum ) const;
 	int							ClusterAreaNum( int clusterNum, int areaNum ) const;
-	void						UpdateAreaRoutingCache( idRoutingCache *areaCache ) const;
+	idRoutingCache *			AllocRoutingCache( int type, int clusterNum, int areaNum, int travelFlags ) const;
+	void						UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *update ) const;
 	idRoutingCache *			GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
-	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
+	void						UpdatePortalRoutingCache( idRoutingCache *portalCache, idRoutingUpdate *update ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
+	static void					UpdateRoutingCacheJob( void *data, int jobNum );
+	void						UpdateRoutingCaches( idRoutingCache **caches, int numCaches ) const;
+	void						PrecomputeRoutingCache( void );
+	unsigned int				RoutingChecksum( void ) const;
+	bool						ReadRoutingCache( const idList<int> &travelFlags );
+	void						WriteRoutingCache( const idList<int> &travelFlags ) const;
+	void						RepairRoutingCache( void );
+	void						ClearGoalRoutes( void ) const;
+	void						CalculateGoalRoute( idGoalRoute &route, int areaNum, int goalAreaNum, int travelFlags ) const;
+	const idGoalRoute *			GetGoalRoute( int areaNum, int goalAreaNum, int travelFlags ) const;
+	void						ClearPathQueries( void );
 	void						RemoveRoutingCacheUsingArea( int areaNum );
 	void						DisableArea( int areaNum );
 	void						EnableArea( int areaNum );
@@ -27,6 +27,10 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
+#include "idlib/Timer.h"
+#include "framework/FileSystem.h"
+#include "gamesys/SysCvar.h"
 #include "Game_local.h"
 
 #include "ai/AAS_local.h"
@@ -36,6 +40,12 @@ If you have questions concerning this license or the applicable additional terms
 
 #define MAX_ROUTING_CACHE_MEMORY	(2*1024*1024)
 
+#define ROUTING_FILE_EXT			"route"
+#define ROUTING_FILEID				( ( 'R' << 24 ) | ( 'O' << 16 ) | ( 'U' << 8 ) | 'T' )
+#define ROUTING_FILEVERSION			1
+
+#define MAX_ROUTING_CACHE_JOBS		64
+
 #define LEDGE_TRAVELTIME_PANALTY	250
 
 /*
@@ -51,6 +61,8 @@ idRoutingCache::idRoutingCache( int size ) {
 	travelFlags = 0;
 	startTravelTime = 0;
 	type = 0;
+	precomputed = false;
+	dirty = false;
 	this->size = size;
 	reachabilities = new byte[size];
 	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
@@ -77,6 +89,16 @@ int idRoutingCache::Size( void ) const {
 	return sizeof( idRoutingCache ) + size * sizeof( reachabilities[0] ) + size * sizeof( travelTimes[0] );
 }
 
+/*
+============
+idRoutingCache::Clear
+============
+*/
+void idRoutingCache::Clear( void ) {
+	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
+	memset( travelTimes, 0, size * sizeof( travelTimes[0] ) );
+}
+
 /*
 ============
 idAASLocal::AreaTravelTime
@@ -211,22 +233,35 @@ void idAASLocal::SetupRoutingCache( void ) {
 
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
+
+	precomputedCache.Clear();
+	precomputedCacheMemory = 0;
+
+	memset( goalRouteTables, 0, sizeof( goalRouteTables ) );
+	goalRouteUseCount = 0;
+	numGoalRouteHits = 0;
+	numGoalRouteMisses = 0;
 }
 
 /*
 ============
 idAASLocal::DeleteClusterCache
+
+  the precomputed cache is kept and updated before it is used again
 ============
 */
 void idAASLocal::DeleteClusterCache( int clusterNum ) {
 	int i;
-	idRoutingCache *cache;
+	idRoutingCache *cache, *next;
 
 	for ( i = 0; i < file->GetCluster( clusterNum ).numReachableAreas; i++ ) {
-		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = areaCacheIndex[clusterNum][i] ) {
-			areaCacheIndex[clusterNum][i] = cache->next;
-			UnlinkCache( cache );
-			delete cache;
+		for ( cache = areaCacheIndex[clusterNum][i]; cache; cache = next ) {
+			next = cache->next;
+			if ( cache->precomputed ) {
+				cache->dirty = true;
+				continue;
+			}
+			DeleteCache( cache );
 		}
 	}
 }
@@ -234,19 +269,27 @@ void idAASLocal::DeleteClusterCache( int clusterNum ) {
 /*
 ============
 idAASLocal::DeletePortalCache
+
+  the precomputed cache is kept and updated before it is used again
 ============
 */
 void idAASLocal::DeletePortalCache( void ) {
 	int i;
-	idRoutingCache *cache;
+	idRoutingCache *cache, *next;
 
 	for ( i = 0; i < file->GetNumAreas(); i++ ) {
-		for ( cache = portalCacheIndex[i]; cache; cache = portalCacheIndex[i] ) {
-			portalCacheIndex[i] = cache->next;
-			UnlinkCache( cache );
-			delete cache;
+		for ( cache = portalCacheIndex[i]; cache; cache = next ) {
+			next = cache->next;
+			if ( cache->precomputed ) {
+				cache->dirty = true;
+				continue;
+			}
+			DeleteCache( cache );
 		}
 	}
+
+	// the routes are calculated from the cache
+	ClearGoalRoutes();
 }
 
 /*
@@ -257,6 +300,12 @@ idAASLocal::ShutdownRoutingCache
 void idAASLocal::ShutdownRoutingCache( void ) {
 	int i;
 
+	for ( i = 0; i < precomputedCache.Num(); i++ ) {
+		precomputedCache[i]->precomputed = false;
+	}
+	precomputedCache.Clear();
+	precomputedCacheMemory = 0;
+
 	for ( i = 0; i < file->GetNumClusters(); i++ ) {
 		DeleteClusterCache( i );
 	}
@@ -276,6 +325,11 @@ void idAASLocal::ShutdownRoutingCache( void ) {
 	Mem_Free( goalAreaTravelTimes );
 	goalAreaTravelTimes = NULL;
 
+	for ( i = 0; i < MAX_GOAL_ROUTE_TABLES; i++ ) {
+		Mem_Free( goalRouteTables[i].routes );
+		goalRouteTables[i].routes = NULL;
+	}
+
 	cacheListStart = cacheListEnd = NULL;
 	totalCacheMemory = 0;
 }
@@ -288,6 +342,7 @@ idAASLocal::SetupRouting
 bool idAASLocal::SetupRouting( void ) {
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	PrecomputeRoutingCache();
 	return true;
 }
 
@@ -308,7 +363,7 @@ idAASLocal::RoutingStats
 */
 void idAASLocal::RoutingStats( void ) const {
 	idRoutingCache *cache;
-	int numAreaCache, numPortalCache;
+	int i, numAreaCache, numPortalCache, numGoalRouteTables;
 	int totalAreaCacheMemory, totalPortalCacheMemory;
 
 	numAreaCache = numPortalCache = 0;
@@ -326,6 +381,16 @@ void idAASLocal::RoutingStats( void ) const {
 	gameLocal.Printf( "%6d area cache (%d KB)\n", numAreaCache, totalAreaCacheMemory >> 10 );
 	gameLocal.Printf( "%6d portal cache (%d KB)\n", numPortalCache, totalPortalCacheMemory >> 10 );
 	gameLocal.Printf( "%6d total cache (%d KB)\n", numAreaCache + numPortalCache, totalCacheMemory >> 10 );
+	gameLocal.Printf( "%6d precomputed cache (%d KB)\n", precomputedCache.Num(), precomputedCacheMemory >> 10 );
+
+	numGoalRouteTables = 0;
+	for ( i = 0; i < MAX_GOAL_ROUTE_TABLES; i++ ) {
+		if ( goalRouteTables[i].routes ) {
+			numGoalRouteTables++;
+		}
+	}
+	gameLocal.Printf( "%6d goal route tables (%zd KB), %d routes reused, %d calculated\n", numGoalRouteTables,
+						( numGoalRouteTables * file->GetNumAreas() * sizeof( idGoalRoute ) ) >> 10, numGoalRouteHits, numGoalRouteMisses );
 	gameLocal.Printf( "%6d area travel times (%zd KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%zd KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%zd KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
@@ -442,7 +507,11 @@ bool idAASLocal::SetAreaState( const idBounds &bounds, const int areaContents, b
 	expBounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
 
 	// find all areas within or touching the bounds with the given contents and disable/enable them for routing
-	return SetAreaState_r( 1, expBounds, areaContents, disabled );
+	if ( !SetAreaState_r( 1, expBounds, areaContents, disabled ) ) {
+		return false;
+	}
+	RepairRoutingCache();
+	return true;
 }
 
 /*
@@ -545,6 +614,7 @@ aasHandle_t idAASLocal::AddObstacle( const idBounds &bounds ) {
 	obstacle->bounds[1] = bounds[1] - file->GetSettings().boundingBoxes[0][0];
 	GetBoundsAreas_r( 1, obstacle->bounds, obstacle->areas );
 	SetObstacleState( obstacle, true );
+	RepairRoutingCache();
 
 	obstacleList.Append( obstacle );
 	return obstacleList.Num() - 1;
@@ -561,6 +631,7 @@ void idAASLocal::RemoveObstacle( const aasHandle_t handle ) {
 	}
 	if ( ( handle >= 0 ) && ( handle < obstacleList.Num() ) ) {
 		SetObstacleState( obstacleList[handle], false );
+		RepairRoutingCache();
 
 		delete obstacleList[handle];
 		obstacleList.RemoveIndex( handle );
@@ -583,6 +654,9 @@ void idAASLocal::RemoveAllObstacles( void ) {
 		SetObstacleState( obstacleList[i], false );
 		delete obstacleList[i];
 	}
+	if ( obstacleList.Num() ) {
+		RepairRoutingCache();
+	}
 	obstacleList.Clear();
 }
 
@@ -639,19 +713,17 @@ void idAASLocal::UnlinkCache( idRoutingCache *cache ) const {
 
 /*
 ============
-idAASLocal::DeleteOldestCache
+idAASLocal::DeleteCache
 ============
 */
-void idAASLocal::DeleteOldestCache( void ) const {
-	idRoutingCache *cache;
+void idAASLocal::DeleteCache( idRoutingCache *cache ) const {
 
-	assert( cacheListStart );
-
-	// unlink the oldest cache
-	cache = cacheListStart;
-	UnlinkCache( cache );
+	// the precomputed cache is never linked in the time based list
+	if ( cache->time_next || cache->time_prev || cacheListStart == cache ) {
+		UnlinkCache( cache );
+	}
 
-	// unlink the oldest cache from the area or portal cache index
+	// unlink the cache from the area or portal cache index
 	if ( cache->next ) {
 		cache->next->prev = cache->prev;
 	}
@@ -668,6 +740,17 @@ void idAASLocal::DeleteOldestCache( void ) const {
 	delete cache;
 }
 
+/*
+============
+idAASLocal::DeleteOldestCache
+============
+*/
+void idAASLocal::DeleteOldestCache( void ) const {
+	assert( cacheListStart );
+
+	DeleteCache( cacheListStart );
+}
+
 /*
 ============
 idAASLocal::GetAreaReachability
@@ -707,7 +790,7 @@ ID_INLINE int idAASLocal::ClusterAreaNum( int clusterNum, int areaNum ) const {
 idAASLocal::UpdateAreaRoutingCache
 ============
 */
-void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
+void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache, idRoutingUpdate *update ) const {
 	int i, nextAreaNum, cluster, badTravelFlags, clusterAreaNum, numReachableAreas;
 	unsigned short t, startAreaTravelTimes[MAX_REACH_PER_AREA];
 	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
@@ -728,7 +811,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 	memset( startAreaTravelTimes, 0, sizeof( startAreaTravelTimes ) );
 
 	// initialize first update
-	curUpdate = &areaUpdate[clusterAreaNum];
+	curUpdate = &update[clusterAreaNum];
 	curUpdate->areaNum = areaCache->areaNum;
 	curUpdate->areaTravelTimes = startAreaTravelTimes;
 	curUpdate->tmpTravelTime = areaCache->startTravelTime;
@@ -790,7 +873,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 
 				areaCache->travelTimes[clusterAreaNum] = t;
 				areaCache->reachabilities[clusterAreaNum] = reach->number; // reversed reachability used to get into this area
-				nextUpdate = &areaUpdate[clusterAreaNum];
+				nextUpdate = &update[clusterAreaNum];
 				nextUpdate->areaNum = nextAreaNum;
 				nextUpdate->tmpTravelTime = t;
 				nextUpdate->areaTravelTimes = reach->areaTravelTimes;
@@ -820,6 +903,37 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache *areaCache ) const {
 	}
 }
 
+/*
+============
+idAASLocal::AllocRoutingCache
+
+  allocates a new cache and links it in the area or portal cache index
+============
+*/
+idRoutingCache *idAASLocal::AllocRoutingCache( int type, int clusterNum, int areaNum, int travelFlags ) const {
+	idRoutingCache *cache, **first;
+
+	if ( type == CACHETYPE_AREA ) {
+		cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
+		first = &areaCacheIndex[clusterNum][ClusterAreaNum( clusterNum, areaNum )];
+	} else {
+		cache = new idRoutingCache( file->GetNumPortals() );
+		first = &portalCacheIndex[areaNum];
+	}
+	cache->type = type;
+	cache->cluster = clusterNum;
+	cache->areaNum = areaNum;
+	cache->startTravelTime = 1;
+	cache->travelFlags = travelFlags;
+	cache->prev = NULL;
+	cache->next = *first;
+	if ( *first ) {
+		(*first)->prev = cache;
+	}
+	*first = cache;
+	return cache;
+}
+
 /*
 ============
 idAASLocal::GetAreaRoutingCache
@@ -827,35 +941,31 @@ idAASLocal::GetAreaRoutingCache
 */
 idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, int travelFlags ) const {
 	int clusterAreaNum;
-	idRoutingCache *cache, *clusterCache;
+	idRoutingCache *cache;
 
 	// number of the area in the cluster
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
-	// pointer to the cache for the area in the cluster
-	clusterCache = areaCacheIndex[clusterNum][clusterAreaNum];
 	// check if cache without undesired travel flags already exists
-	for ( cache = clusterCache; cache; cache = cache->next ) {
+	for ( cache = areaCacheIndex[clusterNum][clusterAreaNum]; cache; cache = cache->next ) {
 		if ( cache->travelFlags == travelFlags ) {
 			break;
 		}
 	}
 	// if no cache found
 	if ( !cache ) {
-		cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
-		cache->type = CACHETYPE_AREA;
-		cache->cluster = clusterNum;
-		cache->areaNum = areaNum;
-		cache->startTravelTime = 1;
-		cache->travelFlags = travelFlags;
-		cache->prev = NULL;
-		cache->next = clusterCache;
-		if ( clusterCache ) {
-			clusterCache->prev = cache;
-		}
-		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
-		UpdateAreaRoutingCache( cache );
+		cache = AllocRoutingCache( CACHETYPE_AREA, clusterNum, areaNum, travelFlags );
+		UpdateAreaRoutingCache( cache, areaUpdate );
+	}
+	// if areas in the cluster were enabled or disabled since the cache was precomputed
+	else if ( cache->dirty ) {
+		cache->Clear();
+		UpdateAreaRoutingCache( cache, areaUpdate );
+		cache->dirty = false;
+	}
+	// the precomputed cache is never deleted to save memory
+	if ( !cache->precomputed ) {
+		LinkCache( cache );
 	}
-	LinkCache( cache );
 	return cache;
 }
 
@@ -864,7 +974,7 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 idAASLocal::UpdatePortalRoutingCache
 ============
 */
-void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
+void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache, idRoutingUpdate *update ) const {
 	int i, portalNum, clusterAreaNum;
 	unsigned short t;
 	const aasPortal_t *portal;
@@ -872,7 +982,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 	idRoutingCache *cache;
 	idRoutingUpdate *updateListStart, *updateListEnd, *curUpdate, *nextUpdate;
 
-	curUpdate = &portalUpdate[ file->GetNumPortals() ];
+	curUpdate = &update[ file->GetNumPortals() ];
 	curUpdate->cluster = portalCache->cluster;
 	curUpdate->areaNum = portalCache->areaNum;
 	curUpdate->tmpTravelTime = portalCache->startTravelTime;
@@ -922,7 +1032,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache *portalCache ) const {
 
 				portalCache->travelTimes[portalNum] = t;
 				portalCache->reachabilities[portalNum] = cache->reachabilities[clusterAreaNum];
-				nextUpdate = &portalUpdate[portalNum];
+				nextUpdate = &update[portalNum];
 				if ( portal->clusters[0] == curUpdate->cluster ) {
 					nextUpdate->cluster = portal->clusters[1];
 				}
@@ -967,81 +1077,421 @@ idRoutingCache *idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 	}
 	// if no cache found
 	if ( !cache ) {
-		cache = new idRoutingCache( file->GetNumPortals() );
-		cache->type = CACHETYPE_PORTAL;
-		cache->cluster = clusterNum;
-		cache->areaNum = areaNum;
-		cache->startTravelTime = 1;
-		cache->travelFlags = travelFlags;
-		cache->prev = NULL;
-		cache->next = portalCacheIndex[areaNum];
-		if ( portalCacheIndex[areaNum] ) {
-			portalCacheIndex[areaNum]->prev = cache;
-		}
-		portalCacheIndex[areaNum] = cache;
-		UpdatePortalRoutingCache( cache );
+		cache = AllocRoutingCache( CACHETYPE_PORTAL, clusterNum, areaNum, travelFlags );
+		UpdatePortalRoutingCache( cache, portalUpdate );
+	}
+	// if areas were enabled or disabled since the cache was precomputed
+	else if ( cache->dirty ) {
+		cache->Clear();
+		UpdatePortalRoutingCache( cache, portalUpdate );
+		cache->dirty = false;
+	}
+	// the precomputed cache is never deleted to save memory
+	if ( !cache->precomputed ) {
+		LinkCache( cache );
 	}
-	LinkCache( cache );
 	return cache;
 }
 
 /*
 ============
-idAASLocal::RouteToGoalArea
+idAASLocal::UpdateRoutingCacheJob
 ============
 */
-bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const {
-	int clusterNum, goalClusterNum, portalNum, i, clusterAreaNum;
-	unsigned short int t, bestTime;
+typedef struct routingCacheJob_s {
+	const idAASLocal *		aas;
+	idRoutingCache **		caches;
+	int						numCaches;
+	int						numJobs;
+	idRoutingUpdate *		updates;			// memory used to update the cache of each job
+	int						numUpdates;			// number of updates for each job
+} routingCacheJob_t;
+
+void idAASLocal::UpdateRoutingCacheJob( void *data, int jobNum ) {
+	routingCacheJob_t *job = (routingCacheJob_t *) data;
+	idRoutingUpdate *update = job->updates + jobNum * job->numUpdates;
+	idRoutingCache *cache;
+	int i;
+
+	for ( i = jobNum * job->numCaches / job->numJobs; i < ( jobNum + 1 ) * job->numCaches / job->numJobs; i++ ) {
+		cache = job->caches[i];
+		cache->Clear();
+		if ( cache->type == CACHETYPE_AREA ) {
+			job->aas->UpdateAreaRoutingCache( cache, update );
+		} else {
+			job->aas->UpdatePortalRoutingCache( cache, update );
+		}
+		cache->dirty = false;
+	}
+}
+
+/*
+============
+idAASLocal::UpdateRoutingCaches
+
+  updates the travel times of the given precomputed caches on the job threads,
+  the caches must all be of the same type and the portal caches may only use
+  precomputed area caches that are up to date
+============
+*/
+void idAASLocal::UpdateRoutingCaches( idRoutingCache **caches, int numCaches ) const {
+	int i;
+	routingCacheJob_t job;
+
+	if ( numCaches <= 0 ) {
+		return;
+	}
+
+	job.aas = this;
+	job.caches = caches;
+	job.numCaches = numCaches;
+	job.numJobs = ( sys->GetNumJobThreads() > 0 ) ? Min( numCaches, MAX_ROUTING_CACHE_JOBS ) : 1;
+	if ( caches[0]->type == CACHETYPE_AREA ) {
+		job.numUpdates = 0;
+		for ( i = 0; i < file->GetNumClusters(); i++ ) {
+			job.numUpdates = Max( job.numUpdates, file->GetCluster( i ).numReachableAreas );
+		}
+	} else {
+		job.numUpdates = file->GetNumPortals() + 1;
+	}
+	job.updates = (idRoutingUpdate *) Mem_ClearedAlloc( job.numJobs * job.numUpdates * sizeof( idRoutingUpdate ) );
+
+	if ( job.numJobs > 1 ) {
+		sys->RunJobs( UpdateRoutingCacheJob, &job, job.numJobs );
+	} else {
+		UpdateRoutingCacheJob( &job, 0 );
+	}
+
+	Mem_Free( job.updates );
+}
+
+/*
+============
+idAASLocal::PrecomputeRoutingCache
+
+  Precomputes the travel times between all areas of each cluster and from all portals
+  towards every area for the travel flags of walking and flying monsters. The cache is
+  read from the routing file next to the AAS file, or calculated on the job threads and
+  written to it. The precomputed cache is never deleted to save memory. When areas are
+  enabled or disabled it is updated instead of being calculated again when first used.
+============
+*/
+void idAASLocal::PrecomputeRoutingCache( void ) {
+	int i, j, side, clusterNum, areaNum, numAreaCaches, numPortalCaches, areaMemory, portalMemory;
+	const aasArea_t *area;
 	const aasPortal_t *portal;
-	const aasCluster_t *cluster;
-	idRoutingCache *areaCache, *portalCache, *clusterCache;
-	idReachability *bestReach, *r, *nextr;
+	idList<int> travelFlags;
+	idList<idRoutingCache *> areaCaches, portalCaches;
+	idTimer timer;
 
-	travelTime = 0;
-	*reach = NULL;
+	if ( aas_precomputeRouting.GetInteger() <= 0 ) {
+		return;
+	}
 
-	if ( !file ) {
+	timer.Start();
+
+	travelFlags.Append( TFL_WALK|TFL_AIR );
+	if ( file->GetSettings().allowFlyReachabilities ) {
+		travelFlags.Append( TFL_WALK|TFL_AIR|TFL_FLY );
+	}
+
+	// memory for the travel times between all areas in each cluster
+	areaMemory = 0;
+	for ( i = 1; i < file->GetNumClusters(); i++ ) {
+		areaMemory += file->GetCluster( i ).numReachableAreas * ( sizeof( idRoutingCache ) + file->GetCluster( i ).numReachableAreas * ( sizeof( byte ) + sizeof( unsigned short ) ) );
+	}
+	areaMemory *= travelFlags.Num();
+
+	// memory for the travel times from all portals towards every area
+	numPortalCaches = 0;
+	for ( areaNum = 1; areaNum < file->GetNumAreas(); areaNum++ ) {
+		if ( file->GetArea( areaNum ).flags & ( AREA_REACHABLE_WALK|AREA_REACHABLE_FLY ) ) {
+			numPortalCaches++;
+		}
+	}
+	portalMemory = numPortalCaches * ( sizeof( idRoutingCache ) + file->GetNumPortals() * ( sizeof( byte ) + sizeof( unsigned short ) ) ) * travelFlags.Num();
+
+	if ( areaMemory > ( aas_precomputeRouting.GetInteger() << 20 ) ) {
+		gameLocal.Printf( "%s: not precomputing %d KB routing cache\n", file->GetName(), areaMemory >> 10 );
+		return;
+	}
+	if ( areaMemory + portalMemory > ( aas_precomputeRouting.GetInteger() << 20 ) ) {
+		gameLocal.Printf( "%s: not precomputing %d KB portal routing cache\n", file->GetName(), portalMemory >> 10 );
+		portalMemory = 0;
+	}
+
+	for ( i = 0; i < travelFlags.Num(); i++ ) {
+		for ( areaNum = 1; areaNum < file->GetNumAreas(); areaNum++ ) {
+			area = &file->GetArea( areaNum );
+			if ( area->cluster > 0 ) {
+				if ( area->clusterAreaNum < file->GetCluster( area->cluster ).numReachableAreas ) {
+					areaCaches.Append( AllocRoutingCache( CACHETYPE_AREA, area->cluster, areaNum, travelFlags[i] ) );
+				}
+			} else if ( area->cluster < 0 ) {
+				// a cluster portal is part of both the front and back cluster
+				portal = &file->GetPortal( -area->cluster );
+				for ( side = 0; side < 2; side++ ) {
+					if ( portal->clusterAreaNum[side] < file->GetCluster( portal->clusters[side] ).numReachableAreas ) {
+						areaCaches.Append( AllocRoutingCache( CACHETYPE_AREA, portal->clusters[side], areaNum, travelFlags[i] ) );
+					}
+				}
+			}
+		}
+		if ( !portalMemory ) {
+			continue;
+		}
+		for ( areaNum = 1; areaNum < file->GetNumAreas(); areaNum++ ) {
+			area = &file->GetArea( areaNum );
+			if ( !( area->flags & ( AREA_REACHABLE_WALK|AREA_REACHABLE_FLY ) ) || area->cluster == 0 ) {
+				continue;
+			}
+			// just like RouteToGoalArea assume a portal is part of the front cluster
+			clusterNum = ( area->cluster > 0 ) ? area->cluster : file->GetPortal( -area->cluster ).clusters[0];
+			// the portal cache is updated with the area cache of the goal area
+			if ( ClusterAreaNum( clusterNum, areaNum ) >= file->GetCluster( clusterNum ).numReachableAreas ) {
+				continue;
+			}
+			portalCaches.Append( AllocRoutingCache( CACHETYPE_PORTAL, clusterNum, areaNum, travelFlags[i] ) );
+		}
+	}
+
+	numAreaCaches = areaCaches.Num();
+	numPortalCaches = portalCaches.Num();
+	precomputedCache = areaCaches;
+	precomputedCache.Append( portalCaches );
+	precomputedCacheMemory = 0;
+	for ( j = 0; j < precomputedCache.Num(); j++ ) {
+		precomputedCache[j]->precomputed = true;
+		precomputedCacheMemory += precomputedCache[j]->Size();
+	}
+
+	if ( !ReadRoutingCache( travelFlags ) ) {
+		// the portal cache uses the area cache so it is updated afterwards
+		UpdateRoutingCaches( areaCaches.Ptr(), areaCaches.Num() );
+		UpdateRoutingCaches( portalCaches.Ptr(), portalCaches.Num() );
+		WriteRoutingCache( travelFlags );
+	}
+
+	timer.Stop();
+
+	gameLocal.Printf( "%s: %d area and %d portal routing cache (%d KB) in %d msec\n", file->GetName(),
+						numAreaCaches, numPortalCaches, precomputedCacheMemory >> 10, (int)timer.Milliseconds() );
+}
+
+/*
+============
+idAASLocal::RoutingChecksum
+
+  checksum of everything the precomputed routing cache depends on
+============
+*/
+unsigned int idAASLocal::RoutingChecksum( void ) const {
+	int i;
+	unsigned int crc;
+	const aasArea_t *area;
+	const idReachability *reach;
+
+	CRC32_InitChecksum( crc );
+	CRC32_UpdateChecksum( crc, areaTravelTimes, numAreaTravelTimes * sizeof( areaTravelTimes[0] ) );
+	for ( i = 0; i < file->GetNumAreas(); i++ ) {
+		area = &file->GetArea( i );
+		CRC32_UpdateChecksum( crc, &area->flags, sizeof( area->flags ) );
+		CRC32_UpdateChecksum( crc, &area->cluster, sizeof( area->cluster ) );
+		CRC32_UpdateChecksum( crc, &area->clusterAreaNum, sizeof( area->clusterAreaNum ) );
+		CRC32_UpdateChecksum( crc, &area->travelFlags, sizeof( area->travelFlags ) );
+		for ( reach = area->reach; reach; reach = reach->next ) {
+			CRC32_UpdateChecksum( crc, &reach->travelType, sizeof( reach->travelType ) );
+			CRC32_UpdateChecksum( crc, &reach->toAreaNum, sizeof( reach->toAreaNum ) );
+			CRC32_UpdateChecksum( crc, &reach->travelTime, sizeof( reach->travelTime ) );
+		}
+	}
+	CRC32_FinishChecksum( crc );
+	return crc;
+}
+
+/*
+============
+idAASLocal::ReadRoutingCache
+============
+*/
+bool idAASLocal::ReadRoutingCache( const idList<int> &travelFlags ) {
+	int i, j, fileId, version, length, num, value;
+	unsigned int checksum;
+	idStr fileName;
+	idRoutingCache *cache;
+	void *buffer;
+
+	if ( !aas_routingFile.GetBool() ) {
 		return false;
 	}
 
-	if ( areaNum == goalAreaNum ) {
-		return true;
+	fileName = va( "%s.%s", file->GetName(), ROUTING_FILE_EXT );
+	length = fileSystem->ReadFile( fileName, &buffer );
+	if ( length <= 0 ) {
+		return false;
 	}
 
-	if ( areaNum <= 0 || areaNum >= file->GetNumAreas() ) {
-		gameLocal.Printf( "RouteToGoalArea: areaNum %d out of range\n", areaNum );
+	idFile_Memory fp( fileName, (const char *)buffer, length );
+
+	fileId = version = 0;
+	fp.ReadInt( fileId );
+	fp.ReadInt( version );
+	if ( fileId != ROUTING_FILEID || version != ROUTING_FILEVERSION ) {
+		gameLocal.Printf( "%s has a different version\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
-	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
-		gameLocal.Printf( "RouteToGoalArea: goalAreaNum %d out of range\n", goalAreaNum );
+
+	checksum = 0;
+	num = -1;
+	fp.ReadUnsignedInt( checksum );
+	fp.ReadInt( num );
+	if ( checksum != RoutingChecksum() || num != travelFlags.Num() ) {
+		gameLocal.Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
 		return false;
 	}
+	for ( i = 0; i < travelFlags.Num(); i++ ) {
+		value = 0;
+		fp.ReadInt( value );
+		if ( value != travelFlags[i] ) {
+			gameLocal.Printf( "%s is out of date\n", fileName.c_str() );
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+	}
 
-	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
-		DeleteOldestCache();
+	num = -1;
+	fp.ReadInt( num );
+	if ( num != precomputedCache.Num() ) {
+		gameLocal.Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
 	}
 
-	clusterNum = file->GetArea( areaNum ).cluster;
-	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
+	for ( i = 0; i < precomputedCache.Num(); i++ ) {
+		cache = precomputedCache[i];
+		value = -1;
+		fp.ReadInt( value );
+		if ( value != cache->areaNum || fp.Length() - fp.Tell() < cache->size * (int)( sizeof( byte ) + sizeof( unsigned short ) ) ) {
+			break;
+		}
+		fp.Read( cache->reachabilities, cache->size * sizeof( cache->reachabilities[0] ) );
+		for ( j = 0; j < cache->size; j++ ) {
+			fp.ReadUnsignedShort( cache->travelTimes[j] );
+		}
+	}
 
-	// if the source area is a cluster portal, read directly from the portal cache
-	if ( clusterNum < 0 ) {
-		// if the goal area is a portal
-		if ( goalClusterNum < 0 ) {
-			// just assume the goal area is part of the front cluster
-			portal = &file->GetPortal( -goalClusterNum );
-			goalClusterNum = portal->clusters[0];
+	fileSystem->FreeFile( buffer );
+
+	if ( i < precomputedCache.Num() ) {
+		gameLocal.Warning( "%s is corrupt", fileName.c_str() );
+		for ( i = 0; i < precomputedCache.Num(); i++ ) {
+			precomputedCache[i]->Clear();
 		}
-		// get the portal routing cache
-		portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
-		*reach = GetAreaReachability( areaNum, portalCache->reachabilities[-clusterNum] );
-		travelTime = portalCache->travelTimes[-clusterNum] + AreaTravelTime( areaNum, origin, (*reach)->start );
-		return true;
+		return false;
 	}
+	return true;
+}
 
-	bestTime = 0;
-	bestReach = NULL;
+/*
+============
+idAASLocal::WriteRoutingCache
+============
+*/
+void idAASLocal::WriteRoutingCache( const idList<int> &travelFlags ) const {
+	int i, j;
+	idStr fileName;
+	idRoutingCache *cache;
+	idFile *fp;
+
+	if ( !aas_routingFile.GetBool() ) {
+		return;
+	}
+
+	fileName = va( "%s.%s", file->GetName(), ROUTING_FILE_EXT );
+	fp = fileSystem->OpenFileWrite( fileName, "fs_devpath" );
+	if ( !fp ) {
+		gameLocal.Warning( "idAASLocal::WriteRoutingCache: Error opening file %s", fileName.c_str() );
+		return;
+	}
+
+	fp->WriteInt( ROUTING_FILEID );
+	fp->WriteInt( ROUTING_FILEVERSION );
+	fp->WriteUnsignedInt( RoutingChecksum() );
+	fp->WriteInt( travelFlags.Num() );
+	for ( i = 0; i < travelFlags.Num(); i++ ) {
+		fp->WriteInt( travelFlags[i] );
+	}
+	fp->WriteInt( precomputedCache.Num() );
+	for ( i = 0; i < precomputedCache.Num(); i++ ) {
+		cache = precomputedCache[i];
+		fp->WriteInt( cache->areaNum );
+		fp->Write( cache->reachabilities, cache->size * sizeof( cache->reachabilities[0] ) );
+		for ( j = 0; j < cache->size; j++ ) {
+			fp->WriteUnsignedShort( cache->travelTimes[j] );
+		}
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+============
+idAASLocal::RepairRoutingCache
+
+  Updates the precomputed area cache of the clusters with areas that were enabled or
+  disabled on the job threads. The precomputed portal cache depends on all clusters
+  and is updated when it is used again.
+============
+*/
+void idAASLocal::RepairRoutingCache( void ) {
+	int i;
+	idList<idRoutingCache *> caches;
+
+	for ( i = 0; i < precomputedCache.Num(); i++ ) {
+		if ( precomputedCache[i]->dirty && precomputedCache[i]->type == CACHETYPE_AREA ) {
+			caches.Append( precomputedCache[i] );
+		}
+	}
+	UpdateRoutingCaches( caches.Ptr(), caches.Num() );
+}
+
+/*
+============
+idAASLocal::ClearGoalRoutes
+============
+*/
+void idAASLocal::ClearGoalRoutes( void ) const {
+	int i;
+
+	for ( i = 0; i < MAX_GOAL_ROUTE_TABLES; i++ ) {
+		goalRouteTables[i].goalAreaNum = 0;
+		goalRouteTables[i].lastUsed = 0;
+	}
+}
+
+/*
+============
+idAASLocal::CalculateGoalRoute
+
+  Calculates the route from an area in a cluster towards the goal area.
+  The travel time from the origin in the area is not included because it is
+  different for every query, it's added when the route is used.
+============
+*/
+void idAASLocal::CalculateGoalRoute( idGoalRoute &route, int areaNum, int goalAreaNum, int travelFlags ) const {
+	int clusterNum, goalClusterNum, portalNum, i, clusterAreaNum;
+	unsigned short t;
+	const aasPortal_t *portal;
+	const aasCluster_t *cluster;
+	idRoutingCache *areaCache, *portalCache, *clusterCache;
+	idReachability *nextr;
+
+	route.flags = GOALROUTE_CALCULATED;
+
+	clusterNum = file->GetArea( areaNum ).cluster;
+	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
 
 	// check if the goal area is a portal of the source area cluster
 	if ( goalClusterNum < 0 ) {
@@ -1056,8 +1506,9 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		clusterCache = GetAreaRoutingCache( clusterNum, goalAreaNum, travelFlags );
 		clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
 		if ( clusterCache->travelTimes[clusterAreaNum] ) {
-			bestReach = GetAreaReachability( areaNum, clusterCache->reachabilities[clusterAreaNum] );
-			bestTime = clusterCache->travelTimes[clusterAreaNum] + AreaTravelTime( areaNum, origin, bestReach->start );
+			route.clusterReachability = clusterCache->reachabilities[clusterAreaNum];
+			route.clusterTravelTime = clusterCache->travelTimes[clusterAreaNum];
+			route.flags |= GOALROUTE_CLUSTER;
 		}
 		else {
 			clusterCache = NULL;
@@ -1085,7 +1536,8 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
 	// if the area is not a reachable area
 	if ( clusterAreaNum >= cluster->numReachableAreas) {
-		return false;
+		route.flags = GOALROUTE_CALCULATED | GOALROUTE_UNREACHABLE;
+		return;
 	}
 
 	// find the portal of the source area cluster leading towards the goal area
@@ -1105,8 +1557,6 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 			continue;
 		}
 
-		r = GetAreaReachability( areaNum, areaCache->reachabilities[clusterAreaNum] );
-
 		if ( clusterCache ) {
 			// if the next reachability from the portal leads back into the cluster
 			nextr = GetAreaReachability( portal->areaNum, portalCache->reachabilities[portalNum] );
@@ -1125,10 +1575,133 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		t += portal->maxAreaTravelTime;
 
 		// if the time is better than the one already found
-		if ( !bestTime || t < bestTime ) {
-			bestReach = r;
-			bestTime = t;
+		if ( !( route.flags & GOALROUTE_PORTAL ) || t < route.portalTravelTime ) {
+			route.portalReachability = areaCache->reachabilities[clusterAreaNum];
+			route.portalTravelTime = t;
+			route.flags |= GOALROUTE_PORTAL;
+		}
+	}
+}
+
+/*
+============
+idAASLocal::GetGoalRoute
+
+  The routes towards a goal area are kept until the routing cache changes,
+  so all AI chasing the same goal share the work to find the best portals.
+============
+*/
+const idGoalRoute *idAASLocal::GetGoalRoute( int areaNum, int goalAreaNum, int travelFlags ) const {
+	int i;
+	idGoalRouteTable *table, *oldest;
+	idGoalRoute *route;
+
+	table = NULL;
+	oldest = &goalRouteTables[0];
+	for ( i = 0; i < MAX_GOAL_ROUTE_TABLES; i++ ) {
+		if ( goalRouteTables[i].goalAreaNum == goalAreaNum && goalRouteTables[i].travelFlags == travelFlags ) {
+			table = &goalRouteTables[i];
+			break;
 		}
+		if ( goalRouteTables[i].lastUsed < oldest->lastUsed ) {
+			oldest = &goalRouteTables[i];
+		}
+	}
+
+	// reuse the least recently used table for a new goal
+	if ( !table ) {
+		table = oldest;
+		if ( !table->routes ) {
+			table->routes = (idGoalRoute *) Mem_Alloc( file->GetNumAreas() * sizeof( idGoalRoute ) );
+		}
+		memset( table->routes, 0, file->GetNumAreas() * sizeof( idGoalRoute ) );
+		table->goalAreaNum = goalAreaNum;
+		table->travelFlags = travelFlags;
+	}
+	table->lastUsed = ++goalRouteUseCount;
+
+	route = &table->routes[areaNum];
+	if ( route->flags & GOALROUTE_CALCULATED ) {
+		numGoalRouteHits++;
+	} else {
+		CalculateGoalRoute( *route, areaNum, goalAreaNum, travelFlags );
+		numGoalRouteMisses++;
+	}
+	return route;
+}
+
+/*
+============
+idAASLocal::RouteToGoalArea
+============
+*/
+bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalAreaNum, int travelFlags, int &travelTime, idReachability **reach ) const {
+	int clusterNum, goalClusterNum;
+	unsigned short int bestTime;
+	const aasPortal_t *portal;
+	const idGoalRoute *route;
+	idRoutingCache *portalCache;
+	idReachability *bestReach;
+
+	travelTime = 0;
+	*reach = NULL;
+
+	if ( !file ) {
+		return false;
+	}
+
+	if ( areaNum == goalAreaNum ) {
+		return true;
+	}
+
+	if ( areaNum <= 0 || areaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RouteToGoalArea: areaNum %d out of range\n", areaNum );
+		return false;
+	}
+	if ( goalAreaNum <= 0 || goalAreaNum >= file->GetNumAreas() ) {
+		gameLocal.Printf( "RouteToGoalArea: goalAreaNum %d out of range\n", goalAreaNum );
+		return false;
+	}
+
+	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY ) {
+		DeleteOldestCache();
+	}
+
+	clusterNum = file->GetArea( areaNum ).cluster;
+	goalClusterNum = file->GetArea( goalAreaNum ).cluster;
+
+	// if the source area is a cluster portal, read directly from the portal cache
+	if ( clusterNum < 0 ) {
+		// if the goal area is a portal
+		if ( goalClusterNum < 0 ) {
+			// just assume the goal area is part of the front cluster
+			portal = &file->GetPortal( -goalClusterNum );
+			goalClusterNum = portal->clusters[0];
+		}
+		// get the portal routing cache
+		portalCache = GetPortalRoutingCache( goalClusterNum, goalAreaNum, travelFlags );
+		*reach = GetAreaReachability( areaNum, portalCache->reachabilities[-clusterNum] );
+		travelTime = portalCache->travelTimes[-clusterNum] + AreaTravelTime( areaNum, origin, (*reach)->start );
+		return true;
+	}
+
+	route = GetGoalRoute( areaNum, goalAreaNum, travelFlags );
+	if ( route->flags & GOALROUTE_UNREACHABLE ) {
+		return false;
+	}
+
+	bestTime = 0;
+	bestReach = NULL;
+
+	if ( route->flags & GOALROUTE_CLUSTER ) {
+		bestReach = GetAreaReachability( areaNum, route->clusterReachability );
+		bestTime = route->clusterTravelTime + AreaTravelTime( areaNum, origin, bestReach->start );
+	}
+
+	// the travel time through a portal does not include the travel time from the origin
+	if ( ( route->flags & GOALROUTE_PORTAL ) && ( !bestTime || route->portalTravelTime < bestTime ) ) {
+		bestReach = GetAreaReachability( areaNum, route->portalReachability );
+		bestTime = route->portalTravelTime;
 	}
 
 	if ( !bestReach ) {
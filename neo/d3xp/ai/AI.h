@@ -286,6 +286,12 @@ public:
 	static bool				FindPathAroundObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, const idVec3 &startPos, const idVec3 &seekPos, obstaclePath_t &path );
 							// Frees any nodes used for the dynamic obstacle avoidance.
 	static void				FreeObstacleAvoidanceNodes( void );
+							// Builds the obstacle hash again on the next query, for when actors or moveables spawn or teleport.
+	static void				InvalidateObstacleHash( void );
+							// Finds the clip models of actors and moveables touching the bounds.
+	static int				ObstaclesTouchingBounds( const idBounds &bounds, int contentMask, idClipModel **clipModelList, int maxCount );
+							// Compares finding obstacles with and without the obstacle hash.
+	static void				BenchmarkObstacles( int numPasses );
 							// Predicts movement, returns true if a stop event was triggered.
 	static bool				PredictPath( const idEntity *ent, const idAAS *aas, const idVec3 &start, const idVec3 &velocity, int totalTime, int frameTime, int stopEvent, predictedPath_t &path );
 							// Return true if the trajectory of the clip model is collision free.
@@ -417,6 +423,8 @@ protected:
 	idVec3					lastVisibleEnemyEyeOffset;
 	idVec3					lastVisibleReachableEnemyPos;
 	idVec3					lastReachableEnemyPos;
+	aasPathQuery_t			enemyPathQuery;			// queued path query towards the enemy
+	idVec3					enemyPathQueryPos;		// enemy position of the queued path query
 	bool					wakeOnFlashlight;
 
 #ifdef _D3XP
@@ -455,6 +463,7 @@ protected:
 	virtual	void			DormantBegin( void );	// called when entity becomes dormant
 	virtual	void			DormantEnd( void );		// called when entity wakes from being dormant
 	void					Think( void );
+	virtual bool			RunsPhysicsFirst( void );
 	void					Activate( idEntity *activator );
 	int						ReactionTo( const idEntity *ent );
 	bool					CheckForEnemy( void );
@@ -494,6 +503,8 @@ protected:
 	float					TravelDistance( const idVec3 &start, const idVec3 &end ) const;
 	int						PointReachableAreaNum( const idVec3 &pos, const float boundsScale = 2.0f ) const;
 	bool					PathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const;
+	bool					QueuePathToGoal( aasPathQuery_t &query, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin );
+	void					CancelEnemyPathQuery( void );
 	void					DrawRoute( void ) const;
 	bool					GetMovePos( idVec3 &seekPos );
 	bool					MoveDone( void ) const;
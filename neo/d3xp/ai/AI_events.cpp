@@ -382,14 +382,17 @@ void idAI::Event_FindEnemyAI( int useFOV ) {
 	idActor		*actor;
 	idActor		*bestEnemy;
 	float		bestDist;
-	float		dist;
 	idVec3		delta;
 	pvsHandle_t pvs;
+	idEntity	*candidates[ MAX_GENTITIES ];
+	float		dists[ MAX_GENTITIES ];
+	bool		visible[ MAX_GENTITIES ];
+	int			numCandidates;
+	int			i;
 
 	pvs = gameLocal.pvs.SetupCurrentPVS( GetPVSAreas(), GetNumPVSAreas() );
 
-	bestDist = idMath::INFINITY;
-	bestEnemy = NULL;
+	numCandidates = 0;
 	for ( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
 		if ( ent->fl.hidden || ent->fl.isDormant || !ent->IsType( idActor::Type ) ) {
 			continue;
@@ -405,14 +408,27 @@ void idAI::Event_FindEnemyAI( int useFOV ) {
 		}
 
 		delta = physicsObj.GetOrigin() - actor->GetPhysics()->GetOrigin();
-		dist = delta.LengthSqr();
-		if ( ( dist < bestDist ) && CanSee( actor, useFOV != 0 ) ) {
-			bestDist = dist;
-			bestEnemy = actor;
-		}
+		candidates[ numCandidates ] = actor;
+		dists[ numCandidates ] = delta.LengthSqr();
+		numCandidates++;
 	}
 
 	gameLocal.pvs.FreeCurrentPVS( pvs );
+
+	// trace the lines of sight to all candidates at once
+	CanSeeBatch( candidates, numCandidates, useFOV != 0, visible );
+
+	// pick the closest visible one, going through the candidates in the order of the active entities and
+	// only taking a strictly closer one, so an actor at the same distance doesn't replace an earlier one
+	bestDist = idMath::INFINITY;
+	bestEnemy = NULL;
+	for ( i = 0; i < numCandidates; i++ ) {
+		if ( ( dists[ i ] < bestDist ) && visible[ i ] ) {
+			bestDist = dists[ i ];
+			bestEnemy = static_cast<idActor *>( candidates[ i ] );
+		}
+	}
+
 	idThread::ReturnEntity( bestEnemy );
 }
 
@@ -2709,13 +2725,14 @@ idAI::Event_FindActorsInBounds
 */
 void idAI::Event_FindActorsInBounds( const idVec3 &mins, const idVec3 &maxs ) {
 	idEntity *	ent;
-	idEntity *	entityList[ MAX_GENTITIES ];
-	int			numListedEntities;
+	idClipModel *clipModelList[ MAX_GENTITIES ];
+	int			numListedClipModels;
 	int			i;
 
-	numListedEntities = gameLocal.clip.EntitiesTouchingBounds( idBounds( mins, maxs ), CONTENTS_BODY, entityList, MAX_GENTITIES );
-	for( i = 0; i < numListedEntities; i++ ) {
-		ent = entityList[ i ];
+	// scripts get the first actor found, so keep the order of the clip model query
+	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( idBounds( mins, maxs ), CONTENTS_BODY, clipModelList, MAX_GENTITIES );
+	for( i = 0; i < numListedClipModels; i++ ) {
+		ent = clipModelList[ i ]->GetEntity();
 		if ( ent != this && !ent->IsHidden() && ( ent->health > 0 ) && ent->IsType( idActor::Type ) ) {
 			idThread::ReturnEntity( ent );
 			return;
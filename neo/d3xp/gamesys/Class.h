@@ -250,10 +250,13 @@ public:
 	static int					GetNumTypes( void ) { return types.Num(); }
 	static int					GetTypeNumBits( void ) { return typeNumBits; }
 	static idTypeInfo *			GetType( int num );
+	static void					PrintEventStats( void );
 
 private:
 	classSpawnFunc_t			CallSpawnFunc( idTypeInfo *cls );
 
+	static void					InitEventThunks( void );
+
 	bool						PostEventArgs( const idEventDef *ev, int time, int numargs, ... );
 	bool						ProcessEventArgs( const idEventDef *ev, int numargs, ... );
 
@@ -265,6 +268,9 @@ private:
 	static int					typeNumBits;
 	static int					memused;
 	static int					numobjects;
+
+	idLinkList<idEvent>			eventList;					// events posted to the object, so they can be cancelled without searching the queue
+	friend class				idEvent;
 };
 
 /***********************************************************************
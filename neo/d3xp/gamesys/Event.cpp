@@ -41,7 +41,6 @@ Event are used for scheduling tasks and for linking script commands.
 */
 
 #define MAX_EVENTSPERFRAME			4096
-//#define CREATE_EVENT_CODE
 
 /***********************************************************************
 
@@ -206,15 +205,319 @@ const idEventDef *idEventDef::FindEvent( const char *name ) {
 
 /***********************************************************************
 
-  idEvent
+  idEventWheel
+
+  Hierarchical timer wheel of scheduled events.  The first level has a
+  list for each millisecond of the current 256 msec block, the three levels
+  above it have 64 lists each for the blocks of the level below.  An event
+  is put in the lowest level whose current block contains its time, and
+  moved down a level when the current block of that level reaches it, so
+  scheduling and removing an event takes constant time.  Events are only
+  ever appended to the lists, and all events with the same time end up in
+  the same list, so they are serviced in the order they were scheduled
+  just like with the sorted list used before.
 
 ***********************************************************************/
 
-static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
+#define EVENT_WHEEL_LEVEL0_BITS		8
+#define EVENT_WHEEL_LEVEL_BITS		6
+#define EVENT_WHEEL_LEVELS			4
+#define EVENT_WHEEL_LEVEL0_SIZE		( 1 << EVENT_WHEEL_LEVEL0_BITS )
+#define EVENT_WHEEL_LEVEL_SIZE		( 1 << EVENT_WHEEL_LEVEL_BITS )
+#define EVENT_WHEEL_FAR				( EVENT_WHEEL_LEVEL0_SIZE + ( EVENT_WHEEL_LEVELS - 1 ) * EVENT_WHEEL_LEVEL_SIZE )	// events after the last block of the top level
+#define EVENT_WHEEL_LATE			( EVENT_WHEEL_FAR + 1 )		// events before the current time of the wheel, sorted by time
+#define EVENT_WHEEL_LISTS			( EVENT_WHEEL_LATE + 1 )
+
+class idEventWheel {
+public:
+							idEventWheel( void );
+
+	void					Clear( void );
+	void					Add( idEvent *event, int now );
+	void					Remove( idEvent *event );
+	idEvent *				NextEvent( int now );
+	int						Num( void ) const { return numEvents; }
+	int						NumInLevel( int level ) const { return levelCount[ level ]; }
+	void					GetEvents( idList<idEvent *> &events ) const;
+
+private:
+	idLinkList<idEvent>		lists[ EVENT_WHEEL_LISTS ];
+	int						levelCount[ EVENT_WHEEL_LEVELS + 2 ];	// wheel levels, far and late events
+	int						numEvents;
+	int						wheelTime;		// time of the current list of the first level
+
+	static int				LevelShift( int level ) { return ( level == 0 ) ? 0 : EVENT_WHEEL_LEVEL0_BITS + ( level - 1 ) * EVENT_WHEEL_LEVEL_BITS; }
+	static int				LevelOfList( int list );
+	void					Insert( idEvent *event );
+	void					Requeue( int list );
+	void					Advance( int now );
+};
+
+static idEventWheel EventQueue;
 #ifdef _D3XP
-static idLinkList<idEvent> FastEventQueue;
+static idEventWheel FastEventQueue;
 #endif
+
+/*
+================
+idEventWheel::idEventWheel
+================
+*/
+idEventWheel::idEventWheel( void ) {
+	memset( levelCount, 0, sizeof( levelCount ) );
+	numEvents = 0;
+	wheelTime = 0;
+}
+
+/*
+================
+idEventWheel::LevelOfList
+================
+*/
+int idEventWheel::LevelOfList( int list ) {
+	if ( list < EVENT_WHEEL_LEVEL0_SIZE ) {
+		return 0;
+	}
+	if ( list < EVENT_WHEEL_FAR ) {
+		return 1 + ( list - EVENT_WHEEL_LEVEL0_SIZE ) / EVENT_WHEEL_LEVEL_SIZE;
+	}
+	return EVENT_WHEEL_LEVELS + ( list - EVENT_WHEEL_FAR );
+}
+
+/*
+================
+idEventWheel::Clear
+================
+*/
+void idEventWheel::Clear( void ) {
+	idEvent *event;
+	int i;
+
+	for( i = 0; i < EVENT_WHEEL_LISTS; i++ ) {
+		for( event = lists[ i ].Next(); event != NULL; event = event->eventNode.Next() ) {
+			event->queue = NULL;
+		}
+		lists[ i ].Clear();
+	}
+	memset( levelCount, 0, sizeof( levelCount ) );
+	numEvents = 0;
+	wheelTime = 0;
+}
+
+/*
+================
+idEventWheel::Insert
+================
+*/
+void idEventWheel::Insert( idEvent *event ) {
+	idEvent *prev;
+	int time;
+	int list;
+	int level;
+
+	time = event->time;
+	if ( time < wheelTime ) {
+		// only happens when the game time went back, keep these sorted
+		for( prev = lists[ EVENT_WHEEL_LATE ].Prev(); prev != NULL && prev->time > time; prev = prev->eventNode.Prev() ) {
+		}
+		if ( prev ) {
+			event->eventNode.InsertAfter( prev->eventNode );
+		} else {
+			event->eventNode.AddToFront( lists[ EVENT_WHEEL_LATE ] );
+		}
+		event->slot = EVENT_WHEEL_LATE;
+		levelCount[ EVENT_WHEEL_LEVELS + 1 ]++;
+		return;
+	}
+
+	list = EVENT_WHEEL_FAR;
+	for( level = 0; level < EVENT_WHEEL_LEVELS; level++ ) {
+		int blockShift = LevelShift( level + 1 );
+		if ( ( time >> blockShift ) == ( wheelTime >> blockShift ) ) {
+			if ( level == 0 ) {
+				list = time & ( EVENT_WHEEL_LEVEL0_SIZE - 1 );
+			} else {
+				list = EVENT_WHEEL_LEVEL0_SIZE + ( level - 1 ) * EVENT_WHEEL_LEVEL_SIZE + ( ( time >> LevelShift( level ) ) & ( EVENT_WHEEL_LEVEL_SIZE - 1 ) );
+			}
+			break;
+		}
+	}
+
+	event->eventNode.AddToEnd( lists[ list ] );
+	event->slot = list;
+	levelCount[ level ]++;
+}
+
+/*
+================
+idEventWheel::Add
+================
+*/
+void idEventWheel::Add( idEvent *event, int now ) {
+	if ( !numEvents ) {
+		// nothing to move down the levels, so the wheel can start at the current time
+		wheelTime = now;
+	}
+	event->queue = this;
+	numEvents++;
+	Insert( event );
+}
+
+/*
+================
+idEventWheel::Remove
+================
+*/
+void idEventWheel::Remove( idEvent *event ) {
+	assert( event->queue == this );
+	event->eventNode.Remove();
+	event->queue = NULL;
+	levelCount[ LevelOfList( event->slot ) ]--;
+	numEvents--;
+}
+
+/*
+================
+idEventWheel::Requeue
+
+Moves the events of a list to the lists for their time relative to the current time of the wheel.
+================
+*/
+void idEventWheel::Requeue( int list ) {
+	idEvent *event;
+	int i;
+
+	for( i = lists[ list ].Num(); i > 0; i-- ) {
+		event = lists[ list ].Next();
+		event->eventNode.Remove();
+		levelCount[ LevelOfList( list ) ]--;
+		Insert( event );
+	}
+}
+
+/*
+================
+idEventWheel::Advance
+
+Moves the wheel towards now, skipping the blocks of levels that have no events.
+================
+*/
+void idEventWheel::Advance( int now ) {
+	int step;
+	int level;
+
+	if ( !numEvents ) {
+		wheelTime = now;
+		return;
+	}
+
+	for( level = 0; level < EVENT_WHEEL_LEVELS && !levelCount[ level ]; level++ ) {
+	}
+	step = 1 << LevelShift( level );
+	wheelTime = Min( now, ( wheelTime | ( step - 1 ) ) + 1 );
+
+	if ( wheelTime & ( EVENT_WHEEL_LEVEL0_SIZE - 1 ) ) {
+		return;
+	}
+
+	// entered a new block of the first level, move the events of the levels above down
+	for( level = EVENT_WHEEL_LEVELS - 1; level > 0; level-- ) {
+		if ( !( wheelTime & ( ( 1 << LevelShift( level ) ) - 1 ) ) ) {
+			break;
+		}
+	}
+	if ( level == EVENT_WHEEL_LEVELS - 1 && !( wheelTime & ( ( 1 << LevelShift( EVENT_WHEEL_LEVELS ) ) - 1 ) ) ) {
+		Requeue( EVENT_WHEEL_FAR );
+	}
+	for( ; level > 0; level-- ) {
+		Requeue( EVENT_WHEEL_LEVEL0_SIZE + ( level - 1 ) * EVENT_WHEEL_LEVEL_SIZE + ( ( wheelTime >> LevelShift( level ) ) & ( EVENT_WHEEL_LEVEL_SIZE - 1 ) ) );
+	}
+}
+
+/*
+================
+idEventWheel::NextEvent
+
+Returns the first event that is due at the given time, or NULL if there is none.
+================
+*/
+idEvent *idEventWheel::NextEvent( int now ) {
+	idEvent *event;
+
+	while( numEvents ) {
+		event = lists[ EVENT_WHEEL_LATE ].Next();
+		if ( event ) {
+			return ( event->time <= now ) ? event : NULL;
+		}
+		if ( wheelTime > now ) {
+			return NULL;
+		}
+		event = lists[ wheelTime & ( EVENT_WHEEL_LEVEL0_SIZE - 1 ) ].Next();
+		if ( event ) {
+			return event;
+		}
+		if ( wheelTime == now ) {
+			return NULL;
+		}
+		Advance( now );
+	}
+
+	return NULL;
+}
+
+typedef struct {
+	idEvent *	event;
+	int			time;
+	int			order;
+} queuedEvent_t;
+
+/*
+================
+QueuedEventCompare
+================
+*/
+static int QueuedEventCompare( const queuedEvent_t *a, const queuedEvent_t *b ) {
+	if ( a->time != b->time ) {
+		return ( a->time < b->time ) ? -1 : 1;
+	}
+	return a->order - b->order;
+}
+
+/*
+================
+idEventWheel::GetEvents
+
+Gets the events in the order they will be serviced.
+================
+*/
+void idEventWheel::GetEvents( idList<idEvent *> &events ) const {
+	idList<queuedEvent_t> queued;
+	queuedEvent_t qe;
+	int i;
+
+	queued.SetGranularity( 256 );
+	for( i = 0; i < EVENT_WHEEL_LISTS; i++ ) {
+		for( qe.event = lists[ i ].Next(); qe.event != NULL; qe.event = qe.event->eventNode.Next() ) {
+			qe.time = qe.event->time;
+			qe.order = queued.Num();
+			queued.Append( qe );
+		}
+	}
+	queued.Sort( QueuedEventCompare );
+
+	events.SetNum( queued.Num() );
+	for( i = 0; i < queued.Num(); i++ ) {
+		events[ i ] = queued[ i ].event;
+	}
+}
+
+/***********************************************************************
+
+  idEvent
+
+***********************************************************************/
+
+static idLinkList<idEvent> FreeEvents;
 static idEvent EventPool[ MAX_EVENTS ];
 
 bool idEvent::initialized = false;
@@ -365,11 +668,18 @@ void idEvent::Free( void ) {
 		data = NULL;
 	}
 
+	if ( queue ) {
+		queue->Remove( this );
+	}
+
 	eventdef	= NULL;
 	time		= 0;
 	object		= NULL;
 	typeinfo	= NULL;
 
+	objectNode.SetOwner( this );
+	objectNode.Remove();
+
 	eventNode.SetOwner( this );
 	eventNode.AddToEnd( FreeEvents );
 }
@@ -380,8 +690,6 @@ idEvent::Schedule
 ================
 */
 void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
-	idEvent *event;
-
 	assert( initialized );
 	if ( !initialized ) {
 		return;
@@ -397,33 +705,16 @@ void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
 
 #ifdef _D3XP
 	if ( obj->IsType( idEntity::Type ) && ( ( (idEntity*)(obj) )->timeGroup == TIME_GROUP2 ) ) {
-		event = FastEventQueue.Next();
-		while( ( event != NULL ) && ( this->time >= event->time ) ) {
-			event = event->eventNode.Next();
-		}
-
-		if ( event ) {
-			eventNode.InsertBefore( event->eventNode );
-		} else {
-			eventNode.AddToEnd( FastEventQueue );
-		}
-
-		return;
+		FastEventQueue.Add( this, gameLocal.fast.time );
 	} else {
 		this->time = gameLocal.slow.time + time;
+		EventQueue.Add( this, gameLocal.slow.time );
 	}
+#else
+	EventQueue.Add( this, gameLocal.time );
 #endif
 
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) ) {
-		event = event->eventNode.Next();
-	}
-
-	if ( event ) {
-		eventNode.InsertBefore( event->eventNode );
-	} else {
-		eventNode.AddToEnd( EventQueue );
-	}
+	objectNode.AddToEnd( obj->eventList );
 }
 
 /*
@@ -439,25 +730,12 @@ void idEvent::CancelEvents( const idClass *obj, const idEventDef *evdef ) {
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
+	for( event = obj->eventList.Next(); event != NULL; event = next ) {
+		next = event->objectNode.Next();
+		if ( !evdef || ( evdef == event->eventdef ) ) {
+			event->Free();
 		}
 	}
-
-#ifdef _D3XP
-	for( event = FastEventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
-		}
-	}
-#endif
 }
 
 /*
@@ -473,6 +751,9 @@ void idEvent::ClearEventList( void ) {
 	//
 	FreeEvents.Clear();
 	EventQueue.Clear();
+#ifdef _D3XP
+	FastEventQueue.Clear();
+#endif
 
 	//
 	// add the events to the free list
@@ -501,14 +782,7 @@ void idEvent::ServiceEvents( void ) {
 	const char  *materialName;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() ) {
-		event = EventQueue.Next();
-		assert( event );
-
-		if ( event->time > gameLocal.time ) {
-			break;
-		}
-
+	while( ( event = EventQueue.NextEvent( gameLocal.time ) ) != NULL ) {
 		// copy the data into the local args array and set up pointers
 		ev = event->eventdef;
 		formatspec = ev->GetArgFormat();
@@ -555,9 +829,10 @@ void idEvent::ServiceEvents( void ) {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		EventQueue.Remove( event );
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -593,14 +868,7 @@ void idEvent::ServiceFastEvents() {
 	const char  *materialName;
 
 	num = 0;
-	while( !FastEventQueue.IsListEmpty() ) {
-		event = FastEventQueue.Next();
-		assert( event );
-
-		if ( event->time > gameLocal.fast.time ) {
-			break;
-		}
-
+	while( ( event = FastEventQueue.NextEvent( gameLocal.fast.time ) ) != NULL ) {
 		// copy the data into the local args array and set up pointers
 		ev = event->eventdef;
 		formatspec = ev->GetArgFormat();
@@ -647,9 +915,10 @@ void idEvent::ServiceFastEvents() {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		FastEventQueue.Remove( event );
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -678,12 +947,6 @@ void idEvent::Init( void ) {
 		gameLocal.Error( "%s", eventErrorMsg );
 	}
 
-#ifdef CREATE_EVENT_CODE
-	void CreateEventCallbackHandler();
-	CreateEventCallbackHandler();
-	gameLocal.Error( "Wrote event callback handler" );
-#endif
-
 	if ( initialized ) {
 		gameLocal.Printf( "...already initialized\n" );
 		ClearEventList();
@@ -721,6 +984,80 @@ void idEvent::Shutdown( void ) {
 	initialized = false;
 }
 
+typedef struct {
+	const idEventDef *	eventdef;
+	int					count;
+} eventTypeCount_t;
+
+/*
+================
+EventTypeCountCompare
+================
+*/
+static int EventTypeCountCompare( const eventTypeCount_t *a, const eventTypeCount_t *b ) {
+	if ( a->count != b->count ) {
+		return b->count - a->count;
+	}
+	return idStr::Icmp( a->eventdef->GetName(), b->eventdef->GetName() );
+}
+
+/*
+================
+idEvent::ListEvents_f
+================
+*/
+void idEvent::ListEvents_f( const idCmdArgs &args ) {
+	idList<idEvent *> events;
+	idList<eventTypeCount_t> types;
+	eventTypeCount_t *type;
+	int typeIndex[ MAX_EVENTS ];
+	const idEventWheel *queue;
+	const idEventDef *ev;
+	int i, j;
+
+	if ( !initialized ) {
+		gameLocal.Printf( "event system not started\n" );
+		return;
+	}
+
+	for( j = 0; j < 2; j++ ) {
+#ifdef _D3XP
+		queue = ( j == 0 ) ? &EventQueue : &FastEventQueue;
+#else
+		if ( j > 0 ) {
+			break;
+		}
+		queue = &EventQueue;
+#endif
+
+		gameLocal.Printf( "%s: %d events (late %d, wheel %d %d %d %d, far %d)\n", ( j == 0 ) ? "queue" : "fast queue", queue->Num(),
+			queue->NumInLevel( EVENT_WHEEL_LEVELS + 1 ), queue->NumInLevel( 0 ), queue->NumInLevel( 1 ), queue->NumInLevel( 2 ), queue->NumInLevel( 3 ),
+			queue->NumInLevel( EVENT_WHEEL_LEVELS ) );
+
+		// count the events of each type
+		memset( typeIndex, -1, sizeof( typeIndex ) );
+		types.Clear();
+		queue->GetEvents( events );
+		for( i = 0; i < events.Num(); i++ ) {
+			ev = events[ i ]->eventdef;
+			if ( typeIndex[ ev->GetEventNum() ] < 0 ) {
+				typeIndex[ ev->GetEventNum() ] = types.Num();
+				type = &types.Alloc();
+				type->eventdef = ev;
+				type->count = 0;
+			}
+			types[ typeIndex[ ev->GetEventNum() ] ].count++;
+		}
+		types.Sort( EventTypeCountCompare );
+
+		for( i = 0; i < types.Num(); i++ ) {
+			gameLocal.Printf( "%6d %s\n", types[ i ].count, types[ i ].eventdef->GetName() );
+		}
+	}
+
+	gameLocal.Printf( "...%d free events\n", FreeEvents.Num() );
+}
+
 /*
 ================
 idEvent::Save
@@ -729,16 +1066,19 @@ idEvent::Save
 void idEvent::Save( idSaveGame *savefile ) {
 	char *str;
 	int i, size;
+	idList<idEvent *> events;
 	idEvent	*event;
 	byte *dataPtr;
 	bool validTrace;
 	const char	*format;
 	idStr s;
 
-	savefile->WriteInt( EventQueue.Num() );
+	// write the events in the order they will be serviced, same as when they were kept in a single sorted list
+	EventQueue.GetEvents( events );
+	savefile->WriteInt( events.Num() );
 
-	event = EventQueue.Next();
-	while( event != NULL ) {
+	for( int e = 0; e < events.Num(); e++ ) {
+		event = events[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -791,23 +1131,21 @@ void idEvent::Save( idSaveGame *savefile ) {
 			}
 		}
 		assert( size == event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 
 #ifdef _D3XP
 	// Save the Fast EventQueue
-	savefile->WriteInt( FastEventQueue.Num() );
+	FastEventQueue.GetEvents( events );
+	savefile->WriteInt( events.Num() );
 
-	event = FastEventQueue.Next();
-	while( event != NULL ) {
+	for( int e = 0; e < events.Num(); e++ ) {
+		event = events[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
 		savefile->WriteObject( event->object );
 		savefile->WriteInt( event->eventdef->GetArgSize() );
 		savefile->Write( event->data, event->eventdef->GetArgSize() );
-
-		event = event->eventNode.Next();
 	}
 #endif
 }
@@ -835,7 +1173,6 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -855,6 +1192,11 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		savefile->ReadObject( event->object );
 
+		EventQueue.Add( event, gameLocal.time );
+		if ( event->object ) {
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if ( argsize != event->eventdef->GetArgSize() ) {
@@ -924,7 +1266,6 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( FastEventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -944,6 +1285,11 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 
 		savefile->ReadObject( event->object );
 
+		FastEventQueue.Add( event, gameLocal.fast.time );
+		if ( event->object ) {
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+
 		// read the args
 		savefile->ReadInt( argsize );
 		if ( argsize != event->eventdef->GetArgSize() ) {
@@ -1006,61 +1352,3 @@ void idEvent::SaveTrace( idSaveGame *savefile, const trace_t &trace ) {
 	savefile->WriteInt( trace.c.trmFeature );
 	savefile->WriteInt( trace.c.id );
 }
-
-
-
-#ifdef CREATE_EVENT_CODE
-/*
-================
-CreateEventCallbackHandler
-================
-*/
-void CreateEventCallbackHandler( void ) {
-	int i, j, k;
-	char argString[ D_EVENT_MAXARGS + 1 ];
-	idStr string1;
-	idStr string2;
-	idFile *file;
-
-	file = fileSystem->OpenFileWrite( "Callbacks.cpp" );
-
-	file->Printf( "// generated file - see CREATE_EVENT_CODE\n\n" );
-
-	for( i = 1; i <= D_EVENT_MAXARGS; i++ ) {
-
-		file->Printf( "\t/*******************************************************\n\n\t\t%d args\n\n\t*******************************************************/\n\n", i );
-
-		for ( j = 0; j < ( 1 << i ); j++ ) {
-			for( k = 0; k < i; k++ ) {
-				argString[ k ] = j & ( 1 << k ) ? 'f' : 'i';
-			}
-			argString[ i ] = '\0';
-
-			string1.Empty();
-			string2.Empty();
-
-			for( k = 0; k < i; k++ ) {
-				if ( j & ( 1 << k ) ) {
-					string1 += "const float";
-					string2 += va( "*( float * )&data[ %d ]", k );
-				} else {
-					string1 += "const intptr_t";
-					string2 += va( "data[ %d ]", k );
-				}
-
-				if ( k < i - 1 ) {
-					string1 += ", ";
-					string2 += ", ";
-				}
-			}
-
-			file->Printf( "\tcase %d :\n\t\ttypedef void ( idClass::*eventCallback_%s_t )( %s );\n", ( 1 << ( i + D_EVENT_MAXARGS ) ) + j, argString, string1.c_str() );
-			file->Printf( "\t\t( this->*( eventCallback_%s_t )callback )( %s );\n\t\tbreak;\n\n", argString, string2.c_str() );
-
-		}
-	}
-
-	fileSystem->CloseFile( file );
-}
-
-#endif
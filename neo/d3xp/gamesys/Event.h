@@ -34,8 +34,7 @@ If you have questions concerning this license or the applicable additional terms
 
 // Event are used for scheduling tasks and for linking script commands.
 
-#define D_EVENT_MAXARGS				8			// if changed, enable the CREATE_EVENT_CODE define in Event.cpp to generate switch statement for idClass::ProcessEventArgPtr.
-												// running the game will then generate c:\doom\base\events.txt, the contents of which should be copied into the switch statement.
+#define D_EVENT_MAXARGS				8			// if changed, the event thunks in Class.cpp need to be updated as well
 
 // stack size of idVec3, aligned to native pointer size
 #define E_EVENT_SIZEOF_VEC			((sizeof(idVec3) + (sizeof(intptr_t) - 1)) & ~(sizeof(intptr_t) - 1))
@@ -53,6 +52,8 @@ If you have questions concerning this license or the applicable additional terms
 
 class idClass;
 class idTypeInfo;
+class idEventWheel;
+class idCmdArgs;
 
 class idEventDef {
 private:
@@ -98,9 +99,14 @@ private:
 	const idTypeInfo			*typeinfo;
 
 	idLinkList<idEvent>			eventNode;
+	idLinkList<idEvent>			objectNode;		// node in the list of events posted to the object
+	idEventWheel *				queue;			// queue the event is scheduled in
+	int							slot;			// list of the queue the event is in
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
+	friend class				idEventWheel;
+
 
 public:
 	static bool					initialized;
@@ -122,6 +128,7 @@ public:
 #endif
 	static void					Init( void );
 	static void					Shutdown( void );
+	static void					ListEvents_f( const idCmdArgs &args );
 
 	// save games
 	static void					Save( idSaveGame *savefile );					// archives object for save game file
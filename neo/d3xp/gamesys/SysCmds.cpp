@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
+#include "idlib/Timer.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/FileSystem.h"
 
@@ -1405,6 +1406,156 @@ static void Cmd_CollisionModelInfo_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+Cmd_ClipBenchmark_f
+==================
+*/
+static void Cmd_ClipBenchmark_f( const idCmdArgs &args ) {
+	int numQueries;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numQueries = 10000;
+	if ( args.Argc() > 1 ) {
+		numQueries = atoi( args.Argv( 1 ) );
+		if ( numQueries <= 0 ) {
+			gameLocal.Printf( "usage: clipBenchmark [numQueries]\n" );
+			return;
+		}
+	}
+
+	gameLocal.clip.Benchmark( numQueries );
+}
+
+/*
+==================
+Cmd_ObstacleBenchmark_f
+==================
+*/
+static void Cmd_ObstacleBenchmark_f( const idCmdArgs &args ) {
+	int numPasses;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numPasses = 100;
+	if ( args.Argc() > 1 ) {
+		numPasses = atoi( args.Argv( 1 ) );
+		if ( numPasses <= 0 ) {
+			gameLocal.Printf( "usage: obstacleBenchmark [numPasses]\n" );
+			return;
+		}
+	}
+
+	idAI::BenchmarkObstacles( numPasses );
+}
+
+/*
+==================
+Cmd_ScriptBenchmark_f
+==================
+*/
+static const char *scriptBenchmarkText =
+	"void scriptBenchmark_loop_%d() {\n"
+	"	float i;\n"
+	"	float sum;\n"
+	"	for( i = 0; i < %d; i++ ) {\n"
+	"		sum = sum + i * 0.5;\n"
+	"		if ( sum > 1000 ) {\n"
+	"			sum = sum - 1000;\n"
+	"		}\n"
+	"	}\n"
+	"}\n"
+	"void scriptBenchmark_events_%d() {\n"
+	"	float i;\n"
+	"	float sum;\n"
+	"	for( i = 0; i < %d; i++ ) {\n"
+	"		sum = sum + sys.sin( i ) + sys.sqrt( i );\n"
+	"	}\n"
+	"}\n"
+	"void scriptBenchmark_vectors_%d() {\n"
+	"	float i;\n"
+	"	vector v;\n"
+	"	vector w;\n"
+	"	w = '1 2 3';\n"
+	"	for( i = 0; i < %d; i++ ) {\n"
+	"		v = v + w * 0.5;\n"
+	"		v = v - w * ( v * w ) * 0.0001;\n"
+	"		v_z = v_x;\n"
+	"	}\n"
+	"}\n";
+
+static void Cmd_ScriptBenchmark_f( const idCmdArgs &args ) {
+	static int			benchmarkNum = 0;
+	static const char *	tests[] = { "loop", "events", "vectors" };
+	idStr				text;
+	const function_t *	func;
+	idThread *			thread;
+	idTimer				timer;
+	unsigned int		numStatements;
+	int					i, count;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	count = 100000;
+	if ( args.Argc() > 1 ) {
+		count = atoi( args.Argv( 1 ) );
+		if ( count <= 0 || count > 300000 ) {
+			gameLocal.Printf( "usage: scriptBenchmark [1 - 300000 iterations]\n" );
+			return;
+		}
+	}
+
+	// every run compiles its own functions, like the script command
+	benchmarkNum++;
+	sprintf( text, scriptBenchmarkText, benchmarkNum, count, benchmarkNum, count, benchmarkNum, count );
+	if ( !gameLocal.program.CompileText( "scriptBenchmark", text, true ) ) {
+		return;
+	}
+
+	for( i = 0; i < (int)( sizeof( tests ) / sizeof( tests[0] ) ); i++ ) {
+		func = gameLocal.program.FindFunction( va( "scriptBenchmark_%s_%d", tests[i], benchmarkNum ) );
+		if ( !func ) {
+			continue;
+		}
+
+		thread = new idThread( func );
+		thread->ManualDelete();
+		thread->ManualControl();
+
+		numStatements = idInterpreter::statementsExecuted;
+		timer.Clear();
+		timer.Start();
+		thread->Execute();
+		timer.Stop();
+		numStatements = idInterpreter::statementsExecuted - numStatements;
+
+		delete thread;
+
+		gameLocal.Printf( "%-8s %9u statements in %5u msec, %6.2f million statements per second\n", tests[i], numStatements,
+			timer.Milliseconds(), timer.Milliseconds() ? numStatements / ( timer.Milliseconds() * 1000.0f ) : 0.0f );
+	}
+}
+
+/*
+==================
+Cmd_LCPBenchmark_f
+==================
+*/
+static void Cmd_LCPBenchmark_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 ) {
+		idPhysics_AF::BenchmarkLCP( args.Argv( 1 ) );
+	} else {
+		idPhysics_AF::BenchmarkLCP();
+	}
+}
+
 /*
 ==================
 Cmd_ExportModels_f
@@ -1472,6 +1623,35 @@ static void Cmd_ReloadAnims_f( const idCmdArgs &args ) {
 	animationLib.ReloadAnims();
 }
 
+/*
+==================
+Cmd_AnimFrameCacheStats_f
+==================
+*/
+static void Cmd_AnimFrameCacheStats_f( const idCmdArgs &args ) {
+	idMD5Anim::PrintFrameCacheStats();
+}
+
+/*
+==================
+Cmd_AnimCompressionReport_f
+==================
+*/
+static void Cmd_AnimCompressionReport_f( const idCmdArgs &args ) {
+	float maxError;
+
+	maxError = g_animCompressError.GetFloat();
+	if ( args.Argc() > 1 ) {
+		maxError = atof( args.Argv( 1 ) );
+		if ( maxError < 0.0f ) {
+			gameLocal.Printf( "usage: animCompressionReport [maxError]\n" );
+			return;
+		}
+	}
+
+	animationLib.ReportCompression( maxError );
+}
+
 /*
 ==================
 Cmd_ListAnims_f
@@ -2410,6 +2590,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testSaveGame",			TestSaveGame_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"test a save game for a level" );
 	cmdSystem->AddCommand( "game_memory",			idClass::DisplayInfo_f,		CMD_FL_GAME,				"displays game class info" );
 	cmdSystem->AddCommand( "listClasses",			idClass::ListClasses_f,		CMD_FL_GAME,				"lists game classes" );
+	cmdSystem->AddCommand( "listEvents",			idEvent::ListEvents_f,		CMD_FL_GAME,				"lists the number of scheduled events of each type" );
 	cmdSystem->AddCommand( "listThreads",			idThread::ListThreads_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"lists script threads" );
 	cmdSystem->AddCommand( "listEntities",			Cmd_EntityList_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"lists game entities" );
 	cmdSystem->AddCommand( "listActiveEntities",	Cmd_ActiveEntityList_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"lists active game entities" );
@@ -2464,9 +2645,15 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
+	cmdSystem->AddCommand( "clipBenchmark",			Cmd_ClipBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"compares finding clip models with the clip sectors and the clip model tree" );
+	cmdSystem->AddCommand( "scriptBenchmark",		Cmd_ScriptBenchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"runs script loops, event calls and vector math and prints the statements executed per second" );
+	cmdSystem->AddCommand( "obstacleBenchmark",		Cmd_ObstacleBenchmark_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"compares finding the obstacles of all monsters with and without the obstacle hash" );
+	cmdSystem->AddCommand( "lcpBenchmark",			Cmd_LCPBenchmark_f,			CMD_FL_GAME,				"compares the LCP solvers on the articulated figure systems recorded with af_recordLCP" );
 	cmdSystem->AddCommand( "reexportmodels",		Cmd_ReexportModels_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"reexports models", ArgCompletion_DefFile );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
+	cmdSystem->AddCommand( "animCompressionReport",	Cmd_AnimCompressionReport_f,	CMD_FL_GAME,			"reports the memory and the largest joint error of all loaded anims when compressed with the given max error" );
+	cmdSystem->AddCommand( "animFrameCacheStats",	Cmd_AnimFrameCacheStats_f,	CMD_FL_GAME,				"prints the hit rate of the animation frame cache since the last report" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
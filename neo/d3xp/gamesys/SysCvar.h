@@ -52,6 +52,7 @@ extern idCVar	g_hitEffect;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_scriptBinaryCache;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
 extern idCVar	g_debugMove;
@@ -77,6 +78,10 @@ extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
 extern idCVar	g_maxShowDistance;
+extern idCVar	g_clipModelTree;
+extern idCVar	g_checkClipModelTree;
+extern idCVar	g_traceBatchJobs;
+extern idCVar	g_traceBatchRegion;
 extern idCVar	g_showEntityInfo;
 extern idCVar	g_showviewpos;
 extern idCVar	g_showcamerainfo;
@@ -85,7 +90,16 @@ extern idCVar	g_showActiveEntities;
 extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
+extern idCVar	g_eventStats;
 extern idCVar	g_timeentities;
+extern idCVar	g_parallelThink;
+extern idCVar	g_checkParallelThink;
+extern idCVar	g_animFrameCache;
+extern idCVar	g_animCompress;
+extern idCVar	g_animCompressError;
+extern idCVar	g_animLOD;
+extern idCVar	g_animLODDistance;
+extern idCVar	g_animLODMaxInterval;
 
 extern idCVar	ai_debugScript;
 extern idCVar	ai_debugMove;
@@ -94,6 +108,8 @@ extern idCVar	ai_testPredictPath;
 extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
+extern idCVar	ai_obstacleHash;
+extern idCVar	ai_obstacleStats;
 extern idCVar	ai_blockedFailSafe;
 #ifdef _D3XP
 extern idCVar	ai_showHealth;
@@ -161,6 +177,8 @@ extern idCVar	af_showInertia;
 extern idCVar	af_showVelocity;
 extern idCVar	af_showActive;
 extern idCVar	af_testSolid;
+extern idCVar	af_lcpGaussSeidelRows;
+extern idCVar	af_recordLCP;
 
 extern idCVar	rb_showTimings;
 extern idCVar	rb_showBodies;
@@ -168,6 +186,9 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_showStats;
+extern idCVar	rb_contactCache;
+extern idCVar	rb_islandRestTime;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
@@ -268,6 +289,9 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_precomputeRouting;
+extern idCVar	aas_routingFile;
+extern idCVar	aas_pathQueryBudget;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -129,6 +129,8 @@ private:
 	int						renderModelHandle;		// render model def handle
 
 	struct clipLink_s *		clipLinks;				// links into sectors
+	int						clipProxy;				// leaf in the clip model tree, -1 if none
+	bool					proxyLinked;			// false while the leaf is only kept to speed up relinking
 	int						touchCount;
 
 	void					Init( void );			// initialize
@@ -225,7 +227,7 @@ ID_INLINE bool idClipModel::IsTraceModel( void ) const {
 }
 
 ID_INLINE bool idClipModel::IsLinked( void ) const {
-	return ( clipLinks != NULL );
+	return ( clipLinks != NULL || proxyLinked );
 }
 
 ID_INLINE bool idClipModel::IsEnabled( void ) const {
@@ -250,6 +252,56 @@ ID_INLINE const idTraceModel *idClipModel::GetTraceModel( void ) const {
 //
 //===============================================================
 
+// node in the dynamic bounding box tree used to find clip models
+typedef struct clipTreeNode_s {
+	idBounds				bounds;			// fattened bounds of the clip model for leaves
+	idClipModel *			clipModel;		// NULL for internal nodes
+	int						parent;			// next free node for free nodes
+	int						children[2];	// -1 for leaves
+	int						height;			// 0 for leaves, -1 for free nodes
+} clipTreeNode_t;
+
+// translation for idClip::TraceBatch
+typedef struct clipTrace_s {
+	idVec3					start;
+	idVec3					end;
+	idBounds				bounds;			// axial box moved from start to end, cleared for a point trace
+	int						contentMask;
+	const idEntity *		passEntity;
+	trace_t					results;		// set by idClip::TraceBatch
+} clipTrace_t;
+
+// clip model gathered for idClip::StartMotion
+typedef struct clipMotionModel_s {
+	idClipModel *			clipModel;
+	cmHandle_t				collisionModelHandle;
+	int						traceModelIndex;
+	const idMaterial *		material;
+	idVec3					origin;
+	idMat3					axis;
+	idBounds				absBounds;
+} clipMotionModel_t;
+
+// motion for idClip::StartMotion
+typedef struct clipMotion_s {
+	idVec3					start;
+	idVec3					end;
+	idRotation				rotation;
+	const idClipModel *		mdl;
+	int						traceModelIndex;
+	idMat3					trmAxis;
+	int						contentMask;
+	const idEntity *		passEntity;
+	bool					translation;	// pure translation
+	idList<clipMotionModel_t> clipModels;	// clip models the whole motion may collide with
+	idBounds				queryBounds[2];	// bounds of the clip model queries the motion made
+	int						numQueries;
+	int						numTranslations;
+	int						numRotations;
+	trace_t					results;		// set by idClip::EvaluateMotion
+	bool					collided;
+} clipMotion_t;
+
 class idClip {
 
 	friend class idClipModel;
@@ -277,6 +329,15 @@ public:
 								int contentMask, const idEntity *passEntity );
 	bool					TraceBounds( trace_t &results, const idVec3 &start, const idVec3 &end, const idBounds &bounds,
 								int contentMask, const idEntity *passEntity );
+							// many point or box translations at once, returns the number of traces that hit something
+	int						TraceBatch( clipTrace_t *traces, int numTraces );
+							// motion with the collision detection on a job thread, returns false if the motion can't be split up
+	bool					StartMotion( clipMotion_t &motion, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
+	static void				EvaluateMotion( clipMotion_t &motion );
+							// gets the results of EvaluateMotion if the motion and the clip models are still the same
+	bool					GetMotionResults( clipMotion_t &motion, trace_t &results, bool &collided, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
 
 	// clip versus a specific model
 	void					TranslationModel( trace_t &results, const idVec3 &start, const idVec3 &end,
@@ -308,6 +369,7 @@ public:
 
 							// stats and debug drawing
 	void					PrintStatistics( void );
+	void					Benchmark( int numQueries );
 	void					DrawClipModels( const idVec3 &eye, const float radius, const idEntity *passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 
@@ -318,6 +380,12 @@ private:
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
 	mutable int				touchCount;
+							// dynamic bounding box tree used instead of the sectors when useClipTree is set
+	bool					useClipTree;
+	bool					checkClipTree;	// also link into the sectors and compare the queries of both
+	idList<clipTreeNode_t>	treeNodes;
+	int						treeRoot;
+	int						treeFreeNode;
 							// statistics
 	int						numTranslations;
 	int						numRotations;
@@ -325,12 +393,32 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+	mutable int				numClipModelTests;
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	bool					ClipModelsTouchingTree_r( int nodeNum, struct listParms_s &parms ) const;
+	void					CheckClipModelTree( const struct listParms_s &treeParms ) const;
+	bool					AddTouchingClipModel( idClipModel *check, struct listParms_s &parms ) const;
+	int						AllocTreeNode( void );
+	void					FreeTreeNode( int nodeNum );
+	void					InsertTreeLeaf( int leaf );
+	void					RemoveTreeLeaf( int leaf );
+	int						BalanceTreeNode( int nodeNum );
+	void					LinkProxy( idClipModel *clipModel );
+	void					RemoveProxy( idClipModel *clipModel );
+	void					ClearClipModelTree( void );
+	int						GetLinkedClipModels( idList<idClipModel *> &clipModels ) const;
+	void					SetClipModelTree( bool enable );
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
+	static bool				SkipTraceClipModel( const idClipModel *cm, const idEntity *passEntity, const idEntity *passOwner );
+	static idEntity *		GetPassOwner( const idEntity *passEntity );
+	static void				TraceBatchTranslation( clipTrace_t &trace, struct clipBatchTrace_s &work, idClipModel **candidates );
+	static void				TraceBatchJob( void *data, int jobNum );
+	static void				MotionTranslation( clipMotion_t &motion, trace_t &results, const idTraceModel *trm, const idBounds &bounds );
+	bool					MotionClipModelsChanged( const clipMotion_t &motion, const idBounds &bounds ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
 };
 
@@ -29,6 +29,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/math/Quat.h"
 #include "idlib/Timer.h"
+#include "framework/FileSystem.h"
 
 #include "gamesys/SysCvar.h"
 #include "Entity.h"
@@ -59,6 +60,7 @@ const float SUSPEND_LINEAR_ACCELERATION		= 20.0f;
 const float SUSPEND_ANGULAR_ACCELERATION	= 30.0f;
 const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON,
 													 LCP_EPSILON, LCP_EPSILON, LCP_EPSILON );
+const char *AF_LCP_FILE						= "afsystems.lcp";		// auxiliary constraint systems recorded for lcpBenchmark
 
 #define AF_TIMINGS
 
@@ -4489,9 +4491,12 @@ void idAFTree::Factor( void ) const {
 	int i, j;
 	idAFBody *body;
 	idAFConstraint *child = NULL;
-	idMatX childI;
+	idMatX childI, m1, m2;
 
+	// no idMatX temporaries are used because they are shared between threads
 	childI.SetData( 6, 6, MATX_ALLOCA( 6 * 6 ) );
+	m1.SetData( 6, 6, MATX_ALLOCA( 6 * 6 ) );
+	m2.SetData( 6, 6, MATX_ALLOCA( 6 * 6 ) );
 
 	// from the leaves up towards the root
 	for ( i = sortedBodies.Num() - 1; i >= 0; i-- ) {
@@ -4505,7 +4510,9 @@ void idAFTree::Factor( void ) const {
 
 				// child->I = - child->body1->J.Transpose() * child->body1->I * child->body1->J;
 				childI.SetSize( child->J1.GetNumRows(), child->J1.GetNumRows() );
-				child->body1->J.TransposeMultiply( child->body1->I ).Multiply( childI, child->body1->J );
+				m1.SetSize( child->body1->J.GetNumColumns(), child->body1->I.GetNumColumns() );
+				child->body1->J.TransposeMultiply( m1, child->body1->I );
+				m1.Multiply( childI, child->body1->J );
 				childI.Negate();
 
 				child->invI = childI;
@@ -4513,9 +4520,17 @@ void idAFTree::Factor( void ) const {
 					gameLocal.Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for constraint '%s'",
 									child->invI.GetNumRows(), child->invI.GetNumColumns(), child->GetName().c_str() );
 				}
-				child->J = child->invI * child->J;
-
-				body->I -= child->J.TransposeMultiply( childI ) * child->J;
+				// child->J = child->invI * child->J;
+				m1.SetSize( child->invI.GetNumRows(), child->J.GetNumColumns() );
+				child->invI.Multiply( m1, child->J );
+				child->J = m1;
+
+				// body->I -= child->J.TransposeMultiply( childI ) * child->J;
+				m1.SetSize( child->J.GetNumColumns(), childI.GetNumColumns() );
+				child->J.TransposeMultiply( m1, childI );
+				m2.SetSize( m1.GetNumRows(), child->J.GetNumColumns() );
+				m1.Multiply( m2, child->J );
+				body->I -= m2;
 			}
 
 			body->invI = body->I;
@@ -4524,11 +4539,15 @@ void idAFTree::Factor( void ) const {
 								child->invI.GetNumRows(), child->invI.GetNumColumns(), body->GetName().c_str() );
 			}
 			if ( body->primaryConstraint ) {
-				body->J = body->invI * body->J;
+				m1.SetSize( body->invI.GetNumRows(), body->J.GetNumColumns() );
+				body->invI.Multiply( m1, body->J );
+				body->J = m1;
 			}
 		}
 		else if ( body->primaryConstraint ) {
-			body->J = body->inverseWorldSpatialInertia * body->J;
+			m1.SetSize( body->inverseWorldSpatialInertia.GetNumRows(), body->J.GetNumColumns() );
+			body->inverseWorldSpatialInertia.Multiply( m1, body->J );
+			body->J = m1;
 		}
 	}
 }
@@ -4544,6 +4563,9 @@ void idAFTree::Solve( int auxiliaryIndex ) const {
 	int i, j;
 	idAFBody *body, *child;
 	idAFConstraint *primaryConstraint;
+	idVecX v;
+
+	v.SetData( 6, VECX_ALLOCA( 6 ) );
 
 	// from the leaves up towards the root
 	for ( i = sortedBodies.Num() - 1; i >= 0; i-- ) {
@@ -4578,7 +4600,9 @@ void idAFTree::Solve( int auxiliaryIndex ) const {
 			}
 
 			if ( !primaryConstraint->fl.isZero ) {
-				primaryConstraint->s = primaryConstraint->invI * primaryConstraint->s;
+				v.SetSize( primaryConstraint->invI.GetNumRows() );
+				primaryConstraint->invI.Multiply( v, primaryConstraint->s );
+				primaryConstraint->s = v;
 			}
 			primaryConstraint->J.MultiplySub( primaryConstraint->s, primaryConstraint->body2->s );
 
@@ -4590,12 +4614,16 @@ void idAFTree::Solve( int auxiliaryIndex ) const {
 
 			if ( body->children.Num() ) {
 				if ( !body->fl.isZero ) {
-					body->s = body->invI * body->s;
+					v.SetSize( body->invI.GetNumRows() );
+					body->invI.Multiply( v, body->s );
+					body->s = v;
 				}
 				body->J.MultiplySub( body->s, primaryConstraint->s );
 			}
 		} else if ( body->children.Num() ) {
-			body->s = body->invI * body->s;
+			v.SetSize( body->invI.GetNumRows() );
+			body->invI.Multiply( v, body->s );
+			body->s = v;
 		}
 	}
 }
@@ -4720,6 +4748,7 @@ void idAFTree::CalculateForces( float timeStep ) const {
 	float invStep;
 	idAFBody *body;
 	idAFConstraint *child, *c, *primaryConstraint;
+	idVecX v;
 
 	// forces on bodies
 	for ( i = 0; i < sortedBodies.Num(); i++ ) {
@@ -4735,6 +4764,8 @@ void idAFTree::CalculateForces( float timeStep ) const {
 
 	invStep = 1.0f / timeStep;
 
+	v.SetData( 6, VECX_ALLOCA( 6 ) );
+
 	// initialize right hand side
 	for ( i = 0; i < sortedBodies.Num(); i++ ) {
 		body = sortedBodies[i];
@@ -4745,7 +4776,15 @@ void idAFTree::CalculateForces( float timeStep ) const {
 		if ( primaryConstraint ) {
 			// b = ( J * acc + c )
 			c = primaryConstraint;
-			c->s = c->J1 * c->body1->acceleration + c->J2 * c->body2->acceleration + invStep * ( c->c1 + c->c2 );
+			c->s.SetSize( c->J1.GetNumRows() );
+			c->J1.Multiply( c->s, c->body1->acceleration );
+			v.SetSize( c->J2.GetNumRows() );
+			c->J2.Multiply( v, c->body2->acceleration );
+			c->s += v;
+			v = c->c1;
+			v += c->c2;
+			v *= invStep;
+			c->s += v;
 			c->fl.isZero = false;
 		}
 		body->s.Zero();
@@ -4866,7 +4905,7 @@ idPhysics_AF::EvaluateConstraints
 ================
 */
 void idPhysics_AF::EvaluateConstraints( float timeStep ) {
-	int i;
+	int i, j, k;
 	float invTimeStep;
 	idAFBody *body;
 	idAFConstraint *c;
@@ -4893,7 +4932,13 @@ void idPhysics_AF::EvaluateConstraints( float timeStep ) {
 		body = bodies[i];
 
 		if ( body->primaryConstraint ) {
-			body->J = body->primaryConstraint->J1.Transpose();
+			const idMatX &J1 = body->primaryConstraint->J1;
+			body->J.SetSize( J1.GetNumColumns(), J1.GetNumRows() );
+			for ( j = 0; j < J1.GetNumRows(); j++ ) {
+				for ( k = 0; k < J1.GetNumColumns(); k++ ) {
+					body->J[k][j] = J1[j][k];
+				}
+			}
 		}
 	}
 }
@@ -5053,6 +5098,7 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	int i, j, k, l, n, m, s, numAuxConstraints, *index, *boxIndex;
 	float *ptr, *j1, *j2, *dstPtr, *forcePtr;
 	float invStep, u;
+	bool useGaussSeidel;
 	idAFBody *body;
 	idAFConstraint *constraint;
 	idVecX tmp;
@@ -5227,16 +5273,38 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Start();
+	if ( !solvingConcurrently ) {
+		timer_lcp.Start();
+	}
 #endif
 
+	// record the system for lcpBenchmark
+	if ( af_recordLCP.GetInteger() > 0 && !solvingConcurrently ) {
+		RecordLCP( jmk, rhs, lo, hi, boxIndex );
+		af_recordLCP.SetInteger( af_recordLCP.GetInteger() - 1 );
+	}
+
 	// calculate lagrange multipliers for auxiliary constraints
-	if ( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) ) {
-		return;		// bad monkey!
+	useGaussSeidel = ( af_lcpGaussSeidelRows.GetInteger() > 0 && numAuxConstraints >= af_lcpGaussSeidelRows.GetInteger() );
+	if ( useGaussSeidel || !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) ) {
+		// start at the forces of the last step, contacts change every step so their forces start at zero
+		for ( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+			constraint = auxiliaryConstraints[i];
+			for ( j = 0; j < constraint->J1.GetNumRows(); j++, k++ ) {
+				if ( constraint->type == CONSTRAINT_CONTACT || constraint->type == CONSTRAINT_FRICTION ) {
+					lm[k] = 0.0f;
+				} else {
+					lm[k] = constraint->lm[j];
+				}
+			}
+		}
+		gaussSeidel->Solve( jmk, lm, rhs, lo, hi, boxIndex );
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Stop();
+	if ( !solvingConcurrently ) {
+		timer_lcp.Stop();
+	}
 #endif
 
 	// calculate auxiliary constraint forces
@@ -5271,6 +5339,180 @@ void idPhysics_AF::AuxiliaryForces( float timeStep ) {
 	}
 }
 
+/*
+================
+idPhysics_AF::RecordLCP
+
+  Appends an auxiliary constraint system to the file read by lcpBenchmark.
+================
+*/
+void idPhysics_AF::RecordLCP( const idMatX &A, const idVecX &b, const idVecX &lo, const idVecX &hi, const int *boxIndex ) {
+	int i, j;
+	idFile *file;
+
+	file = fileSystem->OpenFileAppend( AF_LCP_FILE, false, "fs_savepath" );
+	if ( !file ) {
+		gameLocal.Warning( "couldn't open %s", AF_LCP_FILE );
+		af_recordLCP.SetInteger( 0 );
+		return;
+	}
+
+	file->WriteInt( A.GetNumRows() );
+	for ( i = 0; i < A.GetNumRows(); i++ ) {
+		for ( j = 0; j < A.GetNumRows(); j++ ) {
+			file->WriteFloat( A[i][j] );
+		}
+	}
+	for ( i = 0; i < A.GetNumRows(); i++ ) {
+		file->WriteFloat( b[i] );
+		file->WriteFloat( lo[i] );
+		file->WriteFloat( hi[i] );
+		file->WriteInt( boxIndex[i] );
+	}
+
+	fileSystem->CloseFile( file );
+}
+
+/*
+================
+AF_LCPError
+
+  Returns the largest violation of the bounds and complementarity conditions.
+================
+*/
+static float AF_LCPError( const idMatX &A, const idVecX &x, const idVecX &b, const idVecX &lo, const idVecX &hi, const int *boxIndex ) {
+	int i;
+	float a, l, h, s, error;
+
+	error = 0.0f;
+	for ( i = 0; i < A.GetNumRows(); i++ ) {
+		SIMDProcessor->Dot( a, A[i], x.ToFloatPtr(), A.GetNumRows() );
+		a -= b[i];
+		l = lo[i];
+		h = hi[i];
+		if ( boxIndex[i] >= 0 ) {
+			s = x[boxIndex[i]];
+			if ( l != -idMath::INFINITY ) {
+				l = - idMath::Fabs( l * s );
+			}
+			if ( h != idMath::INFINITY ) {
+				h = idMath::Fabs( h * s );
+			}
+		}
+		if ( x[i] <= l ) {
+			error = Max( error, Max( l - x[i], -a ) );
+		} else if ( x[i] >= h ) {
+			error = Max( error, Max( x[i] - h, a ) );
+		} else {
+			error = Max( error, idMath::Fabs( a ) );
+		}
+	}
+	return error;
+}
+
+/*
+================
+idPhysics_AF::BenchmarkLCP
+
+  Solves the recorded auxiliary constraint systems with each LCP solver and
+  compares the number of iterations, the time and the remaining constraint error.
+================
+*/
+void idPhysics_AF::BenchmarkLCP( const char *fileName ) {
+	int i, j, s, run, numRows, numSystems, maxRows, totalRows;
+	float error;
+	const int numRuns = 10;
+	const int numSolvers = 3;
+	const char *names[numSolvers] = { "symmetric", "square", "gauss-seidel" };
+	idLCP *solvers[numSolvers];
+	int iterations[numSolvers], failures[numSolvers];
+	float maxError[numSolvers], totalError[numSolvers];
+	idTimer timers[numSolvers];
+	idList<int> boxIndex;
+	idMatX A;
+	idVecX x, b, lo, hi;
+	idFile *file;
+
+	if ( !fileName ) {
+		fileName = AF_LCP_FILE;
+	}
+
+	file = fileSystem->OpenFileRead( fileName );
+	if ( !file ) {
+		gameLocal.Printf( "couldn't open %s, record systems with af_recordLCP first\n", fileName );
+		return;
+	}
+
+	solvers[0] = idLCP::AllocSymmetric();
+	solvers[1] = idLCP::AllocSquare();
+	solvers[2] = idLCP::AllocGaussSeidel();
+	for ( s = 0; s < numSolvers; s++ ) {
+		iterations[s] = 0;
+		failures[s] = 0;
+		maxError[s] = 0.0f;
+		totalError[s] = 0.0f;
+		timers[s].Clear();
+	}
+
+	numSystems = maxRows = totalRows = 0;
+	while( file->ReadInt( numRows ) == sizeof( int ) && numRows > 0 ) {
+
+		A.SetSize( numRows, numRows );
+		x.SetSize( numRows );
+		b.SetSize( numRows );
+		lo.SetSize( numRows );
+		hi.SetSize( numRows );
+		boxIndex.SetNum( numRows );
+		for ( i = 0; i < numRows; i++ ) {
+			for ( j = 0; j < numRows; j++ ) {
+				file->ReadFloat( A[i][j] );
+			}
+		}
+		for ( i = 0; i < numRows; i++ ) {
+			file->ReadFloat( b[i] );
+			file->ReadFloat( lo[i] );
+			file->ReadFloat( hi[i] );
+			file->ReadInt( boxIndex[i] );
+		}
+
+		numSystems++;
+		totalRows += numRows;
+		maxRows = Max( maxRows, numRows );
+
+		for ( s = 0; s < numSolvers; s++ ) {
+			for ( run = 0; run < numRuns; run++ ) {
+				x.Zero();
+				timers[s].Start();
+				if ( !solvers[s]->Solve( A, x, b, lo, hi, boxIndex.Ptr() ) && run == 0 ) {
+					failures[s]++;
+				}
+				timers[s].Stop();
+			}
+			iterations[s] += solvers[s]->GetNumIterations();
+			error = AF_LCPError( A, x, b, lo, hi, boxIndex.Ptr() );
+			maxError[s] = Max( maxError[s], error );
+			totalError[s] += error;
+		}
+	}
+
+	fileSystem->CloseFile( file );
+
+	if ( !numSystems ) {
+		gameLocal.Printf( "no systems in %s\n", fileName );
+	} else {
+		gameLocal.Printf( "%d systems with %d rows on average and %d rows at most\n", numSystems, totalRows / numSystems, maxRows );
+		for ( s = 0; s < numSolvers; s++ ) {
+			gameLocal.Printf( "%-12s %6.1f iterations %8.1f usec %10.4f max error %10.4f avg error %d failed\n",
+						names[s], (float) iterations[s] / numSystems, timers[s].Milliseconds() * 1000.0f / ( numSystems * numRuns ),
+						maxError[s], totalError[s] / numSystems, failures[s] );
+		}
+	}
+
+	for ( s = 0; s < numSolvers; s++ ) {
+		delete solvers[s];
+	}
+}
+
 /*
 ================
 idPhysics_AF::VerifyContactConstraints
@@ -5996,6 +6238,8 @@ idPhysics_AF::Rest
 void idPhysics_AF::Rest( void ) {
 	int i;
 
+	CancelConcurrentStep();
+
 	current.atRest = gameLocal.time;
 
 	for ( i = 0; i < bodies.Num(); i++ ) {
@@ -6012,6 +6256,8 @@ idPhysics_AF::Activate
 ================
 */
 void idPhysics_AF::Activate( void ) {
+	CancelConcurrentStep();
+
 	// if the articulated figure was at rest
 	if ( current.atRest >= 0 ) {
 		// normally gravity is added at the end of a simulation frame
@@ -6132,6 +6378,8 @@ idPhysics_AF::SetContents
 void idPhysics_AF::SetContents( int contents, int id ) {
 	int i;
 
+	CancelConcurrentStep();
+
 	if ( id >= 0 && id < bodies.Num() ) {
 		bodies[id]->GetClipModel()->SetContents( contents );
 	}
@@ -6218,10 +6466,13 @@ const idBounds &idPhysics_AF::GetAbsBounds( int id ) const {
 
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::BeginStep
+
+  sets up the time step and evaluates the contacts,
+  returns false if the figure is not simulated this frame
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+bool idPhysics_AF::BeginStep( int timeStepMSec, int endTimeMSec ) {
 	float timeStep;
 
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
@@ -6278,6 +6529,27 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 
 #ifdef AF_TIMINGS
 	timer_collision.Stop();
+	timer_total.Stop();
+#endif
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SolveStep
+
+  calculates the constraint forces and evolves the current state to the next state,
+  only the figure itself is used so different figures can be solved concurrently
+================
+*/
+void idPhysics_AF::SolveStep( int endTimeMSec ) {
+	float timeStep = current.lastTimeStep;
+
+#ifdef AF_TIMINGS
+	if ( !solvingConcurrently ) {
+		timer_total.Start();
+	}
 #endif
 
 	// evaluate constraint equations
@@ -6290,14 +6562,9 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	AddFrameConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+	if ( !solvingConcurrently ) {
+		timer_pc.Start();
 	}
-	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
-	}
-	timer_pc.Start();
 #endif
 
 	// factor matrices for primary constraints
@@ -6307,20 +6574,45 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	PrimaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
+	if ( !solvingConcurrently ) {
+		timer_pc.Stop();
+		timer_ac.Start();
+	}
 #endif
 
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_ac.Stop();
+	if ( !solvingConcurrently ) {
+		timer_ac.Stop();
+	}
 #endif
 
 	// evolve current state to next state
 	Evolve( timeStep );
 
+#ifdef AF_TIMINGS
+	if ( !solvingConcurrently ) {
+		timer_total.Stop();
+	}
+#endif
+}
+
+/*
+================
+idPhysics_AF::EndStep
+
+  handles collisions, applies forces to other entities and tests if the figure can come to rest
+================
+*/
+void idPhysics_AF::EndStep( int endTimeMSec ) {
+	float timeStep = current.lastTimeStep;
+
+#ifdef AF_TIMINGS
+	timer_total.Start();
+#endif
+
 	// debug graphics
 	DebugDraw();
 
@@ -6381,6 +6673,14 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 #ifdef AF_TIMINGS
 	timer_total.Stop();
 
+	int i, numPrimary = 0, numAuxiliary = 0;
+	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
+		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+	}
+	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	}
+
 	if ( af_showTimings.GetInteger() == 1 ) {
 		gameLocal.Printf( "%12s: t %u pc %2d, %u ac %2d %u lcp %u cd %u\n",
 						self->name.c_str(),
@@ -6411,10 +6711,315 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		timer_lcp.Clear();
 	}
 #endif
+}
+
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) {
+
+	int i;
+	bool check = false;
+
+	// if this step was already solved ahead of time and nothing it depends on changed since
+	if ( concurrentEndTime != -1 ) {
+		if ( concurrentEndTime == endTimeMSec && ConcurrentStepIsValid() ) {
+			if ( !g_checkParallelThink.GetBool() ) {
+				concurrentEndTime = -1;
+				current.lastTimeStep = concurrentTimeStep;
+				contacts.Swap( concurrentContacts );
+				EndStep( endTimeMSec );
+				return true;
+			}
+			// solve the step again to compare
+			concurrentBodyStates.SetNum( bodies.Num(), false );
+			for ( i = 0; i < bodies.Num(); i++ ) {
+				concurrentBodyStates[i] = *bodies[i]->next;
+			}
+			check = true;
+		}
+		CancelConcurrentStep();
+	}
+
+	if ( !BeginStep( timeStepMSec, endTimeMSec ) ) {
+		return false;
+	}
+
+	SolveStep( endTimeMSec );
+
+	if ( check ) {
+		for ( i = 0; i < bodies.Num(); i++ ) {
+			const AFBodyPState_t &state = *bodies[i]->next;
+			const AFBodyPState_t &solved = concurrentBodyStates[i];
+			if ( state.worldOrigin != solved.worldOrigin || state.worldAxis != solved.worldAxis || state.spatialVelocity != solved.spatialVelocity ) {
+				gameLocal.Warning( "articulated figure '%s' solved on a job thread differs from the serial one", self->name.c_str() );
+				break;
+			}
+		}
+	}
+
+	EndStep( endTimeMSec );
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::CanEvaluateConcurrently
+
+  true if the next step can be solved ahead of time with StartConcurrentStep
+================
+*/
+bool idPhysics_AF::CanEvaluateConcurrently( void ) const {
+	int i;
+
+	if ( current.atRest >= 0 || masterBody != NULL ) {
+		return false;
+	}
+	// a step that is thrown away must not have changed the current state
+	if ( current.pushVelocity != vec6_origin || af_useImpulseFriction.GetBool() || af_useJointImpulseFriction.GetBool() ) {
+		return false;
+	}
+	// suspension constraints trace against the world
+	for ( i = 0; i < constraints.Num(); i++ ) {
+		if ( constraints[i]->GetType() == CONSTRAINT_SUSPENSION ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idPhysics_AF::GetStepBounds
+
+  bounds for anything the figure may touch during the step from the current to the next state
+================
+*/
+idBounds idPhysics_AF::GetStepBounds( void ) const {
+	int i;
+	float radius;
+	idAFBody *body;
+	idBounds bounds;
+
+	bounds.Clear();
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		body = bodies[i];
+		// contacts are searched up to 2 units away, see EvaluateContacts
+		radius = body->clipModel->GetBounds().GetRadius() + 2.0f + CM_BOX_EPSILON;
+		bounds.AddBounds( idBounds( body->current->worldOrigin ).Expand( radius ) );
+		bounds.AddBounds( idBounds( body->next->worldOrigin ).Expand( radius ) );
+	}
+	return bounds;
+}
+
+/*
+================
+ClipModelStateCompare
+================
+*/
+static int ClipModelStateCompare( const AFClipModelState_t *a, const AFClipModelState_t *b ) {
+	if ( a->clipModel != b->clipModel ) {
+		return ( a->clipModel < b->clipModel ) ? -1 : 1;
+	}
+	return 0;
+}
+
+/*
+================
+idPhysics_AF::GetTouchingClipModels
+
+  gets the clip models of other entities touching the bounds sorted by address
+================
+*/
+void idPhysics_AF::GetTouchingClipModels( const idBounds &bounds, idList<AFClipModelState_t> &list ) const {
+	int i, num;
+	idClipModel *cm;
+	idClipModel *clipModels[ MAX_GENTITIES ];
+	AFClipModelState_t *state;
+
+	list.SetNum( 0, false );
+	num = gameLocal.clip.ClipModelsTouchingBounds( bounds, -1, clipModels, MAX_GENTITIES );
+	for ( i = 0; i < num; i++ ) {
+		cm = clipModels[i];
+		if ( cm->GetEntity() == self ) {
+			continue;
+		}
+		state = &list.Alloc();
+		state->clipModel = cm;
+		state->origin = cm->GetOrigin();
+		state->axis = cm->GetAxis();
+		state->contents = cm->GetContents();
+	}
+	list.Sort( ClipModelStateCompare );
+}
+
+/*
+================
+idPhysics_AF::ConcurrentStepIsValid
+
+  Returns true if the step solved by EvaluateConcurrentStep gives the same result as
+  evaluating the figure now. That is the case if neither the figure nor anything it
+  could have found contacts with changed since the step was solved.
+================
+*/
+bool idPhysics_AF::ConcurrentStepIsValid( void ) const {
+	int i;
+	idList<AFClipModelState_t> clipModels;
+
+	if ( changedAF ) {
+		return false;
+	}
+	if ( current.atRest != concurrentState.atRest || current.noMoveTime != concurrentState.noMoveTime ||
+			current.activateTime != concurrentState.activateTime || current.lastTimeStep != concurrentState.lastTimeStep ||
+			current.pushVelocity != concurrentState.pushVelocity ) {
+		return false;
+	}
+	if ( bodies.Num() != concurrentBodyStates.Num() ) {
+		return false;
+	}
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		const AFBodyPState_t &state = *bodies[i]->current;
+		const AFBodyPState_t &solved = concurrentBodyStates[i];
+		if ( state.worldOrigin != solved.worldOrigin || state.worldAxis != solved.worldAxis ||
+				state.spatialVelocity != solved.spatialVelocity || state.externalForce != solved.externalForce ) {
+			return false;
+		}
+	}
 
+	// other entities that moved, appeared or changed contents near the figure since then
+	GetTouchingClipModels( concurrentBounds, clipModels );
+	if ( clipModels.Num() != concurrentClipModels.Num() ) {
+		return false;
+	}
+	for ( i = 0; i < clipModels.Num(); i++ ) {
+		const AFClipModelState_t &state = clipModels[i];
+		const AFClipModelState_t &solved = concurrentClipModels[i];
+		if ( state.clipModel != solved.clipModel || state.origin != solved.origin || state.axis != solved.axis || state.contents != solved.contents ) {
+			return false;
+		}
+	}
 	return true;
 }
 
+/*
+================
+idPhysics_AF::CancelConcurrentStep
+
+  throws away a step solved by EvaluateConcurrentStep so the figure is evaluated as usual
+================
+*/
+void idPhysics_AF::CancelConcurrentStep( void ) {
+	int i, j, k;
+	idAFConstraint *constraint;
+
+	if ( concurrentEndTime == -1 ) {
+		return;
+	}
+	concurrentEndTime = -1;
+
+	// only remove the contact constraints added to the frame constraints by EvaluateConstraints
+	auxiliaryConstraints.SetNum( auxiliaryConstraints.Num() - frameConstraints.Num(), false );
+	frameConstraints.SetNum( frameConstraints.Num() - contactConstraints.Num(), false );
+
+	// the forces of the last step are the starting point of the gauss-seidel solver
+	for ( k = 0, i = 0; i < auxiliaryConstraints.Num() + frameConstraints.Num(); i++ ) {
+		constraint = ( i < auxiliaryConstraints.Num() ) ? auxiliaryConstraints[i] : frameConstraints[i - auxiliaryConstraints.Num()];
+		for ( j = 0; j < constraint->lm.GetSize(); j++, k++ ) {
+			constraint->lm[j] = concurrentLM[k];
+		}
+	}
+}
+
+/*
+================
+idPhysics_AF::StartConcurrentStep
+
+  Evaluates the contacts of the next step so its constraint forces can be solved
+  on a job thread ahead of the think of the entity. The figure must be a team master
+  without a team that isn't solid for the team, and the entity must run its physics
+  before anything else when it thinks. The step is only committed when the
+  entity thinks, so collisions and forces on other entities happen in the usual order.
+  It is thrown away if the figure was pushed, moved, activated or had impulses or
+  forces applied in the mean time, or if other entities moved near it, and the figure
+  is evaluated again. The results are the same as evaluating the figure when its
+  entity thinks.
+================
+*/
+bool idPhysics_AF::StartConcurrentStep( int timeStepMSec, int endTimeMSec ) {
+	int i, j;
+	idAFConstraint *constraint;
+	bool solve;
+
+	CancelConcurrentStep();
+
+	if ( !CanEvaluateConcurrently() || !self->RunsPhysicsFirst() ) {
+		return false;
+	}
+	assert( self->GetTeamMaster() == NULL && !self->fl.solidForTeam );
+
+	concurrentState = current;
+	concurrentContacts = contacts;
+
+	// contacts are evaluated with the figure disabled for collision detection like idEntity::RunPhysics does
+	DisableClip();
+	solve = BeginStep( timeStepMSec, endTimeMSec );
+	EnableClip();
+
+	if ( !solve ) {
+		current.lastTimeStep = concurrentState.lastTimeStep;
+		return false;
+	}
+
+	// the step changes the lagrange multipliers the next step starts from
+	concurrentLM.SetNum( 0, false );
+	for ( i = 0; i < auxiliaryConstraints.Num() + frameConstraints.Num(); i++ ) {
+		constraint = ( i < auxiliaryConstraints.Num() ) ? auxiliaryConstraints[i] : frameConstraints[i - auxiliaryConstraints.Num()];
+		for ( j = 0; j < constraint->lm.GetSize(); j++ ) {
+			concurrentLM.Append( constraint->lm[j] );
+		}
+	}
+
+	concurrentEndTime = endTimeMSec;
+	solvingConcurrently = true;
+	return true;
+}
+
+/*
+================
+idPhysics_AF::EvaluateConcurrentStep
+================
+*/
+void idPhysics_AF::EvaluateConcurrentStep( void ) {
+	SolveStep( concurrentEndTime );
+}
+
+/*
+================
+idPhysics_AF::FinishConcurrentStep
+
+  keeps the state of the figure as it was until the step is committed and remembers what the step depends on
+================
+*/
+void idPhysics_AF::FinishConcurrentStep( void ) {
+	int i;
+
+	solvingConcurrently = false;
+
+	concurrentTimeStep = current.lastTimeStep;
+	current.lastTimeStep = concurrentState.lastTimeStep;
+	contacts.Swap( concurrentContacts );
+
+	concurrentBodyStates.SetNum( bodies.Num(), false );
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		concurrentBodyStates[i] = *bodies[i]->current;
+	}
+	concurrentBounds = GetStepBounds();
+	GetTouchingClipModels( concurrentBounds, concurrentClipModels );
+}
+
 /*
 ================
 idPhysics_AF::UpdateTime
@@ -6605,6 +7210,7 @@ idPhysics_AF::idPhysics_AF( void ) {
 	masterBody = NULL;
 
 	lcp = idLCP::AllocSymmetric();
+	gaussSeidel = idLCP::AllocGaussSeidel();
 
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
@@ -6651,6 +7257,11 @@ idPhysics_AF::idPhysics_AF( void ) {
 	worldConstraintsLocked = false;
 	forcePushable = false;
 
+	concurrentEndTime = -1;
+	concurrentTimeStep = 0.0f;
+	solvingConcurrently = false;
+	memset( &concurrentState, 0, sizeof( concurrentState ) );
+
 #ifdef AF_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -6680,6 +7291,7 @@ idPhysics_AF::~idPhysics_AF( void ) {
 	}
 
 	delete lcp;
+	delete gaussSeidel;
 
 	if ( masterBody ) {
 		delete masterBody;
@@ -7079,6 +7691,8 @@ idPhysics_AF::AddFrameConstraint
 ================
 */
 void idPhysics_AF::AddFrameConstraint( idAFConstraint *constraint ) {
+	CancelConcurrentStep();
+
 	frameConstraints.Append( constraint );
 	constraint->physics = this;
 }
@@ -7412,6 +8026,8 @@ idPhysics_AF::ApplyImpulse
 ================
 */
 void idPhysics_AF::ApplyImpulse( const int id, const idVec3 &point, const idVec3 &impulse ) {
+	CancelConcurrentStep();
+
 	if ( id < 0 || id >= bodies.Num() ) {
 		return;
 	}
@@ -7430,6 +8046,8 @@ idPhysics_AF::AddForce
 ================
 */
 void idPhysics_AF::AddForce( const int id, const idVec3 &point, const idVec3 &force ) {
+	CancelConcurrentStep();
+
 	if ( noImpact ) {
 		return;
 	}
@@ -7491,6 +8109,8 @@ idPhysics_AF::RestoreState
 void idPhysics_AF::RestoreState( void ) {
 	int i;
 
+	CancelConcurrentStep();
+
 	current = saved;
 
 	for ( i = 0; i < bodies.Num(); i++ ) {
@@ -7542,6 +8162,8 @@ void idPhysics_AF::Translate( const idVec3 &translation, int id ) {
 	int i;
 	idAFBody *body;
 
+	CancelConcurrentStep();
+
 	if ( !worldConstraintsLocked ) {
 		// translate constraints attached to the world
 		for ( i = 0; i < constraints.Num(); i++ ) {
@@ -7570,6 +8192,8 @@ void idPhysics_AF::Rotate( const idRotation &rotation, int id ) {
 	int i;
 	idAFBody *body;
 
+	CancelConcurrentStep();
+
 	if ( !worldConstraintsLocked ) {
 		// rotate constraints attached to the world
 		for ( i = 0; i < constraints.Num(); i++ ) {
@@ -7624,6 +8248,8 @@ idPhysics_AF::SetLinearVelocity
 ================
 */
 void idPhysics_AF::SetLinearVelocity( const idVec3 &newLinearVelocity, int id ) {
+	CancelConcurrentStep();
+
 	if ( id < 0 || id >= bodies.Num() ) {
 		return;
 	}
@@ -7637,6 +8263,8 @@ idPhysics_AF::SetAngularVelocity
 ================
 */
 void idPhysics_AF::SetAngularVelocity( const idVec3 &newAngularVelocity, int id ) {
+	CancelConcurrentStep();
+
 	if ( id < 0 || id >= bodies.Num() ) {
 		return;
 	}
@@ -7831,6 +8459,8 @@ void idPhysics_AF::SetPushed( int deltaTime ) {
 	idAFBody *body;
 	idRotation rotation;
 
+	CancelConcurrentStep();
+
 	if ( bodies.Num() ) {
 		body = bodies[0];
 		rotation = ( body->saved.worldAxis.Transpose() * body->current->worldAxis ).ToRotation();
@@ -7872,6 +8502,8 @@ void idPhysics_AF::SetMaster( idEntity *master, const bool orientated ) {
 	idMat3 masterAxis;
 	idRotation rotation;
 
+	CancelConcurrentStep();
+
 	if ( master ) {
 		self->GetMasterPosition( masterOrigin, masterAxis );
 		if ( !masterBody ) {
@@ -812,6 +812,13 @@ typedef struct AFCollision_s {
 	idAFBody *				body;
 } AFCollision_t;
 
+typedef struct AFClipModelState_s {
+	const idClipModel *		clipModel;
+	idVec3					origin;
+	idMat3					axis;
+	int						contents;
+} AFClipModelState_t;
+
 
 class idPhysics_AF : public idPhysics_Base {
 
@@ -892,6 +899,10 @@ public:
 	void					SetForcePushable( const bool enable ) { forcePushable = enable; }
 							// update the clip model positions
 	void					UpdateClipModels( void );
+							// true if the next step can be solved ahead of time with StartConcurrentStep
+	bool					CanEvaluateConcurrently( void ) const;
+							// compare the LCP solvers on the auxiliary constraint systems recorded with af_recordLCP
+	static void				BenchmarkLCP( const char *fileName = NULL );
 
 public:	// common physics interface
 	void					SetClipModel( idClipModel *model, float density, int id = 0, bool freeOld = true );
@@ -908,6 +919,10 @@ public:	// common physics interface
 	const idBounds &		GetAbsBounds( int id = -1 ) const;
 
 	bool					Evaluate( int timeStepMSec, int endTimeMSec );
+	bool					StartConcurrentStep( int timeStepMSec, int endTimeMSec );
+	void					EvaluateConcurrentStep( void );
+	void					FinishConcurrentStep( void );
+	void					CancelConcurrentStep( void );
 	void					UpdateTime( int endTimeMSec );
 	int						GetTime( void ) const;
 
@@ -1013,12 +1028,23 @@ private:
 	bool					worldConstraintsLocked;			// if true world constraints cannot be moved
 	bool					forcePushable;					// if true can be pushed even when bound to a master
 
+	int						concurrentEndTime;				// end time of a step solved by EvaluateConcurrentStep that is not committed yet
+	float					concurrentTimeStep;				// time step of that step
+	AFPState_t				concurrentState;				// state of the figure when the step was solved
+	idList<AFBodyPState_t>	concurrentBodyStates;			// state of the bodies when the step was solved
+	idList<contactInfo_t>	concurrentContacts;				// contacts found by the step
+	idList<float>			concurrentLM;					// lagrange multipliers of the auxiliary constraints before the step
+	idBounds				concurrentBounds;				// bounds for anything the step may touch
+	idList<AFClipModelState_t> concurrentClipModels;		// other clip models within those bounds when the step was solved
+	bool					solvingConcurrently;			// the timers and af_recordLCP can't be used from the job threads
+
 							// physics state
 	AFPState_t				current;
 	AFPState_t				saved;
 
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
+	idLCP *					gaussSeidel;					// iterative solver for large systems or when the pivoting solver fails
 
 private:
 	void					BuildTrees( void );
@@ -1046,6 +1072,13 @@ private:
 	void					Rest( void );
 	void					AddPushVelocity( const idVec6 &pushVelocity );
 	void					DebugDraw( void );
+	bool					BeginStep( int timeStepMSec, int endTimeMSec );
+	void					SolveStep( int endTimeMSec );
+	void					EndStep( int endTimeMSec );
+	idBounds				GetStepBounds( void ) const;
+	void					GetTouchingClipModels( const idBounds &bounds, idList<AFClipModelState_t> &list ) const;
+	bool					ConcurrentStepIsValid( void ) const;
+	static void				RecordLCP( const idMatX &A, const idVecX &b, const idVecX &lo, const idVecX &hi, const int *boxIndex );
 };
 
 #endif /* !__PHYSICS_AF_H__ */
@@ -105,6 +105,9 @@ public:	// common physics interface
 	const idBounds &		GetAbsBounds( int id = -1 ) const;
 
 	bool					Evaluate( int timeStepMSec, int endTimeMSec );
+	bool					StartConcurrentStep( int timeStepMSec, int endTimeMSec );
+	void					EvaluateConcurrentStep( void );
+	void					CancelConcurrentStep( void );
 	void					UpdateTime( int endTimeMSec );
 	int						GetTime( void ) const;
 
@@ -156,6 +159,9 @@ public:	// common physics interface
 	void					WriteToSnapshot( idBitMsgDelta &msg ) const;
 	void					ReadFromSnapshot( const idBitMsgDelta &msg );
 
+							// puts islands of touching rigid bodies that have been nearly motionless for a while to rest together
+	static void				RestIslands( idPhysics_RigidBody **bodies, int numBodies );
+
 private:
 	// state of the rigid body
 	rigidBodyPState_t		current;
@@ -185,14 +191,35 @@ private:
 	bool					hasMaster;
 	bool					isOrientated;
 
+	// contact persistence
+	int						contactsReused;				// number of evaluations the contacts have been reused, -1 if they need to be queried
+	idVec3					contactOrigin;				// position the contacts were determined for
+	idMat3					contactAxis;				// orientation the contacts were determined for
+
+	// island resting
+	int						slowTime;					// time the body started to be nearly motionless, -1 if moving
+	idVec3					slowOrigin;					// position when the body started to be nearly motionless
+	idMat3					slowAxis;					// orientation when the body started to be nearly motionless
+	int						islandNum;					// index into the bodies while resting islands, -1 otherwise
+	idEntityPtr<idEntity>	islandNext;					// next body in the ring of bodies put to rest together
+
+	// collision detection done ahead of time
+	int						concurrentEndTime;			// end time of the step started by StartConcurrentStep, -1 if none
+	clipMotion_t			concurrentMotion;			// motion of that step
+
 private:
 	friend void				RigidBodyDerivatives( const float t, const void *clientData, const float *state, float *derivatives );
 	void					Integrate( const float deltaTime, rigidBodyPState_t &next );
-	bool					CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision );
+	bool					CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision, bool concurrent );
 	bool					CollisionImpulse( const trace_t &collision, idVec3 &impulse );
 	void					ContactFriction( float deltaTime );
 	void					DropToFloorAndRest( void );
 	bool					TestIfAtRest( void ) const;
+	bool					TestIfMovingSlowly( void ) const;
+	bool					PoseChanged( const idVec3 &origin, const idMat3 &axis, const float epsilon ) const;
+	bool					ReuseContacts( void );
+	void					UpdateSlowTime( void );
+	void					WakeIsland( void );
 	void					Rest( void );
 	void					DebugDraw( void );
 };
@@ -38,6 +38,11 @@ If you have questions concerning this license or the applicable additional terms
 // HvG: Debugger support
 extern bool updateGameDebugger( idInterpreter *interpreter, idProgram *program, int instructionPointer );
 
+// most statements a thread may execute before it has to wait
+const int MAX_RUNAWAY_STATEMENTS = 5000000;
+
+unsigned int idInterpreter::statementsExecuted = 0;
+
 /*
 ================
 idInterpreter::idInterpreter()
@@ -979,6 +984,7 @@ bool idInterpreter::Execute( void ) {
 	varEval_t	var_c;
 	varEval_t	var;
 	statement_t	*st;
+	const resolvedStatement_t *rs;
 	int			runaway;
 	idThread	*newThread;
 	float		floatVal;
@@ -989,12 +995,14 @@ bool idInterpreter::Execute( void ) {
 		return true;
 	}
 
+	gameLocal.program.UpdateResolvedStatements();
+
 	if ( multiFrameEvent ) {
 		// move to previous instruction and call it again
 		instructionPointer--;
 	}
 
-	runaway = 5000000;
+	runaway = MAX_RUNAWAY_STATEMENTS;
 
 	doneProcessing = false;
 	while( !doneProcessing && !threadDying ) {
@@ -1006,6 +1014,7 @@ bool idInterpreter::Execute( void ) {
 
 		// next statement
 		st = &gameLocal.program.GetStatement( instructionPointer );
+		rs = &gameLocal.program.GetResolvedStatement( instructionPointer );
 
 		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
 			&& g_debugScript.GetBool( ) ) 
@@ -1020,26 +1029,26 @@ bool idInterpreter::Execute( void ) {
 			}
 		}
 
-		switch( st->op ) {
+		switch( rs->op ) {
 		case OP_RETURN:
 			LeaveFunction( st->a );
 			break;
 
 		case OP_THREAD:
-			newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
+			newThread = new idThread( this, rs->a.value.functionPtr, rs->b.value.argSize );
 			newThread->Start();
 
 			// return the thread number to the script
 			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
-			PopParms( st->b->value.argSize );
+			PopParms( rs->b.value.argSize );
 			break;
 
 		case OP_OBJTHREAD:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
-				assert( st->c->value.argSize == func->parmTotal );
+				func = obj->GetTypeDef()->GetFunction( rs->b.value.virtualFunction );
+				assert( rs->c.value.argSize == func->parmTotal );
 				newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
 				newThread->Start();
 
@@ -1049,142 +1058,142 @@ bool idInterpreter::Execute( void ) {
 				// return a null thread to the script
 				gameLocal.program.ReturnFloat( 0.0f );
 			}
-			PopParms( st->c->value.argSize );
+			PopParms( rs->c.value.argSize );
 			break;
 
 		case OP_CALL:
-			EnterFunction( st->a->value.functionPtr, false );
+			EnterFunction( rs->a.value.functionPtr, false );
 			break;
 
 		case OP_EVENTCALL:
-			CallEvent( st->a->value.functionPtr, st->b->value.argSize );
+			CallEvent( rs->a.value.functionPtr, rs->b.value.argSize );
 			break;
 
 		case OP_OBJECTCALL:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
+				func = obj->GetTypeDef()->GetFunction( rs->b.value.virtualFunction );
 				EnterFunction( func, false );
 			} else {
 				// return a 'safe' value
 				gameLocal.program.ReturnVector( vec3_zero );
 				gameLocal.program.ReturnString( "" );
-				PopParms( st->c->value.argSize );
+				PopParms( rs->c.value.argSize );
 			}
 			break;
 
 		case OP_SYSCALL:
-			CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
+			CallSysEvent( rs->a.value.functionPtr, rs->b.value.argSize );
 			break;
 
 		case OP_IFNOT:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			if ( *var_a.intPtr == 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + rs->b.value.jumpOffset );
 			}
 			break;
 
 		case OP_IF:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			if ( *var_a.intPtr != 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + rs->b.value.jumpOffset );
 			}
 			break;
 
 		case OP_GOTO:
-			NextInstruction( instructionPointer + st->a->value.jumpOffset );
+			NextInstruction( instructionPointer + rs->a.value.jumpOffset );
 			break;
 
 		case OP_ADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
 			break;
 
 		case OP_ADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
 			break;
 
 		case OP_ADD_S:
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, GetString( st->b ) );
+			SetString( rs->c, GetString( rs->a ) );
+			AppendString( rs->c, GetString( rs->b ) );
 			break;
 
 		case OP_ADD_FS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, FloatToString( *var_a.floatPtr ) );
-			AppendString( st->c, GetString( st->b ) );
+			var_a = GetVariable( rs->a );
+			SetString( rs->c, FloatToString( *var_a.floatPtr ) );
+			AppendString( rs->c, GetString( rs->b ) );
 			break;
 
 		case OP_ADD_SF:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, FloatToString( *var_b.floatPtr ) );
+			var_b = GetVariable( rs->b );
+			SetString( rs->c, GetString( rs->a ) );
+			AppendString( rs->c, FloatToString( *var_b.floatPtr ) );
 			break;
 
 		case OP_ADD_VS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, var_a.vectorPtr->ToString() );
-			AppendString( st->c, GetString( st->b ) );
+			var_a = GetVariable( rs->a );
+			SetString( rs->c, var_a.vectorPtr->ToString() );
+			AppendString( rs->c, GetString( rs->b ) );
 			break;
 
 		case OP_ADD_SV:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, var_b.vectorPtr->ToString() );
+			var_b = GetVariable( rs->b );
+			SetString( rs->c, GetString( rs->a ) );
+			AppendString( rs->c, var_b.vectorPtr->ToString() );
 			break;
 
 		case OP_SUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
 			break;
 
 		case OP_SUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
 			break;
 
 		case OP_MUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
 			break;
 
 		case OP_MUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
 			break;
 
 		case OP_MUL_FV:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
 			break;
 
 		case OP_MUL_VF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
 			break;
 
 		case OP_DIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1195,9 +1204,9 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_MOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable ( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1208,249 +1217,249 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_BITAND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
 			break;
 
 		case OP_BITOR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
 			break;
 
 		case OP_GE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
 			break;
 
 		case OP_LE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
 			break;
 
 		case OP_GT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
 			break;
 
 		case OP_LT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
 			break;
 
 		case OP_AND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
 			break;
 
 		case OP_AND_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
 			break;
 
 		case OP_AND_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
 			break;
 
 		case OP_AND_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
 			break;
 
 		case OP_OR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
 			break;
 
 		case OP_OR_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
 			break;
 
 		case OP_OR_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
 			break;
 
 		case OP_OR_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
 			break;
 
 		case OP_NOT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.intPtr == 0 );
 			break;
 
 		case OP_NOT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
 			break;
 
 		case OP_NOT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
 			break;
 
 		case OP_NOT_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
+			var_c = GetVariable( rs->c );
+			*var_c.floatPtr = ( strlen( GetString( rs->a ) ) == 0 );
 			break;
 
 		case OP_NOT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
 			break;
 
 		case OP_NEG_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = -*var_a.floatPtr;
 			break;
 
 		case OP_NEG_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.vectorPtr = -*var_a.vectorPtr;
 			break;
 
 		case OP_INT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
 			break;
 
 		case OP_EQ_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
 			break;
 
 		case OP_EQ_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
 			break;
 
 		case OP_EQ_S:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
+			*var_c.floatPtr = ( idStr::Cmp( GetString( rs->a ), GetString( rs->b ) ) == 0 );
 			break;
 
 		case OP_EQ_E:
 		case OP_EQ_EO:
 		case OP_EQ_OE:
 		case OP_EQ_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
 			break;
 
 		case OP_NE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
 			break;
 
 		case OP_NE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
 			break;
 
 		case OP_NE_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
+			var_c = GetVariable( rs->c );
+			*var_c.floatPtr = ( idStr::Cmp( GetString( rs->a ), GetString( rs->b ) ) != 0 );
 			break;
 
 		case OP_NE_E:
 		case OP_NE_EO:
 		case OP_NE_OE:
 		case OP_NE_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
 			break;
 
 		case OP_UADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr += *var_a.floatPtr;
 			break;
 
 		case OP_UADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.vectorPtr += *var_a.vectorPtr;
 			break;
 
 		case OP_USUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr -= *var_a.floatPtr;
 			break;
 
 		case OP_USUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.vectorPtr -= *var_a.vectorPtr;
 			break;
 
 		case OP_UMUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr *= *var_a.floatPtr;
 			break;
 
 		case OP_UMUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.vectorPtr *= *var_a.floatPtr;
 			break;
 
 		case OP_UDIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1461,8 +1470,8 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_UDIV_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1473,8 +1482,8 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_UMOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1485,72 +1494,72 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_UOR_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
 			break;
 
 		case OP_UAND_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
 			break;
 
 		case OP_UINC_F:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			( *var_a.floatPtr )++;
 			break;
 
 		case OP_UINCP_F:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				( *var.floatPtr )++;
 			}
 			break;
 
 		case OP_UDEC_F:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			( *var_a.floatPtr )--;
 			break;
 
 		case OP_UDECP_F:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				( *var.floatPtr )--;
 			}
 			break;
 
 		case OP_COMP_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
 			break;
 
 		case OP_STORE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr = *var_a.floatPtr;
 			break;
 
 		case OP_STORE_ENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
 			break;
 
 		case OP_STORE_BOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.intPtr = *var_a.intPtr;
 			break;
 
 		case OP_STORE_OBJENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_b.entityNumberPtr = 0;
@@ -1564,39 +1573,39 @@ bool idInterpreter::Execute( void ) {
 
 		case OP_STORE_OBJ:
 		case OP_STORE_ENTOBJ:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
 			break;
 
 		case OP_STORE_S:
-			SetString( st->b, GetString( st->a ) );
+			SetString( rs->b, GetString( rs->a ) );
 			break;
 
 		case OP_STORE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.vectorPtr = *var_a.vectorPtr;
 			break;
 
 		case OP_STORE_FTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, FloatToString( *var_a.floatPtr ) );
+			var_a = GetVariable( rs->a );
+			SetString( rs->b, FloatToString( *var_a.floatPtr ) );
 			break;
 
 		case OP_STORE_BTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, *var_a.intPtr ? "true" : "false" );
+			var_a = GetVariable( rs->a );
+			SetString( rs->b, *var_a.intPtr ? "true" : "false" );
 			break;
 
 		case OP_STORE_VTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, var_a.vectorPtr->ToString() );
+			var_a = GetVariable( rs->a );
+			SetString( rs->b, var_a.vectorPtr->ToString() );
 			break;
 
 		case OP_STORE_FTOBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			if ( *var_a.floatPtr != 0.0f ) {
 				*var_b.intPtr = 1;
 			} else {
@@ -1605,70 +1614,70 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_STORE_BOOLTOF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			var_a = GetVariable( rs->a );
+			var_b = GetVariable( rs->b );
 			*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
 			break;
 
 		case OP_STOREP_F:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->floatPtr = *var_a.floatPtr;
 			}
 			break;
 
 		case OP_STOREP_ENT:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
 			break;
 
 		case OP_STOREP_FLD:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
 			break;
 
 		case OP_STOREP_BOOL:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
 			break;
 
 		case OP_STOREP_S:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
+				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( rs->a ), MAX_STRING_LEN );
 			}
 			break;
 
 		case OP_STOREP_V:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
 			}
 			break;
 
 		case OP_STOREP_FTOS:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
 			}
 			break;
 
 		case OP_STOREP_BTOS:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				if ( *var_a.floatPtr != 0.0f ) {
 					idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
 				} else {
@@ -1678,17 +1687,17 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_STOREP_VTOS:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
 			}
 			break;
 
 		case OP_STOREP_FTOBOOL:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				if ( *var_a.floatPtr != 0.0f ) {
 					*var_b.evalPtr->intPtr = 1;
 				} else {
@@ -1698,25 +1707,25 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_STOREP_BOOLTOF:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
 			}
 			break;
 
 		case OP_STOREP_OBJ:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
 			break;
 
 		case OP_STOREP_OBJENT:
-			var_b = GetVariable( st->b );
+			var_b = GetVariable( rs->b );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( rs->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if ( !obj ) {
 					*var_b.evalPtr->entityNumberPtr = 0;
@@ -1734,22 +1743,22 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_ADDRESS:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var_c.evalPtr->bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var_c.evalPtr->bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 			} else {
 				var_c.evalPtr->bytePtr = NULL;
 			}
 			break;
 
 		case OP_INDIRECT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				*var_c.floatPtr = *var.floatPtr;
 			} else {
 				*var_c.floatPtr = 0.0f;
@@ -1757,11 +1766,11 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_INDIRECT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			} else {
 				*var_c.entityNumberPtr = 0;
@@ -1769,11 +1778,11 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_INDIRECT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				*var_c.intPtr = *var.intPtr;
 			} else {
 				*var_c.intPtr = 0;
@@ -1781,22 +1790,22 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_INDIRECT_S:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				SetString( st->c, var.stringPtr );
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
+				SetString( rs->c, var.stringPtr );
 			} else {
-				SetString( st->c, "" );
+				SetString( rs->c, "" );
 			}
 			break;
 
 		case OP_INDIRECT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				*var_c.vectorPtr = *var.vectorPtr;
 			} else {
 				var_c.vectorPtr->Zero();
@@ -1804,35 +1813,35 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_INDIRECT_OBJ:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+			var_a = GetVariable( rs->a );
+			var_c = GetVariable( rs->c );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_c.entityNumberPtr = 0;
 			} else {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ rs->b.value.ptrOffset ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			}
 			break;
 
 		case OP_PUSH_F:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			Push( *var_a.intPtr );
 			break;
 
 		case OP_PUSH_FTOS:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			PushString( FloatToString( *var_a.floatPtr ) );
 			break;
 
 		case OP_PUSH_BTOF:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			floatVal = *var_a.intPtr;
 			Push( *reinterpret_cast<int *>( &floatVal ) );
 			break;
 
 		case OP_PUSH_FTOB:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			if ( *var_a.floatPtr != 0.0f ) {
 				Push( 1 );
 			} else {
@@ -1841,36 +1850,36 @@ bool idInterpreter::Execute( void ) {
 			break;
 
 		case OP_PUSH_VTOS:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			PushString( var_a.vectorPtr->ToString() );
 			break;
 
 		case OP_PUSH_BTOS:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			PushString( *var_a.intPtr ? "true" : "false" );
 			break;
 
 		case OP_PUSH_ENT:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			Push( *var_a.entityNumberPtr );
 			break;
 
 		case OP_PUSH_S:
-			PushString( GetString( st->a ) );
+			PushString( GetString( rs->a ) );
 			break;
 
 		case OP_PUSH_V:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			PushVector(*var_a.vectorPtr);
 			break;
 
 		case OP_PUSH_OBJ:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			Push( *var_a.entityNumberPtr );
 			break;
 
 		case OP_PUSH_OBJENT:
-			var_a = GetVariable( st->a );
+			var_a = GetVariable( rs->a );
 			Push( *var_a.entityNumberPtr );
 			break;
 
@@ -1882,6 +1891,8 @@ bool idInterpreter::Execute( void ) {
 		}
 	}
 
+	statementsExecuted += MAX_RUNAWAY_STATEMENTS - runaway;
+
 	return threadDying;
 }
 
@@ -1639,6 +1639,53 @@ statement_t *idProgram::AllocStatement( void ) {
 	return ret;
 }
 
+/*
+================
+ResolveOperand
+================
+*/
+static void ResolveOperand( const idVarDef *def, resolvedOperand_t &operand ) {
+	if ( !def ) {
+		operand.value.intPtr = NULL;
+		operand.onStack = false;
+	} else if ( def->initialized == idVarDef::stackVariable ) {
+		operand.value.intPtr = NULL;
+		operand.value.stackOffset = def->value.stackOffset;
+		operand.onStack = true;
+	} else {
+		operand.value = def->value;
+		operand.onStack = false;
+	}
+}
+
+/*
+================
+idProgram::ResolveStatements
+
+Copies the values of the operands of the statements added since the last call, so
+the interpreter reads globals, constants, jump offsets and functions straight from the
+statement instead of going through the defs. The defs keep their values once the
+statements using them are compiled, and statements are only added or removed at the
+end, so they are resolved once when they are first executed.
+================
+*/
+void idProgram::ResolveStatements( void ) {
+	int i;
+
+	i = Min( resolvedStatements.Num(), statements.Num() );
+	resolvedStatements.SetGranularity( 1024 );
+	resolvedStatements.SetNum( statements.Num(), false );
+	for( ; i < statements.Num(); i++ ) {
+		const statement_t &st = statements[ i ];
+		resolvedStatement_t &resolved = resolvedStatements[ i ];
+
+		resolved.op = st.op;
+		ResolveOperand( st.a, resolved.a );
+		ResolveOperand( st.b, resolved.b );
+		ResolveOperand( st.c, resolved.c );
+	}
+}
+
 /*
 ==============
 idProgram::BeginCompilation
@@ -1945,6 +1992,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	resolvedStatements.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -1967,17 +2015,767 @@ void idProgram::Startup( const char *defaultScript ) {
 	// make sure all data is freed up
 	idThread::Restart();
 
-	// get ready for loading scripts
-	BeginCompilation();
+	// load the default script from the binary file written when it was last compiled,
+	// or compile it if any of its source files changed since then
+	if ( !defaultScript || !*defaultScript || !LoadBinaryProgram( defaultScript ) ) {
+		// get ready for loading scripts
+		BeginCompilation();
 
-	// load the default script
-	if ( defaultScript && *defaultScript ) {
-		CompileFile( defaultScript );
+		// load the default script
+		if ( defaultScript && *defaultScript ) {
+			CompileFile( defaultScript );
+			WriteBinaryProgram( defaultScript );
+		}
 	}
 
 	FinishCompilation();
 }
 
+/***********************************************************************
+
+  Binary programs
+
+  The program compiled from the default script is written to a binary file
+  with the checksums of the source files it was compiled from, and loaded
+  from it on the next startup when none of them changed.  Types, defs and
+  functions are stored by index, the built-in types and defs as negative
+  numbers.  Events are stored by name, since their numbers depend on the
+  game code, and the header has a checksum of all event definitions so the
+  file isn't used by a game build whose events have other arguments.
+
+***********************************************************************/
+
+#define SCRIPT_BINARY_FILE_EXT		"scriptb"
+#define SCRIPT_BINARY_FILEID		( ( 'S' << 24 ) | ( 'C' << 16 ) | ( 'B' << 8 ) | 'F' )
+#define SCRIPT_BINARY_FILEVERSION	2
+
+#define SCRIPT_BINARY_NULL			-1
+#define SCRIPT_BINARY_INVALID		( -0x7fffffff - 1 )
+
+// how the value of a def is stored
+enum {
+	SCRIPT_BINARY_VALUE_INT,		// stack, object or jump offset, argument size or virtual function number
+	SCRIPT_BINARY_VALUE_GLOBAL,		// offset of a global variable or constant
+	SCRIPT_BINARY_VALUE_FUNCTION	// function number
+};
+
+static idTypeDef * const scriptBinaryTypes[] = {
+	&type_void, &type_scriptevent, &type_namespace, &type_string, &type_float, &type_vector, &type_entity, &type_field,
+	&type_function, &type_virtualfunction, &type_pointer, &type_object, &type_jumpoffset, &type_argsize, &type_boolean
+};
+
+static idVarDef * const scriptBinaryDefs[] = {
+	&def_void, &def_scriptevent, &def_namespace, &def_string, &def_float, &def_vector, &def_entity, &def_field,
+	&def_function, &def_virtualfunction, &def_pointer, &def_object, &def_jumpoffset, &def_argsize, &def_boolean
+};
+
+static const int numScriptBinaryBuiltins = sizeof( scriptBinaryTypes ) / sizeof( scriptBinaryTypes[ 0 ] );
+
+/*
+================
+ScriptBinaryPointerKey
+================
+*/
+static int ScriptBinaryPointerKey( const void *ptr ) {
+	return static_cast<int>( reinterpret_cast<uintptr_t>( ptr ) >> 4 );
+}
+
+/*
+================
+ScriptBinaryTypeRef
+================
+*/
+static int ScriptBinaryTypeRef( const idTypeDef *type, const idList<idTypeDef *> &types, const idHashIndex &typeHash ) {
+	int i;
+
+	if ( !type ) {
+		return SCRIPT_BINARY_NULL;
+	}
+	for( i = typeHash.First( ScriptBinaryPointerKey( type ) ); i != -1; i = typeHash.Next( i ) ) {
+		if ( types[ i ] == type ) {
+			return i;
+		}
+	}
+	for( i = 0; i < numScriptBinaryBuiltins; i++ ) {
+		if ( scriptBinaryTypes[ i ] == type ) {
+			return -2 - i;
+		}
+	}
+	return SCRIPT_BINARY_INVALID;
+}
+
+/*
+================
+ScriptBinaryDefRef
+================
+*/
+static int ScriptBinaryDefRef( const idVarDef *def, const idList<idVarDef *> &varDefs ) {
+	int i;
+
+	if ( !def ) {
+		return SCRIPT_BINARY_NULL;
+	}
+	if ( def->num >= 0 && def->num < varDefs.Num() && varDefs[ def->num ] == def ) {
+		return def->num;
+	}
+	for( i = 0; i < numScriptBinaryBuiltins; i++ ) {
+		if ( scriptBinaryDefs[ i ] == def ) {
+			return -2 - i;
+		}
+	}
+	return SCRIPT_BINARY_INVALID;
+}
+
+/*
+================
+ScriptBinaryFunctionRef
+================
+*/
+static int ScriptBinaryFunctionRef( const function_t *func, const function_t *functions, int numFunctions ) {
+	if ( !func ) {
+		return SCRIPT_BINARY_NULL;
+	}
+	if ( func >= functions && func < functions + numFunctions ) {
+		return func - functions;
+	}
+	return SCRIPT_BINARY_INVALID;
+}
+
+/*
+================
+ScriptBinaryType
+
+returns false if the reference read from the file is invalid
+================
+*/
+static bool ScriptBinaryType( int ref, const idList<idTypeDef *> &types, idTypeDef *&type ) {
+	if ( ref >= 0 && ref < types.Num() ) {
+		type = types[ ref ];
+	} else if ( ref <= -2 && ref > -2 - numScriptBinaryBuiltins ) {
+		type = scriptBinaryTypes[ -2 - ref ];
+	} else if ( ref == SCRIPT_BINARY_NULL ) {
+		type = NULL;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+ScriptBinaryDef
+================
+*/
+static bool ScriptBinaryDef( int ref, const idList<idVarDef *> &varDefs, idVarDef *&def ) {
+	if ( ref >= 0 && ref < varDefs.Num() ) {
+		def = varDefs[ ref ];
+	} else if ( ref <= -2 && ref > -2 - numScriptBinaryBuiltins ) {
+		def = scriptBinaryDefs[ -2 - ref ];
+	} else if ( ref == SCRIPT_BINARY_NULL ) {
+		def = NULL;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+ScriptBinaryHasData
+
+returns true if count elements of the given size can still be read
+================
+*/
+static bool ScriptBinaryHasData( idFile *fp, int count, int size ) {
+	return ( count >= 0 && count <= ( fp->Length() - fp->Tell() ) / size );
+}
+
+/*
+================
+ScriptBinaryReadString
+================
+*/
+static bool ScriptBinaryReadString( idFile *fp, idStr &string ) {
+	int len;
+
+	len = -1;
+	fp->ReadInt( len );
+	if ( !ScriptBinaryHasData( fp, len, 1 ) ) {
+		return false;
+	}
+	string.Fill( ' ', len );
+	return ( fp->Read( &string[ 0 ], len ) == len );
+}
+
+/*
+================
+ScriptBinarySourceChecksums
+
+Gets the checksums of the files the program was compiled from, and of all scripts in the script
+folder, since files that only have #defines are included without adding them to the file list.
+================
+*/
+static bool ScriptBinarySourceChecksums( const idStrList &fileList, idStrList &sources, idList<unsigned int> &checksums ) {
+	idFileList	*scripts;
+	void		*buffer;
+	int			length;
+	int			i;
+
+	sources = fileList;
+	scripts = fileSystem->ListFiles( "script", ".script", true, true );
+	for( i = 0; i < scripts->GetNumFiles(); i++ ) {
+		sources.AddUnique( scripts->GetFile( i ) );
+	}
+	fileSystem->FreeFileList( scripts );
+
+	checksums.SetNum( sources.Num() );
+	for( i = 0; i < sources.Num(); i++ ) {
+		length = fileSystem->ReadFile( sources[ i ], &buffer, NULL );
+		if ( length < 0 ) {
+			return false;
+		}
+		checksums[ i ] = MD4_BlockChecksum( buffer, length );
+		fileSystem->FreeFile( buffer );
+	}
+
+	return true;
+}
+
+/*
+================
+ScriptBinaryEventChecksum
+
+Gets a checksum of the names, argument formats and return types of all event definitions.
+================
+*/
+static unsigned int ScriptBinaryEventChecksum( void ) {
+	const idEventDef	*ev;
+	idStr				events;
+	int					i;
+
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ ) {
+		ev = idEventDef::GetEventCommand( i );
+		events += va( "%s(%s)%d;", ev->GetName(), ev->GetArgFormat(), ev->GetReturnType() );
+	}
+
+	return MD4_BlockChecksum( events.c_str(), events.Length() );
+}
+
+/*
+================
+idProgram::WriteBinaryProgram
+
+Writes the compiled program next to the default script, if all the types, defs and functions it
+references can be stored.
+================
+*/
+void idProgram::WriteBinaryProgram( const char *scriptName ) const {
+	idStrList				sources;
+	idList<unsigned int>	checksums;
+	idHashIndex				typeHash;
+	idFile_Memory			data( SCRIPT_BINARY_FILE_EXT );
+	idStr					name;
+	idFile					*fp;
+	const idTypeDef			*type;
+	const idVarDef			*def;
+	const function_t		*func;
+	int						refs[ 3 ];
+	bool					valid;
+	int						kind;
+	int						i;
+	int						j;
+
+	if ( !g_scriptBinaryCache.GetBool() ) {
+		return;
+	}
+
+	if ( !ScriptBinarySourceChecksums( fileList, sources, checksums ) ) {
+		return;
+	}
+
+	typeHash.Clear( 1024, types.Num() );
+	for( i = 0; i < types.Num(); i++ ) {
+		typeHash.Add( ScriptBinaryPointerKey( types[ i ] ), i );
+	}
+
+	valid = true;
+
+	data.WriteInt( fileList.Num() );
+	for( i = 0; i < fileList.Num(); i++ ) {
+		data.WriteString( fileList[ i ] );
+	}
+
+	data.WriteInt( numVariables );
+	data.Write( variables, numVariables );
+
+	data.WriteInt( types.Num() );
+	data.WriteInt( varDefs.Num() );
+	data.WriteInt( functions.Num() );
+	data.WriteInt( statements.Num() );
+
+	for( i = 0; i < types.Num(); i++ ) {
+		type = types[ i ];
+		data.WriteInt( type->type );
+		data.WriteString( type->name );
+		data.WriteInt( type->size );
+		refs[ 0 ] = ScriptBinaryTypeRef( type->auxType, types, typeHash );
+		refs[ 1 ] = ScriptBinaryDefRef( type->def, varDefs );
+		data.WriteInt( refs[ 0 ] );
+		data.WriteInt( refs[ 1 ] );
+		valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID && refs[ 1 ] != SCRIPT_BINARY_INVALID );
+
+		data.WriteInt( type->parmTypes.Num() );
+		for( j = 0; j < type->parmTypes.Num(); j++ ) {
+			refs[ 0 ] = ScriptBinaryTypeRef( type->parmTypes[ j ], types, typeHash );
+			data.WriteInt( refs[ 0 ] );
+			data.WriteString( type->parmNames[ j ] );
+			valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID );
+		}
+
+		data.WriteInt( type->functions.Num() );
+		for( j = 0; j < type->functions.Num(); j++ ) {
+			refs[ 0 ] = ScriptBinaryFunctionRef( type->functions[ j ], functions.Ptr(), functions.Num() );
+			data.WriteInt( refs[ 0 ] );
+			valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID );
+		}
+	}
+
+	for( i = 0; i < varDefs.Num(); i++ ) {
+		def = varDefs[ i ];
+		data.WriteString( def->Name() );
+		refs[ 0 ] = ScriptBinaryDefRef( def->scope, varDefs );
+		refs[ 1 ] = ScriptBinaryTypeRef( def->TypeDef(), types, typeHash );
+		data.WriteInt( refs[ 0 ] );
+		data.WriteInt( refs[ 1 ] );
+		data.WriteInt( def->numUsers );
+		data.WriteInt( def->initialized );
+		valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID && refs[ 1 ] != SCRIPT_BINARY_INVALID );
+
+		// stack and object variables, jumps, argument sizes and virtual functions store an integer, the others
+		// point to a global, a constant or a function
+		if ( ( def->initialized == idVarDef::stackVariable ) || ( def->Type() == ev_jumpoffset ) || ( def->Type() == ev_argsize ) ||
+			( def->Type() == ev_virtualfunction ) || ( ( def->Type() != ev_function ) && def->scope && def->scope->TypeDef()->Inherits( &type_object ) ) ||
+			( def->value.bytePtr == NULL ) ) {
+			kind = SCRIPT_BINARY_VALUE_INT;
+			refs[ 0 ] = def->value.virtualFunction;
+		} else if ( def->value.bytePtr >= variables && def->value.bytePtr <= variables + numVariables ) {
+			kind = SCRIPT_BINARY_VALUE_GLOBAL;
+			refs[ 0 ] = def->value.bytePtr - variables;
+		} else {
+			kind = SCRIPT_BINARY_VALUE_FUNCTION;
+			refs[ 0 ] = ScriptBinaryFunctionRef( def->value.functionPtr, functions.Ptr(), functions.Num() );
+			valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID );
+		}
+		data.WriteInt( kind );
+		data.WriteInt( refs[ 0 ] );
+	}
+
+	for( i = 0; i < functions.Num(); i++ ) {
+		func = &functions[ i ];
+		data.WriteString( func->Name() );
+		data.WriteString( func->eventdef ? func->eventdef->GetName() : "" );
+		refs[ 0 ] = ScriptBinaryDefRef( func->def, varDefs );
+		refs[ 1 ] = ScriptBinaryTypeRef( func->type, types, typeHash );
+		data.WriteInt( refs[ 0 ] );
+		data.WriteInt( refs[ 1 ] );
+		valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID && refs[ 1 ] != SCRIPT_BINARY_INVALID );
+		data.WriteInt( func->firstStatement );
+		data.WriteInt( func->numStatements );
+		data.WriteInt( func->parmTotal );
+		data.WriteInt( func->locals );
+		data.WriteInt( func->filenum );
+		data.WriteInt( func->parmSize.Num() );
+		for( j = 0; j < func->parmSize.Num(); j++ ) {
+			data.WriteInt( func->parmSize[ j ] );
+		}
+	}
+
+	for( i = 0; i < statements.Num(); i++ ) {
+		const statement_t &statement = statements[ i ];
+		data.WriteUnsignedShort( statement.op );
+		data.WriteUnsignedShort( statement.flags );
+		data.WriteUnsignedShort( statement.linenumber );
+		data.WriteUnsignedShort( statement.file );
+		refs[ 0 ] = ScriptBinaryDefRef( statement.a, varDefs );
+		refs[ 1 ] = ScriptBinaryDefRef( statement.b, varDefs );
+		refs[ 2 ] = ScriptBinaryDefRef( statement.c, varDefs );
+		data.WriteInt( refs[ 0 ] );
+		data.WriteInt( refs[ 1 ] );
+		data.WriteInt( refs[ 2 ] );
+		valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID && refs[ 1 ] != SCRIPT_BINARY_INVALID && refs[ 2 ] != SCRIPT_BINARY_INVALID );
+	}
+
+	refs[ 0 ] = ScriptBinaryDefRef( returnDef, varDefs );
+	refs[ 1 ] = ScriptBinaryDefRef( returnStringDef, varDefs );
+	refs[ 2 ] = ScriptBinaryDefRef( sysDef, varDefs );
+	data.WriteInt( refs[ 0 ] );
+	data.WriteInt( refs[ 1 ] );
+	data.WriteInt( refs[ 2 ] );
+	valid &= ( refs[ 0 ] != SCRIPT_BINARY_INVALID && refs[ 1 ] != SCRIPT_BINARY_INVALID && refs[ 2 ] != SCRIPT_BINARY_INVALID );
+
+	name = scriptName;
+	name.SetFileExtension( SCRIPT_BINARY_FILE_EXT );
+
+	if ( !valid ) {
+		gameLocal.Warning( "idProgram::WriteBinaryProgram: couldn't store all references of the program, not writing %s", name.c_str() );
+		return;
+	}
+
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		gameLocal.Warning( "idProgram::WriteBinaryProgram: Error opening file %s", name.c_str() );
+		return;
+	}
+
+	fp->WriteInt( SCRIPT_BINARY_FILEID );
+	fp->WriteInt( SCRIPT_BINARY_FILEVERSION );
+	fp->WriteInt( sizeof( intptr_t ) );
+	fp->WriteInt( NUM_OPCODES );
+	fp->WriteUnsignedInt( ScriptBinaryEventChecksum() );
+	fp->WriteInt( sources.Num() );
+	for( i = 0; i < sources.Num(); i++ ) {
+		fp->WriteString( sources[ i ] );
+		fp->WriteUnsignedInt( checksums[ i ] );
+	}
+	fp->Write( data.GetDataPtr(), data.Length() );
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+idProgram::ReadBinaryProgram
+
+Reads the program after the header of the binary file.  Returns false if the file is corrupt.
+================
+*/
+bool idProgram::ReadBinaryProgram( idFile *fp ) {
+	idTypeDef		*type;
+	idVarDef		*def;
+	function_t		*func;
+	idStr			str;
+	int				numTypes;
+	int				numDefs;
+	int				numFunctions;
+	int				numStatements;
+	int				num;
+	int				value;
+	int				refs[ 3 ];
+	int				i;
+	int				j;
+
+	num = -1;
+	fp->ReadInt( num );
+	if ( !ScriptBinaryHasData( fp, num, sizeof( int ) ) ) {
+		return false;
+	}
+	for( i = 0; i < num; i++ ) {
+		if ( !ScriptBinaryReadString( fp, str ) ) {
+			return false;
+		}
+		fileList.Append( str );
+	}
+
+	numVariables = -1;
+	fp->ReadInt( numVariables );
+	if ( numVariables < 0 || numVariables > MAX_GLOBALS || fp->Read( variables, numVariables ) != numVariables ) {
+		numVariables = 0;
+		return false;
+	}
+
+	numTypes = numDefs = numFunctions = numStatements = -1;
+	fp->ReadInt( numTypes );
+	fp->ReadInt( numDefs );
+	fp->ReadInt( numFunctions );
+	fp->ReadInt( numStatements );
+	if ( !ScriptBinaryHasData( fp, numTypes, sizeof( int ) * 6 ) || !ScriptBinaryHasData( fp, numDefs, sizeof( int ) * 7 ) ||
+		numFunctions < 0 || numFunctions > functions.Max() || numStatements < 0 || numStatements > statements.Max() ) {
+		return false;
+	}
+
+	// allocate everything first, since the types, defs and functions reference each other in any order
+	for( i = 0; i < numTypes; i++ ) {
+		AllocType( ev_void, NULL, "", 0, NULL );
+	}
+	for( i = 0; i < numDefs; i++ ) {
+		def = new idVarDef();
+		def->num = varDefs.Append( def );
+	}
+	functions.SetNum( numFunctions );
+	statements.SetNum( numStatements );
+
+	for( i = 0; i < numTypes; i++ ) {
+		type = types[ i ];
+		value = ev_error;
+		fp->ReadInt( value );
+		if ( value < ev_void || value > ev_boolean || !ScriptBinaryReadString( fp, type->name ) ) {
+			return false;
+		}
+		type->type = static_cast<etype_t>( value );
+		fp->ReadInt( type->size );
+		fp->ReadInt( refs[ 0 ] );
+		fp->ReadInt( refs[ 1 ] );
+		if ( !ScriptBinaryType( refs[ 0 ], types, type->auxType ) || !ScriptBinaryDef( refs[ 1 ], varDefs, type->def ) ) {
+			return false;
+		}
+
+		num = -1;
+		fp->ReadInt( num );
+		if ( !ScriptBinaryHasData( fp, num, sizeof( int ) * 2 ) ) {
+			return false;
+		}
+		type->parmTypes.SetNum( num );
+		type->parmNames.SetNum( num );
+		for( j = 0; j < num; j++ ) {
+			fp->ReadInt( refs[ 0 ] );
+			if ( !ScriptBinaryType( refs[ 0 ], types, type->parmTypes[ j ] ) || !ScriptBinaryReadString( fp, type->parmNames[ j ] ) ) {
+				return false;
+			}
+		}
+
+		num = -1;
+		fp->ReadInt( num );
+		if ( !ScriptBinaryHasData( fp, num, sizeof( int ) ) ) {
+			return false;
+		}
+		type->functions.SetNum( num );
+		for( j = 0; j < num; j++ ) {
+			refs[ 0 ] = SCRIPT_BINARY_INVALID;
+			fp->ReadInt( refs[ 0 ] );
+			if ( refs[ 0 ] < 0 || refs[ 0 ] >= numFunctions ) {
+				return false;
+			}
+			type->functions[ j ] = &functions[ refs[ 0 ] ];
+		}
+	}
+
+	for( i = 0; i < numDefs; i++ ) {
+		def = varDefs[ i ];
+		if ( !ScriptBinaryReadString( fp, str ) ) {
+			return false;
+		}
+		// added in the same order as they were compiled, so defs with the same name are found in the same order
+		AddDefToNameList( def, str );
+
+		fp->ReadInt( refs[ 0 ] );
+		fp->ReadInt( refs[ 1 ] );
+		if ( !ScriptBinaryDef( refs[ 0 ], varDefs, def->scope ) || !ScriptBinaryType( refs[ 1 ], types, type ) ) {
+			return false;
+		}
+		def->SetTypeDef( type );
+		fp->ReadInt( def->numUsers );
+		value = -1;
+		fp->ReadInt( value );
+		if ( value < idVarDef::uninitialized || value > idVarDef::stackVariable ) {
+			return false;
+		}
+		def->initialized = static_cast<idVarDef::initialized_t>( value );
+
+		value = -1;
+		fp->ReadInt( value );
+		fp->ReadInt( refs[ 0 ] );
+		switch( value ) {
+		case SCRIPT_BINARY_VALUE_INT:
+			def->value.virtualFunction = refs[ 0 ];
+			break;
+		case SCRIPT_BINARY_VALUE_GLOBAL:
+			if ( refs[ 0 ] < 0 || refs[ 0 ] > numVariables ) {
+				return false;
+			}
+			def->value.bytePtr = &variables[ refs[ 0 ] ];
+			break;
+		case SCRIPT_BINARY_VALUE_FUNCTION:
+			if ( refs[ 0 ] < 0 || refs[ 0 ] >= numFunctions ) {
+				return false;
+			}
+			def->value.functionPtr = &functions[ refs[ 0 ] ];
+			break;
+		default:
+			return false;
+		}
+	}
+
+	for( i = 0; i < numFunctions; i++ ) {
+		func = &functions[ i ];
+		func->Clear();
+		func->parmSize.SetGranularity( 1 );
+		if ( !ScriptBinaryReadString( fp, str ) ) {
+			return false;
+		}
+		func->SetName( str );
+		if ( !ScriptBinaryReadString( fp, str ) ) {
+			return false;
+		}
+		func->eventdef = NULL;
+		if ( str.Length() ) {
+			func->eventdef = idEventDef::FindEvent( str );
+			if ( !func->eventdef ) {
+				return false;
+			}
+		}
+		fp->ReadInt( refs[ 0 ] );
+		fp->ReadInt( refs[ 1 ] );
+		if ( !ScriptBinaryDef( refs[ 0 ], varDefs, func->def ) || !ScriptBinaryType( refs[ 1 ], types, type ) ) {
+			return false;
+		}
+		func->type = type;
+		fp->ReadInt( func->firstStatement );
+		fp->ReadInt( func->numStatements );
+		fp->ReadInt( func->parmTotal );
+		fp->ReadInt( func->locals );
+		fp->ReadInt( func->filenum );
+		if ( func->firstStatement < 0 || func->numStatements < 0 || func->firstStatement + func->numStatements > numStatements ) {
+			return false;
+		}
+
+		num = -1;
+		fp->ReadInt( num );
+		if ( !ScriptBinaryHasData( fp, num, sizeof( int ) ) ) {
+			return false;
+		}
+		func->parmSize.SetNum( num );
+		for( j = 0; j < num; j++ ) {
+			fp->ReadInt( func->parmSize[ j ] );
+		}
+	}
+
+	if ( !ScriptBinaryHasData( fp, numStatements, sizeof( unsigned short ) * 4 + sizeof( int ) * 3 ) ) {
+		return false;
+	}
+	for( i = 0; i < numStatements; i++ ) {
+		statement_t &statement = statements[ i ];
+		fp->ReadUnsignedShort( statement.op );
+		fp->ReadUnsignedShort( statement.flags );
+		fp->ReadUnsignedShort( statement.linenumber );
+		fp->ReadUnsignedShort( statement.file );
+		fp->ReadInt( refs[ 0 ] );
+		fp->ReadInt( refs[ 1 ] );
+		fp->ReadInt( refs[ 2 ] );
+		if ( statement.op >= NUM_OPCODES || statement.file >= fileList.Num() || !ScriptBinaryDef( refs[ 0 ], varDefs, statement.a ) ||
+			!ScriptBinaryDef( refs[ 1 ], varDefs, statement.b ) || !ScriptBinaryDef( refs[ 2 ], varDefs, statement.c ) ) {
+			return false;
+		}
+	}
+
+	refs[ 0 ] = refs[ 1 ] = refs[ 2 ] = SCRIPT_BINARY_INVALID;
+	fp->ReadInt( refs[ 0 ] );
+	fp->ReadInt( refs[ 1 ] );
+	fp->ReadInt( refs[ 2 ] );
+	if ( !ScriptBinaryDef( refs[ 0 ], varDefs, returnDef ) || !ScriptBinaryDef( refs[ 1 ], varDefs, returnStringDef ) ||
+		!ScriptBinaryDef( refs[ 2 ], varDefs, sysDef ) || !returnDef || !returnStringDef || !sysDef ) {
+		return false;
+	}
+
+	return ( fp->Tell() == fp->Length() );
+}
+
+/*
+================
+idProgram::LoadBinaryProgram
+
+Loads the program compiled from the default script from its binary file.  Returns false if there is
+no binary file, or if it is outdated or corrupt.
+================
+*/
+bool idProgram::LoadBinaryProgram( const char *scriptName ) {
+	idStr					name;
+	unsigned int			checksum;
+	void					*buffer;
+	void					*source;
+	int						length;
+	int						fileId;
+	int						version;
+	int						pointerSize;
+	int						numOpcodes;
+	unsigned int			eventChecksum;
+	int						num;
+	int						i;
+
+	if ( !g_scriptBinaryCache.GetBool() ) {
+		return false;
+	}
+
+	name = scriptName;
+	name.SetFileExtension( SCRIPT_BINARY_FILE_EXT );
+	length = fileSystem->ReadFile( name, &buffer, NULL );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	idFile_Memory fp( name, (const char *)buffer, length );
+
+	fileId = version = pointerSize = numOpcodes = 0;
+	eventChecksum = 0;
+	fp.ReadInt( fileId );
+	fp.ReadInt( version );
+	fp.ReadInt( pointerSize );
+	fp.ReadInt( numOpcodes );
+	fp.ReadUnsignedInt( eventChecksum );
+	if ( fileId != SCRIPT_BINARY_FILEID || version != SCRIPT_BINARY_FILEVERSION || pointerSize != sizeof( intptr_t ) || numOpcodes != NUM_OPCODES ) {
+		gameLocal.Printf( "%s has a different version\n", name.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	// the event definitions are compiled into the game code, so another build may have changed them
+	if ( eventChecksum != ScriptBinaryEventChecksum() ) {
+		gameLocal.Printf( "%s was written by a game build with different events\n", name.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	// don't use the binary file if any of the scripts changed since it was written
+	num = -1;
+	fp.ReadInt( num );
+	if ( !ScriptBinaryHasData( &fp, num, sizeof( int ) * 2 ) ) {
+		gameLocal.Warning( "%s is corrupt", name.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+	for( i = 0; i < num; i++ ) {
+		checksum = 0;
+		if ( !ScriptBinaryReadString( &fp, name ) || fp.ReadUnsignedInt( checksum ) != sizeof( checksum ) ) {
+			gameLocal.Warning( "%s is corrupt", fp.GetName() );
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+		length = fileSystem->ReadFile( name, &source, NULL );
+		if ( length < 0 ) {
+			gameLocal.Printf( "%s was compiled from %s, which doesn't exist anymore\n", fp.GetName(), name.c_str() );
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+		if ( MD4_BlockChecksum( source, length ) != checksum ) {
+			gameLocal.Printf( "%s is older than %s\n", fp.GetName(), name.c_str() );
+			fileSystem->FreeFile( source );
+			fileSystem->FreeFile( buffer );
+			return false;
+		}
+		fileSystem->FreeFile( source );
+	}
+
+	FreeData();
+
+	if ( !ReadBinaryProgram( &fp ) ) {
+		gameLocal.Warning( "%s is corrupt", fp.GetName() );
+		FreeData();
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	fileSystem->FreeFile( buffer );
+
+	gameLocal.Printf( "Loaded compiled script %s\n", fp.GetName() );
+
+	CompileStats();
+
+	if ( g_disasm.GetBool() ) {
+		Disassemble();
+	}
+
+	return true;
+}
+
 /*
 ================
 idProgram::Save
@@ -2156,6 +2954,7 @@ void idProgram::Restart( void ) {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	resolvedStatements.SetNum( Min( resolvedStatements.Num(), top_statements ), false );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
@@ -129,4 +129,7 @@ dhewm WIP		42
 
 // threads
 
-#define MAX_THREADS				(10)
+#define MAX_THREADS				(20)
+
+// worker threads used by Sys_RunJobs()
+#define MAX_JOB_THREADS			(8)
@@ -260,6 +260,7 @@ public:
 	void					Restore( idRestoreGame *savefile );
 
 	virtual void			Think( void );
+	virtual bool			RunsPhysicsFirst( void ) { return true; }
 	void					KeepRunningPhysics( void ) { keepRunningPhysics = true; }
 
 private:
@@ -43,6 +43,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "Mover.h"
 #include "WorldSpawn.h"
 #include "SmokeParticles.h"
+#include "ai/AI.h"
 
 #include "Entity.h"
 
@@ -1454,7 +1455,12 @@ bool idEntity::UpdateRenderEntity( renderEntity_s *renderEntity, const renderVie
 
 	idAnimator *animator = GetAnimator();
 	if ( animator ) {
-		return animator->CreateFrame( gameLocal.time, false );
+		bool skipDetail;
+		int animTime = gameLocal.AnimationLODTime( this, skipDetail );
+		animator->SetLastRenderFrame( gameLocal.framenum );
+		// a frame created ahead of time by idGameLocal::CreateAnimationFrames is reported once
+		bool createdAhead = animator->TakeFrameCreatedAhead();
+		return animator->CreateFrame( animTime, false, skipDetail ) || createdAhead;
 	}
 
 	return false;
@@ -2530,6 +2536,18 @@ idPhysics *idEntity::GetPhysics( void ) const {
 	return physics;
 }
 
+/*
+================
+idEntity::RunsPhysicsFirst
+
+  Entities returning true may have their articulated figure solved ahead
+  of the think, see idPhysics_AF::StartConcurrentStep.
+================
+*/
+bool idEntity::RunsPhysicsFirst( void ) {
+	return false;
+}
+
 /*
 ================
 idEntity::RunPhysics
@@ -3592,6 +3610,8 @@ void idEntity::Teleport( const idVec3 &origin, const idAngles &angles, idEntity
 	GetPhysics()->SetAxis( angles.ToMat3() );
 
 	UpdateVisuals();
+
+	idAI::InvalidateObstacleHash();
 }
 
 /*
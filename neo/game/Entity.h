@@ -267,6 +267,8 @@ public:
 	void					RestorePhysics( idPhysics *phys );
 							// run the physics for this entity
 	bool					RunPhysics( void );
+							// true if Think() runs the physics before doing anything that could change it
+	virtual bool			RunsPhysicsFirst( void );
 							// set the origin of the physics object (relative to bindMaster if not NULL)
 	void					SetOrigin( const idVec3 &org );
 							// set the axis of the physics object (relative to bindMaster if not NULL)
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
 #include "idlib/Timer.h"
+#include "idlib/geometry/JointTransform.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/BuildVersion.h"
 #include "framework/DeclEntityDef.h"
@@ -229,6 +230,9 @@ void idGameLocal::Clear( void ) {
 	aasNames.Clear();
 	lastAIAlertEntity = NULL;
 	lastAIAlertTime = 0;
+	animLODFrame = -1;
+	concurrentEntities.Clear();
+	concurrentPhysics.Clear();
 	spawnArgs.Clear();
 	gravity.Set( 0, 0, -1 );
 	playerPVS.h = (unsigned int)-1;
@@ -944,6 +948,7 @@ void idGameLocal::LoadMap( const char *mapName, int randseed ) {
 
 	lastAIAlertEntity = NULL;
 	lastAIAlertTime = 0;
+	animLODFrame = -1;
 
 	previousTime	= 0;
 	time			= 0;
@@ -1483,6 +1488,9 @@ bool idGameLocal::InitFromSaveGame( const char *mapName, idRenderWorld *renderWo
 	// free up any unused animations
 	animationLib.FlushUnusedAnims();
 
+	// the frame number was restored, so the obstacle hash may look current
+	idAI::InvalidateObstacleHash();
+
 	gamestate = GAMESTATE_ACTIVE;
 
 	return true;
@@ -1552,6 +1560,9 @@ void idGameLocal::MapShutdown( void ) {
 
 	MapClear( true );
 
+	// the frame number starts over with the next map
+	idAI::InvalidateObstacleHash();
+
 	// reset the script to the state it was before the map was started
 	program.Restart();
 
@@ -2224,6 +2235,379 @@ void idGameLocal::SortActiveEntityList( void ) {
 	sortPushers = false;
 }
 
+/*
+================
+ThinkEntityCompare
+================
+*/
+typedef struct thinkEntity_s {
+	idEntity *				ent;
+	idBounds				bounds;			// anything the entity may touch during the frame
+	int						group;
+	int						order;			// position in the active entity list
+} thinkEntity_t;
+
+static int ThinkEntityCompare( const thinkEntity_t *a, const thinkEntity_t *b ) {
+	if ( a->bounds[0][0] < b->bounds[0][0] ) {
+		return -1;
+	}
+	if ( a->bounds[0][0] > b->bounds[0][0] ) {
+		return 1;
+	}
+	return a->order - b->order;
+}
+
+/*
+================
+FindThinkGroup
+================
+*/
+static int FindThinkGroup( int *groups, int group ) {
+	while( groups[group] != group ) {
+		groups[group] = groups[groups[group]];
+		group = groups[group];
+	}
+	return group;
+}
+
+/*
+================
+ConcurrentStepsJob
+================
+*/
+static void ConcurrentStepsJob( void *data, int jobNum ) {
+	idPhysics **physics = (idPhysics **) data;
+
+	physics[jobNum]->EvaluateConcurrentStep();
+}
+
+/*
+================
+idGameLocal::ScheduleThink
+
+  Groups the active entities by dependency and evaluates the physics of independent groups
+  on the job threads before the entities think. The entities of a team form one group, and
+  groups that may touch each other during the frame are merged. Only the first entity of a
+  group in think order runs ahead, every other entity of the group may be moved by the ones
+  that think before it. That entity must not be part of a team.
+  The job threads don't change anything outside the physics objects: the steps are committed
+  when the entities think, which moves the clip models, applies the impulses and sends the
+  events in the usual order, and the physics objects evaluate the step serially instead if
+  anything it depends on changed in the mean time. The animation frames are created on the
+  job threads by CreateAnimationFrames once the entities thought.
+================
+*/
+void idGameLocal::ScheduleThink( void ) {
+	int i, j, a, b, timeStep;
+	int groups[MAX_GENTITIES];
+	bool scheduled[MAX_GENTITIES];
+	idEntity *ent;
+	idPhysics *physics;
+	thinkEntity_t *entity;
+	idList<thinkEntity_t> entities;
+
+	if ( !g_parallelThink.GetBool() || isMultiplayer || inCinematic || sys->GetNumJobThreads() <= 0 ) {
+		return;
+	}
+
+	timeStep = time - previousTime;
+
+	// every team starts out as a group of its own
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		physics = ent->GetPhysics();
+		a = ent->GetTeamMaster() ? ent->GetTeamMaster()->entityNumber : ent->entityNumber;
+		groups[a] = a;
+		scheduled[a] = false;
+
+		// entities without contents don't collide with anything
+		if ( !physics->GetContents() || physics->GetAbsBounds().IsCleared() ) {
+			continue;
+		}
+
+		entity = &entities.Alloc();
+		entity->ent = ent;
+		entity->bounds = physics->GetAbsBounds();
+		entity->bounds.ExpandSelf( physics->GetLinearVelocity().Length() * MS2SEC( timeStep ) + CM_CLIP_EPSILON + 2.0f );
+		entity->group = a;
+		entity->order = entities.Num() - 1;
+	}
+
+	// merge the groups of entities that may touch each other
+	entities.Sort( ThinkEntityCompare );
+	for ( i = 0; i < entities.Num(); i++ ) {
+		for ( j = i + 1; j < entities.Num() && entities[j].bounds[0][0] <= entities[i].bounds[1][0]; j++ ) {
+			if ( !entities[i].bounds.IntersectsBounds( entities[j].bounds ) ) {
+				continue;
+			}
+			a = FindThinkGroup( groups, entities[i].group );
+			b = FindThinkGroup( groups, entities[j].group );
+			if ( a != b ) {
+				groups[Max( a, b )] = Min( a, b );
+			}
+		}
+	}
+
+	// the first entity of each group in think order may run ahead
+	concurrentEntities.SetNum( 0, false );
+	concurrentPhysics.SetNum( 0, false );
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		physics = ent->GetPhysics();
+		if ( !physics->GetContents() || physics->GetAbsBounds().IsCleared() ) {
+			continue;
+		}
+		a = FindThinkGroup( groups, ent->GetTeamMaster() ? ent->GetTeamMaster()->entityNumber : ent->entityNumber );
+		if ( scheduled[a] ) {
+			continue;
+		}
+		scheduled[a] = true;
+
+		// the physics of team members is evaluated together by the team master
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->GetTeamMaster() || ent->fl.solidForTeam ) {
+			continue;
+		}
+		if ( physics->StartConcurrentStep( timeStep, time ) ) {
+			concurrentEntities.Alloc() = ent;
+			concurrentPhysics.Append( physics );
+		}
+	}
+
+	if ( concurrentPhysics.Num() > 1 ) {
+		sys->RunJobs( ConcurrentStepsJob, concurrentPhysics.Ptr(), concurrentPhysics.Num() );
+	} else {
+		for ( i = 0; i < concurrentPhysics.Num(); i++ ) {
+			ConcurrentStepsJob( concurrentPhysics.Ptr(), i );
+		}
+	}
+
+	for ( i = 0; i < concurrentPhysics.Num(); i++ ) {
+		concurrentPhysics[i]->FinishConcurrentStep();
+	}
+}
+
+/*
+================
+idGameLocal::CancelConcurrentSteps
+
+  Throws away the steps evaluated by ScheduleThink that weren't committed because
+  the entity stopped thinking before its turn.
+================
+*/
+void idGameLocal::CancelConcurrentSteps( void ) {
+	int i;
+
+	for ( i = 0; i < concurrentPhysics.Num(); i++ ) {
+		if ( concurrentEntities[i].GetEntity() != NULL ) {
+			concurrentPhysics[i]->CancelConcurrentStep();
+		}
+	}
+	concurrentEntities.SetNum( 0, false );
+	concurrentPhysics.SetNum( 0, false );
+}
+
+/*
+================
+idGameLocal::RestRigidBodyIslands
+
+  Puts islands of touching rigid bodies that stopped moving to rest together.
+================
+*/
+void idGameLocal::RestRigidBodyIslands( void ) {
+	idEntity *ent;
+	idList<idPhysics_RigidBody *> bodies;
+
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+			continue;
+		}
+		if ( ent->GetPhysics()->IsAtRest() ) {
+			continue;
+		}
+		bodies.Append( static_cast<idPhysics_RigidBody *>( ent->GetPhysics() ) );
+	}
+
+	idPhysics_RigidBody::RestIslands( bodies.Ptr(), bodies.Num() );
+}
+
+/*
+================
+idGameLocal::AnimationLODTime
+
+  Returns the time the animation frame of an entity is created at for the renderer. Entities
+  further than g_animLODDistance from the view, scaled by the zoom, reuse their frame for up to
+  g_animLODMaxInterval game frames, spread over the frames by entity number, and entities more
+  than twice as far skip the eyelids channel. Game code that needs joints, like attachments bound
+  to a joint, articulated figures and IK, creates the frame at the current time itself.
+================
+*/
+int idGameLocal::AnimationLODTime( idEntity *ent, bool &skipDetail ) {
+	skipDetail = false;
+
+	if ( !g_animLOD.GetBool() || g_animLODDistance.GetFloat() <= 0.0f ) {
+		return time;
+	}
+
+	idAnimator *animator = ent->GetAnimator();
+	if ( !animator ) {
+		return time;
+	}
+
+	// the view of the local player doesn't change during a frame
+	if ( animLODFrame != framenum ) {
+		idPlayer *player = GetLocalPlayer();
+		const renderView_t *view = player ? player->GetRenderView() : NULL;
+		animLODFrame = framenum;
+		animLODScale = 0.0f;
+		if ( view && view->fov_x > 0.0f ) {
+			animLODOrigin = view->vieworg;
+			animLODScale = Min( view->fov_x / 90.0f, 1.0f ) / g_animLODDistance.GetFloat();
+		}
+	}
+	if ( animLODScale <= 0.0f || ent == GetLocalPlayer() ) {
+		return time;
+	}
+
+	float distance = ( ent->GetPhysics()->GetOrigin() - animLODOrigin ).LengthFast() * animLODScale;
+	if ( distance <= 1.0f ) {
+		return time;
+	}
+	skipDetail = ( distance > 2.0f );
+
+	int interval = Min( 1 + (int)distance, g_animLODMaxInterval.GetInteger() );
+	int lastTime = animator->LastFrameTime();
+	if ( interval <= 1 || lastTime < 0 || lastTime > time || ( framenum + ent->entityNumber ) % interval == 0 ) {
+		return time;
+	}
+
+	// keep the last frame until it's interval frames old
+	if ( time - lastTime >= interval * USERCMD_MSEC ) {
+		return time;
+	}
+	return lastTime;
+}
+
+/*
+================
+AnimationFramesJob
+================
+*/
+typedef struct animFramesJob_s {
+	idAnimator **			animators;
+	const int *				times;
+	const bool *			skipDetail;
+	const int *				firstAnimator;		// first animator of each team, with one past the last one at the end
+	bool *					created;
+} animFramesJob_t;
+
+static void AnimationFramesJob( void *data, int jobNum ) {
+	animFramesJob_t *job = (animFramesJob_t *) data;
+
+	for ( int i = job->firstAnimator[jobNum]; i < job->firstAnimator[jobNum + 1]; i++ ) {
+		job->created[i] = job->animators[i]->CreateFrameAhead( job->times[i], job->skipDetail[i] );
+	}
+}
+
+/*
+================
+idGameLocal::CreateAnimationFrames
+
+  Creates the animation frames of the animating entities in the player PVS on the job threads
+  once the game state of the frame is final, instead of one after the other when the renderer
+  asks for them. The entities of a team are handled by the same job in team order. Creating a
+  frame only reads the animation state and writes the joints of the entity itself, so the joints
+  are the same as if they had been created when the entity is drawn. The renderer callback still
+  reports the new frame so the dynamic model is regenerated even if the entity wasn't presented.
+  With g_animLOD only entities the renderer asked for in the last frame are created ahead, at the
+  time their level of detail asks for. With g_checkParallelThink the frames are created again
+  serially and compared.
+================
+*/
+void idGameLocal::CreateAnimationFrames( void ) {
+	int i, numJoints, animTime;
+	bool skipDetail;
+	idEntity *ent, *master, *part;
+	idAnimator *animator;
+	idJointMat *joints;
+	bool teamDone[MAX_GENTITIES];
+	idList<idAnimator *> animators;
+	idList<int> times, firstAnimator;
+	idList<bool> skipDetails;
+	idList<idJointMat> parallelJoints;
+	bool *created;
+	animFramesJob_t job;
+
+	if ( !g_parallelThink.GetBool() || isMultiplayer || sys->GetNumJobThreads() <= 0 ) {
+		return;
+	}
+	// debug output can't be printed from the job threads
+	if ( g_debugAnim.GetInteger() != -1 || ( inCinematic && skipCinematic ) ) {
+		return;
+	}
+
+	memset( teamDone, 0, sizeof( teamDone ) );
+	for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		master = ent->GetTeamMaster() ? ent->GetTeamMaster() : ent;
+		if ( teamDone[master->entityNumber] ) {
+			continue;
+		}
+		teamDone[master->entityNumber] = true;
+
+		firstAnimator.Append( animators.Num() );
+		for ( part = master; part != NULL; part = part->GetNextTeamEntity() ) {
+			animator = part->GetAnimator();
+			if ( !animator || part->IsHidden() || !InPlayerPVS( part ) ) {
+				continue;
+			}
+			// entities out of view are only animated when game code needs their joints
+			if ( g_animLOD.GetBool() && animator->LastRenderFrame() < framenum - 1 ) {
+				continue;
+			}
+			animTime = AnimationLODTime( part, skipDetail );
+			if ( !animator->IsAnimating( animTime ) ) {
+				continue;
+			}
+			animators.Append( animator );
+			times.Append( animTime );
+			skipDetails.Append( skipDetail );
+		}
+		// drop teams without animating entities
+		if ( firstAnimator[firstAnimator.Num() - 1] == animators.Num() ) {
+			firstAnimator.RemoveIndex( firstAnimator.Num() - 1 );
+		}
+	}
+
+	// not worth it for a single team
+	if ( firstAnimator.Num() < 2 ) {
+		return;
+	}
+	firstAnimator.Append( animators.Num() );
+
+	created = (bool *) _alloca16( animators.Num() * sizeof( bool ) );
+
+	job.animators = animators.Ptr();
+	job.times = times.Ptr();
+	job.skipDetail = skipDetails.Ptr();
+	job.firstAnimator = firstAnimator.Ptr();
+	job.created = created;
+	sys->RunJobs( AnimationFramesJob, &job, firstAnimator.Num() - 1 );
+
+	if ( !g_checkParallelThink.GetBool() ) {
+		return;
+	}
+
+	for ( i = 0; i < animators.Num(); i++ ) {
+		if ( !created[i] ) {
+			continue;
+		}
+		animators[i]->GetJoints( &numJoints, &joints );
+		parallelJoints.SetNum( numJoints, false );
+		memcpy( parallelJoints.Ptr(), joints, numJoints * sizeof( joints[0] ) );
+		animators[i]->CreateFrame( times[i], true, skipDetails[i] );
+		if ( memcmp( parallelJoints.Ptr(), joints, numJoints * sizeof( joints[0] ) ) != 0 ) {
+			Warning( "animation frame of entity '%s' created on a job thread differs from the serial one", animators[i]->GetEntity()->name.c_str() );
+		}
+	}
+}
+
 /*
 ================
 idGameLocal::RunFrame
@@ -2309,6 +2693,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 		timer_think.Clear();
 		timer_think.Start();
 
+		// evaluate the physics of independent groups of entities on the job threads
+		ScheduleThink();
+
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
 			num = 0;
@@ -2347,6 +2734,12 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 			}
 		}
 
+		// throw away the physics evaluated for entities that didn't think
+		CancelConcurrentSteps();
+
+		// put stacks of rigid bodies that stopped moving to rest
+		RestRigidBodyIslands();
+
 		// remove any entities that have stopped thinking
 		if ( numEntitiesToDeactivate ) {
 			idEntity *next_ent;
@@ -2371,6 +2764,12 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 
 		timer_events.Stop();
 
+		// answer the path queries the AI queued while thinking
+		ProcessAASPathQueries();
+
+		// create the animation frames of the visible entities on the job threads
+		CreateAnimationFrames();
+
 		// free the player pvs
 		FreePlayerPVS();
 
@@ -2386,6 +2785,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds ) {
 				timer_think.Milliseconds(), timer_events.Milliseconds(), num );
 		}
 
+		// list the events that were processed most often this frame
+		idClass::PrintEventStats();
+
 		// build the return value
 		ret.consistencyHash = 0;
 		ret.sessionCommand[0] = 0;
@@ -2961,6 +3363,32 @@ void idGameLocal::RemoveAllAASObstacles( void ) {
 	}
 }
 
+/*
+==================
+idGameLocal::ProcessAASPathQueries
+
+  answers at most aas_pathQueryBudget path queries per frame, starting with a
+  different area system every frame so all of them get a share of the budget
+==================
+*/
+void idGameLocal::ProcessAASPathQueries( void ) {
+	int i, budget;
+
+	if ( !aasList.Num() ) {
+		return;
+	}
+
+	budget = aas_pathQueryBudget.GetInteger();
+	if ( budget <= 0 ) {
+		// answer everything that was queued before the budget was disabled
+		budget = MAX_GENTITIES;
+	}
+
+	for( i = 0; i < aasList.Num() && budget > 0; i++ ) {
+		budget -= aasList[ ( i + framenum ) % aasList.Num() ]->ProcessPathQueries( budget );
+	}
+}
+
 /*
 ==================
 idGameLocal::CheatsOk
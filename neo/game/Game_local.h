@@ -79,6 +79,7 @@ class idTypeInfo;
 class idThread;
 class idEditEntities;
 class idLocationEntity;
+class idPhysics;
 
 //============================================================================
 extern const int NUM_RENDER_PORTAL_BITS;
@@ -365,6 +366,8 @@ public:
 	aasHandle_t				AddAASObstacle( const idBounds &bounds );
 	void					RemoveAASObstacle( const aasHandle_t handle );
 	void					RemoveAllAASObstacles( void );
+	void					ProcessAASPathQueries( void );
+	int						AnimationLODTime( idEntity *ent, bool &skipDetail );
 
 	bool					CheatsOk( bool requirePlayer = true );
 	void					SetSkill( int value );
@@ -470,6 +473,13 @@ private:
 	idEntityPtr<idActor>	lastAIAlertEntity;
 	int						lastAIAlertTime;
 
+	int						animLODFrame;			// frame the animation level of detail view was set up for
+	idVec3					animLODOrigin;
+	float					animLODScale;			// zoom divided by g_animLODDistance, 0 without a view
+
+	idList< idEntityPtr<idEntity> > concurrentEntities;	// entities with a step evaluated by ScheduleThink
+	idList<idPhysics *>		concurrentPhysics;		// physics of those entities
+
 	idDict					spawnArgs;				// spawn args used during entity spawning  FIXME: shouldn't be necessary anymore
 
 	pvsHandle_t				playerPVS;				// merged pvs of all players
@@ -515,6 +525,10 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					ScheduleThink( void );
+	void					CancelConcurrentSteps( void );
+	void					RestRigidBodyIslands( void );
+	void					CreateAnimationFrames( void );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
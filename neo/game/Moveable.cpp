@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "renderer/ModelManager.h"
 
 #include "Fx.h"
+#include "ai/AI.h"
 
 #include "Moveable.h"
 
@@ -179,6 +180,9 @@ void idMoveable::Spawn( void ) {
 	allowStep = spawnArgs.GetBool( "allowStep", "1" );
 
 	PostEventMS( &EV_SetOwnerFromSpawnArgs, 0 );
+
+	// add the moveable to the obstacles found by monsters this frame
+	idAI::InvalidateObstacleHash();
 }
 
 /*
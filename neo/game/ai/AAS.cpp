@@ -96,6 +96,7 @@ idAASLocal::Shutdown
 ============
 */
 void idAASLocal::Shutdown( void ) {
+	ClearPathQueries();
 	if ( file ) {
 		ShutdownRouting();
 		RemoveAllObstacles();
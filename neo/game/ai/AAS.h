@@ -66,6 +66,26 @@ typedef struct aasObstacle_s {
 	idBounds					expAbsBounds;	// expanded absolute bounds of obstacle
 } aasObstacle_t;
 
+
+// path query states
+enum {
+	PATHQUERY_IDLE,								// not queued
+	PATHQUERY_QUEUED,							// waiting to be answered
+	PATHQUERY_DONE								// answered
+};
+
+typedef struct aasPathQuery_s {
+	int							areaNum;		// area the path starts in
+	idVec3						origin;			// start of the path
+	int							goalAreaNum;	// area the goal is in
+	idVec3						goalOrigin;		// goal of the path
+	int							travelFlags;	// travel flags used for the path
+	bool						fly;			// create a fly path instead of a walk path
+	int							state;			// PATHQUERY_?
+	bool						pathFound;		// true if a path to the goal was found
+	aasPath_t					path;			// path towards the goal
+} aasPathQuery_t;
+
 class idAASCallback {
 public:
 	virtual						~idAASCallback() {};
@@ -138,6 +158,12 @@ public:
 	virtual void				ShowFlyPath( const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) const = 0;
 								// Find the nearest goal which satisfies the callback.
 	virtual bool				FindNearestGoal( aasGoal_t &goal, int areaNum, const idVec3 origin, const idVec3 &target, int travelFlags, aasObstacle_t *obstacles, int numObstacles, idAASCallback &callback ) const = 0;
+								// Queue a path query, the query must stay valid until it is answered or cancelled.
+	virtual void				QueuePathQuery( aasPathQuery_t *query ) = 0;
+								// Remove a path query from the queue.
+	virtual void				CancelPathQuery( aasPathQuery_t *query ) = 0;
+								// Answer at most the given number of queued path queries, returns the number of answered queries.
+	virtual int					ProcessPathQueries( int maxQueries ) = 0;
 };
 
 #endif /* !__AAS_H__ */
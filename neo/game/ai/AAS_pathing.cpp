@@ -713,3 +713,97 @@ int idAASLocal::GetWallEdges( int areaNum, const idBounds &bounds, int travelFla
 	}
 	return numEdges;
 }
+
+/*
+============
+idAASLocal::QueuePathQuery
+============
+*/
+void idAASLocal::QueuePathQuery( aasPathQuery_t *query ) {
+	if ( query->state == PATHQUERY_QUEUED ) {
+		return;
+	}
+	query->state = PATHQUERY_QUEUED;
+	query->pathFound = false;
+	pathQueries.Append( query );
+}
+
+/*
+============
+idAASLocal::CancelPathQuery
+============
+*/
+void idAASLocal::CancelPathQuery( aasPathQuery_t *query ) {
+	if ( query->state == PATHQUERY_QUEUED ) {
+		pathQueries.Remove( query );
+	}
+	query->state = PATHQUERY_IDLE;
+}
+
+/*
+============
+idAASLocal::ClearPathQueries
+============
+*/
+void idAASLocal::ClearPathQueries( void ) {
+	int i;
+
+	for ( i = 0; i < pathQueries.Num(); i++ ) {
+		pathQueries[i]->state = PATHQUERY_IDLE;
+	}
+	pathQueries.Clear();
+}
+
+/*
+============
+PathQuerySortGoal
+============
+*/
+static int PathQuerySortGoal( aasPathQuery_t * const *a, aasPathQuery_t * const *b ) {
+	if ( (*a)->goalAreaNum != (*b)->goalAreaNum ) {
+		return (*a)->goalAreaNum - (*b)->goalAreaNum;
+	}
+	return (*a)->travelFlags - (*b)->travelFlags;
+}
+
+/*
+============
+idAASLocal::ProcessPathQueries
+
+  The oldest queries are answered first. The queries are sorted on their goal
+  so the queries towards the same goal use the same goal route table.
+============
+*/
+int idAASLocal::ProcessPathQueries( int maxQueries ) {
+	int i, num;
+	aasPathQuery_t *query;
+	idList<aasPathQuery_t *> queries;
+
+	num = Min( maxQueries, pathQueries.Num() );
+	if ( num <= 0 ) {
+		return 0;
+	}
+
+	queries.SetNum( num );
+	for ( i = 0; i < num; i++ ) {
+		queries[i] = pathQueries[i];
+	}
+	for ( i = num; i < pathQueries.Num(); i++ ) {
+		pathQueries[i - num] = pathQueries[i];
+	}
+	pathQueries.SetNum( pathQueries.Num() - num, false );
+
+	queries.Sort( PathQuerySortGoal );
+
+	for ( i = 0; i < num; i++ ) {
+		query = queries[i];
+		if ( query->fly ) {
+			query->pathFound = FlyPathToGoal( query->path, query->areaNum, query->origin, query->goalAreaNum, query->goalOrigin, query->travelFlags );
+		} else {
+			query->pathFound = WalkPathToGoal( query->path, query->areaNum, query->origin, query->goalAreaNum, query->goalOrigin, query->travelFlags );
+		}
+		query->state = PATHQUERY_DONE;
+	}
+
+	return num;
+}
@@ -345,6 +345,9 @@ idAI::idAI() {
 	lastVisibleEnemyEyeOffset.Zero();
 	lastVisibleReachableEnemyPos.Zero();
 	lastReachableEnemyPos.Zero();
+	enemyPathQuery.state = PATHQUERY_IDLE;
+	enemyPathQuery.pathFound = false;
+	enemyPathQueryPos.Zero();
 	shrivel_rate		= 0.0f;
 	shrivel_start		= 0;
 	fl.neverDormant		= false;		// AI's can go dormant
@@ -392,6 +395,7 @@ idAI::~idAI
 =====================
 */
 idAI::~idAI() {
+	CancelEnemyPathQuery();
 	delete projectileClipModel;
 	DeconstructScriptObject();
 	scriptObject.Free();
@@ -1043,6 +1047,24 @@ void idAI::DormantEnd( void ) {
 	idActor::DormantEnd();
 }
 
+/*
+=====================
+idAI::RunsPhysicsFirst
+
+  Dead monsters only run the death script before the ragdoll physics.
+=====================
+*/
+bool idAI::RunsPhysicsFirst( void ) {
+	if ( !( thinkFlags & TH_THINK ) || num_cinematics || move.moveType != MOVETYPE_DEAD ) {
+		return false;
+	}
+	if ( !allowHiddenMovement && IsHidden() ) {
+		return false;
+	}
+	// the CheckDormant at the start of Think gives the same result later this frame
+	return !CheckDormant();
+}
+
 /*
 =====================
 idAI::Think
@@ -1235,6 +1257,7 @@ void idAI::KickObstacles( const idVec3 &dir, float force, idEntity *alwaysKick )
 	clipBounds.ExpandSelf( 8.0f );
 	clipBounds.AddPoint( org );
 	clipmask = physicsObj.GetClipMask();
+	// the random impulses are applied in the order of the clip model query
 	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipmask, clipModelList, MAX_GENTITIES );
 	for ( i = 0; i < numListedClipModels; i++ ) {
 		clipModel = clipModelList[i];
@@ -1420,6 +1443,51 @@ bool idAI::PathToGoal( aasPath_t &path, int areaNum, const idVec3 &origin, int g
 	}
 }
 
+/*
+=====================
+idAI::QueuePathToGoal
+
+  Same as PathToGoal but the path is created in a later frame within the path query budget.
+  Returns false if the path cannot be queued.
+=====================
+*/
+bool idAI::QueuePathToGoal( aasPathQuery_t &query, int areaNum, const idVec3 &origin, int goalAreaNum, const idVec3 &goalOrigin ) {
+	if ( !aas ) {
+		return false;
+	}
+
+	query.origin = origin;
+	aas->PushPointIntoAreaNum( areaNum, query.origin );
+	if ( !areaNum ) {
+		return false;
+	}
+
+	query.goalOrigin = goalOrigin;
+	aas->PushPointIntoAreaNum( goalAreaNum, query.goalOrigin );
+	if ( !goalAreaNum ) {
+		return false;
+	}
+
+	query.areaNum = areaNum;
+	query.goalAreaNum = goalAreaNum;
+	query.travelFlags = travelFlags;
+	query.fly = ( move.moveType == MOVETYPE_FLY );
+	aas->QueuePathQuery( &query );
+	return true;
+}
+
+/*
+=====================
+idAI::CancelEnemyPathQuery
+=====================
+*/
+void idAI::CancelEnemyPathQuery( void ) {
+	if ( aas && enemyPathQuery.state == PATHQUERY_QUEUED ) {
+		aas->CancelPathQuery( &enemyPathQuery );
+	}
+	enemyPathQuery.state = PATHQUERY_IDLE;
+}
+
 /*
 =====================
 idAI::TravelDistance
@@ -3612,6 +3680,8 @@ void idAI::ClearEnemy( void ) {
 		StopMove( MOVE_STATUS_DEST_NOT_FOUND );
 	}
 
+	CancelEnemyPathQuery();
+
 	enemyNode.Remove();
 	enemy				= NULL;
 	AI_ENEMY_IN_FOV		= false;
@@ -3781,7 +3851,18 @@ void idAI::UpdateEnemyPosition( void ) {
 			enemyAreaNum = PointReachableAreaNum( enemyPos, 1.0f );
 			if ( enemyAreaNum ) {
 				areaNum = PointReachableAreaNum( org );
-				if ( PathToGoal( path, areaNum, org, enemyAreaNum, enemyPos ) ) {
+				if ( aas_pathQueryBudget.GetInteger() > 0 ) {
+					// use the answer to the path query from an earlier frame and queue a new one
+					if ( enemyPathQuery.state == PATHQUERY_DONE && enemyPathQuery.pathFound ) {
+						lastReachableEnemyPos = enemyPathQueryPos;
+					}
+					if ( enemyPathQuery.state != PATHQUERY_QUEUED ) {
+						enemyPathQuery.state = PATHQUERY_IDLE;
+						if ( QueuePathToGoal( enemyPathQuery, areaNum, org, enemyAreaNum, enemyPos ) ) {
+							enemyPathQueryPos = enemyPos;
+						}
+					}
+				} else if ( PathToGoal( path, areaNum, org, enemyAreaNum, enemyPos ) ) {
 					lastReachableEnemyPos = enemyPos;
 				}
 			}
@@ -3831,6 +3912,7 @@ void idAI::SetEnemy( idActor *newEnemy ) {
 	if ( !newEnemy ) {
 		ClearEnemy();
 	} else if ( enemy.GetEntity() != newEnemy ) {
+		CancelEnemyPathQuery();
 		enemy = newEnemy;
 		enemyNode.AddToEnd( newEnemy->enemyList );
 		if ( newEnemy->health <= 0 ) {
@@ -28,7 +28,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/containers/Queue.h"
+#include "idlib/containers/HashIndex.h"
 #include "idlib/geometry/Winding2D.h"
+#include "idlib/Timer.h"
 
 #include "gamesys/SysCvar.h"
 #include "Moveable.h"
@@ -70,6 +72,43 @@ typedef struct obstacle_s {
 	idEntity *			entity;
 } obstacle_t;
 
+/*
+===============================================================================
+
+	Obstacle Hash
+
+	Actors and moveables are hashed into 2D grid cells once per frame. The
+	cells an entity is put in cover its bounds and its movement during the
+	frame, so the obstacles near an AI are found without going through all
+	the clip models near the AI. The clip models themselves are tested at
+	their current position when the hash is queried.
+
+===============================================================================
+*/
+
+const float OBSTACLE_HASH_CELL_SIZE		= 128.0f;
+const float OBSTACLE_HASH_MARGIN		= 16.0f;
+const int	OBSTACLE_HASH_SIZE			= 1024;
+const int	OBSTACLE_HASH_MAX_CELLS		= 8;		// entities covering more cells in a direction are always tested
+
+typedef struct obstacleHashEntity_s {
+	idEntityPtr<idEntity>	entity;
+	int						queryCount;			// last query the entity was tested for
+} obstacleHashEntity_t;
+
+static idList<obstacleHashEntity_t>	obstacleHashEntities;
+static idList<int>					obstacleHashCells;			// entity for every cell an entity is in
+static idList<int>					obstacleHashLarge;			// entities covering too many cells
+static idHashIndex					obstacleHash( OBSTACLE_HASH_SIZE, 1024 );
+static int							obstacleHashFrame = -1;
+static int							obstacleHashQueryCount;
+
+// statistics for the current frame
+static int							obstacleStatsFrame = -1;
+static int							obstacleNumQueries;
+static int							obstacleNumTests;
+static int							obstacleNumFound;
+
 typedef struct pathNode_s {
 	int					dir;
 	idVec2				pos;
@@ -345,7 +384,7 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	clipMask = physics->GetClipMask();
 
 	// find all obstacles touching the clip bounds
-	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	numListedClipModels = idAI::ObstaclesTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
 
 	for ( i = 0; i < numListedClipModels && numObstacles < MAX_OBSTACLES; i++ ) {
 		clipModel = clipModelList[i];
@@ -1010,6 +1049,256 @@ idAI::FreeObstacleAvoidanceNodes
 */
 void idAI::FreeObstacleAvoidanceNodes( void ) {
 	pathNodeAllocator.Shutdown();
+	obstacleHashEntities.Clear();
+	obstacleHashCells.Clear();
+	obstacleHashLarge.Clear();
+	obstacleHash.Free();
+	obstacleHashFrame = -1;
+}
+
+/*
+============
+idAI::InvalidateObstacleHash
+============
+*/
+void idAI::InvalidateObstacleHash( void ) {
+	obstacleHashFrame = -1;
+}
+
+/*
+============
+ObstacleHashKey
+============
+*/
+static ID_INLINE int ObstacleHashKey( int x, int y ) {
+	return ( x * 73856093 ) ^ ( y * 19349663 );
+}
+
+/*
+============
+ObstacleHashCells
+============
+*/
+static ID_INLINE void ObstacleHashCells( const idBounds &bounds, int cells[2][2] ) {
+	cells[0][0] = idMath::FtoiFast( idMath::Floor( bounds[0].x * ( 1.0f / OBSTACLE_HASH_CELL_SIZE ) ) );
+	cells[0][1] = idMath::FtoiFast( idMath::Floor( bounds[0].y * ( 1.0f / OBSTACLE_HASH_CELL_SIZE ) ) );
+	cells[1][0] = idMath::FtoiFast( idMath::Floor( bounds[1].x * ( 1.0f / OBSTACLE_HASH_CELL_SIZE ) ) );
+	cells[1][1] = idMath::FtoiFast( idMath::Floor( bounds[1].y * ( 1.0f / OBSTACLE_HASH_CELL_SIZE ) ) );
+}
+
+/*
+============
+ObstacleStatsNewFrame
+
+  prints the statistics of the last frame obstacles were searched, the single queries
+  are too short to be timed, obstacleBenchmark measures the time they take
+============
+*/
+static void ObstacleStatsNewFrame( void ) {
+	if ( ai_obstacleStats.GetBool() && obstacleNumQueries ) {
+		gameLocal.Printf( "obstacles: %4d queries %5d entities tested %5d clip models found\n",
+							obstacleNumQueries, obstacleNumTests, obstacleNumFound );
+	}
+	obstacleStatsFrame = gameLocal.framenum;
+	obstacleNumQueries = 0;
+	obstacleNumTests = 0;
+	obstacleNumFound = 0;
+}
+
+/*
+============
+BuildObstacleHash
+============
+*/
+static void BuildObstacleHash( void ) {
+	int x, y, cells[2][2];
+	float frameTime;
+	idEntity *ent;
+	idPhysics *phys;
+	idBounds bounds;
+
+	obstacleHashFrame = gameLocal.framenum;
+	obstacleHashEntities.SetNum( 0, false );
+	obstacleHashCells.SetNum( 0, false );
+	obstacleHashLarge.SetNum( 0, false );
+	obstacleHash.Clear();
+
+	frameTime = MS2SEC( gameLocal.msec );
+
+	for ( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		if ( !ent->IsType( idActor::Type ) && !ent->IsType( idMoveable::Type ) ) {
+			continue;
+		}
+		phys = ent->GetPhysics();
+		if ( !phys->GetNumClipModels() ) {
+			continue;
+		}
+
+		// cover the movement of the entity during the frame
+		bounds = phys->GetAbsBounds();
+		bounds.ExpandSelf( phys->GetLinearVelocity().LengthFast() * frameTime + OBSTACLE_HASH_MARGIN );
+		ObstacleHashCells( bounds, cells );
+
+		obstacleHashEntity_t &hashEntity = obstacleHashEntities.Alloc();
+		hashEntity.entity = ent;
+		hashEntity.queryCount = 0;
+
+		if ( cells[1][0] - cells[0][0] >= OBSTACLE_HASH_MAX_CELLS || cells[1][1] - cells[0][1] >= OBSTACLE_HASH_MAX_CELLS ) {
+			obstacleHashLarge.Append( obstacleHashEntities.Num() - 1 );
+			continue;
+		}
+		for ( x = cells[0][0]; x <= cells[1][0]; x++ ) {
+			for ( y = cells[0][1]; y <= cells[1][1]; y++ ) {
+				obstacleHash.Add( ObstacleHashKey( x, y ), obstacleHashCells.Append( obstacleHashEntities.Num() - 1 ) );
+			}
+		}
+	}
+}
+
+/*
+============
+AddObstacleClipModels
+============
+*/
+static int AddObstacleClipModels( obstacleHashEntity_t &hashEntity, const idBounds &bounds, int contentMask, idClipModel **clipModelList, int count, int maxCount ) {
+	int i;
+	idEntity *ent;
+	idPhysics *phys;
+	idClipModel *clipModel;
+
+	if ( hashEntity.queryCount == obstacleHashQueryCount ) {
+		return count;
+	}
+	hashEntity.queryCount = obstacleHashQueryCount;
+
+	ent = hashEntity.entity.GetEntity();
+	if ( !ent ) {
+		return count;
+	}
+
+	obstacleNumTests++;
+
+	phys = ent->GetPhysics();
+	for ( i = 0; i < phys->GetNumClipModels() && count < maxCount; i++ ) {
+		clipModel = phys->GetClipModel( i );
+		if ( !clipModel || !clipModel->IsLinked() || !clipModel->IsEnabled() ) {
+			continue;
+		}
+		if ( !( clipModel->GetContents() & contentMask ) ) {
+			continue;
+		}
+		if ( !clipModel->GetAbsBounds().IntersectsBounds( bounds ) ) {
+			continue;
+		}
+		clipModelList[count++] = clipModel;
+	}
+	return count;
+}
+
+/*
+============
+idAI::ObstaclesTouchingBounds
+============
+*/
+int idAI::ObstaclesTouchingBounds( const idBounds &bounds, int contentMask, idClipModel **clipModelList, int maxCount ) {
+	int i, x, y, count, cells[2][2];
+	idBounds expBounds;
+
+	if ( obstacleStatsFrame != gameLocal.framenum ) {
+		ObstacleStatsNewFrame();
+	}
+
+	if ( !ai_obstacleHash.GetBool() ) {
+		count = gameLocal.clip.ClipModelsTouchingBounds( bounds, contentMask, clipModelList, maxCount );
+		obstacleNumQueries++;
+		obstacleNumFound += count;
+		return count;
+	}
+
+	if ( obstacleHashFrame != gameLocal.framenum ) {
+		BuildObstacleHash();
+	}
+
+	obstacleHashQueryCount++;
+	obstacleNumQueries++;
+
+	expBounds = bounds.Expand( CM_BOX_EPSILON );
+
+	count = 0;
+	for ( i = 0; i < obstacleHashLarge.Num(); i++ ) {
+		count = AddObstacleClipModels( obstacleHashEntities[obstacleHashLarge[i]], expBounds, contentMask, clipModelList, count, maxCount );
+	}
+
+	ObstacleHashCells( expBounds, cells );
+	for ( x = cells[0][0]; x <= cells[1][0]; x++ ) {
+		for ( y = cells[0][1]; y <= cells[1][1]; y++ ) {
+			for ( i = obstacleHash.First( ObstacleHashKey( x, y ) ); i != -1; i = obstacleHash.Next( i ) ) {
+				count = AddObstacleClipModels( obstacleHashEntities[obstacleHashCells[i]], expBounds, contentMask, clipModelList, count, maxCount );
+			}
+		}
+	}
+
+	obstacleNumFound += count;
+
+	return count;
+}
+
+/*
+============
+idAI::BenchmarkObstacles
+
+  runs the obstacle searches of all living monsters with and without the obstacle hash,
+  the obstacle hash is built again for every pass
+============
+*/
+void idAI::BenchmarkObstacles( int numPasses ) {
+	int i, pass, mode, numFound;
+	idList<idBounds> queries;
+	idList<int> clipMasks;
+	idClipModel *clipModelList[ MAX_GENTITIES ];
+	idEntity *ent;
+	idBounds bounds;
+	idTimer timer;
+	bool oldUseHash = ai_obstacleHash.GetBool();
+
+	for ( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() ) {
+		if ( !ent->IsType( idAI::Type ) || ent->health <= 0 ) {
+			continue;
+		}
+		bounds = ent->GetPhysics()->GetAbsBounds();
+		bounds.ExpandSelf( MAX_OBSTACLE_RADIUS );
+		queries.Append( bounds );
+		clipMasks.Append( ent->GetPhysics()->GetClipMask() );
+	}
+
+	if ( !queries.Num() ) {
+		gameLocal.Printf( "no monsters\n" );
+		return;
+	}
+
+	gameLocal.Printf( "%d monsters, %d passes\n", queries.Num(), numPasses );
+
+	for ( mode = 0; mode < 2; mode++ ) {
+		ai_obstacleHash.SetBool( mode != 0 );
+
+		numFound = 0;
+		timer.Clear();
+		timer.Start();
+		for ( pass = 0; pass < numPasses; pass++ ) {
+			obstacleHashFrame = -1;
+			for ( i = 0; i < queries.Num(); i++ ) {
+				numFound += ObstaclesTouchingBounds( queries[i], clipMasks[i], clipModelList, MAX_GENTITIES );
+			}
+		}
+		timer.Stop();
+
+		gameLocal.Printf( "%-8s %6.1f clip models found per monster, %6.2f usec per frame\n", mode ? "hash" : "clip",
+					(float) numFound / ( numPasses * queries.Num() ), timer.Milliseconds() * 1000.0f / numPasses );
+	}
+
+	ai_obstacleHash.SetBool( oldUseHash );
+	obstacleHashFrame = -1;
+	obstacleNumQueries = 0;
 }
 
 
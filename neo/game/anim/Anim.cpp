@@ -30,12 +30,16 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/geometry/JointTransform.h"
 #include "idlib/math/Quat.h"
 
+#include "gamesys/SysCvar.h"
 #include "Game_local.h"
 
 #include "anim/Anim.h"
 
 bool idAnimManager::forceExport = false;
 
+// most animated components a single joint can have (3 for the translation, 3 for the rotation)
+const int ANIM_MAX_JOINT_COMPONENTS = 6;
+
 /***********************************************************************
 
 	idMD5Anim
@@ -82,6 +86,11 @@ void idMD5Anim::Free( void ) {
 	jointInfo.Clear();
 	bounds.Clear();
 	componentFrames.Clear();
+	componentMins.Clear();
+	componentScales.Clear();
+	quantizedFrames.Clear();
+	keyFrameNums.Clear();
+	frameKeys.Clear();
 }
 
 /*
@@ -150,6 +159,7 @@ idMD5Anim::Allocated
 */
 size_t idMD5Anim::Allocated( void ) const {
 	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size += componentMins.Allocated() + componentScales.Allocated() + quantizedFrames.Allocated() + keyFrameNums.Allocated() + frameKeys.Allocated();
 	return size;
 }
 
@@ -158,7 +168,7 @@ size_t idMD5Anim::Allocated( void ) const {
 idMD5Anim::LoadAnim
 ====================
 */
-bool idMD5Anim::LoadAnim( const char *filename ) {
+bool idMD5Anim::LoadAnim( const char *filename, bool compress ) {
 	int		version;
 	idLexer	parser( LEXFL_ALLOWPATHNAMES | LEXFL_NOSTRINGESCAPECHARS | LEXFL_NOSTRINGCONCAT );
 	idToken	token;
@@ -326,10 +336,172 @@ bool idMD5Anim::LoadAnim( const char *filename ) {
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 
+	if ( compress && g_animCompress.GetBool() ) {
+		Compress( g_animCompressError.GetFloat() );
+	}
+
 	// done
 	return true;
 }
 
+/*
+====================
+idMD5Anim::CanDropFrames
+
+  returns true if all frames between the two frames can be linearly interpolated from them within the tolerance of each component
+====================
+*/
+bool idMD5Anim::CanDropFrames( int startFrame, int endFrame, const float *tolerance ) const {
+	const float *start = &componentFrames[ startFrame * numAnimatedComponents ];
+	const float *end = &componentFrames[ endFrame * numAnimatedComponents ];
+
+	for ( int i = startFrame + 1; i < endFrame; i++ ) {
+		const float *frame = &componentFrames[ i * numAnimatedComponents ];
+		float lerp = (float)( i - startFrame ) / (float)( endFrame - startFrame );
+		for ( int j = 0; j < numAnimatedComponents; j++ ) {
+			if ( idMath::Fabs( start[ j ] + ( end[ j ] - start[ j ] ) * lerp - frame[ j ] ) > tolerance[ j ] ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+====================
+idMD5Anim::Compress
+
+  Stores the animated components as 16 bit values scaled to the range of each component.
+  When maxError is positive, frames that can be interpolated from the frames around them
+  are dropped. The error of translations is measured in units, the error of rotations by
+  how far they move a point 32 units away from the joint.
+====================
+*/
+void idMD5Anim::Compress( float maxError ) {
+	int				i, j, k;
+	idList<float>	tolerance;
+	idList<int>		keys;
+
+	if ( IsCompressed() || !numAnimatedComponents || !numFrames ) {
+		return;
+	}
+
+	// pick the key frames
+	keys.SetGranularity( 1 );
+	if ( maxError > 0.0f && numFrames > 2 ) {
+		tolerance.SetNum( numAnimatedComponents );
+		for ( i = 0; i < numAnimatedComponents; i++ ) {
+			tolerance[ i ] = maxError;
+		}
+		for ( i = 0; i < numJoints; i++ ) {
+			int animBits = jointInfo[ i ].animBits;
+			k = jointInfo[ i ].firstComponent;
+			for ( j = 0; j < 6; j++ ) {
+				if ( animBits & ( 1 << j ) ) {
+					if ( j >= 3 && k < numAnimatedComponents ) {
+						// a quaternion component error of e rotates a point at distance d by about 2 * e * d
+						tolerance[ k ] = maxError / 64.0f;
+					}
+					k++;
+				}
+			}
+		}
+
+		int start = 0;
+		keys.Append( start );
+		for ( i = start + 2; i < numFrames; i++ ) {
+			if ( !CanDropFrames( start, i, tolerance.Ptr() ) ) {
+				start = i - 1;
+				keys.Append( start );
+			}
+		}
+		keys.Append( numFrames - 1 );
+	}
+
+	if ( keys.Num() && keys.Num() < numFrames ) {
+		keyFrameNums = keys;
+		frameKeys.SetGranularity( 1 );
+		frameKeys.SetNum( numFrames );
+		for ( i = 0, k = 0; i < numFrames; i++ ) {
+			while( k + 1 < keyFrameNums.Num() && keyFrameNums[ k + 1 ] <= i ) {
+				k++;
+			}
+			frameKeys[ i ] = k;
+		}
+	} else {
+		keys.SetNum( numFrames );
+		for ( i = 0; i < numFrames; i++ ) {
+			keys[ i ] = i;
+		}
+	}
+
+	// find the range of each component
+	componentMins.SetGranularity( 1 );
+	componentMins.SetNum( numAnimatedComponents );
+	componentScales.SetGranularity( 1 );
+	componentScales.SetNum( numAnimatedComponents );
+	for ( j = 0; j < numAnimatedComponents; j++ ) {
+		float min = componentFrames[ j ];
+		float max = componentFrames[ j ];
+		for ( i = 1; i < numFrames; i++ ) {
+			float value = componentFrames[ i * numAnimatedComponents + j ];
+			min = Min( min, value );
+			max = Max( max, value );
+		}
+		componentMins[ j ] = min;
+		componentScales[ j ] = ( max - min ) / 65535.0f;
+	}
+
+	// quantize the key frames
+	quantizedFrames.SetGranularity( 1 );
+	quantizedFrames.SetNum( keys.Num() * numAnimatedComponents );
+	unsigned short *quantized = quantizedFrames.Ptr();
+	for ( i = 0; i < keys.Num(); i++ ) {
+		const float *frame = &componentFrames[ keys[ i ] * numAnimatedComponents ];
+		for ( j = 0; j < numAnimatedComponents; j++, quantized++ ) {
+			if ( componentScales[ j ] > 0.0f ) {
+				*quantized = (unsigned short)idMath::ClampInt( 0, 65535, (int)( ( frame[ j ] - componentMins[ j ] ) / componentScales[ j ] + 0.5f ) );
+			} else {
+				*quantized = 0;
+			}
+		}
+	}
+
+	componentFrames.Clear();
+}
+
+/*
+====================
+idMD5Anim::DecodeFrame
+
+  Returns the animated components numbers firstComponent .. firstComponent + numComponents - 1 of a frame.
+  Compressed frames are decoded into the buffer, which must have room for numComponents floats.
+====================
+*/
+const float *idMD5Anim::DecodeFrame( int framenum, int firstComponent, int numComponents, float *buffer ) const {
+	int		key1;
+	float	lerp;
+
+	if ( !IsCompressed() ) {
+		return &componentFrames[ framenum * numAnimatedComponents + firstComponent ];
+	}
+
+	key1 = framenum;
+	lerp = 0.0f;
+	if ( frameKeys.Num() ) {
+		key1 = frameKeys[ framenum ];
+		if ( keyFrameNums[ key1 ] != framenum ) {
+			lerp = (float)( framenum - keyFrameNums[ key1 ] ) / (float)( keyFrameNums[ key1 + 1 ] - keyFrameNums[ key1 ] );
+		}
+	}
+
+	// a key frame is decoded by interpolating it with itself, q1 + ( q1 - q1 ) * 0 is exactly q1
+	const unsigned short *q1 = &quantizedFrames[ key1 * numAnimatedComponents + firstComponent ];
+	const unsigned short *q2 = ( lerp == 0.0f ) ? q1 : q1 + numAnimatedComponents;
+	SIMDProcessor->DecodeQuantized( buffer, q1, q2, lerp, componentMins.Ptr() + firstComponent, componentScales.Ptr() + firstComponent, numComponents );
+	return buffer;
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -445,8 +617,11 @@ void idMD5Anim::GetOrigin( idVec3 &offset, int time, int cyclecount ) const {
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[ ANIM_MAX_JOINT_COMPONENTS ];
+	float buffer2[ ANIM_MAX_JOINT_COMPONENTS ];
+	int numComponents = Min( ANIM_MAX_JOINT_COMPONENTS, numAnimatedComponents - jointInfo[ 0 ].firstComponent );
+	const float *componentPtr1 = DecodeFrame( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float *componentPtr2 = DecodeFrame( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 	if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 		offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -487,8 +662,11 @@ void idMD5Anim::GetOriginRotation( idQuat &rotation, int time, int cyclecount )
 
 	ConvertTimeToFrame( time, cyclecount, frame );
 
-	const float	*jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float	*jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float		buffer1[ ANIM_MAX_JOINT_COMPONENTS ];
+	float		buffer2[ ANIM_MAX_JOINT_COMPONENTS ];
+	int			numComponents = Min( ANIM_MAX_JOINT_COMPONENTS, numAnimatedComponents - jointInfo[ 0 ].firstComponent );
+	const float	*jointframe1 = DecodeFrame( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float	*jointframe2 = DecodeFrame( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 	if ( animBits & ANIM_TX ) {
 		jointframe1++;
@@ -601,8 +779,11 @@ void idMD5Anim::GetBounds( idBounds &bnds, int time, int cyclecount ) const {
 	// origin position
 	offset = baseFrame[ 0 ].t;
 	if ( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) ) {
-		const float *componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float *componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		float buffer1[ ANIM_MAX_JOINT_COMPONENTS ];
+		float buffer2[ ANIM_MAX_JOINT_COMPONENTS ];
+		int numComponents = Min( ANIM_MAX_JOINT_COMPONENTS, numAnimatedComponents - jointInfo[ 0 ].firstComponent );
+		const float *componentPtr1 = DecodeFrame( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+		const float *componentPtr2 = DecodeFrame( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 
 		if ( jointInfo[ 0 ].animBits & ANIM_TX ) {
 			offset.x = *componentPtr1 * frame.frontlerp + *componentPtr2 * frame.backlerp;
@@ -655,8 +836,8 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints,
 	lerpIndex = (int *)_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 	numLerpJoints = 0;
 
-	frame1 = &componentFrames[ frame.frame1 * numAnimatedComponents ];
-	frame2 = &componentFrames[ frame.frame2 * numAnimatedComponents ];
+	frame1 = DecodeFrame( frame.frame1, 0, numAnimatedComponents, (float *)_alloca16( numAnimatedComponents * sizeof( float ) ) );
+	frame2 = DecodeFrame( frame.frame2, 0, numAnimatedComponents, (float *)_alloca16( numAnimatedComponents * sizeof( float ) ) );
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -836,7 +1017,7 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 		return;
 	}
 
-	frame = &componentFrames[ framenum * numAnimatedComponents ];
+	frame = DecodeFrame( framenum, 0, numAnimatedComponents, (float *)_alloca16( numAnimatedComponents * sizeof( float ) ) );
 
 	for ( i = 0; i < numIndexes; i++ ) {
 		int j = index[i];
@@ -883,6 +1064,226 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat *joints, const int *in
 	}
 }
 
+/*
+==============================================================================================
+
+	Animation frame cache
+
+	Keeps the joints of the animation frames decoded during the current game frame, so
+	entities that play the same animation at the same time, like a group of monsters
+	running the same idle or walk cycle, copy the joints instead of decoding them again.
+	Every job thread has its own cache, so creating the animation frames on the job threads
+	doesn't need any locking.
+
+==============================================================================================
+*/
+
+const int ANIMCACHE_MAX_ENTRIES		= 256;
+const int ANIMCACHE_MAX_JOINTS		= 16384;
+const int ANIMCACHE_HASH_SIZE		= 256;
+
+typedef struct {
+	const idMD5Anim *		anim;
+	const int *				index;				// joints that were decoded
+	int						numIndexes;
+	int						frame1;
+	int						frame2;				// -1 for a single frame
+	float					backlerp;
+	int						firstJoint;			// offset into the joint pool
+	int						hashNext;
+} animCacheEntry_t;
+
+typedef struct {
+	int						frameNum;			// game frame the entries were decoded in
+	int						numEntries;
+	int						numJoints;
+	int						hash[ ANIMCACHE_HASH_SIZE ];
+	animCacheEntry_t		entries[ ANIMCACHE_MAX_ENTRIES ];
+	idJointQuat *			joints;
+	int						numLookups;			// statistics since they were last printed
+	int						numHits;
+} animCache_t;
+
+static animCache_t animCache[ MAX_JOB_THREADS + 1 ];
+
+/*
+====================
+AnimCache_ForThread
+
+  returns the cache of the calling thread, emptied when a new game frame has started
+====================
+*/
+static animCache_t *AnimCache_ForThread( void ) {
+	int threadNum = sys->GetJobThreadNum();
+	if ( threadNum < 0 || threadNum > MAX_JOB_THREADS ) {
+		threadNum = 0;
+	}
+
+	animCache_t *cache = &animCache[ threadNum ];
+	if ( cache->frameNum != gameLocal.framenum || !cache->joints ) {
+		if ( !cache->joints ) {
+			cache->joints = (idJointQuat *)Mem_Alloc16( ANIMCACHE_MAX_JOINTS * sizeof( cache->joints[ 0 ] ) );
+		}
+		cache->frameNum = gameLocal.framenum;
+		cache->numEntries = 0;
+		cache->numJoints = 0;
+		memset( cache->hash, -1, sizeof( cache->hash ) );
+	}
+	return cache;
+}
+
+/*
+====================
+AnimCache_HashKey
+====================
+*/
+static int AnimCache_HashKey( const idMD5Anim *anim, const int *index, int frame1, int frame2 ) {
+	int key = (int)( (intptr_t)anim >> 4 ) ^ (int)( (intptr_t)index >> 2 ) ^ ( frame1 * 31 ) ^ ( frame2 * 7 );
+	return key & ( ANIMCACHE_HASH_SIZE - 1 );
+}
+
+/*
+====================
+AnimCache_Find
+====================
+*/
+static const idJointQuat *AnimCache_Find( animCache_t *cache, int key, const idMD5Anim *anim, const int *index, int numIndexes, int frame1, int frame2, float backlerp ) {
+	cache->numLookups++;
+	for ( int i = cache->hash[ key ]; i != -1; i = cache->entries[ i ].hashNext ) {
+		const animCacheEntry_t &entry = cache->entries[ i ];
+		if ( entry.anim == anim && entry.index == index && entry.numIndexes == numIndexes &&
+				entry.frame1 == frame1 && entry.frame2 == frame2 && entry.backlerp == backlerp ) {
+			cache->numHits++;
+			return cache->joints + entry.firstJoint;
+		}
+	}
+	return NULL;
+}
+
+/*
+====================
+AnimCache_Add
+====================
+*/
+static void AnimCache_Add( animCache_t *cache, int key, const idMD5Anim *anim, const int *index, int numIndexes, int frame1, int frame2, float backlerp, const idJointQuat *joints, int numJoints ) {
+	if ( cache->numEntries >= ANIMCACHE_MAX_ENTRIES || cache->numJoints + numJoints > ANIMCACHE_MAX_JOINTS ) {
+		return;
+	}
+
+	animCacheEntry_t &entry = cache->entries[ cache->numEntries ];
+	entry.anim = anim;
+	entry.index = index;
+	entry.numIndexes = numIndexes;
+	entry.frame1 = frame1;
+	entry.frame2 = frame2;
+	entry.backlerp = backlerp;
+	entry.firstJoint = cache->numJoints;
+	entry.hashNext = cache->hash[ key ];
+	cache->hash[ key ] = cache->numEntries++;
+	cache->numJoints += numJoints;
+
+	SIMDProcessor->Memcpy( cache->joints + entry.firstJoint, joints, numJoints * sizeof( joints[ 0 ] ) );
+}
+
+/*
+====================
+idMD5Anim::GetCachedInterpolatedFrame
+
+  same as GetInterpolatedFrame, but reuses the joints when the frame was already decoded this game frame,
+  the frames are cached without the translation of the completed cycles which differs between callers
+====================
+*/
+void idMD5Anim::GetCachedInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints, const int *index, int numIndexes ) const {
+	if ( !g_animFrameCache.GetBool() || !numAnimatedComponents ) {
+		GetInterpolatedFrame( frame, joints, index, numIndexes );
+		return;
+	}
+
+	animCache_t *cache = AnimCache_ForThread();
+	int key = AnimCache_HashKey( this, index, frame.frame1, frame.frame2 );
+	const idJointQuat *cached = AnimCache_Find( cache, key, this, index, numIndexes, frame.frame1, frame.frame2, frame.backlerp );
+	if ( cached ) {
+		SIMDProcessor->Memcpy( joints, cached, baseFrame.Num() * sizeof( joints[ 0 ] ) );
+	} else {
+		frameBlend_t frameInCycle = frame;
+		frameInCycle.cycleCount = 0;
+		GetInterpolatedFrame( frameInCycle, joints, index, numIndexes );
+		AnimCache_Add( cache, key, this, index, numIndexes, frame.frame1, frame.frame2, frame.backlerp, joints, baseFrame.Num() );
+	}
+
+	if ( frame.cycleCount ) {
+		joints[ 0 ].t += totaldelta * ( float )frame.cycleCount;
+	}
+}
+
+/*
+====================
+idMD5Anim::GetCachedSingleFrame
+
+  same as GetSingleFrame, but reuses the joints when the frame was already decoded this game frame
+====================
+*/
+void idMD5Anim::GetCachedSingleFrame( int framenum, idJointQuat *joints, const int *index, int numIndexes ) const {
+	if ( !g_animFrameCache.GetBool() || ( framenum == 0 ) || !numAnimatedComponents ) {
+		GetSingleFrame( framenum, joints, index, numIndexes );
+		return;
+	}
+
+	animCache_t *cache = AnimCache_ForThread();
+	int key = AnimCache_HashKey( this, index, framenum, -1 );
+	const idJointQuat *cached = AnimCache_Find( cache, key, this, index, numIndexes, framenum, -1, 0.0f );
+	if ( cached ) {
+		SIMDProcessor->Memcpy( joints, cached, baseFrame.Num() * sizeof( joints[ 0 ] ) );
+		return;
+	}
+
+	GetSingleFrame( framenum, joints, index, numIndexes );
+	AnimCache_Add( cache, key, this, index, numIndexes, framenum, -1, 0.0f, joints, baseFrame.Num() );
+}
+
+/*
+====================
+idMD5Anim::ClearFrameCache
+
+  throws away the decoded frames of all threads, must be called when anims are reloaded or freed
+====================
+*/
+void idMD5Anim::ClearFrameCache( bool freeMemory ) {
+	for ( int i = 0; i <= MAX_JOB_THREADS; i++ ) {
+		animCache[ i ].frameNum = -1;
+		if ( freeMemory && animCache[ i ].joints ) {
+			Mem_Free16( animCache[ i ].joints );
+			animCache[ i ].joints = NULL;
+		}
+	}
+}
+
+/*
+====================
+idMD5Anim::PrintFrameCacheStats
+====================
+*/
+void idMD5Anim::PrintFrameCacheStats( void ) {
+	int totalLookups = 0;
+	int totalHits = 0;
+
+	for ( int i = 0; i <= MAX_JOB_THREADS; i++ ) {
+		animCache_t &cache = animCache[ i ];
+		if ( !cache.numLookups ) {
+			continue;
+		}
+		gameLocal.Printf( "thread %d: %7d lookups, %7d hits (%5.1f%%), %3d frames / %5d joints cached\n", i,
+			cache.numLookups, cache.numHits, cache.numHits * 100.0f / cache.numLookups, cache.numEntries, cache.numJoints );
+		totalLookups += cache.numLookups;
+		totalHits += cache.numHits;
+		cache.numLookups = 0;
+		cache.numHits = 0;
+	}
+
+	gameLocal.Printf( "%d lookups, %d hits (%.1f%%) since the last report, frame cache %s\n", totalLookups, totalHits,
+		totalLookups ? totalHits * 100.0f / totalLookups : 0.0f, g_animFrameCache.GetBool() ? "enabled" : "disabled" );
+}
+
 /*
 ====================
 idMD5Anim::CheckModelHierarchy
@@ -943,6 +1344,7 @@ idAnimManager::Shutdown
 ====================
 */
 void idAnimManager::Shutdown( void ) {
+	idMD5Anim::ClearFrameCache( true );
 	animations.DeleteContents();
 	jointnames.Clear();
 	jointnamesHash.Free();
@@ -991,6 +1393,8 @@ void idAnimManager::ReloadAnims( void ) {
 	int			i;
 	idMD5Anim	**animptr;
 
+	idMD5Anim::ClearFrameCache( false );
+
 	for( i = 0; i < animations.Num(); i++ ) {
 		animptr = animations.GetIndex( i );
 		if ( animptr && *animptr ) {
@@ -1064,6 +1468,88 @@ void idAnimManager::ListAnims( void ) const {
 	gameLocal.Printf( "%zd memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
+/*
+================
+idAnimManager::ReportCompression
+
+  Loads all anims again with and without compression and reports the memory they use and the largest
+  difference of a joint between the compressed and the original frames. Doesn't change the loaded anims.
+================
+*/
+void idAnimManager::ReportCompression( float maxError ) const {
+	int						i, j, k;
+	idMD5Anim				**animptr;
+	idList<int>				index;
+	idList<idJointQuat>		rawJoints;
+	idList<idJointQuat>		packedJoints;
+	frameBlend_t			frame;
+	size_t					rawSize;
+	size_t					packedSize;
+	float					worstTranslation;
+	float					worstRotation;
+	int						num;
+
+	num = 0;
+	rawSize = 0;
+	packedSize = 0;
+	worstTranslation = 0.0f;
+	worstRotation = 0.0f;
+	for( i = 0; i < animations.Num(); i++ ) {
+		animptr = animations.GetIndex( i );
+		if ( !animptr || !*animptr ) {
+			continue;
+		}
+
+		idMD5Anim raw;
+		idMD5Anim packed;
+		if ( !raw.LoadAnim( ( *animptr )->Name(), false ) || !packed.LoadAnim( ( *animptr )->Name(), false ) ) {
+			continue;
+		}
+		packed.Compress( maxError );
+
+		int numJoints = raw.NumJoints();
+		index.SetNum( numJoints, false );
+		rawJoints.SetNum( numJoints, false );
+		packedJoints.SetNum( numJoints, false );
+		for( j = 0; j < numJoints; j++ ) {
+			index[ j ] = j;
+		}
+
+		float maxTranslation = 0.0f;
+		float maxRotation = 0.0f;
+		for( j = 0; j < raw.NumFrames(); j++ ) {
+			frame.cycleCount = 0;
+			frame.frame1 = j;
+			frame.frame2 = j;
+			frame.frontlerp = 1.0f;
+			frame.backlerp = 0.0f;
+			raw.GetInterpolatedFrame( frame, rawJoints.Ptr(), index.Ptr(), numJoints );
+			packed.GetInterpolatedFrame( frame, packedJoints.Ptr(), index.Ptr(), numJoints );
+
+			for( k = 0; k < numJoints; k++ ) {
+				const idQuat &q1 = rawJoints[ k ].q;
+				const idQuat &q2 = packedJoints[ k ].q;
+				float cosom = idMath::Fabs( q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w );
+				maxTranslation = Max( maxTranslation, ( rawJoints[ k ].t - packedJoints[ k ].t ).Length() );
+				maxRotation = Max( maxRotation, RAD2DEG( 2.0f * idMath::ACos( cosom ) ) );
+			}
+		}
+
+		gameLocal.Printf( "%8zd -> %8zd bytes : %3d -> %3d frames : %7.4f units %7.4f degrees : %s\n", raw.Size(), packed.Size(),
+			raw.NumFrames(), packed.NumKeyFrames(), maxTranslation, maxRotation, raw.Name() );
+
+		rawSize += raw.Size();
+		packedSize += packed.Size();
+		worstTranslation = Max( worstTranslation, maxTranslation );
+		worstRotation = Max( worstRotation, maxRotation );
+		num++;
+	}
+
+	gameLocal.Printf( "\n%zd bytes uncompressed, %zd bytes compressed in %d anims (%.1f%%)\n", rawSize, packedSize, num,
+		rawSize ? packedSize * 100.0f / rawSize : 0.0f );
+	gameLocal.Printf( "largest joint error %.4f units, %.4f degrees with a max error of %.4f\n", worstTranslation, worstRotation, maxError );
+}
+
 /*
 ================
 idAnimManager::FlushUnusedAnims
@@ -1083,6 +1569,10 @@ void idAnimManager::FlushUnusedAnims( void ) {
 		}
 	}
 
+	if ( removeAnims.Num() ) {
+		idMD5Anim::ClearFrameCache( false );
+	}
+
 	for( i = 0; i < removeAnims.Num(); i++ ) {
 		animations.Remove( removeAnims[ i ]->Name() );
 		delete removeAnims[ i ];
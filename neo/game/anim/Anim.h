@@ -235,10 +235,18 @@ private:
 	idList<jointAnimInfo_t>	jointInfo;
 	idList<idJointQuat>		baseFrame;
 	idList<float>			componentFrames;
+	idList<float>			componentMins;			// compressed frames: range of each animated component
+	idList<float>			componentScales;
+	idList<unsigned short>	quantizedFrames;		// compressed frames: 16 bit components of the key frames
+	idList<int>				keyFrameNums;			// frame number of each key frame when frames were dropped
+	idList<int>				frameKeys;				// last key frame at or before each frame when frames were dropped
 	idStr					name;
 	idVec3					totaldelta;
 	mutable int				ref_count;
 
+	const float *			DecodeFrame( int framenum, int firstComponent, int numComponents, float *buffer ) const;
+	bool					CanDropFrames( int startFrame, int endFrame, const float *tolerance ) const;
+
 public:
 							idMD5Anim();
 							~idMD5Anim();
@@ -247,7 +255,10 @@ public:
 	bool					Reload( void );
 	size_t					Allocated( void ) const;
 	size_t					Size( void ) const { return sizeof( *this ) + Allocated(); };
-	bool					LoadAnim( const char *filename );
+	bool					LoadAnim( const char *filename, bool compress = true );
+	void					Compress( float maxError );
+	bool					IsCompressed( void ) const { return quantizedFrames.Num() > 0; }
+	int						NumKeyFrames( void ) const { return keyFrameNums.Num() ? keyFrameNums.Num() : numFrames; }
 
 	void					IncreaseRefs( void ) const;
 	void					DecreaseRefs( void ) const;
@@ -256,6 +267,10 @@ public:
 	void					CheckModelHierarchy( const idRenderModel *model ) const;
 	void					GetInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints, const int *index, int numIndexes ) const;
 	void					GetSingleFrame( int framenum, idJointQuat *joints, const int *index, int numIndexes ) const;
+	void					GetCachedInterpolatedFrame( frameBlend_t &frame, idJointQuat *joints, const int *index, int numIndexes ) const;
+	void					GetCachedSingleFrame( int framenum, idJointQuat *joints, const int *index, int numIndexes ) const;
+	static void				ClearFrameCache( bool freeMemory );
+	static void				PrintFrameCacheStats( void );
 	int						Length( void ) const;
 	int						NumFrames( void ) const;
 	int						NumJoints( void ) const;
@@ -521,7 +536,12 @@ public:
 
 	void						ForceUpdate( void );
 	void						ClearForceUpdate( void );
-	bool						CreateFrame( int animtime, bool force );
+	bool						CreateFrame( int animtime, bool force, bool skipDetail = false );
+	bool						CreateFrameAhead( int animtime, bool skipDetail );
+	bool						TakeFrameCreatedAhead( void );
+	int							LastFrameTime( void ) const { return lastTransformTime; }
+	void						SetLastRenderFrame( int frameNum ) { lastRenderFrame = frameNum; }
+	int							LastRenderFrame( void ) const { return lastRenderFrame; }
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -583,6 +603,9 @@ private:
 	mutable bool				stoppedAnimatingUpdate;
 	bool						removeOriginOffset;
 	bool						forceUpdate;
+	bool						frameCreatedAhead;		// frame was created before the renderer asked for it
+	bool						frameSkippedDetail;		// frame was created without the eyelids channel
+	int							lastRenderFrame;		// last game frame the renderer asked for the frame
 
 	idBounds					frameBounds;
 
@@ -613,6 +636,7 @@ public:
 	idMD5Anim *					GetAnim( const char *name );
 	void						ReloadAnims( void );
 	void						ListAnims( void ) const;
+	void						ReportCompression( float maxError ) const;
 	int							JointIndex( const char *name );
 	const char *				JointName( int index ) const;
 
@@ -44,6 +44,9 @@ static const char *channelNames[ ANIM_NumAnimChannels ] = {
 	"all", "torso", "legs", "head", "eyelids"
 };
 
+// frames are also created on the job threads, so the cvar must be constructed before
+static idCVar r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+
 /***********************************************************************
 
 	idAnim
@@ -1773,10 +1776,10 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 	if ( numAnims == 1 ) {
 		md5anim = anim->MD5Anim( 0 );
 		if ( frame ) {
-			md5anim->GetSingleFrame( frame - 1, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+			md5anim->GetCachedSingleFrame( frame - 1, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
 		} else {
 			md5anim->ConvertTimeToFrame( time, cycle, frametime );
-			md5anim->GetInterpolatedFrame( frametime, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+			md5anim->GetCachedInterpolatedFrame( frametime, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
 		}
 	} else {
 		//
@@ -1797,9 +1800,9 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 				lerp = animWeights[ i ] / mixWeight;
 				md5anim = anim->MD5Anim( i );
 				if ( frame ) {
-					md5anim->GetSingleFrame( frame - 1, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+					md5anim->GetCachedSingleFrame( frame - 1, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
 				} else {
-					md5anim->GetInterpolatedFrame( frametime, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+					md5anim->GetCachedInterpolatedFrame( frametime, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
 				}
 
 				// only blend after the first anim is mixed in
@@ -3020,6 +3023,9 @@ idAnimator::idAnimator() {
 	stoppedAnimatingUpdate	= false;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
+	frameCreatedAhead		= false;
+	frameSkippedDetail		= false;
+	lastRenderFrame			= -1;
 
 	frameBounds.Clear();
 
@@ -4172,12 +4178,42 @@ bool idAnimator::FrameHasChanged( int currentTime ) const {
 	return false;
 }
 
+/*
+=====================
+idAnimator::CreateFrameAhead
+
+  Creates the frame before the renderer asks for it. The next TakeFrameCreatedAhead
+  reports the new frame so the renderer still regenerates the dynamic model.
+=====================
+*/
+bool idAnimator::CreateFrameAhead( int currentTime, bool skipDetail ) {
+	if ( CreateFrame( currentTime, false, skipDetail ) ) {
+		frameCreatedAhead = true;
+		return true;
+	}
+	return false;
+}
+
+/*
+=====================
+idAnimator::TakeFrameCreatedAhead
+=====================
+*/
+bool idAnimator::TakeFrameCreatedAhead( void ) {
+	bool createdAhead = frameCreatedAhead;
+	frameCreatedAhead = false;
+	return createdAhead;
+}
+
 /*
 =====================
 idAnimator::CreateFrame
+
+  With skipDetail the eyelids channel isn't blended, such a frame is created again
+  when it's asked for with all the detail at the same time.
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force ) {
+bool idAnimator::CreateFrame( int currentTime, bool force, bool skipDetail ) {
 	int					i, j;
 	int					numJoints;
 	int					parentNum;
@@ -4190,8 +4226,6 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	const jointMod_t *	jointMod;
 	const idJointQuat *	defaultPose;
 
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
-
 	if ( gameLocal.inCinematic && gameLocal.skipCinematic ) {
 		return false;
 	}
@@ -4200,7 +4234,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 		return false;
 	}
 
-	if ( !force && !r_showSkel.GetInteger() ) {
+	if ( !force && !r_showSkel.GetInteger() && ( skipDetail || !frameSkippedDetail ) ) {
 		if ( lastTransformTime == currentTime ) {
 			return false;
 		}
@@ -4211,6 +4245,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 
 	lastTransformTime = currentTime;
 	stoppedAnimatingUpdate = false;
+	frameSkippedDetail = skipDetail;
 
 	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
 		debugInfo = true;
@@ -4280,7 +4315,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	}
 
 	// blend in the eyelids
-	if ( modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) ) {
+	if ( modelDef->NumJointsOnChannel( ANIMCHANNEL_EYELIDS ) && !skipDetail ) {
 		blend = channels[ ANIMCHANNEL_EYELIDS ];
 		blendWeight = baseBlend;
 		for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ ) {
@@ -219,6 +219,148 @@ void idTypeInfo::Shutdown() {
 }
 
 
+/***********************************************************************
+
+  Event thunks
+
+  Every event callback takes up to D_EVENT_MAXARGS arguments, which are
+  passed as floats or as intptr_t (integers, entities, strings, vectors
+  and traces are all passed as a pointer sized value).  A thunk is
+  generated for each combination of argument count and float arguments
+  and looked up once per event def in idClass::Init, so processing an
+  event is a single call through the table.
+
+***********************************************************************/
+
+typedef void ( *eventThunk_t )( idClass *obj, eventCallback_t callback, const intptr_t *data );
+
+template<int isFloat>
+struct idEventThunkArg {
+	typedef intptr_t type;
+	static intptr_t Get( const intptr_t *data, int i ) { return data[ i ]; }
+};
+
+template<>
+struct idEventThunkArg<1> {
+	typedef float type;
+	static float Get( const intptr_t *data, int i ) { return *( const float * )&data[ i ]; }
+};
+
+#define EVENT_THUNK_ARG( n )	typename idEventThunkArg<( bits >> n ) & 1>::type
+#define EVENT_THUNK_GET( n )	idEventThunkArg<( bits >> n ) & 1>::Get( data, n )
+
+template<int numArgs, unsigned int bits>
+struct idEventThunk;
+
+template<unsigned int bits>
+struct idEventThunk<0, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		( obj->*callback )();
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<1, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<2, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<3, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<4, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ), EVENT_THUNK_ARG( 3 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ), EVENT_THUNK_GET( 3 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<5, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ), EVENT_THUNK_ARG( 3 ),
+			EVENT_THUNK_ARG( 4 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ), EVENT_THUNK_GET( 3 ),
+			EVENT_THUNK_GET( 4 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<6, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ), EVENT_THUNK_ARG( 3 ),
+			EVENT_THUNK_ARG( 4 ), EVENT_THUNK_ARG( 5 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ), EVENT_THUNK_GET( 3 ),
+			EVENT_THUNK_GET( 4 ), EVENT_THUNK_GET( 5 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<7, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ), EVENT_THUNK_ARG( 3 ),
+			EVENT_THUNK_ARG( 4 ), EVENT_THUNK_ARG( 5 ), EVENT_THUNK_ARG( 6 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ), EVENT_THUNK_GET( 3 ),
+			EVENT_THUNK_GET( 4 ), EVENT_THUNK_GET( 5 ), EVENT_THUNK_GET( 6 ) );
+	}
+};
+
+template<unsigned int bits>
+struct idEventThunk<8, bits> {
+	static void Call( idClass *obj, eventCallback_t callback, const intptr_t *data ) {
+		typedef void ( idClass::*callback_t )( EVENT_THUNK_ARG( 0 ), EVENT_THUNK_ARG( 1 ), EVENT_THUNK_ARG( 2 ), EVENT_THUNK_ARG( 3 ),
+			EVENT_THUNK_ARG( 4 ), EVENT_THUNK_ARG( 5 ), EVENT_THUNK_ARG( 6 ), EVENT_THUNK_ARG( 7 ) );
+		( obj->*( callback_t )callback )( EVENT_THUNK_GET( 0 ), EVENT_THUNK_GET( 1 ), EVENT_THUNK_GET( 2 ), EVENT_THUNK_GET( 3 ),
+			EVENT_THUNK_GET( 4 ), EVENT_THUNK_GET( 5 ), EVENT_THUNK_GET( 6 ), EVENT_THUNK_GET( 7 ) );
+	}
+};
+
+#undef EVENT_THUNK_ARG
+#undef EVENT_THUNK_GET
+
+// fills in the thunks for all float bit combinations of numArgs arguments, counting down from bits
+template<int numArgs, unsigned int bits>
+struct idEventThunkTable {
+	static void Fill( eventThunk_t *table ) {
+		table[ bits ] = &idEventThunk<numArgs, bits>::Call;
+		idEventThunkTable<numArgs, bits - 1>::Fill( table );
+	}
+};
+
+template<int numArgs>
+struct idEventThunkTable<numArgs, 0> {
+	static void Fill( eventThunk_t *table ) {
+		table[ 0 ] = &idEventThunk<numArgs, 0>::Call;
+	}
+};
+
+#if D_EVENT_MAXARGS != 8
+#error "idEventThunk and idClass::InitEventThunks need to be updated for D_EVENT_MAXARGS"
+#endif
+
+static eventThunk_t		eventThunks[ MAX_EVENTS ];
+
+// number of times each event was processed since the last idClass::PrintEventStats
+static int				eventCallCounts[ MAX_EVENTS ];
+static idList<int>		eventStatsList;
+
+
 /***********************************************************************
 
   idClass
@@ -412,11 +554,88 @@ void idClass::Init( void ) {
 		typenums[ c->typeNum ] = c;
 	}
 
+	InitEventThunks();
+
 	initialized = true;
 
 	gameLocal.Printf( "...%i classes, %i bytes for event callbacks\n", types.Num(), eventCallbackMemory );
 }
 
+/*
+================
+idClass::InitEventThunks
+
+Looks up the thunk that calls the callbacks of each event with the right argument types.
+================
+*/
+void idClass::InitEventThunks( void ) {
+	eventThunk_t	thunks[ D_EVENT_MAXARGS + 1 ][ 1 << D_EVENT_MAXARGS ];
+	const idEventDef *ev;
+	int				numArgs;
+	int				i;
+
+	idEventThunkTable<0, 0>::Fill( thunks[ 0 ] );
+	idEventThunkTable<1, ( 1 << 1 ) - 1>::Fill( thunks[ 1 ] );
+	idEventThunkTable<2, ( 1 << 2 ) - 1>::Fill( thunks[ 2 ] );
+	idEventThunkTable<3, ( 1 << 3 ) - 1>::Fill( thunks[ 3 ] );
+	idEventThunkTable<4, ( 1 << 4 ) - 1>::Fill( thunks[ 4 ] );
+	idEventThunkTable<5, ( 1 << 5 ) - 1>::Fill( thunks[ 5 ] );
+	idEventThunkTable<6, ( 1 << 6 ) - 1>::Fill( thunks[ 6 ] );
+	idEventThunkTable<7, ( 1 << 7 ) - 1>::Fill( thunks[ 7 ] );
+	idEventThunkTable<8, ( 1 << 8 ) - 1>::Fill( thunks[ 8 ] );
+
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ ) {
+		ev = idEventDef::GetEventCommand( i );
+		numArgs = ev->GetNumArgs();
+		eventThunks[ i ] = thunks[ numArgs ][ ev->GetFormatspecIndex() & ( ( 1 << numArgs ) - 1 ) ];
+	}
+
+	memset( eventCallCounts, 0, sizeof( eventCallCounts ) );
+}
+
+/*
+================
+EventStatsCompare
+================
+*/
+static int EventStatsCompare( const int *a, const int *b ) {
+	return eventCallCounts[ *b ] - eventCallCounts[ *a ];
+}
+
+/*
+================
+idClass::PrintEventStats
+
+Prints the events processed most often since the last call, and starts counting again.
+================
+*/
+void idClass::PrintEventStats( void ) {
+	int i;
+	int total;
+
+	if ( g_eventStats.GetInteger() <= 0 ) {
+		return;
+	}
+
+	eventStatsList.SetGranularity( 256 );
+	eventStatsList.Clear();
+	total = 0;
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ ) {
+		if ( eventCallCounts[ i ] ) {
+			eventStatsList.Append( i );
+			total += eventCallCounts[ i ];
+		}
+	}
+	eventStatsList.Sort( EventStatsCompare );
+
+	gameLocal.Printf( "events %d: %d calls, %d different events\n", gameLocal.framenum, total, eventStatsList.Num() );
+	for( i = 0; i < eventStatsList.Num() && i < g_eventStats.GetInteger(); i++ ) {
+		gameLocal.Printf( "%6d %s\n", eventCallCounts[ eventStatsList[ i ] ], idEventDef::GetEventCommand( eventStatsList[ i ] )->GetName() );
+	}
+
+	memset( eventCallCounts, 0, sizeof( eventCallCounts ) );
+}
+
 /*
 ================
 idClass::Shutdown
@@ -430,6 +649,7 @@ void idClass::Shutdown( void ) {
 	}
 	types.Clear();
 	typenums.Clear();
+	eventStatsList.Clear();
 
 	initialized = false;
 }
@@ -957,19 +1177,12 @@ bool idClass::ProcessEventArgPtr( const idEventDef *ev, intptr_t *data ) {
 
 	callback = c->eventMap[ num ];
 
-	switch( ev->GetFormatspecIndex() ) {
-	case 1 << D_EVENT_MAXARGS :
-		( this->*callback )();
-		break;
-
-// generated file - see CREATE_EVENT_CODE
-#include "Callbacks.cpp"
-
-	default:
-		gameLocal.Warning( "Invalid formatspec on event '%s'", ev->GetName() );
-		break;
+	if ( g_eventStats.GetInteger() > 0 ) {
+		eventCallCounts[ num ]++;
 	}
 
+	eventThunks[ num ]( this, callback, data );
+
 	return true;
 }
 
@@ -113,6 +113,7 @@ idCVar g_skipFX(					"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_skipParticles(				"g_skipParticles",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
+idCVar g_scriptBinaryCache(			"g_scriptBinaryCache",		"1",			CVAR_GAME | CVAR_BOOL, "load the program compiled from the default script from a binary .scriptb file and write it after compiling, the file is only used if none of the scripts changed" );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -140,6 +141,10 @@ idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_B
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
+idCVar g_clipModelTree(				"g_clipModelTree",			"0",			CVAR_GAME | CVAR_BOOL, "find clip models with a dynamic bounding box tree instead of the fixed clip sectors, takes effect at map load" );
+idCVar g_checkClipModelTree(		"g_checkClipModelTree",		"0",			CVAR_GAME | CVAR_BOOL, "also link clip models into the clip sectors when g_clipModelTree is set and warn when a query of the tree finds other clip models than the sectors, takes effect at map load" );
+idCVar g_traceBatchJobs(			"g_traceBatchJobs",			"1",			CVAR_GAME | CVAR_BOOL, "run batched traces on the job threads" );
+idCVar g_traceBatchRegion(			"g_traceBatchRegion",		"256",			CVAR_GAME | CVAR_FLOAT, "how far a batched trace may grow the bounds of its region before a new region is started" );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showviewpos(				"g_showviewpos",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showcamerainfo(			"g_showcamerainfo",			"0",			CVAR_GAME | CVAR_ARCHIVE, "displays the current frame # for the camera when playing cinematics" );
@@ -148,7 +153,16 @@ idCVar g_showActiveEntities(		"g_showActiveEntities",		"0",			CVAR_GAME | CVAR_B
 idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws boxes around monsters that have targeted the the player" );
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
+idCVar g_eventStats(				"g_eventStats",				"0",			CVAR_GAME | CVAR_INTEGER, "when non-zero, prints the number of events processed each game frame and lists the given number of most called events" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_parallelThink(				"g_parallelThink",			"0",			CVAR_GAME | CVAR_BOOL, "group the thinking entities by dependency and run the physics and animation of independent groups on the job threads, the results are committed serially (single player only)" );
+idCVar g_checkParallelThink(		"g_checkParallelThink",		"0",			CVAR_GAME | CVAR_BOOL, "evaluate the physics and animation done on the job threads by g_parallelThink again serially and warn when they differ" );
+idCVar g_animFrameCache(			"g_animFrameCache",			"1",			CVAR_GAME | CVAR_BOOL, "reuse the joints of animation frames already decoded by other entities in the same game frame" );
+idCVar g_animCompress(				"g_animCompress",			"1",			CVAR_GAME | CVAR_BOOL, "store the frames of anims loaded from now on as 16 bit values" );
+idCVar g_animCompressError(			"g_animCompressError",		"0",			CVAR_GAME | CVAR_FLOAT, "drop frames of compressed anims that can be interpolated from the frames around them within this many units, 0 keeps all frames", 0.0f, 10.0f );
+idCVar g_animLOD(					"g_animLOD",				"1",			CVAR_GAME | CVAR_BOOL, "update the animation frames of distant entities less often and don't create the frames of entities out of view ahead of time" );
+idCVar g_animLODDistance(			"g_animLODDistance",		"1024",			CVAR_GAME | CVAR_FLOAT, "distance from the view at a 90 degree field of view beyond which animation frames are updated less often" );
+idCVar g_animLODMaxInterval(		"g_animLODMaxInterval",		"4",			CVAR_GAME | CVAR_INTEGER, "most game frames the animation frame of a distant entity is reused", 1, 16 );
 
 idCVar ai_debugScript(				"ai_debugScript",			"-1",			CVAR_GAME | CVAR_INTEGER, "displays script calls for the specified monster entity number" );
 idCVar ai_debugMove(				"ai_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "draws movement information for monsters" );
@@ -156,6 +170,8 @@ idCVar ai_debugTrajectory(			"ai_debugTrajectory",		"0",			CVAR_GAME | CVAR_BOOL
 idCVar ai_testPredictPath(			"ai_testPredictPath",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar ai_showCombatNodes(			"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL, "draws attack cones for monsters" );
 idCVar ai_showPaths(				"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
+idCVar ai_obstacleHash(				"ai_obstacleHash",			"1",			CVAR_GAME | CVAR_BOOL, "find the actors and moveables near monsters with a grid that is updated every frame instead of going through all clip models" );
+idCVar ai_obstacleStats(			"ai_obstacleStats",			"0",			CVAR_GAME | CVAR_BOOL, "print the number of obstacle queries, tested entities and found clip models every frame" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
 
@@ -223,6 +239,8 @@ idCVar af_showInertia(				"af_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "sho
 idCVar af_showVelocity(				"af_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each body" );
 idCVar af_showActive(				"af_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show tree-like structures of articulated figures not at rest" );
 idCVar af_testSolid(				"af_testSolid",				"1",			CVAR_GAME | CVAR_BOOL, "test for bodies initially stuck in solid" );
+idCVar af_lcpGaussSeidelRows(		"af_lcpGaussSeidelRows",	"0",			CVAR_GAME | CVAR_INTEGER, "solve auxiliary constraint systems with at least this many rows with projected Gauss-Seidel instead of pivoting, 0 = only when pivoting fails" );
+idCVar af_recordLCP(				"af_recordLCP",				"0",			CVAR_GAME | CVAR_INTEGER, "number of auxiliary constraint systems to append to afsystems.lcp for lcpBenchmark" );
 
 idCVar rb_showTimings(				"rb_showTimings",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid body cpu usage" );
 idCVar rb_showBodies(				"rb_showBodies",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies" );
@@ -230,6 +248,9 @@ idCVar rb_showMass(					"rb_showMass",				"0",			CVAR_GAME | CVAR_BOOL, "show th
 idCVar rb_showInertia(				"rb_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "show the inertia tensor of each rigid body" );
 idCVar rb_showVelocity(				"rb_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each rigid body" );
 idCVar rb_showActive(				"rb_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies that are not at rest" );
+idCVar rb_showStats(				"rb_showStats",				"0",			CVAR_GAME | CVAR_BOOL, "show the number of awake rigid bodies and contact queries each frame" );
+idCVar rb_contactCache(				"rb_contactCache",			"0",			CVAR_GAME | CVAR_BOOL, "reuse the contacts of rigid bodies that barely moved instead of querying them again" );
+idCVar rb_islandRestTime(			"rb_islandRestTime",		"0",			CVAR_GAME | CVAR_INTEGER, "milliseconds touching rigid bodies must be nearly motionless before they are put to rest together, 0 = disabled" );
 
 // The default values for player movement cvars are set in def/player.def
 idCVar pm_jumpheight(				"pm_jumpheight",			"48",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_FLOAT, "approximate height the player can jump" );
@@ -309,6 +330,9 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_precomputeRouting(		"aas_precomputeRouting",	"32",			CVAR_GAME | CVAR_INTEGER, "megabytes of routing cache to precompute for all areas when the map is loaded, 0 = calculate routing cache only when used", 0, 1024 );
+idCVar aas_pathQueryBudget(			"aas_pathQueryBudget",		"0",			CVAR_GAME | CVAR_INTEGER, "number of queued path queries from AI answered per frame, 0 = AI create their paths immediately", 0, 1024 );
+idCVar aas_routingFile(				"aas_routingFile",			"1",			CVAR_GAME | CVAR_BOOL, "read the precomputed routing cache from and write it to a .route file next to the .aas file" );
 
 idCVar g_password(					"g_password",				"",				CVAR_GAME | CVAR_ARCHIVE, "game password" );
 idCVar password(					"password",					"",				CVAR_GAME | CVAR_NOCHEAT, "client password used when connecting" );
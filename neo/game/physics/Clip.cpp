@@ -27,7 +27,9 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/Timer.h"
 #include "gamesys/SaveGame.h"
+#include "gamesys/SysCvar.h"
 #include "Entity.h"
 #include "Game_local.h"
 
@@ -36,6 +38,10 @@ If you have questions concerning this license or the applicable additional terms
 #define	MAX_SECTOR_DEPTH				12
 #define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
 
+#define CLIP_TREE_MARGIN				4.0f		// clip model bounds are fattened by this much in the tree
+#define CLIP_TREE_PREDICT				2.0f		// and stretched this many times the last move
+#define CLIP_TREE_MAX_PREDICT			128.0f		// unless the clip model was teleported
+
 typedef struct clipSector_s {
 	int						axis;		// -1 = leaf node
 	float					dist;
@@ -75,6 +81,28 @@ idBlockAlloc<clipLink_t, 1024>	clipLinkAllocator;
 static idList<trmCache_s*>		traceModelCache;
 static idHashIndex				traceModelHash;
 
+// per trace state for idClip::TraceBatch
+typedef struct clipBatchTrace_s {
+	idBounds				bounds;
+	int						firstCandidate;
+	int						numCandidates;
+	int						numTranslations;
+	int						numRenderModels;
+	bool					done;
+} clipBatchTrace_t;
+
+typedef struct clipBatchJob_s {
+	clipTrace_t *			traces;
+	clipBatchTrace_t *		work;
+	idClipModel **			candidates;
+	int						numTraces;
+} clipBatchJob_t;
+
+static const int			CLIP_BATCH_TRACES_PER_JOB = 8;
+
+static idList<clipBatchTrace_t>	batchTraces;
+static idList<idClipModel *>	batchCandidates;
+
 /*
 ===============
 idClipModel::ClearTraceModelCache
@@ -286,6 +314,8 @@ void idClipModel::Init( void ) {
 	renderModelHandle = -1;
 	traceModelIndex = -1;
 	clipLinks = NULL;
+	clipProxy = -1;
+	proxyLinked = false;
 	touchCount = -1;
 }
 
@@ -352,6 +382,8 @@ idClipModel::idClipModel( const idClipModel *model ) {
 	}
 	renderModelHandle = model->renderModelHandle;
 	clipLinks = NULL;
+	clipProxy = -1;
+	proxyLinked = false;
 	touchCount = -1;
 }
 
@@ -363,6 +395,9 @@ idClipModel::~idClipModel
 idClipModel::~idClipModel( void ) {
 	// make sure the clip model is no longer linked
 	Unlink();
+	if ( clipProxy != -1 ) {
+		gameLocal.clip.RemoveProxy( this );
+	}
 	if ( traceModelIndex != -1 ) {
 		FreeTraceModel( traceModelIndex );
 	}
@@ -391,7 +426,7 @@ void idClipModel::Save( idSaveGame *savefile ) const {
 	}
 	savefile->WriteInt( traceModelIndex );
 	savefile->WriteInt( renderModelHandle );
-	savefile->WriteBool( clipLinks != NULL );
+	savefile->WriteBool( IsLinked() );
 	savefile->WriteInt( touchCount );
 }
 
@@ -431,6 +466,8 @@ void idClipModel::Restore( idRestoreGame *savefile ) {
 	// the render model will be set when the clip model is linked
 	renderModelHandle = -1;
 	clipLinks = NULL;
+	clipProxy = -1;
+	proxyLinked = false;
 	touchCount = -1;
 
 	if ( linked ) {
@@ -493,6 +530,10 @@ idClipModel::Unlink
 void idClipModel::Unlink( void ) {
 	clipLink_t *link;
 
+	// the tree leaf is kept until the clip model is linked again, most
+	// clip models are unlinked for a move and linked close to where they were
+	proxyLinked = false;
+
 	for ( link = clipLinks; link; link = clipLinks ) {
 		clipLinks = link->nextLink;
 		if ( link->prevInSector ) {
@@ -574,7 +615,14 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
-	Link_r( clp.clipSectors );
+	if ( clp.useClipTree ) {
+		clp.LinkProxy( this );
+		if ( clp.checkClipTree ) {
+			Link_r( clp.clipSectors );
+		}
+	} else {
+		Link_r( clp.clipSectors );
+	}
 }
 
 /*
@@ -625,7 +673,13 @@ idClip::idClip( void ) {
 	numClipSectors = 0;
 	clipSectors = NULL;
 	worldBounds.Zero();
+	touchCount = -1;
+	useClipTree = false;
+	checkClipTree = false;
+	treeRoot = -1;
+	treeFreeNode = -1;
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numClipModelTests = 0;
 }
 
 /*
@@ -698,6 +752,13 @@ void idClip::Init( void ) {
 	// create world sectors
 	CreateClipSectors_r( 0, worldBounds, maxSector );
 
+	// the sectors are always created so the benchmark can switch between them and the tree
+	useClipTree = g_clipModelTree.GetBool();
+	checkClipTree = useClipTree && g_checkClipModelTree.GetBool();
+	treeNodes.SetGranularity( 1024 );
+	treeRoot = -1;
+	treeFreeNode = -1;
+
 	size = worldBounds[1] - worldBounds[0];
 	gameLocal.Printf( "map bounds are (%1.1f, %1.1f, %1.1f)\n", size[0], size[1], size[2] );
 	gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
@@ -731,6 +792,440 @@ void idClip::Shutdown( void ) {
 	}
 
 	clipLinkAllocator.Shutdown();
+
+	ClearClipModelTree();
+
+	batchTraces.Clear();
+	batchCandidates.Clear();
+}
+
+/*
+===============================================================
+
+	idClip dynamic bounding box tree
+
+	Clip models are stored in the leaves with bounds that are a bit larger
+	than the clip model and stretched in the direction it last moved, so a
+	moving clip model usually stays inside its leaf and relinking is free.
+	The tree is kept balanced with rotations like an AVL tree.
+
+===============================================================
+*/
+
+/*
+================
+ClipTreeArea
+
+  surface area cost used to decide where to insert a leaf
+================
+*/
+static ID_INLINE float ClipTreeArea( const idBounds &bounds ) {
+	idVec3 size = bounds[1] - bounds[0];
+	return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+/*
+================
+idClip::AllocTreeNode
+================
+*/
+int idClip::AllocTreeNode( void ) {
+	int nodeNum;
+
+	if ( treeFreeNode != -1 ) {
+		nodeNum = treeFreeNode;
+		treeFreeNode = treeNodes[nodeNum].parent;
+	} else {
+		nodeNum = treeNodes.Num();
+		treeNodes.AssureSize( nodeNum + 1 );
+	}
+
+	clipTreeNode_t &node = treeNodes[nodeNum];
+	node.bounds.Clear();
+	node.clipModel = NULL;
+	node.parent = -1;
+	node.children[0] = node.children[1] = -1;
+	node.height = 0;
+	return nodeNum;
+}
+
+/*
+================
+idClip::FreeTreeNode
+================
+*/
+void idClip::FreeTreeNode( int nodeNum ) {
+	clipTreeNode_t &node = treeNodes[nodeNum];
+	node.clipModel = NULL;
+	node.parent = treeFreeNode;
+	node.height = -1;
+	treeFreeNode = nodeNum;
+}
+
+/*
+================
+idClip::BalanceTreeNode
+
+  rotates the higher child up if the children heights differ by more than one,
+  returns the node now at the position of the given node
+================
+*/
+int idClip::BalanceTreeNode( int iA ) {
+	clipTreeNode_t *A = &treeNodes[iA];
+
+	if ( A->children[0] == -1 || A->height < 2 ) {
+		return iA;
+	}
+
+	int iB = A->children[0];
+	int iC = A->children[1];
+	clipTreeNode_t *B = &treeNodes[iB];
+	clipTreeNode_t *C = &treeNodes[iC];
+	int balance = C->height - B->height;
+
+	// rotate C up
+	if ( balance > 1 ) {
+		int iF = C->children[0];
+		int iG = C->children[1];
+		clipTreeNode_t *F = &treeNodes[iF];
+		clipTreeNode_t *G = &treeNodes[iG];
+
+		C->children[0] = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if ( C->parent != -1 ) {
+			clipTreeNode_t &parent = treeNodes[C->parent];
+			parent.children[parent.children[0] == iA ? 0 : 1] = iC;
+		} else {
+			treeRoot = iC;
+		}
+
+		if ( F->height > G->height ) {
+			C->children[1] = iF;
+			A->children[1] = iG;
+			G->parent = iA;
+			A->bounds = B->bounds + G->bounds;
+			C->bounds = A->bounds + F->bounds;
+			A->height = 1 + Max( B->height, G->height );
+			C->height = 1 + Max( A->height, F->height );
+		} else {
+			C->children[1] = iG;
+			A->children[1] = iF;
+			F->parent = iA;
+			A->bounds = B->bounds + F->bounds;
+			C->bounds = A->bounds + G->bounds;
+			A->height = 1 + Max( B->height, F->height );
+			C->height = 1 + Max( A->height, G->height );
+		}
+		return iC;
+	}
+
+	// rotate B up
+	if ( balance < -1 ) {
+		int iD = B->children[0];
+		int iE = B->children[1];
+		clipTreeNode_t *D = &treeNodes[iD];
+		clipTreeNode_t *E = &treeNodes[iE];
+
+		B->children[0] = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if ( B->parent != -1 ) {
+			clipTreeNode_t &parent = treeNodes[B->parent];
+			parent.children[parent.children[0] == iA ? 0 : 1] = iB;
+		} else {
+			treeRoot = iB;
+		}
+
+		if ( D->height > E->height ) {
+			B->children[1] = iD;
+			A->children[0] = iE;
+			E->parent = iA;
+			A->bounds = C->bounds + E->bounds;
+			B->bounds = A->bounds + D->bounds;
+			A->height = 1 + Max( C->height, E->height );
+			B->height = 1 + Max( A->height, D->height );
+		} else {
+			B->children[1] = iE;
+			A->children[0] = iD;
+			D->parent = iA;
+			A->bounds = C->bounds + D->bounds;
+			B->bounds = A->bounds + E->bounds;
+			A->height = 1 + Max( C->height, D->height );
+			B->height = 1 + Max( A->height, E->height );
+		}
+		return iB;
+	}
+
+	return iA;
+}
+
+/*
+================
+idClip::InsertTreeLeaf
+================
+*/
+void idClip::InsertTreeLeaf( int leaf ) {
+	int index, sibling, oldParent, newParent, child0, child1;
+	float area, combinedArea, cost, inheritanceCost, cost0, cost1;
+	idBounds leafBounds;
+
+	if ( treeRoot == -1 ) {
+		treeRoot = leaf;
+		treeNodes[leaf].parent = -1;
+		return;
+	}
+
+	// find the best sibling for the new leaf
+	leafBounds = treeNodes[leaf].bounds;
+	index = treeRoot;
+	while( treeNodes[index].children[0] != -1 ) {
+		const clipTreeNode_t &node = treeNodes[index];
+		child0 = node.children[0];
+		child1 = node.children[1];
+
+		area = ClipTreeArea( node.bounds );
+		combinedArea = ClipTreeArea( node.bounds + leafBounds );
+
+		// cost of creating a new parent for this node and the new leaf
+		cost = 2.0f * combinedArea;
+		// minimum cost of pushing the leaf further down the tree
+		inheritanceCost = 2.0f * ( combinedArea - area );
+
+		cost0 = ClipTreeArea( treeNodes[child0].bounds + leafBounds ) + inheritanceCost;
+		if ( treeNodes[child0].children[0] != -1 ) {
+			cost0 -= ClipTreeArea( treeNodes[child0].bounds );
+		}
+		cost1 = ClipTreeArea( treeNodes[child1].bounds + leafBounds ) + inheritanceCost;
+		if ( treeNodes[child1].children[0] != -1 ) {
+			cost1 -= ClipTreeArea( treeNodes[child1].bounds );
+		}
+
+		if ( cost < cost0 && cost < cost1 ) {
+			break;
+		}
+		index = ( cost0 < cost1 ) ? child0 : child1;
+	}
+	sibling = index;
+
+	// create a new parent for the sibling and the leaf
+	oldParent = treeNodes[sibling].parent;
+	newParent = AllocTreeNode();
+	clipTreeNode_t &parent = treeNodes[newParent];
+	parent.parent = oldParent;
+	parent.bounds = leafBounds + treeNodes[sibling].bounds;
+	parent.height = treeNodes[sibling].height + 1;
+	parent.children[0] = sibling;
+	parent.children[1] = leaf;
+	treeNodes[sibling].parent = newParent;
+	treeNodes[leaf].parent = newParent;
+
+	if ( oldParent != -1 ) {
+		clipTreeNode_t &node = treeNodes[oldParent];
+		node.children[node.children[0] == sibling ? 0 : 1] = newParent;
+	} else {
+		treeRoot = newParent;
+	}
+
+	// walk back up fixing heights and bounds
+	index = treeNodes[leaf].parent;
+	while( index != -1 ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		node.height = 1 + Max( treeNodes[node.children[0]].height, treeNodes[node.children[1]].height );
+		node.bounds = treeNodes[node.children[0]].bounds + treeNodes[node.children[1]].bounds;
+		index = node.parent;
+	}
+}
+
+/*
+================
+idClip::RemoveTreeLeaf
+================
+*/
+void idClip::RemoveTreeLeaf( int leaf ) {
+	int index, parent, grandParent, sibling;
+
+	if ( leaf == treeRoot ) {
+		treeRoot = -1;
+		return;
+	}
+
+	parent = treeNodes[leaf].parent;
+	grandParent = treeNodes[parent].parent;
+	sibling = treeNodes[parent].children[treeNodes[parent].children[0] == leaf ? 1 : 0];
+
+	FreeTreeNode( parent );
+	treeNodes[leaf].parent = -1;
+
+	if ( grandParent == -1 ) {
+		treeRoot = sibling;
+		treeNodes[sibling].parent = -1;
+		return;
+	}
+
+	// connect the sibling to the grand parent
+	clipTreeNode_t &grandParentNode = treeNodes[grandParent];
+	grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+	treeNodes[sibling].parent = grandParent;
+
+	index = grandParent;
+	while( index != -1 ) {
+		index = BalanceTreeNode( index );
+
+		clipTreeNode_t &node = treeNodes[index];
+		node.height = 1 + Max( treeNodes[node.children[0]].height, treeNodes[node.children[1]].height );
+		node.bounds = treeNodes[node.children[0]].bounds + treeNodes[node.children[1]].bounds;
+		index = node.parent;
+	}
+}
+
+/*
+================
+idClip::LinkProxy
+================
+*/
+void idClip::LinkProxy( idClipModel *clipModel ) {
+	int i, proxy;
+	idVec3 move;
+	idBounds fatBounds;
+	const idBounds &absBounds = clipModel->absBounds;
+
+	proxy = clipModel->clipProxy;
+	if ( proxy != -1 ) {
+		const idBounds &leafBounds = treeNodes[proxy].bounds;
+
+		// nothing to do if the clip model is still inside its leaf
+		if (	absBounds[0][0] >= leafBounds[0][0] && absBounds[1][0] <= leafBounds[1][0] &&
+				absBounds[0][1] >= leafBounds[0][1] && absBounds[1][1] <= leafBounds[1][1] &&
+				absBounds[0][2] >= leafBounds[0][2] && absBounds[1][2] <= leafBounds[1][2] ) {
+			clipModel->proxyLinked = true;
+			return;
+		}
+
+		move = absBounds.GetCenter() - leafBounds.GetCenter();
+		RemoveTreeLeaf( proxy );
+	} else {
+		move.Zero();
+		proxy = AllocTreeNode();
+		treeNodes[proxy].clipModel = clipModel;
+		clipModel->clipProxy = proxy;
+	}
+
+	fatBounds[0] = absBounds[0] - idVec3( CLIP_TREE_MARGIN, CLIP_TREE_MARGIN, CLIP_TREE_MARGIN );
+	fatBounds[1] = absBounds[1] + idVec3( CLIP_TREE_MARGIN, CLIP_TREE_MARGIN, CLIP_TREE_MARGIN );
+
+	// stretch the leaf in the direction the clip model is moving
+	if ( move.LengthSqr() < Square( CLIP_TREE_MAX_PREDICT ) ) {
+		for ( i = 0; i < 3; i++ ) {
+			if ( move[i] < 0.0f ) {
+				fatBounds[0][i] += CLIP_TREE_PREDICT * move[i];
+			} else {
+				fatBounds[1][i] += CLIP_TREE_PREDICT * move[i];
+			}
+		}
+	}
+
+	treeNodes[proxy].bounds = fatBounds;
+	InsertTreeLeaf( proxy );
+	clipModel->proxyLinked = true;
+}
+
+/*
+================
+idClip::RemoveProxy
+================
+*/
+void idClip::RemoveProxy( idClipModel *clipModel ) {
+	int proxy = clipModel->clipProxy;
+
+	// the tree may have been cleared since the clip model was linked
+	if ( proxy >= 0 && proxy < treeNodes.Num() && treeNodes[proxy].clipModel == clipModel ) {
+		RemoveTreeLeaf( proxy );
+		FreeTreeNode( proxy );
+	}
+	clipModel->clipProxy = -1;
+	clipModel->proxyLinked = false;
+}
+
+/*
+================
+idClip::ClearClipModelTree
+================
+*/
+void idClip::ClearClipModelTree( void ) {
+	for ( int i = 0; i < treeNodes.Num(); i++ ) {
+		if ( treeNodes[i].height != -1 && treeNodes[i].clipModel ) {
+			treeNodes[i].clipModel->clipProxy = -1;
+			treeNodes[i].clipModel->proxyLinked = false;
+		}
+	}
+	treeNodes.Clear();
+	treeRoot = -1;
+	treeFreeNode = -1;
+}
+
+/*
+================
+idClip::GetLinkedClipModels
+================
+*/
+int idClip::GetLinkedClipModels( idList<idClipModel *> &clipModels ) const {
+	int i;
+	clipLink_t *link;
+
+	clipModels.Clear();
+	if ( useClipTree ) {
+		for ( i = 0; i < treeNodes.Num(); i++ ) {
+			if ( treeNodes[i].height != -1 && treeNodes[i].clipModel && treeNodes[i].clipModel->proxyLinked ) {
+				clipModels.Append( treeNodes[i].clipModel );
+			}
+		}
+	} else {
+		touchCount++;
+		for ( i = 0; i < numClipSectors; i++ ) {
+			for ( link = clipSectors[i].clipLinks; link; link = link->nextInSector ) {
+				if ( link->clipModel->touchCount != touchCount ) {
+					link->clipModel->touchCount = touchCount;
+					clipModels.Append( link->clipModel );
+				}
+			}
+		}
+	}
+	return clipModels.Num();
+}
+
+/*
+================
+idClip::SetClipModelTree
+
+  relinks all clip models into either the tree or the sectors
+================
+*/
+void idClip::SetClipModelTree( bool enable ) {
+	int i;
+	idList<idClipModel *> clipModels;
+
+	if ( enable == useClipTree ) {
+		return;
+	}
+
+	GetLinkedClipModels( clipModels );
+	// also unlinks from the sectors the clip models are linked into when checking the tree
+	for ( i = 0; i < clipModels.Num(); i++ ) {
+		clipModels[i]->Unlink();
+	}
+	if ( useClipTree ) {
+		ClearClipModelTree();
+	}
+
+	useClipTree = enable;
+	for ( i = 0; i < clipModels.Num(); i++ ) {
+		clipModels[i]->Link( *this );
+	}
 }
 
 /*
@@ -762,40 +1257,94 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
 		idClipModel	*check = link->clipModel;
 
-		// if the clip model is enabled
-		if ( !check->enabled ) {
-			continue;
-		}
-
 		// avoid duplicates in the list
 		if ( check->touchCount == touchCount ) {
 			continue;
 		}
 
-		// if the clip model does not have any contents we are looking for
-		if ( !( check->contents & parms.contentMask ) ) {
-			continue;
+		if ( !AddTouchingClipModel( check, parms ) ) {
+			return;
 		}
+	}
+}
 
-		// if the bounds really do overlap
-		if (	check->absBounds[0][0] > parms.bounds[1][0] ||
-				check->absBounds[1][0] < parms.bounds[0][0] ||
-				check->absBounds[0][1] > parms.bounds[1][1] ||
-				check->absBounds[1][1] < parms.bounds[0][1] ||
-				check->absBounds[0][2] > parms.bounds[1][2] ||
-				check->absBounds[1][2] < parms.bounds[0][2] ) {
-			continue;
+/*
+====================
+idClip::ClipModelsTouchingTree_r
+
+  returns false if the list is full
+====================
+*/
+bool idClip::ClipModelsTouchingTree_r( int nodeNum, listParms_t &parms ) const {
+	const clipTreeNode_t *node;
+
+	while( 1 ) {
+		node = &treeNodes[nodeNum];
+
+		if (	node->bounds[0][0] > parms.bounds[1][0] ||
+				node->bounds[1][0] < parms.bounds[0][0] ||
+				node->bounds[0][1] > parms.bounds[1][1] ||
+				node->bounds[1][1] < parms.bounds[0][1] ||
+				node->bounds[0][2] > parms.bounds[1][2] ||
+				node->bounds[1][2] < parms.bounds[0][2] ) {
+			return true;
 		}
 
-		if ( parms.count >= parms.maxCount ) {
-			gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
-			return;
+		if ( node->children[0] == -1 ) {
+			// leaves of unlinked clip models are kept around until they are linked again
+			if ( node->clipModel->proxyLinked ) {
+				return AddTouchingClipModel( node->clipModel, parms );
+			}
+			return true;
+		}
+
+		if ( !ClipModelsTouchingTree_r( node->children[0], parms ) ) {
+			return false;
 		}
+		nodeNum = node->children[1];
+	}
+}
+
+/*
+====================
+idClip::AddTouchingClipModel
+
+  returns false if the list is full
+====================
+*/
+bool idClip::AddTouchingClipModel( idClipModel *check, listParms_t &parms ) const {
 
-		check->touchCount = touchCount;
-		parms.list[parms.count] = check;
-		parms.count++;
+	numClipModelTests++;
+
+	// if the clip model is enabled
+	if ( !check->enabled ) {
+		return true;
+	}
+
+	// if the clip model does not have any contents we are looking for
+	if ( !( check->contents & parms.contentMask ) ) {
+		return true;
+	}
+
+	// if the bounds really do overlap
+	if (	check->absBounds[0][0] > parms.bounds[1][0] ||
+			check->absBounds[1][0] < parms.bounds[0][0] ||
+			check->absBounds[0][1] > parms.bounds[1][1] ||
+			check->absBounds[1][1] < parms.bounds[0][1] ||
+			check->absBounds[0][2] > parms.bounds[1][2] ||
+			check->absBounds[1][2] < parms.bounds[0][2] ) {
+		return true;
 	}
+
+	if ( parms.count >= parms.maxCount ) {
+		gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
+		return false;
+	}
+
+	check->touchCount = touchCount;
+	parms.list[parms.count] = check;
+	parms.count++;
+	return true;
 }
 
 /*
@@ -822,11 +1371,57 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	parms.maxCount = maxCount;
 
 	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+	if ( useClipTree ) {
+		if ( treeRoot != -1 ) {
+			ClipModelsTouchingTree_r( treeRoot, parms );
+		}
+		if ( checkClipTree ) {
+			CheckClipModelTree( parms );
+		}
+	} else {
+		ClipModelsTouchingBounds_r( clipSectors, parms );
+	}
 
 	return parms.count;
 }
 
+/*
+================
+idClip::CheckClipModelTree
+
+  runs the query of the tree again with the sectors and warns when they found other clip models
+================
+*/
+void idClip::CheckClipModelTree( const listParms_t &treeParms ) const {
+	int i;
+	listParms_t parms;
+	idClipModel *clipModelList[MAX_GENTITIES];
+
+	parms = treeParms;
+	parms.list = clipModelList;
+	parms.count = 0;
+	parms.maxCount = MAX_GENTITIES;
+
+	touchCount++;
+	ClipModelsTouchingBounds_r( clipSectors, parms );
+
+	// either list may be incomplete when it is full
+	if ( treeParms.count >= treeParms.maxCount || parms.count >= parms.maxCount ) {
+		return;
+	}
+
+	// the clip models found with the sectors are marked with the new touchCount,
+	// both queries found the same clip models if every one of the tree is marked
+	for ( i = 0; i < treeParms.count; i++ ) {
+		if ( treeParms.list[i]->touchCount != touchCount ) {
+			break;
+		}
+	}
+	if ( i < treeParms.count || parms.count != treeParms.count ) {
+		gameLocal.Warning( "idClip::ClipModelsTouchingBounds: the clip model tree found %d clip models, the sectors %d", treeParms.count, parms.count );
+	}
+}
+
 /*
 ================
 idClip::EntitiesTouchingBounds
@@ -860,18 +1455,52 @@ int idClip::EntitiesTouchingBounds( const idBounds &bounds, int contentMask, idE
 
 /*
 ====================
-idClip::GetTraceClipModels
+idClip::GetPassOwner
+====================
+*/
+idEntity *idClip::GetPassOwner( const idEntity *passEntity ) {
+	if ( passEntity && passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
+		return passEntity->GetPhysics()->GetClipModel()->GetOwner();
+	}
+	return NULL;
+}
 
-  an ent will be excluded from testing if:
+/*
+====================
+idClip::SkipTraceClipModel
+
+  an ent will be excluded from testing if:
   cm->entity == passEntity ( don't clip against the pass entity )
   cm->entity == passOwner ( missiles don't clip with owner )
   cm->owner == passEntity ( don't interact with your own missiles )
   cm->owner == passOwner ( don't interact with other missiles from same owner )
 ====================
 */
+bool idClip::SkipTraceClipModel( const idClipModel *cm, const idEntity *passEntity, const idEntity *passOwner ) {
+	if ( !passEntity ) {
+		return false;
+	}
+	if ( cm->entity == passEntity ) {
+		return true;			// don't clip against the pass entity
+	} else if ( cm->entity == passOwner ) {
+		return true;			// missiles don't clip with their owner
+	} else if ( cm->owner ) {
+		if ( cm->owner == passEntity ) {
+			return true;		// don't clip against own missiles
+		} else if ( cm->owner == passOwner ) {
+			return true;		// don't clip against other missiles from same owner
+		}
+	}
+	return false;
+}
+
+/*
+====================
+idClip::GetTraceClipModels
+====================
+*/
 int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const {
 	int i, num;
-	idClipModel	*cm;
 	idEntity *passOwner;
 
 	num = ClipModelsTouchingBounds( bounds, contentMask, clipModelList, MAX_GENTITIES );
@@ -880,27 +1509,12 @@ int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const i
 		return num;
 	}
 
-	if ( passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
-		passOwner = passEntity->GetPhysics()->GetClipModel()->GetOwner();
-	} else {
-		passOwner = NULL;
-	}
+	passOwner = GetPassOwner( passEntity );
 
 	for ( i = 0; i < num; i++ ) {
-
-		cm = clipModelList[i];
-
 		// check if we should ignore this entity
-		if ( cm->entity == passEntity ) {
-			clipModelList[i] = NULL;			// don't clip against the pass entity
-		} else if ( cm->entity == passOwner ) {
-			clipModelList[i] = NULL;			// missiles don't clip with their owner
-		} else if ( cm->owner ) {
-			if ( cm->owner == passEntity ) {
-				clipModelList[i] = NULL;		// don't clip against own missiles
-			} else if ( cm->owner == passOwner ) {
-				clipModelList[i] = NULL;		// don't clip against other missiles from same owner
-			}
+		if ( SkipTraceClipModel( clipModelList[i], passEntity, passOwner ) ) {
+			clipModelList[i] = NULL;
 		}
 	}
 
@@ -1131,6 +1745,273 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+============
+idClip::TraceBatchTranslation
+
+  Same as Translation but only tests the candidates gathered by TraceBatch and
+  skips render models, those are traced afterwards on the calling thread.
+  Safe to run from the job threads.
+============
+*/
+void idClip::TraceBatchTranslation( clipTrace_t &trace, clipBatchTrace_t &work, idClipModel **candidates ) {
+	int i;
+	idClipModel *touch;
+	idBounds traceBounds;
+	trace_t tr;
+	idTraceModel boxTrm;
+	const idTraceModel *trm;
+	trace_t &results = trace.results;
+
+	if ( trace.bounds.IsCleared() ) {
+		trm = NULL;
+	} else {
+		boxTrm.SetupBox( trace.bounds );
+		trm = &boxTrm;
+	}
+
+	if ( !trace.passEntity || trace.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		work.numTranslations++;
+		collisionModelManager->Translation( &results, trace.start, trace.end, trm, mat3_identity, trace.contentMask, 0, vec3_origin, mat3_default );
+		results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+		if ( results.fraction == 0.0f ) {
+			work.numRenderModels = 0;
+			return;		// blocked immediately by the world
+		}
+	} else {
+		memset( &results, 0, sizeof( results ) );
+		results.fraction = 1.0f;
+		results.endpos = trace.end;
+		results.endAxis = mat3_identity;
+	}
+
+	if ( !trm ) {
+		traceBounds.FromPointTranslation( trace.start, results.endpos - trace.start );
+	} else {
+		traceBounds.FromBoundsTranslation( trm->bounds, trace.start, mat3_identity, results.endpos - trace.start );
+	}
+	traceBounds[0] -= vec3_boxEpsilon;
+	traceBounds[1] += vec3_boxEpsilon;
+
+	for ( i = 0; i < work.numCandidates; i++ ) {
+		touch = candidates[work.firstCandidate + i];
+
+		if ( touch->renderModelHandle != -1 ) {
+			continue;
+		}
+
+		// the candidates were gathered with the full trace bounds
+		if ( !traceBounds.IntersectsBounds( touch->absBounds ) ) {
+			continue;
+		}
+
+		work.numTranslations++;
+		collisionModelManager->Translation( &tr, trace.start, trace.end, trm, mat3_identity, trace.contentMask,
+								touch->Handle(), touch->origin, touch->axis );
+
+		if ( tr.fraction < results.fraction ) {
+			results = tr;
+			results.c.entityNum = touch->entity->entityNumber;
+			results.c.id = touch->id;
+			if ( results.fraction == 0.0f ) {
+				work.numRenderModels = 0;
+				return;
+			}
+		}
+	}
+}
+
+/*
+============
+idClip::TraceBatchJob
+============
+*/
+void idClip::TraceBatchJob( void *data, int jobNum ) {
+	clipBatchJob_t *job = reinterpret_cast<clipBatchJob_t *>( data );
+	int first = jobNum * CLIP_BATCH_TRACES_PER_JOB;
+	int last = Min( first + CLIP_BATCH_TRACES_PER_JOB, job->numTraces );
+
+	for ( int i = first; i < last; i++ ) {
+		if ( !job->work[i].done ) {
+			TraceBatchTranslation( job->traces[i], job->work[i], job->candidates );
+		}
+	}
+}
+
+/*
+============
+idClip::TraceBatch
+
+  Gives the same results as calling TracePoint or TraceBounds for each trace.
+  Traces are grouped into regions in the order given, so callers should pass
+  traces that are close to each other next to each other. The clip models
+  touching a region are gathered once for all its traces and the collision
+  tests of the whole batch can run on the job threads.
+============
+*/
+int idClip::TraceBatch( clipTrace_t *traces, int numTraces ) {
+	int i, j, k, num, numHits, regionMask;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	idBounds regionBounds, bounds;
+	idVec3 size;
+	float regionExtent, traceExtent, maxGrowth, radius;
+	const idEntity *passOwner;
+	clipBatchTrace_t *work;
+	clipBatchJob_t job;
+	trace_t tr;
+
+	if ( numTraces <= 0 ) {
+		return 0;
+	}
+
+	batchTraces.AssureSize( numTraces );
+	batchCandidates.SetNum( 0, false );
+	work = batchTraces.Ptr();
+
+	for ( i = 0; i < numTraces; i++ ) {
+		clipTrace_t &trace = traces[i];
+
+		work[i].firstCandidate = 0;
+		work[i].numCandidates = 0;
+		work[i].numTranslations = 0;
+		work[i].numRenderModels = 0;
+		work[i].done = false;
+
+		if ( trace.bounds.IsCleared() ) {
+			work[i].bounds.FromPointTranslation( trace.start, trace.end - trace.start );
+		} else {
+			if ( ( trace.end - trace.start ).LengthSqr() > Square( CM_MAX_TRACE_DIST ) ) {
+				temporaryClipModel.LoadModel( idTraceModel( trace.bounds ) );
+				if ( TestHugeTranslation( trace.results, &temporaryClipModel, trace.start, trace.end, mat3_identity ) ) {
+					work[i].done = true;
+					continue;
+				}
+			}
+			work[i].bounds.FromBoundsTranslation( trace.bounds, trace.start, mat3_identity, trace.end - trace.start );
+		}
+	}
+
+	// gather the clip models touching each region once
+	maxGrowth = g_traceBatchRegion.GetFloat();
+	for ( i = 0; i < numTraces; i = j ) {
+		if ( work[i].done ) {
+			j = i + 1;
+			continue;
+		}
+
+		regionBounds = work[i].bounds;
+		regionMask = traces[i].contentMask;
+		size = regionBounds[1] - regionBounds[0];
+		regionExtent = Max( size[0], Max( size[1], size[2] ) );
+
+		for ( j = i + 1; j < numTraces; j++ ) {
+			if ( work[j].done ) {
+				continue;
+			}
+			bounds = regionBounds + work[j].bounds;
+			size = work[j].bounds[1] - work[j].bounds[0];
+			traceExtent = Max( size[0], Max( size[1], size[2] ) );
+			size = bounds[1] - bounds[0];
+			if ( Max( size[0], Max( size[1], size[2] ) ) > Max( regionExtent, traceExtent ) + maxGrowth ) {
+				break;
+			}
+			regionBounds = bounds;
+			regionMask |= traces[j].contentMask;
+			regionExtent = Max( size[0], Max( size[1], size[2] ) );
+		}
+
+		num = ClipModelsTouchingBounds( regionBounds, regionMask, clipModelList, MAX_GENTITIES );
+
+		for ( k = i; k < j; k++ ) {
+			if ( work[k].done ) {
+				continue;
+			}
+
+			bounds[0] = work[k].bounds[0] - vec3_boxEpsilon;
+			bounds[1] = work[k].bounds[1] + vec3_boxEpsilon;
+			passOwner = GetPassOwner( traces[k].passEntity );
+
+			work[k].firstCandidate = batchCandidates.Num();
+			for ( int c = 0; c < num; c++ ) {
+				touch = clipModelList[c];
+				if ( !( touch->contents & traces[k].contentMask ) ) {
+					continue;
+				}
+				if ( !bounds.IntersectsBounds( touch->absBounds ) ) {
+					continue;
+				}
+				if ( SkipTraceClipModel( touch, traces[k].passEntity, passOwner ) ) {
+					continue;
+				}
+				if ( touch->renderModelHandle != -1 ) {
+					work[k].numRenderModels++;
+				}
+				batchCandidates.Append( touch );
+			}
+			work[k].numCandidates = batchCandidates.Num() - work[k].firstCandidate;
+		}
+	}
+
+	job.traces = traces;
+	job.work = work;
+	job.candidates = batchCandidates.Ptr();
+	job.numTraces = numTraces;
+
+	num = ( numTraces + CLIP_BATCH_TRACES_PER_JOB - 1 ) / CLIP_BATCH_TRACES_PER_JOB;
+	if ( g_traceBatchJobs.GetBool() && num > 1 && sys->GetNumJobThreads() > 0 ) {
+		sys->RunJobs( TraceBatchJob, &job, num );
+	} else {
+		for ( i = 0; i < num; i++ ) {
+			TraceBatchJob( &job, i );
+		}
+	}
+
+	// render models can't be traced from the job threads
+	numHits = 0;
+	for ( i = 0; i < numTraces; i++ ) {
+		clipTrace_t &trace = traces[i];
+
+		idClip::numTranslations += work[i].numTranslations;
+
+		if ( work[i].numRenderModels > 0 ) {
+			radius = trace.bounds.IsCleared() ? 0.0f : trace.bounds.GetRadius();
+			if ( trace.bounds.IsCleared() ) {
+				bounds.FromPointTranslation( trace.start, trace.results.endpos - trace.start );
+			} else {
+				bounds.FromBoundsTranslation( trace.bounds, trace.start, mat3_identity, trace.results.endpos - trace.start );
+			}
+			bounds[0] -= vec3_boxEpsilon;
+			bounds[1] += vec3_boxEpsilon;
+
+			for ( k = 0; k < work[i].numCandidates; k++ ) {
+				touch = batchCandidates[work[i].firstCandidate + k];
+				if ( touch->renderModelHandle == -1 || !bounds.IntersectsBounds( touch->absBounds ) ) {
+					continue;
+				}
+
+				idClip::numRenderModelTraces++;
+				TraceRenderModel( tr, trace.start, trace.end, radius, mat3_identity, touch );
+
+				if ( tr.fraction < trace.results.fraction ) {
+					trace.results = tr;
+					trace.results.c.entityNum = touch->entity->entityNumber;
+					trace.results.c.id = touch->id;
+					if ( trace.results.fraction == 0.0f ) {
+						break;
+					}
+				}
+			}
+		}
+
+		if ( trace.results.fraction < 1.0f ) {
+			numHits++;
+		}
+	}
+
+	return numHits;
+}
+
 /*
 ============
 idClip::Rotation
@@ -1359,6 +2240,360 @@ bool idClip::Motion( trace_t &results, const idVec3 &start, const idVec3 &end, c
 	return ( translationalTrace.fraction < 1.0f || rotationalTrace.fraction < 1.0f );
 }
 
+/*
+============
+idClip::StartMotion
+
+  Gathers the clip models the whole motion may collide with on the calling thread so
+  EvaluateMotion can do the collision detection on a job thread. Only translations and
+  motions that both translate and rotate a trace model are handled.
+============
+*/
+bool idClip::StartMotion( clipMotion_t &motion, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
+					const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
+	int i, num;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	idBounds bounds;
+	idVec3 dir;
+	const idTraceModel *trm;
+	clipMotionModel_t *model;
+
+	assert( rotation.GetOrigin() == start );
+
+	// huge translations are reported by Motion
+	if ( mdl == NULL || !mdl->IsTraceModel() || ( end - start ).LengthSqr() > Square( CM_MAX_TRACE_DIST ) ) {
+		return false;
+	}
+
+	if ( rotation.GetAngle() != 0.0f && rotation.GetVec() != vec3_origin ) {
+		if ( start == end ) {
+			return false;
+		}
+		motion.translation = false;
+	} else if ( start != end ) {
+		motion.translation = true;
+	} else {
+		return false;
+	}
+
+	trm = TraceModelForClipModel( mdl );
+
+	if ( motion.translation ) {
+		bounds.FromBoundsTranslation( trm->bounds, start, trmAxis, end - start );
+	} else {
+		bounds.FromBoundsRotation( trm->bounds, start, trmAxis, rotation );
+		dir = end - start;
+		for ( i = 0; i < 3; i++ ) {
+			if ( dir[i] < 0.0f ) {
+				bounds[0][i] += dir[i];
+			}
+			else {
+				bounds[1][i] += dir[i];
+			}
+		}
+	}
+
+	num = GetTraceClipModels( bounds, contentMask, passEntity, clipModelList );
+
+	motion.clipModels.SetNum( 0, false );
+	for ( i = 0; i < num; i++ ) {
+		touch = clipModelList[i];
+
+		if ( !touch ) {
+			continue;
+		}
+
+		// render models can't be traced from the job threads
+		if ( touch->renderModelHandle != -1 || ( !touch->collisionModelHandle && touch->traceModelIndex == -1 ) ) {
+			return false;
+		}
+
+		model = &motion.clipModels.Alloc();
+		model->clipModel = touch;
+		model->collisionModelHandle = touch->collisionModelHandle;
+		model->traceModelIndex = touch->traceModelIndex;
+		model->material = touch->material;
+		model->origin = touch->origin;
+		model->axis = touch->axis;
+		model->absBounds = touch->absBounds;
+	}
+
+	motion.start = start;
+	motion.end = end;
+	motion.rotation = rotation;
+	motion.mdl = mdl;
+	motion.traceModelIndex = mdl->traceModelIndex;
+	motion.trmAxis = trmAxis;
+	motion.contentMask = contentMask;
+	motion.passEntity = passEntity;
+	motion.numQueries = 0;
+
+	return true;
+}
+
+/*
+============
+idClip::MotionTranslation
+
+  Translates against the clip models of the motion that touch the bounds.
+============
+*/
+void idClip::MotionTranslation( clipMotion_t &motion, trace_t &results, const idTraceModel *trm, const idBounds &traceBounds ) {
+	int i;
+	idBounds bounds;
+	idClipModel *touch;
+	trace_t trace;
+
+	motion.queryBounds[motion.numQueries++] = traceBounds;
+
+	bounds[0] = traceBounds[0] - vec3_boxEpsilon;
+	bounds[1] = traceBounds[1] + vec3_boxEpsilon;
+
+	for ( i = 0; i < motion.clipModels.Num(); i++ ) {
+		// the clip models were gathered for the whole motion
+		if ( !bounds.IntersectsBounds( motion.clipModels[i].absBounds ) ) {
+			continue;
+		}
+
+		touch = motion.clipModels[i].clipModel;
+
+		motion.numTranslations++;
+		collisionModelManager->Translation( &trace, motion.start, motion.end, trm, motion.trmAxis, motion.contentMask,
+								touch->Handle(), touch->origin, touch->axis );
+
+		if ( trace.fraction < results.fraction ) {
+			results = trace;
+			results.c.entityNum = touch->entity->entityNumber;
+			results.c.id = touch->id;
+			if ( results.fraction == 0.0f ) {
+				break;
+			}
+		}
+	}
+}
+
+/*
+============
+idClip::EvaluateMotion
+
+  Same as Motion but only tests the clip models gathered by StartMotion.
+  Safe to run from the job threads.
+============
+*/
+void idClip::EvaluateMotion( clipMotion_t &motion ) {
+	int i;
+	idVec3 dir, endPosition;
+	idBounds traceBounds, bounds;
+	trace_t translationalTrace, rotationalTrace, trace;
+	idRotation endRotation;
+	idClipModel *touch;
+	const idTraceModel *trm;
+	const idVec3 &start = motion.start;
+	const idVec3 &end = motion.end;
+
+	trm = idClipModel::GetCachedTraceModel( motion.traceModelIndex );
+
+	motion.numQueries = 0;
+	motion.numTranslations = 0;
+	motion.numRotations = 0;
+
+	if ( motion.translation ) {
+		trace_t &results = motion.results;
+
+		if ( !motion.passEntity || motion.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+			// test world
+			motion.numTranslations++;
+			collisionModelManager->Translation( &results, start, end, trm, motion.trmAxis, motion.contentMask, 0, vec3_origin, mat3_default );
+			results.c.entityNum = results.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+			if ( results.fraction == 0.0f ) {
+				motion.collided = true;
+				return;		// blocked immediately by the world
+			}
+		} else {
+			memset( &results, 0, sizeof( results ) );
+			results.fraction = 1.0f;
+			results.endpos = end;
+			results.endAxis = motion.trmAxis;
+		}
+
+		traceBounds.FromBoundsTranslation( trm->bounds, start, motion.trmAxis, results.endpos - start );
+		MotionTranslation( motion, results, trm, traceBounds );
+
+		motion.collided = ( results.fraction < 1.0f );
+		return;
+	}
+
+	if ( !motion.passEntity || motion.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// translational collision with world
+		motion.numTranslations++;
+		collisionModelManager->Translation( &translationalTrace, start, end, trm, motion.trmAxis, motion.contentMask, 0, vec3_origin, mat3_default );
+		translationalTrace.c.entityNum = translationalTrace.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+	} else {
+		memset( &translationalTrace, 0, sizeof( translationalTrace ) );
+		translationalTrace.fraction = 1.0f;
+		translationalTrace.endpos = end;
+		translationalTrace.endAxis = motion.trmAxis;
+	}
+
+	if ( translationalTrace.fraction != 0.0f ) {
+
+		traceBounds.FromBoundsRotation( trm->bounds, start, motion.trmAxis, motion.rotation );
+		dir = translationalTrace.endpos - start;
+		for ( i = 0; i < 3; i++ ) {
+			if ( dir[i] < 0.0f ) {
+				traceBounds[0][i] += dir[i];
+			}
+			else {
+				traceBounds[1][i] += dir[i];
+			}
+		}
+
+		MotionTranslation( motion, translationalTrace, trm, traceBounds );
+	}
+
+	endPosition = translationalTrace.endpos;
+	endRotation = motion.rotation;
+	endRotation.SetOrigin( endPosition );
+
+	if ( !motion.passEntity || motion.passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// rotational collision with world
+		motion.numRotations++;
+		collisionModelManager->Rotation( &rotationalTrace, endPosition, endRotation, trm, motion.trmAxis, motion.contentMask, 0, vec3_origin, mat3_default );
+		rotationalTrace.c.entityNum = rotationalTrace.fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+	} else {
+		memset( &rotationalTrace, 0, sizeof( rotationalTrace ) );
+		rotationalTrace.fraction = 1.0f;
+		rotationalTrace.endpos = endPosition;
+		rotationalTrace.endAxis = motion.trmAxis * motion.rotation.ToMat3();
+	}
+
+	if ( rotationalTrace.fraction != 0.0f ) {
+
+		if ( motion.numQueries == 0 ) {
+			traceBounds.FromBoundsRotation( trm->bounds, endPosition, motion.trmAxis, endRotation );
+			motion.queryBounds[motion.numQueries++] = traceBounds;
+		}
+
+		bounds[0] = motion.queryBounds[0][0] - vec3_boxEpsilon;
+		bounds[1] = motion.queryBounds[0][1] + vec3_boxEpsilon;
+
+		for ( i = 0; i < motion.clipModels.Num(); i++ ) {
+			if ( !bounds.IntersectsBounds( motion.clipModels[i].absBounds ) ) {
+				continue;
+			}
+
+			touch = motion.clipModels[i].clipModel;
+
+			motion.numRotations++;
+			collisionModelManager->Rotation( &trace, endPosition, endRotation, trm, motion.trmAxis, motion.contentMask,
+								touch->Handle(), touch->origin, touch->axis );
+
+			if ( trace.fraction < rotationalTrace.fraction ) {
+				rotationalTrace = trace;
+				rotationalTrace.c.entityNum = touch->entity->entityNumber;
+				rotationalTrace.c.id = touch->id;
+				if ( rotationalTrace.fraction == 0.0f ) {
+					break;
+				}
+			}
+		}
+	}
+
+	if ( rotationalTrace.fraction < 1.0f ) {
+		motion.results = rotationalTrace;
+	} else {
+		motion.results = translationalTrace;
+		motion.results.endAxis = rotationalTrace.endAxis;
+	}
+
+	motion.results.fraction = Max( translationalTrace.fraction, rotationalTrace.fraction );
+
+	motion.collided = ( translationalTrace.fraction < 1.0f || rotationalTrace.fraction < 1.0f );
+}
+
+/*
+============
+idClip::MotionClipModelsChanged
+
+  Returns true if a query with the bounds now gives other clip models, or the same
+  clip models in another order or state, than the ones EvaluateMotion tested.
+============
+*/
+bool idClip::MotionClipModelsChanged( const clipMotion_t &motion, const idBounds &traceBounds ) const {
+	int i, j, num;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES];
+	idBounds bounds;
+
+	num = GetTraceClipModels( traceBounds, motion.contentMask, motion.passEntity, clipModelList );
+
+	bounds[0] = traceBounds[0] - vec3_boxEpsilon;
+	bounds[1] = traceBounds[1] + vec3_boxEpsilon;
+
+	for ( i = 0, j = 0; i < num; i++ ) {
+		touch = clipModelList[i];
+
+		if ( !touch ) {
+			continue;
+		}
+
+		while( j < motion.clipModels.Num() && !bounds.IntersectsBounds( motion.clipModels[j].absBounds ) ) {
+			j++;
+		}
+		if ( j >= motion.clipModels.Num() ) {
+			return true;
+		}
+
+		const clipMotionModel_t &model = motion.clipModels[j++];
+		if ( touch != model.clipModel || touch->collisionModelHandle != model.collisionModelHandle ||
+				touch->traceModelIndex != model.traceModelIndex || touch->material != model.material ||
+				touch->origin != model.origin || touch->axis != model.axis || touch->absBounds != model.absBounds ) {
+			return true;
+		}
+	}
+
+	for ( ; j < motion.clipModels.Num(); j++ ) {
+		if ( bounds.IntersectsBounds( motion.clipModels[j].absBounds ) ) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+============
+idClip::GetMotionResults
+
+  Gets the results of EvaluateMotion if they are the same as calling Motion now.
+============
+*/
+bool idClip::GetMotionResults( clipMotion_t &motion, trace_t &results, bool &collided, const idVec3 &start, const idVec3 &end, const idRotation &rotation,
+					const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
+	int i;
+
+	if ( start != motion.start || end != motion.end || rotation.GetOrigin() != motion.rotation.GetOrigin() ||
+			rotation.GetVec() != motion.rotation.GetVec() || rotation.GetAngle() != motion.rotation.GetAngle() ) {
+		return false;
+	}
+	if ( mdl != motion.mdl || mdl->traceModelIndex != motion.traceModelIndex || trmAxis != motion.trmAxis ||
+			contentMask != motion.contentMask || passEntity != motion.passEntity ) {
+		return false;
+	}
+
+	for ( i = 0; i < motion.numQueries; i++ ) {
+		if ( MotionClipModelsChanged( motion, motion.queryBounds[i] ) ) {
+			return false;
+		}
+	}
+
+	idClip::numTranslations += motion.numTranslations;
+	idClip::numRotations += motion.numRotations;
+
+	results = motion.results;
+	collided = motion.collided;
+	return true;
+}
+
 /*
 ============
 idClip::Contacts
@@ -1618,6 +2853,78 @@ void idClip::PrintStatistics( void ) {
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
+/*
+============
+idClip::Benchmark
+
+  runs the same random queries around the linked clip models with the
+  clip sectors and with the clip model tree
+============
+*/
+void idClip::Benchmark( int numQueries ) {
+	int i, pass, mode, numTouched;
+	const int numPasses = 10;
+	idList<idClipModel *> clipModels;
+	idList<idBounds> queries;
+	idClipModel *clipModelList[MAX_GENTITIES];
+	idRandom random( 0 );
+	idVec3 center, dir;
+	idBounds bounds;
+	idTimer timer;
+	bool oldUseClipTree = useClipTree;
+	bool oldCheckClipTree;
+
+	if ( !GetLinkedClipModels( clipModels ) ) {
+		gameLocal.Printf( "no clip models linked\n" );
+		return;
+	}
+
+	// boxes and traces close to the clip models in the map
+	queries.SetNum( numQueries );
+	for ( i = 0; i < numQueries; i++ ) {
+		center = clipModels[random.RandomInt( clipModels.Num() )]->absBounds.GetCenter();
+		center += idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() ) * 64.0f;
+		if ( i & 1 ) {
+			dir = idVec3( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+			dir.Normalize();
+			queries[i].FromPointTranslation( center, dir * ( 64.0f + random.RandomFloat() * 1024.0f ) );
+		} else {
+			queries[i] = idBounds( center ).Expand( 8.0f + random.RandomFloat() * 120.0f );
+		}
+	}
+
+	gameLocal.Printf( "%d clip models, %d queries\n", clipModels.Num(), numQueries );
+
+	for ( mode = 0; mode < 2; mode++ ) {
+		SetClipModelTree( mode != 0 );
+
+		numClipModelTests = 0;
+		numTouched = 0;
+		// time the tree without the sector queries of g_checkClipModelTree
+		oldCheckClipTree = checkClipTree;
+		checkClipTree = false;
+		timer.Clear();
+		timer.Start();
+		for ( pass = 0; pass < numPasses; pass++ ) {
+			for ( i = 0; i < numQueries; i++ ) {
+				numTouched += ClipModelsTouchingBounds( queries[i], -1, clipModelList, MAX_GENTITIES );
+			}
+		}
+		timer.Stop();
+		checkClipTree = oldCheckClipTree;
+
+		gameLocal.Printf( "%-8s %7.1f clip models tested, %6.1f touched per query, %6.2f usec per query\n",
+					mode ? "tree" : "sectors", (float) numClipModelTests / ( numPasses * numQueries ),
+					(float) numTouched / ( numPasses * numQueries ), timer.Milliseconds() * 1000.0f / ( numPasses * numQueries ) );
+	}
+
+	SetClipModelTree( oldUseClipTree );
+
+	if ( treeRoot != -1 ) {
+		gameLocal.Printf( "clip model tree has %d nodes and height %d\n", treeNodes.Num(), treeNodes[treeRoot].height );
+	}
+}
+
 /*
 ============
 idClip::DrawClipModels
@@ -68,6 +68,47 @@ void idPhysics::SetClipBox( const idBounds &bounds, float density ) {
 	SetClipModel( new idClipModel( idTraceModel( bounds ) ), density );
 }
 
+/*
+================
+idPhysics::StartConcurrentStep
+
+  Prepares the next step on the main thread, returns false if the step can't be evaluated ahead of time.
+================
+*/
+bool idPhysics::StartConcurrentStep( int timeStepMSec, int endTimeMSec ) {
+	return false;
+}
+
+/*
+================
+idPhysics::EvaluateConcurrentStep
+
+  Evaluates the prepared step on a job thread without changing anything outside the physics object.
+================
+*/
+void idPhysics::EvaluateConcurrentStep( void ) {
+}
+
+/*
+================
+idPhysics::FinishConcurrentStep
+
+  Keeps the evaluated step on the main thread until Evaluate commits it.
+================
+*/
+void idPhysics::FinishConcurrentStep( void ) {
+}
+
+/*
+================
+idPhysics::CancelConcurrentStep
+
+  Throws away a step that was evaluated ahead of time.
+================
+*/
+void idPhysics::CancelConcurrentStep( void ) {
+}
+
 /*
 ================
 idPhysics::SnapTimeToPhysicsFrame
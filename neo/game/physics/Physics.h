@@ -113,6 +113,12 @@ public:	// common physics interface
 	virtual const idBounds &	GetAbsBounds( int id = -1 ) const = 0;
 								// evaluate the physics with the given time step, returns true if the object moved
 	virtual bool				Evaluate( int timeStepMSec, int endTimeMSec ) = 0;
+								// evaluate the next step ahead of time with the expensive part on a job thread,
+								// Evaluate commits it if the step still gives the same result by then
+	virtual bool				StartConcurrentStep( int timeStepMSec, int endTimeMSec );
+	virtual void				EvaluateConcurrentStep( void );
+	virtual void				FinishConcurrentStep( void );
+	virtual void				CancelConcurrentStep( void );
 								// update the time without moving
 	virtual void				UpdateTime( int endTimeMSec ) = 0;
 								// get the last physics update time
@@ -39,6 +39,14 @@ CLASS_DECLARATION( idPhysics_Base, idPhysics_RigidBody )
 END_CLASS
 
 const float STOP_SPEED		= 10.0f;
+const int	MAX_CONTACT_REUSE		= 4;			// maximum number of evaluations the contacts are reused
+const float	CONTACT_REUSE_EPSILON	= 0.1f;			// maximum movement for which the contacts are reused
+
+// statistics shown with rb_showStats
+static int numEvaluated = 0;
+static int numContactQueries = 0;
+static int numContactsReused = 0;
+static int numRestedInIslands = 0;
 
 
 #undef RB_TIMINGS
@@ -171,13 +179,17 @@ idPhysics_RigidBody::CheckForCollisions
 
   Check for collisions between the current and next state.
   If there is a collision the next state is set to the state at the moment of impact.
+  With concurrent set the collision detection done by EvaluateConcurrentStep is used
+  if it gives the same result.
 ================
 */
-bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision ) {
+bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPState_t &next, trace_t &collision, bool concurrent ) {
 //#define TEST_COLLISION_DETECTION
 	idMat3 axis;
 	idRotation rotation;
 	bool collided = false;
+	bool hit, serialHit;
+	trace_t serial;
 
 #ifdef TEST_COLLISION_DETECTION
 	bool startsolid;
@@ -190,8 +202,18 @@ bool idPhysics_RigidBody::CheckForCollisions( const float deltaTime, rigidBodyPS
 	rotation = axis.ToRotation();
 	rotation.SetOrigin( current.i.position );
 
+	if ( !concurrent || !gameLocal.clip.GetMotionResults( concurrentMotion, collision, hit, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self ) ) {
+		hit = gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self );
+	} else if ( g_checkParallelThink.GetBool() ) {
+		serialHit = gameLocal.clip.Motion( serial, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self );
+		if ( serialHit != hit || serial.fraction != collision.fraction || serial.endpos != collision.endpos || serial.endAxis != collision.endAxis ||
+				( hit && ( serial.c.point != collision.c.point || serial.c.normal != collision.c.normal || serial.c.entityNum != collision.c.entityNum || serial.c.id != collision.c.id ) ) ) {
+			gameLocal.Warning( "collision detection of rigid body '%s' done on a job thread differs from the serial one", self->name.c_str() );
+		}
+	}
+
 	// if there was a collision
-	if ( gameLocal.clip.Motion( collision, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self ) ) {
+	if ( hit ) {
 		// set the next state to the state at the moment of impact
 		next.i.position = collision.endpos;
 		next.i.orientation = collision.endAxis;
@@ -277,9 +299,7 @@ idPhysics_RigidBody::TestIfAtRest
 */
 bool idPhysics_RigidBody::TestIfAtRest( void ) const {
 	int i;
-	float gv;
-	idVec3 v, av, normal, point;
-	idMat3 inverseWorldInertiaTensor;
+	idVec3 normal, point;
 	idFixedWinding contactWinding;
 
 	if ( current.atRest >= 0 ) {
@@ -326,6 +346,21 @@ bool idPhysics_RigidBody::TestIfAtRest( void ) const {
 		return false;
 	}
 
+	return TestIfMovingSlowly();
+}
+
+/*
+================
+idPhysics_RigidBody::TestIfMovingSlowly
+
+  Returns true if the linear and rotational velocity are low enough for the body to come to rest.
+================
+*/
+bool idPhysics_RigidBody::TestIfMovingSlowly( void ) const {
+	float gv;
+	idVec3 v, av;
+	idMat3 inverseWorldInertiaTensor;
+
 	// linear velocity of body
 	v = inverseMass * current.i.linearMomentum;
 	// linear velocity in gravity direction
@@ -354,6 +389,49 @@ bool idPhysics_RigidBody::TestIfAtRest( void ) const {
 	return true;
 }
 
+/*
+================
+idPhysics_RigidBody::PoseChanged
+
+  Returns true if a point of the clip model moved more than epsilon since the body was at the given position and orientation.
+================
+*/
+bool idPhysics_RigidBody::PoseChanged( const idVec3 &origin, const idMat3 &axis, const float epsilon ) const {
+	int i;
+	float radius;
+
+	if ( ( current.i.position - origin ).LengthSqr() > Square( epsilon ) ) {
+		return true;
+	}
+	radius = clipModel->GetBounds().GetRadius();
+	for ( i = 0; i < 3; i++ ) {
+		if ( ( current.i.orientation[i] - axis[i] ).LengthSqr() * Square( radius ) > Square( epsilon ) ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+================
+idPhysics_RigidBody::UpdateSlowTime
+
+  Keeps track of how long the body has been nearly motionless while touching something.
+================
+*/
+void idPhysics_RigidBody::UpdateSlowTime( void ) {
+	if ( !contacts.Num() || !TestIfMovingSlowly() ) {
+		slowTime = -1;
+		return;
+	}
+	// restart when the body drifted away from where it started to move slowly
+	if ( slowTime < 0 || PoseChanged( slowOrigin, slowAxis, CONTACT_EPSILON ) ) {
+		slowTime = gameLocal.time;
+		slowOrigin = current.i.position;
+		slowAxis = current.i.orientation;
+	}
+}
+
 /*
 ================
 idPhysics_RigidBody::DropToFloorAndRest
@@ -473,6 +551,17 @@ idPhysics_RigidBody::idPhysics_RigidBody( void ) {
 	hasMaster = false;
 	isOrientated = false;
 
+	contactsReused = -1;
+	contactOrigin.Zero();
+	contactAxis.Identity();
+
+	slowTime = -1;
+	slowOrigin.Zero();
+	slowAxis.Identity();
+	islandNum = -1;
+
+	concurrentEndTime = -1;
+
 #ifdef RB_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -591,6 +680,10 @@ void idPhysics_RigidBody::Restore( idRestoreGame *savefile ) {
 
 	savefile->ReadBool( hasMaster );
 	savefile->ReadBool( isOrientated );
+
+	// the contact persistence and island links are not saved
+	contactsReused = -1;
+	slowTime = -1;
 }
 
 /*
@@ -614,6 +707,7 @@ void idPhysics_RigidBody::SetClipModel( idClipModel *model, const float density,
 	}
 	clipModel = model;
 	clipModel->Link( gameLocal.clip, self, 0, current.i.position, current.i.orientation );
+	contactsReused = -1;
 
 	// get mass properties from the trace model
 	clipModel->GetMassProperties( density, mass, centerOfMass, inertiaTensor );
@@ -755,8 +849,44 @@ idPhysics_RigidBody::Activate
 ================
 */
 void idPhysics_RigidBody::Activate( void ) {
+	if ( current.atRest >= 0 ) {
+		contactsReused = -1;
+		slowTime = -1;
+	}
 	current.atRest = -1;
 	self->BecomeActive( TH_PHYSICS );
+	WakeIsland();
+}
+
+/*
+================
+idPhysics_RigidBody::WakeIsland
+
+  Wakes up the bodies that were put to rest together with this one.
+================
+*/
+void idPhysics_RigidBody::WakeIsland( void ) {
+	idEntity *ent, *next;
+	idPhysics_RigidBody *body;
+
+	ent = islandNext.GetEntity();
+	islandNext = NULL;
+
+	while( ent != NULL && ent != self ) {
+		if ( !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) ) {
+			break;
+		}
+		body = static_cast<idPhysics_RigidBody *>( ent->GetPhysics() );
+		next = body->islandNext.GetEntity();
+		body->islandNext = NULL;
+		if ( body->current.atRest >= 0 ) {
+			body->current.atRest = -1;
+			body->contactsReused = -1;
+			body->slowTime = -1;
+			ent->BecomeActive( TH_PHYSICS );
+		}
+		ent = next;
+	}
 }
 
 /*
@@ -843,6 +973,11 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	idMat3 oldAxis, masterAxis;
 	float timeStep;
 	bool collided, cameToRest = false;
+	bool concurrent;
+
+	// the collision detection of a step started by StartConcurrentStep is only used at its time
+	concurrent = ( concurrentEndTime == endTimeMSec );
+	concurrentEndTime = -1;
 
 	timeStep = MS2SEC( timeStepMSec );
 	current.lastTimeStep = timeStep;
@@ -885,6 +1020,8 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	timer_total.Start();
 #endif
 
+	numEvaluated++;
+
 	// move the rigid body velocity into the frame of a pusher
 //	current.i.linearMomentum -= current.pushVelocity.SubVec3( 0 ) * mass;
 //	current.i.angularMomentum -= current.pushVelocity.SubVec3( 1 ) * inertiaTensor;
@@ -901,7 +1038,7 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 #endif
 
 	// check for collisions from the current to the next state
-	collided = CheckForCollisions( timeStep, next, collision );
+	collided = CheckForCollisions( timeStep, next, collision, concurrent );
 
 #ifdef RB_TIMINGS
 	timer_collision.Stop();
@@ -942,6 +1079,8 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 		}  else {
 			// apply contact friction
 			ContactFriction( timeStep );
+			// keep track of how long the body has been nearly motionless for resting islands
+			UpdateSlowTime();
 		}
 	}
 
@@ -1001,6 +1140,59 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec ) {
 	return true;
 }
 
+/*
+================
+idPhysics_RigidBody::StartConcurrentStep
+
+  Starts the collision detection of the next step so it can run on a job thread. Evaluate
+  integrates the step again when the entity thinks and uses the collision detection if the
+  motion is the same and the clip models it was tested against didn't change.
+================
+*/
+bool idPhysics_RigidBody::StartConcurrentStep( int timeStepMSec, int endTimeMSec ) {
+	rigidBodyPState_t next;
+	idMat3 axis;
+	idRotation rotation;
+
+	concurrentEndTime = -1;
+
+	if ( hasMaster || current.atRest >= 0 || timeStepMSec <= 0 || dropToFloor ) {
+		return false;
+	}
+
+	next = current;
+	Integrate( MS2SEC( timeStepMSec ), next );
+
+	TransposeMultiply( current.i.orientation, next.i.orientation, axis );
+	rotation = axis.ToRotation();
+	rotation.SetOrigin( current.i.position );
+
+	if ( !gameLocal.clip.StartMotion( concurrentMotion, current.i.position, next.i.position, rotation, clipModel, current.i.orientation, clipMask, self ) ) {
+		return false;
+	}
+
+	concurrentEndTime = endTimeMSec;
+	return true;
+}
+
+/*
+================
+idPhysics_RigidBody::EvaluateConcurrentStep
+================
+*/
+void idPhysics_RigidBody::EvaluateConcurrentStep( void ) {
+	idClip::EvaluateMotion( concurrentMotion );
+}
+
+/*
+================
+idPhysics_RigidBody::CancelConcurrentStep
+================
+*/
+void idPhysics_RigidBody::CancelConcurrentStep( void ) {
+	concurrentEndTime = -1;
+}
+
 /*
 ================
 idPhysics_RigidBody::UpdateTime
@@ -1359,6 +1551,13 @@ bool idPhysics_RigidBody::EvaluateContacts( void ) {
 	idVec6 dir;
 	int num;
 
+	if ( ReuseContacts() ) {
+		numContactsReused++;
+		return ( contacts.Num() != 0 );
+	}
+
+	numContactQueries++;
+
 	ClearContacts();
 
 	contacts.SetNum( 10, false );
@@ -1373,9 +1572,53 @@ bool idPhysics_RigidBody::EvaluateContacts( void ) {
 
 	AddContactEntitiesForContacts();
 
+	contactsReused = 0;
+	contactOrigin = current.i.position;
+	contactAxis = current.i.orientation;
+
 	return ( contacts.Num() != 0 );
 }
 
+/*
+================
+idPhysics_RigidBody::ReuseContacts
+
+  Moves the contacts from the last evaluation along with the body instead of
+  querying them again if the body barely moved and everything it touches is at rest.
+================
+*/
+bool idPhysics_RigidBody::ReuseContacts( void ) {
+	int i;
+	idEntity *ent;
+	idMat3 rotation;
+
+	if ( !rb_contactCache.GetBool() || contactsReused < 0 || contactsReused >= MAX_CONTACT_REUSE ) {
+		return false;
+	}
+
+	if ( PoseChanged( contactOrigin, contactAxis, CONTACT_REUSE_EPSILON ) ) {
+		return false;
+	}
+
+	for ( i = 0; i < contacts.Num(); i++ ) {
+		ent = gameLocal.entities[ contacts[i].entityNum ];
+		if ( !ent || !ent->GetPhysics()->IsAtRest() ) {
+			return false;
+		}
+	}
+
+	rotation = contactAxis.Transpose() * current.i.orientation;
+	for ( i = 0; i < contacts.Num(); i++ ) {
+		contacts[i].point = current.i.position + ( contacts[i].point - contactOrigin ) * rotation;
+	}
+
+	contactsReused++;
+	contactOrigin = current.i.position;
+	contactAxis = current.i.orientation;
+
+	return true;
+}
+
 /*
 ================
 idPhysics_RigidBody::SetPushed
@@ -1540,3 +1783,124 @@ void idPhysics_RigidBody::ReadFromSnapshot( const idBitMsgDelta &msg ) {
 		clipModel->Link( gameLocal.clip, self, clipModel->GetId(), current.i.position, current.i.orientation );
 	}
 }
+
+/*
+================
+idPhysics_RigidBody::RestIslands
+
+  Bodies that touch each other form an island. When all bodies of an island have
+  been nearly motionless for rb_islandRestTime milliseconds the whole island is
+  put to rest, even if the bodies would not come to rest on their own, like a
+  crate leaning against another one. The bodies of the island are linked in a
+  ring so they all wake up again as soon as one of them is activated.
+================
+*/
+void idPhysics_RigidBody::RestIslands( idPhysics_RigidBody **bodies, int numBodies ) {
+	int i, j, a, b, r, numRested, *parent, *first, *last;
+	bool *canRest;
+	idEntity *ent;
+	idPhysics *phys;
+	idPhysics_RigidBody *body;
+
+	if ( rb_islandRestTime.GetInteger() > 0 && numBodies > 0 ) {
+
+		parent = (int *) _alloca16( numBodies * sizeof( int ) );
+		first = (int *) _alloca16( numBodies * sizeof( int ) );
+		last = (int *) _alloca16( numBodies * sizeof( int ) );
+		canRest = (bool *) _alloca16( numBodies * sizeof( bool ) );
+
+		for ( i = 0; i < numBodies; i++ ) {
+			bodies[i]->islandNum = i;
+			parent[i] = i;
+			first[i] = -1;
+			canRest[i] = true;
+		}
+
+		// merge the islands of touching bodies
+		for ( i = 0; i < numBodies; i++ ) {
+			body = bodies[i];
+
+			// the body must have been nearly motionless for a while
+			if ( body->slowTime < 0 || gameLocal.time - body->slowTime < rb_islandRestTime.GetInteger() ) {
+				canRest[i] = false;
+			}
+
+			for ( j = 0; j < body->contacts.Num() + body->contactEntities.Num(); j++ ) {
+				if ( j < body->contacts.Num() ) {
+					ent = gameLocal.entities[ body->contacts[j].entityNum ];
+				} else {
+					ent = body->contactEntities[j - body->contacts.Num()].GetEntity();
+				}
+				if ( !ent || ent == body->self ) {
+					continue;
+				}
+				phys = ent->GetPhysics();
+				if ( phys->IsType( idPhysics_RigidBody::Type ) && static_cast<idPhysics_RigidBody *>( phys )->islandNum >= 0 ) {
+					a = i;
+					b = static_cast<idPhysics_RigidBody *>( phys )->islandNum;
+					while( parent[a] != a ) {
+						a = parent[a];
+					}
+					while( parent[b] != b ) {
+						b = parent[b];
+					}
+					parent[Max( a, b )] = Min( a, b );
+				} else if ( !phys->IsAtRest() ) {
+					// touching something that is moving
+					canRest[i] = false;
+				}
+			}
+		}
+
+		// an island can only rest if all its bodies can rest
+		for ( i = 0; i < numBodies; i++ ) {
+			for ( r = i; parent[r] != r; r = parent[r] ) {
+			}
+			parent[i] = r;
+			if ( !canRest[i] ) {
+				canRest[r] = false;
+			}
+		}
+
+		// put the islands to rest and link their bodies in a ring
+		numRested = 0;
+		for ( i = 0; i < numBodies; i++ ) {
+			r = parent[i];
+			if ( !canRest[r] ) {
+				continue;
+			}
+			bodies[i]->islandNext = NULL;
+			if ( first[r] < 0 ) {
+				first[r] = i;
+			} else {
+				bodies[last[r]]->islandNext = bodies[i]->self;
+			}
+			last[r] = i;
+			numRested++;
+		}
+		for ( i = 0; i < numBodies; i++ ) {
+			r = parent[i];
+			if ( !canRest[r] ) {
+				continue;
+			}
+			if ( last[r] != first[r] ) {
+				bodies[last[r]]->islandNext = bodies[first[r]]->self;
+			}
+			bodies[i]->Rest();
+		}
+		numRestedInIslands += numRested;
+
+		for ( i = 0; i < numBodies; i++ ) {
+			bodies[i]->islandNum = -1;
+		}
+	}
+
+	if ( rb_showStats.GetBool() ) {
+		gameLocal.Printf( "rb %d: %d awake, %d evaluated, %d contact queries, %d contacts reused, %d rested in islands\n",
+						gameLocal.time, numBodies, numEvaluated, numContactQueries, numContactsReused, numRestedInIslands );
+	}
+	numEvaluated = 0;
+	numContactQueries = 0;
+	numContactsReused = 0;
+	numRestedInIslands = 0;
+}
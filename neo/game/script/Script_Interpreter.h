@@ -73,6 +73,10 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	void				AppendString( const resolvedOperand_t &operand, const char *from );
+	void				SetString( const resolvedOperand_t &operand, const char *from );
+	const char			*GetString( const resolvedOperand_t &operand );
+	varEval_t			GetVariable( const resolvedOperand_t &operand );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
@@ -87,6 +91,8 @@ public:
 	bool				terminateOnExit;
 	bool				debug;
 
+	static unsigned int	statementsExecuted;		// for benchmarking
+
 						idInterpreter();
 
 	// save games
@@ -246,6 +252,60 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::AppendString
+====================
+*/
+ID_INLINE void idInterpreter::AppendString( const resolvedOperand_t &operand, const char *from ) {
+	if ( operand.onStack ) {
+		idStr::Append( ( char * )&localstack[ localstackBase + operand.value.stackOffset ], MAX_STRING_LEN, from );
+	} else {
+		idStr::Append( operand.value.stringPtr, MAX_STRING_LEN, from );
+	}
+}
+
+/*
+====================
+idInterpreter::SetString
+====================
+*/
+ID_INLINE void idInterpreter::SetString( const resolvedOperand_t &operand, const char *from ) {
+	if ( operand.onStack ) {
+		idStr::Copynz( ( char * )&localstack[ localstackBase + operand.value.stackOffset ], from, MAX_STRING_LEN );
+	} else {
+		idStr::Copynz( operand.value.stringPtr, from, MAX_STRING_LEN );
+	}
+}
+
+/*
+====================
+idInterpreter::GetString
+====================
+*/
+ID_INLINE const char *idInterpreter::GetString( const resolvedOperand_t &operand ) {
+	if ( operand.onStack ) {
+		return ( char * )&localstack[ localstackBase + operand.value.stackOffset ];
+	} else {
+		return operand.value.stringPtr;
+	}
+}
+
+/*
+====================
+idInterpreter::GetVariable
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetVariable( const resolvedOperand_t &operand ) {
+	if ( operand.onStack ) {
+		varEval_t val;
+		val.intPtr = ( int * )&localstack[ localstackBase + operand.value.stackOffset ];
+		return val;
+	} else {
+		return operand.value;
+	}
+}
+
 /*
 ================
 idInterpreter::GetEntity
@@ -94,6 +94,8 @@ Contains type information for variables and functions.
 ***********************************************************************/
 
 class idTypeDef {
+	friend class idProgram;
+
 private:
 	etype_t						type;
 	idStr						name;
@@ -433,6 +435,20 @@ typedef struct statement_s {
 	idVarDef		*c;
 } statement_t;
 
+// operand of a statement resolved when the statement is first executed
+typedef struct resolvedOperand_s {
+	varEval_t		value;			// value of the def, or its offset on the local stack
+	bool			onStack;		// def is a local variable or parameter
+} resolvedOperand_t;
+
+// statement with its operands resolved, so the interpreter doesn't have to look at the defs
+typedef struct resolvedStatement_s {
+	unsigned short		op;
+	resolvedOperand_t	a;
+	resolvedOperand_t	b;
+	resolvedOperand_t	c;
+} resolvedStatement_t;
+
 /***********************************************************************
 
 idProgram
@@ -455,6 +471,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idList<resolvedStatement_t>					resolvedStatements;	// same index as statements, may lag behind them
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -471,6 +488,10 @@ private:
 	void										CompileStats( void );
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
+	void										ResolveStatements( void );
+	bool										LoadBinaryProgram( const char *scriptName );
+	bool										ReadBinaryProgram( idFile *fp );
+	void										WriteBinaryProgram( const char *scriptName ) const;
 
 public:
 	idVarDef									*returnDef;
@@ -524,6 +545,8 @@ public:
 	statement_t									*AllocStatement( void );
 	statement_t									&GetStatement( int index );
 	int											NumStatements( void ) { return statements.Num(); }
+	void										UpdateResolvedStatements( void );
+	const resolvedStatement_t					&GetResolvedStatement( int index ) const;
 
 	int											GetReturnedInteger( void );
 
@@ -545,6 +568,28 @@ ID_INLINE statement_t &idProgram::GetStatement( int index ) {
 	return statements[ index ];
 }
 
+/*
+================
+idProgram::UpdateResolvedStatements
+
+resolves the statements compiled since the last call
+================
+*/
+ID_INLINE void idProgram::UpdateResolvedStatements( void ) {
+	if ( resolvedStatements.Num() != statements.Num() ) {
+		ResolveStatements();
+	}
+}
+
+/*
+================
+idProgram::GetResolvedStatement
+================
+*/
+ID_INLINE const resolvedStatement_t &idProgram::GetResolvedStatement( int index ) const {
+	return resolvedStatements[ index ];
+}
+
 /*
 ================
 idProgram::GetFunction
@@ -36,6 +36,8 @@ const float LCP_BOUND_EPSILON			= 1e-5f;
 const float LCP_ACCEL_EPSILON			= 1e-5f;
 const float LCP_DELTA_ACCEL_EPSILON		= 1e-9f;
 const float LCP_DELTA_FORCE_EPSILON		= 1e-9f;
+const float LCP_DIAGONAL_EPSILON		= 1e-12f;
+const float LCP_CONVERGENCE_EPSILON		= 1e-4f;
 
 #define IGNORE_UNSATISFIABLE_VARIABLES
 
@@ -76,6 +78,7 @@ private:
 	void			ChangeForce( int d, float step );
 	void			ChangeAccel( int d, float step );
 	void			GetMaxStep( int d, float dir, float &maxStep, int &limit, int &limitSide ) const;
+	void			UnpermuteMatrix( void );
 };
 
 /*
@@ -500,6 +503,29 @@ void idLCP_Square::GetMaxStep( int d, float dir, float &maxStep, int &limit, int
 	}
 }
 
+/*
+============
+idLCP_Square::UnpermuteMatrix
+
+  Swaps the columns of the original matrix back into place.
+============
+*/
+void idLCP_Square::UnpermuteMatrix( void ) {
+	int i, j;
+
+	for ( i = 0; i < m.GetNumRows(); i++ ) {
+		for ( j = 0; j < m.GetNumRows(); j++ ) {
+			if ( permuted[j] == i ) {
+				break;
+			}
+		}
+		if ( i != j ) {
+			m.SwapColumns( i, j );
+			idSwap( permuted[i], permuted[j] );
+		}
+	}
+}
+
 /*
 ============
 idLCP_Square::Solve
@@ -519,6 +545,8 @@ bool idLCP_Square::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, con
 	assert( o_lo.GetSize() == o_m.GetNumRows() );
 	assert( o_hi.GetSize() == o_m.GetNumRows() );
 
+	numIterations = 0;
+
 	// allocate memory for permuted input
 	f.SetData( o_m.GetNumRows(), VECX_ALLOCA( o_m.GetNumRows() ) );
 	a.SetData( o_b.GetSize(), VECX_ALLOCA( o_b.GetSize() ) );
@@ -592,6 +620,7 @@ bool idLCP_Square::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, con
 		// factor and solve for unbounded variables
 		if ( !FactorClamped() ) {
 			idLib::common->Printf( "idLCP_Square::Solve: unbounded factorization failed\n" );
+			UnpermuteMatrix();
 			return false;
 		}
 		SolveClamped( f, b.ToFloatPtr() );
@@ -657,6 +686,8 @@ bool idLCP_Square::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, con
 		// drive the current variable into a valid region
 		for ( n = 0; n < maxIterations; n++ ) {
 
+			numIterations++;
+
 			// direction to move
 			if ( a[i] <= 0.0f ) {
 				dir = 1.0f;
@@ -780,17 +811,7 @@ bool idLCP_Square::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, con
 	}
 
 	// unpermute original matrix
-	for ( i = 0; i < m.GetNumRows(); i++ ) {
-		for ( j = 0; j < m.GetNumRows(); j++ ) {
-			if ( permuted[j] == i ) {
-				break;
-			}
-		}
-		if ( i != j ) {
-			m.SwapColumns( i, j );
-			idSwap( permuted[i], permuted[j] );
-		}
-	}
+	UnpermuteMatrix();
 
 	return true;
 }
@@ -836,6 +857,7 @@ private:
 	void			ChangeForce( int d, float step );
 	void			ChangeAccel( int d, float step );
 	void			GetMaxStep( int d, float dir, float &maxStep, int &limit, int &limitSide ) const;
+	void			UnpermuteMatrix( void );
 };
 
 /*
@@ -1290,6 +1312,29 @@ void idLCP_Symmetric::GetMaxStep( int d, float dir, float &maxStep, int &limit,
 	}
 }
 
+/*
+============
+idLCP_Symmetric::UnpermuteMatrix
+
+  Swaps the columns of the original matrix back into place.
+============
+*/
+void idLCP_Symmetric::UnpermuteMatrix( void ) {
+	int i, j;
+
+	for ( i = 0; i < m.GetNumRows(); i++ ) {
+		for ( j = 0; j < m.GetNumRows(); j++ ) {
+			if ( permuted[j] == i ) {
+				break;
+			}
+		}
+		if ( i != j ) {
+			m.SwapColumns( i, j );
+			idSwap( permuted[i], permuted[j] );
+		}
+	}
+}
+
 /*
 ============
 idLCP_Symmetric::Solve
@@ -1309,6 +1354,8 @@ bool idLCP_Symmetric::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b,
 	assert( o_lo.GetSize() == o_m.GetNumRows() );
 	assert( o_hi.GetSize() == o_m.GetNumRows() );
 
+	numIterations = 0;
+
 	// allocate memory for permuted input
 	f.SetData( o_m.GetNumRows(), VECX_ALLOCA( o_m.GetNumRows() ) );
 	a.SetData( o_b.GetSize(), VECX_ALLOCA( o_b.GetSize() ) );
@@ -1384,6 +1431,7 @@ bool idLCP_Symmetric::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b,
 		// factor and solve for unbounded variables
 		if ( !FactorClamped() ) {
 			idLib::common->Printf( "idLCP_Symmetric::Solve: unbounded factorization failed\n" );
+			UnpermuteMatrix();
 			return false;
 		}
 		SolveClamped( f, b.ToFloatPtr() );
@@ -1451,6 +1499,8 @@ bool idLCP_Symmetric::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b,
 		// drive the current variable into a valid region
 		for ( n = 0; n < maxIterations; n++ ) {
 
+			numIterations++;
+
 			// direction to move
 			if ( a[i] <= 0.0f ) {
 				dir = 1.0f;
@@ -1574,15 +1624,103 @@ bool idLCP_Symmetric::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b,
 	}
 
 	// unpermute original matrix
-	for ( i = 0; i < m.GetNumRows(); i++ ) {
-		for ( j = 0; j < m.GetNumRows(); j++ ) {
-			if ( permuted[j] == i ) {
-				break;
+	UnpermuteMatrix();
+
+	return true;
+}
+
+
+//===============================================================
+//
+//	idLCP_GaussSeidel
+//
+//===============================================================
+
+class idLCP_GaussSeidel : public idLCP {
+public:
+	virtual bool	Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, const idVecX &o_lo, const idVecX &o_hi, const int *o_boxIndex );
+};
+
+/*
+============
+idLCP_GaussSeidel::Solve
+
+  Projected Gauss-Seidel: each variable in turn is set to the value that zeroes its acceleration
+  and is then clamped to its bounds. The initial guess is read from o_x.
+============
+*/
+bool idLCP_GaussSeidel::Solve( const idMatX &o_m, idVecX &o_x, const idVecX &o_b, const idVecX &o_lo, const idVecX &o_hi, const int *o_boxIndex ) {
+	int i, n, numRows;
+	float dot, x, s, lo, hi, maxDelta, maxValue;
+	float *invDiagonal;
+
+	numRows = o_m.GetNumRows();
+
+	assert( ((numRows+3)&~3) == o_m.GetNumColumns() || numRows == o_m.GetNumColumns() );
+	assert( o_x.GetSize() == numRows );
+	assert( o_b.GetSize() == numRows );
+	assert( o_lo.GetSize() == numRows );
+	assert( o_hi.GetSize() == numRows );
+
+	numIterations = 0;
+
+	// variables without a diagonal element cannot be solved for and stay zero
+	invDiagonal = (float *) _alloca16( numRows * sizeof( float ) );
+	for ( i = 0; i < numRows; i++ ) {
+		if ( idMath::Fabs( o_m[i][i] ) < LCP_DIAGONAL_EPSILON ) {
+			invDiagonal[i] = 0.0f;
+			o_x[i] = 0.0f;
+		} else {
+			invDiagonal[i] = 1.0f / o_m[i][i];
+		}
+	}
+
+	for ( n = 0; n < maxIterations; n++ ) {
+
+		numIterations++;
+
+		maxDelta = 0.0f;
+		maxValue = 1.0f;
+		for ( i = 0; i < numRows; i++ ) {
+			if ( invDiagonal[i] == 0.0f ) {
+				continue;
+			}
+
+			// acceleration of the current variable with all other variables fixed
+			SIMDProcessor->Dot( dot, o_m[i], o_x.ToFloatPtr(), numRows );
+			x = o_x[i] - ( dot - o_b[i] ) * invDiagonal[i];
+
+			lo = o_lo[i];
+			hi = o_hi[i];
+			if ( o_boxIndex && o_boxIndex[i] >= 0 ) {
+				s = o_x[o_boxIndex[i]];
+				if ( lo != -idMath::INFINITY ) {
+					lo = - idMath::Fabs( lo * s );
+				}
+				if ( hi != idMath::INFINITY ) {
+					hi = idMath::Fabs( hi * s );
+				}
 			}
+			if ( x < lo ) {
+				x = lo;
+			} else if ( x > hi ) {
+				x = hi;
+			}
+
+			maxDelta = Max( maxDelta, idMath::Fabs( x - o_x[i] ) );
+			maxValue = Max( maxValue, idMath::Fabs( x ) );
+			o_x[i] = x;
 		}
-		if ( i != j ) {
-			m.SwapColumns( i, j );
-			idSwap( permuted[i], permuted[j] );
+
+		// stop when none of the variables changed significantly
+		if ( maxDelta <= LCP_CONVERGENCE_EPSILON * maxValue ) {
+			break;
+		}
+	}
+
+	if ( n >= maxIterations ) {
+		if ( lcp_showFailures.GetBool() ) {
+			idLib::common->Printf( "idLCP_GaussSeidel::Solve: max iterations %d (change %.4f)\n", maxIterations, maxDelta );
 		}
 	}
 
@@ -1618,6 +1756,27 @@ idLCP *idLCP::AllocSymmetric( void ) {
 	return lcp;
 }
 
+/*
+============
+idLCP::AllocGaussSeidel
+============
+*/
+idLCP *idLCP::AllocGaussSeidel( void ) {
+	idLCP *lcp = new idLCP_GaussSeidel;
+	lcp->SetMaxIterations( 64 );
+	return lcp;
+}
+
+/*
+============
+idLCP::idLCP
+============
+*/
+idLCP::idLCP( void ) {
+	maxIterations = 0;
+	numIterations = 0;
+}
+
 /*
 ============
 idLCP::~idLCP
@@ -1643,3 +1802,12 @@ idLCP::GetMaxIterations
 int idLCP::GetMaxIterations( void ) {
 	return maxIterations;
 }
+
+/*
+============
+idLCP::GetNumIterations
+============
+*/
+int idLCP::GetNumIterations( void ) const {
+	return numIterations;
+}
@@ -60,6 +60,13 @@ If you have questions concerning this license or the applicable additional terms
   Before calculating any of the bounded x[i] with boxIndex[i] != -1 the
   solver calculates all unbounded x[i] and all x[i] with boxIndex[i] == -1.
 
+  The square and symmetric solvers pivot one variable at a time and find an
+  exact solution. The projected Gauss-Seidel solver iterates towards the
+  solution starting at the x passed in, which makes it cheaper for large
+  systems when a good initial guess is available, and it does not fail on
+  singular matrices. It stops when no variable changes significantly anymore
+  or when the maximum number of iterations is reached.
+
 ===============================================================================
 */
 
@@ -67,15 +74,19 @@ class idLCP {
 public:
 	static idLCP *	AllocSquare( void );		// A must be a square matrix
 	static idLCP *	AllocSymmetric( void );		// A must be a symmetric matrix
+	static idLCP *	AllocGaussSeidel( void );	// A must be a symmetric positive semi-definite matrix
 
+					idLCP( void );
 	virtual			~idLCP( void );
 
 	virtual bool	Solve( const idMatX &A, idVecX &x, const idVecX &b, const idVecX &lo, const idVecX &hi, const int *boxIndex = NULL ) = 0;
 	virtual void	SetMaxIterations( int max );
 	virtual int		GetMaxIterations( void );
+	int				GetNumIterations( void ) const;	// iterations used by the last Solve
 
 protected:
 	int				maxIterations;
+	int				numIterations;
 };
 
 #endif /* !__MATH_LCP_H__ */
@@ -45,6 +45,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/math/Simd_SSE3.h"
 #include "idlib/math/Simd_AltiVec.h"
 #include "idlib/math/Plane.h"
+#include "idlib/math/Pluecker.h"
 #include "idlib/bv/Bounds.h"
 #include "idlib/Lib.h"
 #include "framework/Common.h"
@@ -2180,6 +2181,56 @@ void TestMatXLDLTFactor( void ) {
 	}
 }
 
+/*
+============
+TestDecodeQuantized
+============
+*/
+void TestDecodeQuantized( void ) {
+	int i;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	unsigned short src1[COUNT], src2[COUNT];
+	float mins[COUNT], scales[COUNT];
+	ALIGN16( float dst1[COUNT] );
+	ALIGN16( float dst2[COUNT] );
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < COUNT; i++ ) {
+		src1[i] = (unsigned short)srnd.RandomInt( 65536 );
+		src2[i] = (unsigned short)srnd.RandomInt( 65536 );
+		mins[i] = srnd.CRandomFloat() * 100.0f;
+		scales[i] = srnd.RandomFloat() * 0.01f;
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_generic->DecodeQuantized( dst1, src1, src2, 0.3f, mins, scales, COUNT - 1 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->DecodeQuantized()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		p_simd->DecodeQuantized( dst2, src1, src2, 0.3f, mins, scales, COUNT - 1 );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	// the results must be bit identical so anims don't depend on the cpu
+	for ( i = 0; i < COUNT - 1; i++ ) {
+		if ( dst1[i] != dst2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT - 1 ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->DecodeQuantized() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestBlendJoints
@@ -2731,6 +2782,118 @@ void TestOverlayPointCull( void ) {
 	PrintClocks( va( "   simd->OverlayPointCull() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestPermutedInnerProductSigns
+============
+*/
+void TestPermutedInnerProductSigns( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( float src[6][32] );
+	idPluecker constants[COUNT];
+	unsigned int bits1[COUNT], bits2[COUNT];
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < 32; i++ ) {
+		for ( j = 0; j < 6; j++ ) {
+			src[j][i] = srnd.CRandomFloat() * 10.0f;
+		}
+	}
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 6; j++ ) {
+			constants[i][j] = srnd.CRandomFloat() * 10.0f;
+		}
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		for ( j = 0; j < COUNT; j++ ) {
+			bits1[j] = p_generic->PermutedInnerProductSigns( constants[j], src[0], 32, 8 + ( j & 3 ) );
+		}
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->PermutedInnerProductSigns()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		for ( j = 0; j < COUNT; j++ ) {
+			bits2[j] = p_simd->PermutedInnerProductSigns( constants[j], src[0], 32, 8 + ( j & 3 ) );
+		}
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( bits1[i] != bits2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->PermutedInnerProductSigns() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
+/*
+============
+TestPointsBehindPlane
+============
+*/
+void TestPointsBehindPlane( void ) {
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	ALIGN16( float src[3][32] );
+	idPlane planes[COUNT];
+	unsigned int bits1[COUNT], bits2[COUNT];
+	const char *result;
+
+	idRandom srnd( RANDOM_SEED );
+
+	for ( i = 0; i < 32; i++ ) {
+		for ( j = 0; j < 3; j++ ) {
+			src[j][i] = srnd.CRandomFloat() * 10.0f;
+		}
+	}
+	for ( i = 0; i < COUNT; i++ ) {
+		for ( j = 0; j < 4; j++ ) {
+			planes[i][j] = srnd.CRandomFloat() * 10.0f;
+		}
+	}
+
+	bestClocksGeneric = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		for ( j = 0; j < COUNT; j++ ) {
+			bits1[j] = p_generic->PointsBehindPlane( planes[j], src[0], 32, 8 + ( j & 3 ) );
+		}
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->PointsBehindPlane()", COUNT, bestClocksGeneric );
+
+	bestClocksSIMD = 0;
+	for ( i = 0; i < NUMTESTS; i++ ) {
+		StartRecordTime( start );
+		for ( j = 0; j < COUNT; j++ ) {
+			bits2[j] = p_simd->PointsBehindPlane( planes[j], src[0], 32, 8 + ( j & 3 ) );
+		}
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+
+	for ( i = 0; i < COUNT; i++ ) {
+		if ( bits1[i] != bits2[i] ) {
+			break;
+		}
+	}
+	result = ( i >= COUNT ) ? "ok" :  S_COLOR_RED "X";
+	PrintClocks( va( "   simd->PointsBehindPlane() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
+}
+
 /*
 ============
 TestDeriveTriPlanes
@@ -4083,6 +4246,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 
 	idLib::common->Printf("====================================\n" );
 
+	TestDecodeQuantized();
 	TestBlendJoints();
 	TestConvertJointQuatsToJointMats();
 	TestConvertJointMatsToJointQuats();
@@ -4092,6 +4256,8 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 	TestTracePointCull();
 	TestDecalPointCull();
 	TestOverlayPointCull();
+	TestPermutedInnerProductSigns();
+	TestPointsBehindPlane();
 	TestDeriveTriPlanes();
 	TestDeriveTangents();
 	TestDeriveUnsmoothedTangents();
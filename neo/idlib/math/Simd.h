@@ -78,6 +78,7 @@ class idMat5;
 class idMat6;
 class idMatX;
 class idPlane;
+class idPluecker;
 class idDrawVert;
 class idJointQuat;
 class idJointMat;
@@ -173,6 +174,8 @@ public:
 	virtual bool VPCALL MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const int n ) = 0;
 
 	// rendering
+	// dst[i] = mins[i] + ( src1[i] + ( src2[i] - src1[i] ) * lerp ) * scales[i], decodes and interpolates 16 bit anim frames
+	virtual void VPCALL DecodeQuantized( float *dst, const unsigned short *src1, const unsigned short *src2, const float lerp, const float *mins, const float *scales, const int count ) = 0;
 	virtual void VPCALL BlendJoints( idJointQuat *joints, const idJointQuat *blendJoints, const float lerp, const int *index, const int numJoints ) = 0;
 	virtual void VPCALL ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) = 0;
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat *jointQuats, const idJointMat *jointMats, const int numJoints ) = 0;
@@ -182,6 +185,9 @@ public:
 	virtual void VPCALL TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) = 0;
 	virtual void VPCALL DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts ) = 0;
 	virtual void VPCALL OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts ) = 0;
+	// src is in SoA form with each component in a row of stride floats, rows are 16 byte aligned and padded to a multiple of four, count <= 32
+	virtual unsigned int VPCALL PermutedInnerProductSigns( const idPluecker &constant, const float *src, const int stride, const int count ) = 0;
+	virtual unsigned int VPCALL PointsBehindPlane( const idPlane &constant, const float *src, const int stride, const int count ) = 0;
 	virtual void VPCALL DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) = 0;
 	virtual void VPCALL DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) = 0;
 	virtual void VPCALL DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts ) = 0;
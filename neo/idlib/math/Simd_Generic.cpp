@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/geometry/JointTransform.h"
 #include "idlib/math/Vector.h"
 #include "idlib/math/Plane.h"
+#include "idlib/math/Pluecker.h"
 #include "idlib/math/Matrix.h"
 #include "renderer/Model.h"
 
@@ -2242,6 +2243,21 @@ bool VPCALL idSIMD_Generic::MatX_LDLTFactor( idMatX &mat, idVecX &invDiag, const
 #endif
 }
 
+/*
+============
+idSIMD_Generic::DecodeQuantized
+============
+*/
+void VPCALL idSIMD_Generic::DecodeQuantized( float *dst, const unsigned short *src1, const unsigned short *src2, const float lerp, const float *mins, const float *scales, const int count ) {
+	int i;
+	float q;
+
+	for ( i = 0; i < count; i++ ) {
+		q = (float)src1[i] + ( (float)src2[i] - (float)src1[i] ) * lerp;
+		dst[i] = mins[i] + q * scales[i];
+	}
+}
+
 /*
 ============
 idSIMD_Generic::BlendJoints
@@ -2441,6 +2457,49 @@ void VPCALL idSIMD_Generic::OverlayPointCull( byte *cullBits, idVec2 *texCoords,
 	}
 }
 
+/*
+============
+idSIMD_Generic::PermutedInnerProductSigns
+
+  bit i of the result is set if constant.PermutedInnerProduct( src[i] ) has the sign bit set
+============
+*/
+unsigned int VPCALL idSIMD_Generic::PermutedInnerProductSigns( const idPluecker &constant, const float *src, const int stride, const int count ) {
+	int i;
+	unsigned int bits;
+	float d;
+
+	bits = 0;
+	for ( i = 0; i < count; i++ ) {
+		d = constant[0] * src[4*stride+i] + constant[1] * src[5*stride+i] + constant[2] * src[3*stride+i] +
+			constant[4] * src[0*stride+i] + constant[5] * src[1*stride+i] + constant[3] * src[2*stride+i];
+		bits |= FLOATSIGNBITSET( d ) << i;
+	}
+	return bits;
+}
+
+/*
+============
+idSIMD_Generic::PointsBehindPlane
+
+  bit i of the result is set if constant.Distance( src[i] ) < 0.0f
+============
+*/
+unsigned int VPCALL idSIMD_Generic::PointsBehindPlane( const idPlane &constant, const float *src, const int stride, const int count ) {
+	int i;
+	unsigned int bits;
+	float d;
+
+	bits = 0;
+	for ( i = 0; i < count; i++ ) {
+		d = constant[0] * src[0*stride+i] + constant[1] * src[1*stride+i] + constant[2] * src[2*stride+i] + constant[3];
+		if ( d < 0.0f ) {
+			bits |= 1u << i;
+		}
+	}
+	return bits;
+}
+
 /*
 ============
 idSIMD_Generic::DeriveTriPlanes
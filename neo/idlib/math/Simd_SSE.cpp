@@ -28,6 +28,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/geometry/DrawVert.h"
+#include "idlib/math/Plane.h"
+#include "idlib/math/Pluecker.h"
 
 #include "idlib/math/Simd_SSE.h"
 
@@ -48,6 +50,9 @@ If you have questions concerning this license or the applicable additional terms
 #if defined(__GNUC__) && defined(__SSE__)
 
 #include <xmmintrin.h>
+#if defined(__SSE2__) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#endif
 
 #define SHUFFLEPS( x, y, z, w )		(( (x) & 3 ) << 6 | ( (y) & 3 ) << 4 | ( (z) & 3 ) << 2 | ( (w) & 3 ))
 #define R_SHUFFLEPS( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
@@ -18095,3 +18100,119 @@ void VPCALL idSIMD_SSE::MixedSoundToSamples( short *samples, const float *mixBuf
 }
 
 #endif /* _MSC_VER */
+
+#if ( defined(__GNUC__) && defined(__SSE__) ) || ( defined(_MSC_VER) && defined(_M_IX86) )
+
+#include <xmmintrin.h>
+
+/*
+============
+idSIMD_SSE::PermutedInnerProductSigns
+
+  bit i of the result is set if constant.PermutedInnerProduct( src[i] ) has the sign bit set,
+  the products are summed in the same order as idPluecker::PermutedInnerProduct
+============
+*/
+unsigned int VPCALL idSIMD_SSE::PermutedInnerProductSigns( const idPluecker &constant, const float *src, const int stride, const int count ) {
+	int i;
+	unsigned int bits;
+	__m128 c0, c1, c2, c3, c4, c5, d;
+
+	assert( ( ( (uintptr_t)src ) & 15 ) == 0 && ( stride & 3 ) == 0 && count <= 32 );
+
+	c0 = _mm_set1_ps( constant[0] );
+	c1 = _mm_set1_ps( constant[1] );
+	c2 = _mm_set1_ps( constant[2] );
+	c3 = _mm_set1_ps( constant[3] );
+	c4 = _mm_set1_ps( constant[4] );
+	c5 = _mm_set1_ps( constant[5] );
+
+	bits = 0;
+	for ( i = 0; i < count; i += 4 ) {
+		d = _mm_mul_ps( c0, _mm_load_ps( src + 4 * stride + i ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c1, _mm_load_ps( src + 5 * stride + i ) ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c2, _mm_load_ps( src + 3 * stride + i ) ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c4, _mm_load_ps( src + 0 * stride + i ) ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c5, _mm_load_ps( src + 1 * stride + i ) ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c3, _mm_load_ps( src + 2 * stride + i ) ) );
+		bits |= (unsigned int)_mm_movemask_ps( d ) << i;
+	}
+	if ( count < 32 ) {
+		bits &= ( 1u << count ) - 1;
+	}
+	return bits;
+}
+
+/*
+============
+idSIMD_SSE::PointsBehindPlane
+
+  bit i of the result is set if constant.Distance( src[i] ) < 0.0f
+============
+*/
+unsigned int VPCALL idSIMD_SSE::PointsBehindPlane( const idPlane &constant, const float *src, const int stride, const int count ) {
+	int i;
+	unsigned int bits;
+	__m128 a, b, c, dist, zero, d;
+
+	assert( ( ( (uintptr_t)src ) & 15 ) == 0 && ( stride & 3 ) == 0 && count <= 32 );
+
+	a = _mm_set1_ps( constant[0] );
+	b = _mm_set1_ps( constant[1] );
+	c = _mm_set1_ps( constant[2] );
+	dist = _mm_set1_ps( constant[3] );
+	zero = _mm_setzero_ps();
+
+	bits = 0;
+	for ( i = 0; i < count; i += 4 ) {
+		d = _mm_mul_ps( a, _mm_load_ps( src + 0 * stride + i ) );
+		d = _mm_add_ps( d, _mm_mul_ps( b, _mm_load_ps( src + 1 * stride + i ) ) );
+		d = _mm_add_ps( d, _mm_mul_ps( c, _mm_load_ps( src + 2 * stride + i ) ) );
+		d = _mm_add_ps( d, dist );
+		bits |= (unsigned int)_mm_movemask_ps( _mm_cmplt_ps( d, zero ) ) << i;
+	}
+	if ( count < 32 ) {
+		bits &= ( 1u << count ) - 1;
+	}
+	return bits;
+}
+
+/*
+============
+idSIMD_SSE::DecodeQuantized
+
+  does the same float operations in the same order as the generic version, so the results are identical
+============
+*/
+void VPCALL idSIMD_SSE::DecodeQuantized( float *dst, const unsigned short *src1, const unsigned short *src2, const float lerp, const float *mins, const float *scales, const int count ) {
+	int i;
+	float q;
+
+#if defined(__SSE2__) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+	__m128i zero, s1, s2;
+	__m128 l, q1, q2, d;
+
+	zero = _mm_setzero_si128();
+	l = _mm_set1_ps( lerp );
+
+	for ( i = 0; i + 4 <= count; i += 4 ) {
+		// widen the unsigned shorts to ints, they convert to floats exactly
+		s1 = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i *)( src1 + i ) ), zero );
+		s2 = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i *)( src2 + i ) ), zero );
+		q1 = _mm_cvtepi32_ps( s1 );
+		q2 = _mm_cvtepi32_ps( s2 );
+		d = _mm_add_ps( q1, _mm_mul_ps( _mm_sub_ps( q2, q1 ), l ) );
+		d = _mm_add_ps( _mm_loadu_ps( mins + i ), _mm_mul_ps( d, _mm_loadu_ps( scales + i ) ) );
+		_mm_storeu_ps( dst + i, d );
+	}
+#else
+	i = 0;
+#endif
+
+	for ( ; i < count; i++ ) {
+		q = (float)src1[i] + ( (float)src2[i] - (float)src1[i] ) * lerp;
+		dst[i] = mins[i] + q * scales[i];
+	}
+}
+
+#endif
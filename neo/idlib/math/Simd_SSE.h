@@ -49,6 +49,9 @@ public:
 	virtual void VPCALL Dot( float *dst,			const idPlane &constant,const idDrawVert *src,	const int count );
 	virtual	void VPCALL MinMax( idVec3 &min,		idVec3 &max,			const idDrawVert *src,	const int *indexes,		const int count );
 	virtual void VPCALL Dot( float *dst,			const idVec3 &constant,	const idPlane *src,		const int count );
+	virtual unsigned int VPCALL PermutedInnerProductSigns( const idPluecker &constant, const float *src, const int stride, const int count );
+	virtual unsigned int VPCALL PointsBehindPlane( const idPlane &constant, const float *src, const int stride, const int count );
+	virtual void VPCALL DecodeQuantized( float *dst, const unsigned short *src1, const unsigned short *src2, const float lerp, const float *mins, const float *scales, const int count );
 
 #elif defined(_MSC_VER) && defined(_M_IX86)
 	virtual const char * VPCALL GetName( void ) const;
@@ -125,6 +128,9 @@ public:
 	virtual void VPCALL TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts );
 	virtual void VPCALL DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts );
 	virtual void VPCALL OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts );
+	virtual unsigned int VPCALL PermutedInnerProductSigns( const idPluecker &constant, const float *src, const int stride, const int count );
+	virtual unsigned int VPCALL PointsBehindPlane( const idPlane &constant, const float *src, const int stride, const int count );
+	virtual void VPCALL DecodeQuantized( float *dst, const unsigned short *src1, const unsigned short *src2, const float lerp, const float *mins, const float *scales, const int count );
 	virtual void VPCALL DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
 	virtual void VPCALL DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
 	virtual void VPCALL DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts );
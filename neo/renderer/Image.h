@@ -230,7 +230,8 @@ public:
 	// background loading information
 	idImage				*partialImage;			// shrunken, space-saving version
 	bool				isPartialImage;			// true if this is pointed to by another image
-	bool				backgroundLoadInProgress;	// true if another thread is reading the complete d3t file
+	bool				backgroundLoadInProgress;	// true if the complete image is being read or is queued for loading
+	bool				partialIsComplete;		// true if the source image was small enough to be used as the partial version
 	backgroundDownload_t	bgl;
 	idImage *			bglNext;				// linked from tr.backgroundImageLoads
 
@@ -272,6 +273,7 @@ ID_INLINE idImage::idImage() {
 	frameUsed = 0;
 	classification = 0;
 	backgroundLoadInProgress = false;
+	partialIsComplete = false;
 	bgl.opcode = DLTYPE_FILE;
 	bgl.f = NULL;
 	bglNext = NULL;
@@ -302,6 +304,15 @@ void	R_WriteTGA( const char *filename, const byte *data, int width, int height,
 void	R_WritePalTGA( const char *filename, const byte *data, const byte *palette, int width, int height, bool flipVertical = false );
 // data is in top-to-bottom raster order unless flipVertical is set
 
+// an image in the packed image cache written by makeImageCache
+typedef struct {
+	idStr				imgName;
+	textureDepth_t		depth;				// as referenced, before the image program changed it
+	textureRepeat_t		repeat;
+	ID_TIME_T			timestamp;			// of the source images when the cache was built
+	int					offset;				// of the .dds data in the cache file
+	int					length;
+} imageCacheEntry_t;
 
 class idImageManager {
 public:
@@ -365,6 +376,11 @@ public:
 
 	void				PrintMemInfo( MemInfo_t *mi );
 
+	// packed image cache written by makeImageCache, see Image_cache.cpp
+	void				LoadImageCacheIndex();
+	int					FindCachedImage( const idImage *image ) const;
+	bool				LoadCachedImage( idImage *image );
+
 	// cvars
 	static idCVar		image_roundDown;			// round bad sizes down to nearest power of two
 	static idCVar		image_colorMipLevels;		// development aid to see texture mip usage
@@ -384,9 +400,12 @@ public:
 	static idCVar		image_preload;				// if 0, dynamically load all images
 	static idCVar		image_cacheMinK;			// maximum K of precompressed files to read at specification time,
 													// the remainder will be dynamically cached
-	static idCVar		image_cacheMegs;			// maximum bytes set aside for temporary loading of full-sized precompressed images
+	static idCVar		image_cacheMegs;			// maximum bytes set aside for full-sized streamed images
+	static idCVar		image_streamPartialSize;	// maximum width/height of the shrunken versions of streamed images
+	static idCVar		image_streamMsec;			// milliseconds per frame spent loading streamed images that aren't precompressed
 	static idCVar		image_useCache;				// 1 = do background load image caching
 	static idCVar		image_showBackgroundLoads;	// 1 = print number of outstanding background loads
+	static idCVar		image_usePackedCache;		// use the images in the packed image cache if they're up to date
 	static idCVar		image_forceDownSize;		// allows the ability to force a downsize
 	static idCVar		image_downSizeSpecular;		// downsize specular
 	static idCVar		image_downSizeSpecularLimit;// downsize specular limit
@@ -426,6 +445,8 @@ public:
 	idImage *			AllocImage( const char *name );
 	void				SetNormalPalette();
 	void				ChangeTextureFilter();
+	void				PurgeStreamedImages( int needed );
+	int					StreamedImagesSize() const;
 
 	idList<idImage*>	images;
 	idStrList			ddsList;
@@ -450,11 +471,17 @@ public:
 
 	int	numActiveBackgroundImageLoads;
 	const static int MAX_BACKGROUND_IMAGE_LOADS = 8;
+
+	idList<idImage*>	streamQueue;				// full-sized images without a precompressed file, loaded a few per frame
+
+	idList<imageCacheEntry_t>	imageCacheEntries;	// index of the packed image cache
+	idHashIndex			imageCacheHash;
 };
 
 extern idImageManager	*globalImages;		// pointer to global list for the rest of the system
 
 int MakePowerOfTwo( int num );
+bool FormatIsDXT( int internalFormat );
 
 /*
 ====================================================================
@@ -481,6 +508,12 @@ void R_HorizontalFlip( byte *data, int width, int height );
 void R_VerticalFlip( byte *data, int width, int height );
 void R_RotatePic( byte *data, int width );
 
+// benchmarks the mipmap and resample filters on the given images
+void R_TestImageProcessing_f( const idCmdArgs &args );
+
+// writes the packed image cache for all images referenced by materials
+void R_MakeImageCache_f( const idCmdArgs &args );
+
 /*
 ====================================================================
 
@@ -490,6 +523,27 @@ IMAGEFILES
 */
 
 void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp, bool makePowerOf2 );
+
+// reads the source files of the images and decodes them on the job threads,
+// the following R_LoadImage() calls for them return the decoded pixels
+void R_PrefetchImages( idImage * const *images, int numImages );
+void R_PurgePrefetchedImages( void );
+
+typedef enum {
+	IMAGE_LOAD_TGA,
+	IMAGE_LOAD_JPG,
+	IMAGE_LOAD_PNG,
+	IMAGE_LOAD_BMP,
+	IMAGE_LOAD_PCX,
+	IMAGE_LOAD_DDS,				// precompressed files
+	IMAGE_LOAD_CACHE,			// packed image cache
+	IMAGE_LOAD_NUM_FORMATS
+} imageLoadFormat_t;
+
+// per format load counts and times, printed by EndLevelLoad
+void R_CountImageLoad( imageLoadFormat_t format, int pixels, int msec, bool prefetched = false );
+void R_ClearImageLoadStats( void );
+void R_PrintImageLoadStats( void );
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6], int *size, ID_TIME_T *timestamp );
 
@@ -0,0 +1,765 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "framework/DeclManager.h"
+#include "framework/FileSystem.h"
+#include "renderer/tr_local.h"
+
+#include "renderer/Image.h"
+
+/*
+====================================================================
+
+PACKED IMAGE CACHE
+
+makeImageCache evaluates the image programs of all images referenced by
+materials, generates the mip levels and compresses them the same way
+GenerateImage() would have the driver do it, and writes the results
+as in-memory .dds files into one packed file.
+
+ActuallyLoadImage() uploads an image straight from the cache when its
+source files haven't changed since, so neither the image program nor the
+mip levels or the compression have to be done at load time.
+
+file layout (little endian):
+	int		IMAGE_CACHE_MAGIC
+	int		IMAGE_CACHE_VERSION
+	int		settings the cache was built with, see R_ImageCacheSettings()
+	int		number of images
+	int		offset of the index
+	...		.dds data of each image
+	index:	for each image its name, depth, repeat, source timestamp,
+			and the offset and length of its .dds data
+====================================================================
+*/
+
+#define IMAGE_CACHE_FILE		"dds/imagecache.bin"
+#define IMAGE_CACHE_MAGIC		( ( 'I' << 24 ) | ( 'M' << 16 ) | ( 'G' << 8 ) | 'C' )
+#define IMAGE_CACHE_VERSION		1
+#define IMAGE_CACHE_HEADER_SIZE	20
+
+/*
+================
+R_ImageCacheSettings
+
+The cvars and hardware capabilities that change which internal format
+SelectInternalFormat() picks, a cache built with other settings is ignored
+================
+*/
+static int R_ImageCacheSettings( void ) {
+	int settings = 0;
+	if ( globalImages->image_useCompression.GetBool() ) {
+		settings |= 1;
+	}
+	if ( globalImages->image_useAllFormats.GetBool() ) {
+		settings |= 2;
+	}
+	if ( glConfig.textureCompressionAvailable ) {
+		settings |= 4;
+	}
+	if ( glConfig.sharedTexturePaletteAvailable ) {
+		settings |= 8;
+	}
+	settings |= ( globalImages->image_useNormalCompression.GetInteger() & 15 ) << 4;
+	return settings;
+}
+
+/*
+====================================================================
+
+DXT COMPRESSION
+
+Bounding box compression of 4x4 blocks, as described in
+"Real-Time DXT Compression" by J.M.P. van Waveren
+====================================================================
+*/
+
+typedef struct {
+	const byte *	pic;
+	int				width;
+	int				height;
+	int				internalFormat;
+	int				blockBytes;
+	byte *			out;
+	int				blockRows;
+	int				blockRowsPerJob;
+} dxtJob_t;
+
+static ID_INLINE unsigned short R_ColorTo565( const byte *color ) {
+	return ( ( color[0] >> 3 ) << 11 ) | ( ( color[1] >> 2 ) << 5 ) | ( color[2] >> 3 );
+}
+
+static ID_INLINE void R_565ToColor( unsigned short c, int *color ) {
+	int r = ( c >> 11 ) & 31;
+	int g = ( c >> 5 ) & 63;
+	int b = c & 31;
+	color[0] = ( r << 3 ) | ( r >> 2 );
+	color[1] = ( g << 2 ) | ( g >> 4 );
+	color[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+/*
+================
+R_ExtractBlock
+
+Copies a 4x4 block of RGBA pixels, repeating the last row and column
+for mip levels smaller than a block
+================
+*/
+static void R_ExtractBlock( const byte *pic, int width, int height, int bx, int by, byte block[64] ) {
+	for ( int y = 0 ; y < 4 ; y++ ) {
+		int sy = Min( by * 4 + y, height - 1 );
+		for ( int x = 0 ; x < 4 ; x++ ) {
+			int sx = Min( bx * 4 + x, width - 1 );
+			const byte *p = pic + ( sy * width + sx ) * 4;
+			byte *b = block + ( y * 4 + x ) * 4;
+			b[0] = p[0];
+			b[1] = p[1];
+			b[2] = p[2];
+			b[3] = p[3];
+		}
+	}
+}
+
+/*
+================
+R_EmitColorBlock
+
+Four color DXT block from the inset bounding box of the colors, with the
+diagonal of the box picked to follow the covariance of the channels
+================
+*/
+static void R_EmitColorBlock( const byte block[64], byte *out ) {
+	int		minColor[3], maxColor[3], mean[3];
+	int		i, j;
+
+	for ( j = 0 ; j < 3 ; j++ ) {
+		minColor[j] = 255;
+		maxColor[j] = 0;
+		mean[j] = 0;
+	}
+	for ( i = 0 ; i < 16 ; i++ ) {
+		for ( j = 0 ; j < 3 ; j++ ) {
+			minColor[j] = Min( minColor[j], (int)block[i*4+j] );
+			maxColor[j] = Max( maxColor[j], (int)block[i*4+j] );
+			mean[j] += block[i*4+j];
+		}
+	}
+
+	// flip green and blue when they go down as red goes up
+	int covRG = 0, covRB = 0;
+	for ( i = 0 ; i < 16 ; i++ ) {
+		int r = block[i*4+0] * 16 - mean[0];
+		covRG += r * ( block[i*4+1] * 16 - mean[1] );
+		covRB += r * ( block[i*4+2] * 16 - mean[2] );
+	}
+
+	for ( j = 0 ; j < 3 ; j++ ) {
+		int inset = ( maxColor[j] - minColor[j] ) >> 4;
+		minColor[j] += inset;
+		maxColor[j] -= inset;
+	}
+	if ( covRG < 0 ) {
+		idSwap( minColor[1], maxColor[1] );
+	}
+	if ( covRB < 0 ) {
+		idSwap( minColor[2], maxColor[2] );
+	}
+
+	byte	c0[3], c1[3];
+	for ( j = 0 ; j < 3 ; j++ ) {
+		c0[j] = maxColor[j];
+		c1[j] = minColor[j];
+	}
+	unsigned short color0 = R_ColorTo565( c0 );
+	unsigned short color1 = R_ColorTo565( c1 );
+	if ( color0 < color1 ) {
+		idSwap( color0, color1 );
+	}
+
+	unsigned int indexes = 0;
+	if ( color0 != color1 ) {
+		int palette[4][3];
+		R_565ToColor( color0, palette[0] );
+		R_565ToColor( color1, palette[1] );
+		for ( j = 0 ; j < 3 ; j++ ) {
+			palette[2][j] = ( 2 * palette[0][j] + palette[1][j] ) / 3;
+			palette[3][j] = ( palette[0][j] + 2 * palette[1][j] ) / 3;
+		}
+		for ( i = 0 ; i < 16 ; i++ ) {
+			int best = 0;
+			int bestDist = INT_MAX;
+			for ( int p = 0 ; p < 4 ; p++ ) {
+				int dr = block[i*4+0] - palette[p][0];
+				int dg = block[i*4+1] - palette[p][1];
+				int db = block[i*4+2] - palette[p][2];
+				int dist = dr * dr + dg * dg + db * db;
+				if ( dist < bestDist ) {
+					bestDist = dist;
+					best = p;
+				}
+			}
+			indexes |= best << ( i * 2 );
+		}
+	}
+
+	out[0] = color0 & 255;
+	out[1] = color0 >> 8;
+	out[2] = color1 & 255;
+	out[3] = color1 >> 8;
+	out[4] = indexes & 255;
+	out[5] = ( indexes >> 8 ) & 255;
+	out[6] = ( indexes >> 16 ) & 255;
+	out[7] = indexes >> 24;
+}
+
+/*
+================
+R_EmitExplicitAlphaBlock
+
+DXT3 alpha: four bits per pixel
+================
+*/
+static void R_EmitExplicitAlphaBlock( const byte block[64], byte *out ) {
+	for ( int i = 0 ; i < 8 ; i++ ) {
+		int a0 = ( block[(i*2+0)*4+3] * 15 + 127 ) / 255;
+		int a1 = ( block[(i*2+1)*4+3] * 15 + 127 ) / 255;
+		out[i] = a0 | ( a1 << 4 );
+	}
+}
+
+/*
+================
+R_EmitInterpolatedAlphaBlock
+
+DXT5 alpha: eight alpha values interpolated between the extremes of the block
+================
+*/
+static void R_EmitInterpolatedAlphaBlock( const byte block[64], byte *out ) {
+	int minAlpha = 255;
+	int maxAlpha = 0;
+	for ( int i = 0 ; i < 16 ; i++ ) {
+		minAlpha = Min( minAlpha, (int)block[i*4+3] );
+		maxAlpha = Max( maxAlpha, (int)block[i*4+3] );
+	}
+
+	out[0] = maxAlpha;
+	out[1] = minAlpha;
+
+	unsigned int indexes[2] = { 0, 0 };
+	if ( maxAlpha != minAlpha ) {
+		int palette[8];
+		palette[0] = maxAlpha;
+		palette[1] = minAlpha;
+		for ( int p = 2 ; p < 8 ; p++ ) {
+			palette[p] = ( ( 8 - p ) * maxAlpha + ( p - 1 ) * minAlpha ) / 7;
+		}
+		for ( int i = 0 ; i < 16 ; i++ ) {
+			int best = 0;
+			int bestDist = INT_MAX;
+			for ( int p = 0 ; p < 8 ; p++ ) {
+				int dist = abs( block[i*4+3] - palette[p] );
+				if ( dist < bestDist ) {
+					bestDist = dist;
+					best = p;
+				}
+			}
+			// 3 bit indexes, eight pixels in each 24 bit half
+			indexes[i >> 3] |= best << ( ( i & 7 ) * 3 );
+		}
+	}
+
+	for ( int h = 0 ; h < 2 ; h++ ) {
+		out[2+h*3+0] = indexes[h] & 255;
+		out[2+h*3+1] = ( indexes[h] >> 8 ) & 255;
+		out[2+h*3+2] = ( indexes[h] >> 16 ) & 255;
+	}
+}
+
+/*
+================
+R_CompressDXTJob
+================
+*/
+static void R_CompressDXTJob( void *data, int jobNum ) {
+	const dxtJob_t *job = (const dxtJob_t *)data;
+	int blocksWide = ( job->width + 3 ) / 4;
+	int firstRow = jobNum * job->blockRowsPerJob;
+	int lastRow = Min( firstRow + job->blockRowsPerJob, job->blockRows );
+	byte block[64];
+
+	for ( int by = firstRow ; by < lastRow ; by++ ) {
+		byte *out = job->out + by * blocksWide * job->blockBytes;
+		for ( int bx = 0 ; bx < blocksWide ; bx++, out += job->blockBytes ) {
+			R_ExtractBlock( job->pic, job->width, job->height, bx, by, block );
+			switch ( job->internalFormat ) {
+			case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+				R_EmitExplicitAlphaBlock( block, out );
+				R_EmitColorBlock( block, out + 8 );
+				break;
+			case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+				R_EmitInterpolatedAlphaBlock( block, out );
+				R_EmitColorBlock( block, out + 8 );
+				break;
+			default:
+				R_EmitColorBlock( block, out );
+				break;
+			}
+		}
+	}
+}
+
+/*
+================
+R_CompressDXT
+
+Compresses one mip level, spreading the block rows over the job threads
+================
+*/
+static void R_CompressDXT( const byte *pic, int width, int height, int internalFormat, byte *out ) {
+	dxtJob_t job;
+	job.pic = pic;
+	job.width = width;
+	job.height = height;
+	job.internalFormat = internalFormat;
+	job.blockBytes = ( internalFormat <= GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ) ? 8 : 16;
+	job.out = out;
+	job.blockRows = ( height + 3 ) / 4;
+
+	int numJobs = Min( job.blockRows, ( Sys_NumJobThreads() + 1 ) * 4 );
+	job.blockRowsPerJob = ( job.blockRows + numJobs - 1 ) / numJobs;
+	numJobs = ( job.blockRows + job.blockRowsPerJob - 1 ) / job.blockRowsPerJob;
+
+	if ( numJobs <= 1 || width * height < 128 * 128 ) {
+		job.blockRowsPerJob = job.blockRows;
+		R_CompressDXTJob( &job, 0 );
+	} else {
+		Sys_RunJobs( R_CompressDXTJob, &job, numJobs );
+	}
+}
+
+/*
+====================================================================
+
+BUILDING
+
+====================================================================
+*/
+
+/*
+================
+R_CachedLevelSize
+================
+*/
+static int R_CachedLevelSize( int internalFormat, int width, int height ) {
+	if ( FormatIsDXT( internalFormat ) ) {
+		return ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * ( internalFormat <= GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ? 8 : 16 );
+	}
+	return width * height * 4;
+}
+
+/*
+================
+R_BuildCachedImage
+
+Returns a complete .dds file with all mip levels of the image program
+output, processed like GenerateImage() does, or NULL for internal formats
+that can't be stored in a .dds file.
+================
+*/
+static byte *R_BuildCachedImage( const idImage *image, byte *pic, int width, int height, textureDepth_t depth, int *length ) {
+	int internalFormat = image->SelectInternalFormat( (const byte **)&pic, 1, width, height, depth );
+
+	switch ( internalFormat ) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_RGB8:
+	case GL_RGBA8:
+		break;
+	default:
+		return NULL;
+	}
+
+	// don't let mip mapping smear the texture into the clamped border
+	bool preserveBorder = ( image->repeat == TR_CLAMP_TO_ZERO );
+
+	if ( image->repeat == TR_CLAMP_TO_ZERO ) {
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 0;
+		rgba[3] = 255;
+		R_SetBorderTexels( pic, width, height, rgba );
+	}
+	if ( image->repeat == TR_CLAMP_TO_ZERO_ALPHA ) {
+		byte	rgba[4];
+
+		rgba[0] = rgba[1] = rgba[2] = 255;
+		rgba[3] = 0;
+		R_SetBorderTexels( pic, width, height, rgba );
+	}
+
+	// swap the red and alpha for rxgb support, like GenerateImage()
+	if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 1 ) {
+		for ( int i = 0; i < width * height * 4; i += 4 ) {
+			pic[ i + 3 ] = pic[ i ];
+			pic[ i ] = 0;
+		}
+	}
+
+	int numLevels = 1;
+	int totalSize = R_CachedLevelSize( internalFormat, width, height );
+	for ( int w = width, h = height ; w > 1 || h > 1 ; numLevels++ ) {
+		w = Max( w >> 1, 1 );
+		h = Max( h >> 1, 1 );
+		totalSize += R_CachedLevelSize( internalFormat, w, h );
+	}
+
+	*length = 4 + sizeof( ddsFileHeader_t ) + totalSize;
+	byte *data = (byte *)R_StaticAlloc( *length );
+	memset( data, 0, 4 + sizeof( ddsFileHeader_t ) );
+
+	*(unsigned int *)data = LittleInt( DDS_MAKEFOURCC( 'D', 'D', 'S', ' ' ) );
+
+	ddsFileHeader_t *header = (ddsFileHeader_t *)( data + 4 );
+	header->dwSize = LittleInt( sizeof( ddsFileHeader_t ) );
+	header->dwFlags = DDSF_CAPS | DDSF_PIXELFORMAT | DDSF_WIDTH | DDSF_HEIGHT | DDSF_MIPMAPCOUNT;
+	header->dwFlags |= FormatIsDXT( internalFormat ) ? DDSF_LINEARSIZE : DDSF_PITCH;
+	header->dwFlags = LittleInt( header->dwFlags );
+	header->dwHeight = LittleInt( height );
+	header->dwWidth = LittleInt( width );
+	header->dwPitchOrLinearSize = LittleInt( FormatIsDXT( internalFormat ) ? R_CachedLevelSize( internalFormat, width, height ) : width * 4 );
+	header->dwMipMapCount = LittleInt( numLevels );
+	header->dwCaps1 = LittleInt( numLevels > 1 ? DDSF_TEXTURE | DDSF_MIPMAP | DDSF_COMPLEX : DDSF_TEXTURE );
+	header->ddspf.dwSize = LittleInt( sizeof( header->ddspf ) );
+	switch ( internalFormat ) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		header->ddspf.dwFlags = LittleInt( DDSF_FOURCC );
+		header->ddspf.dwFourCC = LittleInt( DDS_MAKEFOURCC( 'D', 'X', 'T', '1' ) );
+		break;
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		header->ddspf.dwFlags = LittleInt( DDSF_FOURCC );
+		header->ddspf.dwFourCC = LittleInt( DDS_MAKEFOURCC( 'D', 'X', 'T', '3' ) );
+		break;
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		header->ddspf.dwFlags = LittleInt( DDSF_FOURCC );
+		header->ddspf.dwFourCC = LittleInt( DDS_MAKEFOURCC( 'D', 'X', 'T', '5' ) );
+		break;
+	default:
+		// the alpha of rgb images is 255 anyway, so both are stored as BGRA
+		header->ddspf.dwFlags = LittleInt( internalFormat == GL_RGBA8 ? DDSF_RGBA : DDSF_RGB );
+		header->ddspf.dwRGBBitCount = LittleInt( 32 );
+		header->ddspf.dwRBitMask = LittleInt( 0x00FF0000 );
+		header->ddspf.dwGBitMask = LittleInt( 0x0000FF00 );
+		header->ddspf.dwBBitMask = LittleInt( 0x000000FF );
+		header->ddspf.dwABitMask = LittleInt( internalFormat == GL_RGBA8 ? 0xFF000000 : 0 );
+		break;
+	}
+
+	byte *out = data + 4 + sizeof( ddsFileHeader_t );
+	byte *level = pic;
+	int w = width;
+	int h = height;
+	for ( int i = 0 ; i < numLevels ; i++ ) {
+		if ( i > 0 ) {
+			byte *shrunk = R_MipMap( level, w, h, preserveBorder );
+			if ( level != pic ) {
+				R_StaticFree( level );
+			}
+			level = shrunk;
+			w = Max( w >> 1, 1 );
+			h = Max( h >> 1, 1 );
+		}
+
+		if ( FormatIsDXT( internalFormat ) ) {
+			R_CompressDXT( level, w, h, internalFormat, out );
+		} else {
+			for ( int j = 0 ; j < w * h * 4 ; j += 4 ) {
+				out[j+0] = level[j+2];
+				out[j+1] = level[j+1];
+				out[j+2] = level[j+0];
+				out[j+3] = level[j+3];
+			}
+		}
+		out += R_CachedLevelSize( internalFormat, w, h );
+	}
+	if ( level != pic ) {
+		R_StaticFree( level );
+	}
+
+	return data;
+}
+
+/*
+================
+R_MakeImageCache_f
+
+Parses all materials and writes the packed image cache for all the 2D
+images they reference
+================
+*/
+void R_MakeImageCache_f( const idCmdArgs &args ) {
+	if ( !glConfig.isInitialized ) {
+		common->Printf( "makeImageCache: the renderer must be running to pick the internal formats\n" );
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+
+	// parse all the materials so their images are known, but don't load them
+	bool insideLevelLoad = globalImages->insideLevelLoad;
+	globalImages->insideLevelLoad = true;
+	int numMaterials = declManager->GetNumDecls( DECL_MATERIAL );
+	for ( int i = 0 ; i < numMaterials ; i++ ) {
+		declManager->MaterialByIndex( i, true );
+	}
+	globalImages->insideLevelLoad = insideLevelLoad;
+
+	idFile *f = fileSystem->OpenFileWrite( IMAGE_CACHE_FILE );
+	if ( !f ) {
+		common->Warning( "makeImageCache: couldn't open %s for writing", IMAGE_CACHE_FILE );
+		return;
+	}
+
+	// the header is written again once the index offset is known
+	for ( int i = 0 ; i < IMAGE_CACHE_HEADER_SIZE / 4 ; i++ ) {
+		f->WriteInt( 0 );
+	}
+
+	idList<imageCacheEntry_t> entries;
+	idHashIndex hash;
+	int offset = IMAGE_CACHE_HEADER_SIZE;
+	int skipped = 0;
+
+	for ( int i = 0 ; i < globalImages->images.Num() ; i++ ) {
+		const idImage *image = globalImages->images[i];
+
+		if ( image->generatorFunction || image->isPartialImage || image->cubeFiles != CF_2D ) {
+			continue;
+		}
+
+		// the same image may be referenced with different filters
+		int key = idStr::IHash( image->imgName );
+		int j;
+		for ( j = hash.First( key ) ; j != -1 ; j = hash.Next( j ) ) {
+			if ( entries[j].imgName.Icmp( image->imgName ) == 0 && entries[j].depth == image->depth && entries[j].repeat == image->repeat ) {
+				break;
+			}
+		}
+		if ( j != -1 ) {
+			continue;
+		}
+
+		byte			*pic;
+		int				width, height;
+		ID_TIME_T		timestamp;
+		textureDepth_t	depth = image->depth;
+
+		R_LoadImageProgram( image->imgName, &pic, &width, &height, &timestamp, &depth );
+		if ( pic == NULL ) {
+			continue;
+		}
+
+		int length = 0;
+		byte *data = R_BuildCachedImage( image, pic, width, height, depth, &length );
+		R_StaticFree( pic );
+
+		if ( !data ) {
+			skipped++;
+			continue;
+		}
+
+		f->Write( data, length );
+		R_StaticFree( data );
+
+		imageCacheEntry_t &entry = entries.Alloc();
+		entry.imgName = image->imgName;
+		entry.depth = image->depth;
+		entry.repeat = image->repeat;
+		entry.timestamp = timestamp;
+		entry.offset = offset;
+		entry.length = length;
+		hash.Add( key, entries.Num() - 1 );
+
+		offset += length;
+
+		if ( ( entries.Num() & 63 ) == 0 ) {
+			common->Printf( "%i images...\n", entries.Num() );
+		}
+	}
+
+	for ( int i = 0 ; i < entries.Num() ; i++ ) {
+		f->WriteString( entries[i].imgName );
+		f->WriteInt( entries[i].depth );
+		f->WriteInt( entries[i].repeat );
+		f->WriteInt( (int)entries[i].timestamp );
+		f->WriteInt( entries[i].offset );
+		f->WriteInt( entries[i].length );
+	}
+
+	f->Seek( 0, FS_SEEK_SET );
+	f->WriteInt( IMAGE_CACHE_MAGIC );
+	f->WriteInt( IMAGE_CACHE_VERSION );
+	f->WriteInt( R_ImageCacheSettings() );
+	f->WriteInt( entries.Num() );
+	f->WriteInt( offset );
+
+	fileSystem->CloseFile( f );
+
+	common->Printf( "wrote %i images (%i MB) to %s in %5.1f seconds, %i images with formats that can't be cached\n",
+					entries.Num(), offset >> 20, IMAGE_CACHE_FILE, ( Sys_Milliseconds() - start ) * 0.001f, skipped );
+
+	globalImages->LoadImageCacheIndex();
+}
+
+/*
+====================================================================
+
+LOADING
+
+====================================================================
+*/
+
+/*
+================
+idImageManager::LoadImageCacheIndex
+================
+*/
+void idImageManager::LoadImageCacheIndex() {
+	imageCacheEntries.Clear();
+	imageCacheHash.Clear();
+
+	if ( !image_usePackedCache.GetBool() ) {
+		return;
+	}
+
+	idFile *f = fileSystem->OpenFileRead( IMAGE_CACHE_FILE );
+	if ( !f ) {
+		return;
+	}
+
+	int magic, version, settings, numEntries, indexOffset;
+	f->ReadInt( magic );
+	f->ReadInt( version );
+	f->ReadInt( settings );
+	f->ReadInt( numEntries );
+	f->ReadInt( indexOffset );
+
+	if ( magic != IMAGE_CACHE_MAGIC || version != IMAGE_CACHE_VERSION ) {
+		common->Warning( "%s is not a version %i image cache", IMAGE_CACHE_FILE, IMAGE_CACHE_VERSION );
+		fileSystem->CloseFile( f );
+		return;
+	}
+	if ( settings != R_ImageCacheSettings() ) {
+		common->Printf( "%s was built with different image settings, run makeImageCache again to use it\n", IMAGE_CACHE_FILE );
+		fileSystem->CloseFile( f );
+		return;
+	}
+
+	f->Seek( indexOffset, FS_SEEK_SET );
+	imageCacheEntries.SetNum( numEntries );
+	for ( int i = 0 ; i < numEntries ; i++ ) {
+		imageCacheEntry_t &entry = imageCacheEntries[i];
+		int depth, repeat, timestamp;
+
+		f->ReadString( entry.imgName );
+		f->ReadInt( depth );
+		f->ReadInt( repeat );
+		f->ReadInt( timestamp );
+		f->ReadInt( entry.offset );
+		f->ReadInt( entry.length );
+		entry.depth = (textureDepth_t)depth;
+		entry.repeat = (textureRepeat_t)repeat;
+		entry.timestamp = timestamp;
+
+		imageCacheHash.Add( idStr::IHash( entry.imgName ), i );
+	}
+
+	fileSystem->CloseFile( f );
+
+	common->Printf( "%i images in the packed image cache\n", numEntries );
+}
+
+/*
+================
+idImageManager::FindCachedImage
+
+Returns the index of the image in the packed image cache, or -1
+================
+*/
+int idImageManager::FindCachedImage( const idImage *image ) const {
+	for ( int i = imageCacheHash.First( idStr::IHash( image->imgName ) ) ; i != -1 ; i = imageCacheHash.Next( i ) ) {
+		const imageCacheEntry_t &entry = imageCacheEntries[i];
+		if ( entry.depth == image->depth && entry.repeat == image->repeat && entry.imgName.Icmp( image->imgName ) == 0 ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+================
+idImageManager::LoadCachedImage
+
+Uploads the image from the packed image cache, returns false if it isn't
+in there or the source images have changed since the cache was built
+================
+*/
+bool idImageManager::LoadCachedImage( idImage *image ) {
+	int index = FindCachedImage( image );
+	if ( index == -1 ) {
+		return false;
+	}
+	const imageCacheEntry_t &entry = imageCacheEntries[index];
+	int start = Sys_Milliseconds();
+
+	ID_TIME_T current;
+	R_LoadImageProgram( image->imgName, NULL, NULL, NULL, &current );
+	if ( current == FILE_NOT_FOUND_TIMESTAMP || (int)current != (int)entry.timestamp ) {
+		return false;
+	}
+
+	idFile *f = fileSystem->OpenFileRead( IMAGE_CACHE_FILE );
+	if ( !f ) {
+		return false;
+	}
+
+	byte *data = (byte *)R_StaticAlloc( entry.length );
+	bool ok = ( f->Seek( entry.offset, FS_SEEK_SET ) == 0 && f->Read( data, entry.length ) == entry.length );
+	fileSystem->CloseFile( f );
+
+	if ( ok ) {
+		image->UploadPrecompressedImage( data, entry.length );
+		image->timestamp = current;
+		R_CountImageLoad( IMAGE_LOAD_CACHE, image->uploadWidth * image->uploadHeight, Sys_Milliseconds() - start );
+	}
+	R_StaticFree( data );
+
+	return ok;
+}
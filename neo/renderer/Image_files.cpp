@@ -26,10 +26,15 @@ If you have questions concerning this license or the applicable additional terms
 ===========================================================================
 */
 
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // DG: replace libjpeg with stb_image.h because it causes fewer headaches
 #define STBI_NO_HDR
 #define STBI_NO_LINEAR
-#define STBI_ONLY_JPEG // at least for now, only use it for JPEG
+#define STBI_ONLY_JPEG // at least for now, only use it for JPEG and PNG (must match stblib_impls.c)
+#define STBI_ONLY_PNG
 #define STBI_NO_STDIO  // images are passed as buffers
 #include "stb_image.h"
 
@@ -45,6 +50,8 @@ This file only has a single entry point:
 
 void R_LoadImage( const char *name, byte **pic, int *width, int *height, bool makePowerOf2 );
 
+which R_PrefetchImages() can feed with images decoded on the job threads.
+
 */
 
 /*
@@ -132,7 +139,7 @@ void R_WritePalTGA( const char *filename, const byte *data, const byte *palette,
 
 static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
-static void LoadJPG( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
+static void LoadSTB( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp );
 
 
 /*
@@ -520,35 +527,20 @@ TARGA LOADING
 
 /*
 =============
-LoadTGA
+R_ParseTGAHeader
+
+Validates the header, on the calling thread because of the common->Error()s.
+Returns the start of the pixel data.
 =============
 */
-static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
-	int		columns, rows, numPixels, fileSize, numBytes;
-	byte	*pixbuf;
-	int		row, column;
-	byte	*buf_p;
-	byte	*buffer;
-	TargaHeader	targa_header;
-	byte		*targa_rgba;
-
-	if ( !pic ) {
-		fileSystem->ReadFile( name, NULL, timestamp );
-		return;	// just getting timestamp
-	}
-
-	*pic = NULL;
+static const byte *R_ParseTGAHeader( const char *name, const byte *buffer, int fileSize, TargaHeader &targa_header ) {
+	const byte	*buf_p = buffer;
+	int			numBytes;
 
-	//
-	// load the file
-	//
-	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
-	if ( !buffer ) {
-		return;
+	if ( fileSize < 18 ) {
+		common->Error( "LoadTGA( %s ): incomplete file\n", name );
 	}
 
-	buf_p = buffer;
-
 	targa_header.id_length = *buf_p++;
 	targa_header.colormap_type = *buf_p++;
 	targa_header.image_type = *buf_p++;
@@ -581,6 +573,10 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
 	}
 
+	if ( targa_header.image_type == 3 && targa_header.pixel_size != 8 && targa_header.pixel_size != 24 && targa_header.pixel_size != 32 ) {
+		common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+	}
+
 	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
 		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
 		if ( numBytes > fileSize - 18 - targa_header.id_length ) {
@@ -588,179 +584,214 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 		}
 	}
 
-	columns = targa_header.width;
-	rows = targa_header.height;
-	numPixels = columns * rows;
-
-	if ( width ) {
-		*width = columns;
-	}
-	if ( height ) {
-		*height = rows;
-	}
-
-	targa_rgba = (byte *)R_StaticAlloc(numPixels*4);
-	*pic = targa_rgba;
-
 	if ( targa_header.id_length != 0 ) {
 		buf_p += targa_header.id_length;  // skip TARGA image comment
 	}
 
-	if ( targa_header.image_type == 2 || targa_header.image_type == 3 )
-	{
-		// Uncompressed RGB or gray scale image
-		for( row = rows - 1; row >= 0; row-- )
+	return buf_p;
+}
+
+/*
+=============
+R_TGAPixelsToRGBA
+
+Converts a span of gray, BGR or BGRA pixels to RGBA
+=============
+*/
+static void R_TGAPixelsToRGBA( const byte *in, byte *out, int numPixels, int pixelSize ) {
+	int i = 0;
+
+	switch ( pixelSize ) {
+	case 8:
+		for ( ; i < numPixels ; i++, in++, out += 4 ) {
+			out[0] = out[1] = out[2] = in[0];
+			out[3] = 255;
+		}
+		break;
+	case 24:
+		for ( ; i < numPixels ; i++, in += 3, out += 4 ) {
+			out[0] = in[2];
+			out[1] = in[1];
+			out[2] = in[0];
+			out[3] = 255;
+		}
+		break;
+	case 32:
+#if defined(__GNUC__) && defined(__SSE2__)
 		{
-			pixbuf = targa_rgba + row*columns*4;
-			for( column = 0; column < columns; column++)
-			{
-				unsigned char red,green,blue,alphabyte;
-				switch( targa_header.pixel_size )
-				{
-
-				case 8:
-					blue = *buf_p++;
-					green = blue;
-					red = blue;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = 255;
-					break;
+			// swap the red and blue bytes of four pixels at a time
+			const __m128i ga = _mm_set1_epi32( 0xFF00FF00 );
+			for ( ; i + 4 <= numPixels ; i += 4, in += 16, out += 16 ) {
+				__m128i bgra = _mm_loadu_si128( (const __m128i *)in );
+				__m128i rb = _mm_andnot_si128( ga, bgra );
+				__m128i rgba = _mm_or_si128( _mm_and_si128( bgra, ga ),
+								_mm_or_si128( _mm_slli_epi32( rb, 16 ), _mm_srli_epi32( rb, 16 ) ) );
+				_mm_storeu_si128( (__m128i *)out, rgba );
+			}
+		}
+#endif
+		for ( ; i < numPixels ; i++, in += 4, out += 4 ) {
+			out[0] = in[2];
+			out[1] = in[1];
+			out[2] = in[0];
+			out[3] = in[3];
+		}
+		break;
+	}
+}
 
-				case 24:
-					blue = *buf_p++;
-					green = *buf_p++;
-					red = *buf_p++;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = 255;
-					break;
-				case 32:
-					blue = *buf_p++;
-					green = *buf_p++;
-					red = *buf_p++;
-					alphabyte = *buf_p++;
-					*pixbuf++ = red;
-					*pixbuf++ = green;
-					*pixbuf++ = blue;
-					*pixbuf++ = alphabyte;
-					break;
-				default:
-					common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+/*
+=============
+R_DecodeTGA
+
+Decodes the pixels following a header checked by R_ParseTGAHeader().
+Doesn't use the file system or the heap, so it can run on a job thread.
+=============
+*/
+static void R_DecodeTGA( const TargaHeader &targa_header, const byte *buf_p, const byte *end, byte *targa_rgba ) {
+	int		columns = targa_header.width;
+	int		rows = targa_header.height;
+	int		pixelBytes = targa_header.pixel_size >> 3;
+	int		row, column;
+	byte	*pixbuf;
+
+	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
+		// Uncompressed RGB or gray scale image
+		for ( row = rows - 1; row >= 0; row-- ) {
+			R_TGAPixelsToRGBA( buf_p, targa_rgba + row*columns*4, columns, targa_header.pixel_size );
+			buf_p += columns * pixelBytes;
+		}
+	} else if ( targa_header.image_type == 10 ) {   // Runlength encoded RGB images
+		row = rows - 1;
+		column = 0;
+		pixbuf = targa_rgba + row*columns*4;
+
+		while ( row >= 0 && buf_p < end ) {
+			byte	packetHeader = *buf_p++;
+			int		packetSize = 1 + ( packetHeader & 0x7f );
+			bool	runLength = ( packetHeader & 0x80 ) != 0;
+			byte	color[4];
+
+			if ( runLength ) {        // run-length packet
+				if ( end - buf_p < pixelBytes ) {
 					break;
 				}
+				R_TGAPixelsToRGBA( buf_p, color, 1, targa_header.pixel_size );
+				buf_p += pixelBytes;
+			} else if ( end - buf_p < packetSize * pixelBytes ) {
+				break;
 			}
-		}
-	}
-	else if ( targa_header.image_type == 10 ) {   // Runlength encoded RGB images
-		unsigned char red,green,blue,alphabyte,packetHeader,packetSize,j;
-
-		red = 0;
-		green = 0;
-		blue = 0;
-		alphabyte = 0xff;
-
-		for( row = rows - 1; row >= 0; row-- ) {
-			pixbuf = targa_rgba + row*columns*4;
-			for( column = 0; column < columns; ) {
-				packetHeader= *buf_p++;
-				packetSize = 1 + (packetHeader & 0x7f);
-				if ( packetHeader & 0x80 ) {        // run-length packet
-					switch( targa_header.pixel_size ) {
-						case 24:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								alphabyte = 255;
-								break;
-						case 32:
-								blue = *buf_p++;
-								green = *buf_p++;
-								red = *buf_p++;
-								alphabyte = *buf_p++;
-								break;
-						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-							break;
-					}
 
-					for( j = 0; j < packetSize; j++ ) {
-						*pixbuf++=red;
-						*pixbuf++=green;
-						*pixbuf++=blue;
-						*pixbuf++=alphabyte;
-						column++;
-						if ( column == columns ) { // run spans across rows
-							column = 0;
-							if ( row > 0) {
-								row--;
-							}
-							else {
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row*columns*4;
-						}
+			// packets may span across rows
+			while ( packetSize > 0 && row >= 0 ) {
+				int count = Min( packetSize, columns - column );
+				if ( runLength ) {
+					for ( int j = 0; j < count; j++, pixbuf += 4 ) {
+						pixbuf[0] = color[0];
+						pixbuf[1] = color[1];
+						pixbuf[2] = color[2];
+						pixbuf[3] = color[3];
 					}
+				} else {
+					R_TGAPixelsToRGBA( buf_p, pixbuf, count, targa_header.pixel_size );
+					buf_p += count * pixelBytes;
+					pixbuf += count * 4;
 				}
-				else {                            // non run-length packet
-					for( j = 0; j < packetSize; j++ ) {
-						switch( targa_header.pixel_size ) {
-							case 24:
-									blue = *buf_p++;
-									green = *buf_p++;
-									red = *buf_p++;
-									*pixbuf++ = red;
-									*pixbuf++ = green;
-									*pixbuf++ = blue;
-									*pixbuf++ = 255;
-									break;
-							case 32:
-									blue = *buf_p++;
-									green = *buf_p++;
-									red = *buf_p++;
-									alphabyte = *buf_p++;
-									*pixbuf++ = red;
-									*pixbuf++ = green;
-									*pixbuf++ = blue;
-									*pixbuf++ = alphabyte;
-									break;
-							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
-								break;
-						}
-						column++;
-						if ( column == columns ) { // pixel packet run spans across rows
-							column = 0;
-							if ( row > 0 ) {
-								row--;
-							}
-							else {
-								goto breakOut;
-							}
-							pixbuf = targa_rgba + row*columns*4;
-						}
+				packetSize -= count;
+				column += count;
+				if ( column == columns ) {
+					column = 0;
+					if ( --row >= 0 ) {
+						pixbuf = targa_rgba + row*columns*4;
 					}
 				}
 			}
-			breakOut: ;
 		}
 	}
 
 	if ( (targa_header.attributes & (1<<5)) ) {			// image flp bit
-		R_VerticalFlip( *pic, *width, *height );
+		R_VerticalFlip( targa_rgba, columns, rows );
+	}
+}
+
+/*
+=============
+LoadTGA
+=============
+*/
+static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+	int		fileSize;
+	byte	*buffer;
+	TargaHeader	targa_header;
+
+	if ( !pic ) {
+		fileSystem->ReadFile( name, NULL, timestamp );
+		return;	// just getting timestamp
+	}
+
+	*pic = NULL;
+
+	//
+	// load the file
+	//
+	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	if ( !buffer ) {
+		return;
+	}
+
+	const byte *pixels = R_ParseTGAHeader( name, buffer, fileSize, targa_header );
+
+	if ( width ) {
+		*width = targa_header.width;
+	}
+	if ( height ) {
+		*height = targa_header.height;
 	}
 
+	*pic = (byte *)R_StaticAlloc( targa_header.width * targa_header.height * 4 );
+
+	R_DecodeTGA( targa_header, pixels, buffer + fileSize, *pic );
+
 	fileSystem->FreeFile( buffer );
 }
 
 /*
 =============
-LoadJPG
+R_DecodeSTB
+
+Decodes a .jpg or .png file into the given buffer of width * height * 4 bytes.
+stb_image only uses malloc(), so this can run on a job thread.
+=============
+*/
+static bool R_DecodeSTB( const byte *buffer, int len, byte *pic, int width, int height ) {
+	int w=0, h=0, comp=0;
+	byte* decodedImageData = stbi_load_from_memory( buffer, len, &w, &h, &comp, 4 );
+
+	if ( decodedImageData == NULL ) {
+		return false;
+	}
+	if ( w != width || h != height ) {
+		stbi_image_free( decodedImageData );
+		return false;
+	}
+
+	// *pic must be allocated with R_StaticAlloc(), but stb_image allocates with malloc()
+	// (and as there is no R_StaticRealloc(), #define STBI_MALLOC etc won't help)
+	// so the decoded data must be copied once
+	memcpy( pic, decodedImageData, width * height * 4 );
+	// now that decodedImageData has been copied into pic, it's not needed anymore
+	stbi_image_free( decodedImageData );
+	return true;
+}
+
+/*
+=============
+LoadSTB
+
+Loads .jpg and .png files with stb_image
 =============
 */
-static void LoadJPG( const char *filename, unsigned char **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+static void LoadSTB( const char *filename, unsigned char **pic, int *width, int *height, ID_TIME_T *timestamp ) {
 
 	if ( pic ) {
 		*pic = NULL;		// until proven otherwise
@@ -783,26 +814,285 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 	fileSystem->CloseFile( f );
 
 	int w=0, h=0, comp=0;
-	byte* decodedImageData = stbi_load_from_memory( fbuffer, len, &w, &h, &comp, 4 );
+	if ( !stbi_info_from_memory( fbuffer, len, &w, &h, &comp ) ) {
+		common->Warning( "stb_image was unable to load %s : %s\n",
+					filename, stbi_failure_reason());
+		Mem_Free( fbuffer );
+		return;
+	}
+
+	*pic = (byte *)R_StaticAlloc( w * h * 4 );
+	if ( !R_DecodeSTB( fbuffer, len, *pic, w, h ) ) {
+		common->Warning( "stb_image was unable to load %s : %s\n",
+					filename, stbi_failure_reason());
+		R_StaticFree( *pic );
+		*pic = NULL;
+	} else {
+		*width = w;
+		*height = h;
+	}
 
 	Mem_Free( fbuffer );
+}
 
-	if ( decodedImageData == NULL ) {
-		common->Warning( "stb_image was unable to load JPG %s : %s\n",
-					filename, stbi_failure_reason());
-		return;
+//===================================================================
+
+/*
+=========================================================
+
+LOAD STATISTICS
+
+=========================================================
+*/
+
+typedef struct {
+	int			count;
+	int			prefetched;			// decoded on a job thread by R_PrefetchImages()
+	double		pixels;
+	int			msec;				// for prefetched images, the time spent on the job threads
+} imageLoadStats_t;
+
+static imageLoadStats_t	r_imageLoadStats[IMAGE_LOAD_NUM_FORMATS];
+static const char *		r_imageLoadFormatNames[IMAGE_LOAD_NUM_FORMATS] = { "tga", "jpg", "png", "bmp", "pcx", "dds", "cache" };
+
+/*
+=================
+R_CountImageLoad
+=================
+*/
+void R_CountImageLoad( imageLoadFormat_t format, int pixels, int msec, bool prefetched ) {
+	imageLoadStats_t &stats = r_imageLoadStats[format];
+	stats.count++;
+	if ( prefetched ) {
+		stats.prefetched++;
 	}
+	stats.pixels += pixels;
+	stats.msec += msec;
+}
 
-	// *pic must be allocated with R_StaticAlloc(), but stb_image allocates with malloc()
-	// (and as there is no R_StaticRealloc(), #define STBI_MALLOC etc won't help)
-	// so the decoded data must be copied once
-	int size = w*h*4;
-	*pic = (byte *)R_StaticAlloc( size );
-	memcpy( *pic, decodedImageData, size );
-	*width = w;
-	*height = h;
-	// now that decodedImageData has been copied into *pic, it's not needed anymore
-	stbi_image_free( decodedImageData );
+/*
+=================
+R_ClearImageLoadStats
+=================
+*/
+void R_ClearImageLoadStats( void ) {
+	memset( r_imageLoadStats, 0, sizeof( r_imageLoadStats ) );
+}
+
+/*
+=================
+R_PrintImageLoadStats
+=================
+*/
+void R_PrintImageLoadStats( void ) {
+	common->Printf( "format images prefetched Mpixels  msec\n" );
+	for ( int i = 0 ; i < IMAGE_LOAD_NUM_FORMATS ; i++ ) {
+		const imageLoadStats_t &stats = r_imageLoadStats[i];
+		if ( !stats.count ) {
+			continue;
+		}
+		common->Printf( "%6s %6i %10i %7.1f %5i\n", r_imageLoadFormatNames[i], stats.count, stats.prefetched, stats.pixels / ( 1024.0 * 1024.0 ), stats.msec );
+	}
+}
+
+/*
+=========================================================
+
+PREFETCHING
+
+R_PrefetchImages() reads the source files of a batch of images on the
+calling thread, because the file system isn't thread safe, and decodes
+them on the job threads. R_LoadImage() then returns the decoded pixels
+instead of loading the file again.
+
+=========================================================
+*/
+
+// don't keep more than this many decoded pixels around
+#define MAX_PREFETCH_PIXELS		( 32 * 1024 * 1024 )
+
+typedef struct {
+	idStr				name;			// as looked up by R_LoadImage()
+	imageLoadFormat_t	format;
+	byte *				buffer;			// file contents, freed after decoding
+	int					fileSize;
+	ID_TIME_T			timestamp;
+	TargaHeader			targaHeader;
+	const byte *		targaPixels;
+	byte *				pic;
+	int					width;
+	int					height;
+	bool				decoded;
+	int					msec;
+} prefetchedImage_t;
+
+static idList<prefetchedImage_t>	r_prefetchedImages;
+
+// while set, R_LoadImage() only adds the names of the files to the list
+static idStrList *					r_collectImageNames;
+
+/*
+=================
+R_DecodePrefetchedImage
+=================
+*/
+static void R_DecodePrefetchedImage( void *data, int jobNum ) {
+	prefetchedImage_t *image = (prefetchedImage_t *)data + jobNum;
+	int start = Sys_Milliseconds();
+
+	if ( image->format == IMAGE_LOAD_TGA ) {
+		R_DecodeTGA( image->targaHeader, image->targaPixels, image->buffer + image->fileSize, image->pic );
+		image->decoded = true;
+	} else {
+		image->decoded = R_DecodeSTB( image->buffer, image->fileSize, image->pic, image->width, image->height );
+	}
+
+	image->msec = Sys_Milliseconds() - start;
+}
+
+/*
+=================
+R_PurgePrefetchedImages
+
+Frees the prefetched images that haven't been used
+=================
+*/
+void R_PurgePrefetchedImages( void ) {
+	for ( int i = 0 ; i < r_prefetchedImages.Num() ; i++ ) {
+		if ( r_prefetchedImages[i].pic ) {
+			R_StaticFree( r_prefetchedImages[i].pic );
+		}
+	}
+	r_prefetchedImages.Clear();
+}
+
+/*
+=================
+R_PrefetchImages
+=================
+*/
+void R_PrefetchImages( idImage * const *images, int numImages ) {
+	R_PurgePrefetchedImages();
+
+	// find the files the image programs will load, skipping the images
+	// that will come from a precompressed file or the packed image cache
+	idStrList names;
+	r_collectImageNames = &names;
+	for ( int i = 0 ; i < numImages ; i++ ) {
+		const idImage *image = images[i];
+		if ( image->generatorFunction || image->cubeFiles != CF_2D ) {
+			continue;
+		}
+		if ( globalImages->FindCachedImage( image ) != -1 ) {
+			continue;
+		}
+		if ( globalImages->image_usePrecompressedTextures.GetBool() && glConfig.textureCompressionAvailable ) {
+			char filename[MAX_IMAGE_NAME];
+			image->ImageProgramStringToCompressedFileName( image->imgName, filename );
+			if ( fileSystem->ReadFile( filename, NULL, NULL ) > 0 ) {
+				continue;
+			}
+		}
+		ID_TIME_T timestamp;
+		R_LoadImageProgram( image->imgName, NULL, NULL, NULL, &timestamp );
+	}
+	r_collectImageNames = NULL;
+
+	int totalPixels = 0;
+	for ( int i = 0 ; i < names.Num() && totalPixels < MAX_PREFETCH_PIXELS ; i++ ) {
+		prefetchedImage_t image;
+		idStr fileName = names[i];
+		idStr ext;
+
+		image.buffer = NULL;
+		image.fileSize = 0;
+		image.pic = NULL;
+		image.decoded = false;
+		image.msec = 0;
+
+		// same fallback from .tga to .jpg as R_LoadImage()
+		fileName.ExtractFileExtension( ext );
+		if ( ext == "tga" ) {
+			image.fileSize = fileSystem->ReadFile( fileName, (void **)&image.buffer, &image.timestamp );
+			if ( !image.buffer ) {
+				fileName.SetFileExtension( "jpg" );
+				ext = "jpg";
+			}
+		}
+		if ( ext == "jpg" || ext == "png" ) {
+			image.fileSize = fileSystem->ReadFile( fileName, (void **)&image.buffer, &image.timestamp );
+		}
+		if ( !image.buffer ) {
+			continue;
+		}
+
+		if ( ext == "tga" ) {
+			image.format = IMAGE_LOAD_TGA;
+			image.targaPixels = R_ParseTGAHeader( fileName, image.buffer, image.fileSize, image.targaHeader );
+			image.width = image.targaHeader.width;
+			image.height = image.targaHeader.height;
+		} else {
+			int comp;
+			image.format = ( ext == "png" ) ? IMAGE_LOAD_PNG : IMAGE_LOAD_JPG;
+			if ( !stbi_info_from_memory( image.buffer, image.fileSize, &image.width, &image.height, &comp ) ) {
+				// let R_LoadImage() report it
+				fileSystem->FreeFile( image.buffer );
+				continue;
+			}
+		}
+
+		if ( image.width < 1 || image.height < 1 ) {
+			fileSystem->FreeFile( image.buffer );
+			continue;
+		}
+
+		image.name = names[i];
+		image.pic = (byte *)R_StaticAlloc( image.width * image.height * 4 );
+		totalPixels += image.width * image.height;
+		r_prefetchedImages.Append( image );
+	}
+
+	if ( r_prefetchedImages.Num() ) {
+		Sys_RunJobs( R_DecodePrefetchedImage, r_prefetchedImages.Ptr(), r_prefetchedImages.Num() );
+	}
+
+	for ( int i = 0 ; i < r_prefetchedImages.Num() ; i++ ) {
+		prefetchedImage_t &image = r_prefetchedImages[i];
+		fileSystem->FreeFile( image.buffer );
+		image.buffer = NULL;
+		if ( !image.decoded ) {
+			R_StaticFree( image.pic );
+			image.pic = NULL;
+		}
+	}
+}
+
+/*
+=================
+R_GetPrefetchedImage
+=================
+*/
+static bool R_GetPrefetchedImage( const idStr &name, byte **pic, int *width, int *height, ID_TIME_T *timestamp ) {
+	for ( int i = 0 ; i < r_prefetchedImages.Num() ; i++ ) {
+		prefetchedImage_t &image = r_prefetchedImages[i];
+		if ( !image.pic || image.name != name ) {
+			continue;
+		}
+		*pic = image.pic;
+		if ( width ) {
+			*width = image.width;
+		}
+		if ( height ) {
+			*height = image.height;
+		}
+		if ( timestamp ) {
+			*timestamp = image.timestamp;
+		}
+		image.pic = NULL;
+		R_CountImageLoad( image.format, image.width * image.height, image.msec, true );
+		return true;
+	}
+	return false;
 }
 
 //===================================================================
@@ -857,19 +1147,47 @@ void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIM
 	idStr ext;
 	name.ExtractFileExtension( ext );
 
-	if ( ext == "tga" ) {
+	if ( r_collectImageNames ) {
+		// R_PrefetchImages() only wants the names, pretend the file exists
+		// so image programs continue with their other images
+		r_collectImageNames->AddUnique( name );
+		if ( timestamp ) {
+			*timestamp = 0;
+		}
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+	imageLoadFormat_t format = IMAGE_LOAD_TGA;
+	bool prefetched = false;
+
+	if ( pic && R_GetPrefetchedImage( name, pic, width, height, timestamp ) ) {
+		// already decoded on a job thread
+		prefetched = true;
+	} else if ( ext == "tga" ) {
 		LoadTGA( name.c_str(), pic, width, height, timestamp );            // try tga first
 		if ( ( pic && *pic == 0 ) || ( timestamp && *timestamp == FILE_NOT_FOUND_TIMESTAMP ) ) {
 			name.StripFileExtension();
 			name.DefaultFileExtension( ".jpg" );
-			LoadJPG( name.c_str(), pic, width, height, timestamp );
+			LoadSTB( name.c_str(), pic, width, height, timestamp );
+			format = IMAGE_LOAD_JPG;
 		}
 	} else if ( ext == "pcx" ) {
 		LoadPCX32( name.c_str(), pic, width, height, timestamp );
+		format = IMAGE_LOAD_PCX;
 	} else if ( ext == "bmp" ) {
 		LoadBMP( name.c_str(), pic, width, height, timestamp );
+		format = IMAGE_LOAD_BMP;
 	} else if ( ext == "jpg" ) {
-		LoadJPG( name.c_str(), pic, width, height, timestamp );
+		LoadSTB( name.c_str(), pic, width, height, timestamp );
+		format = IMAGE_LOAD_JPG;
+	} else if ( ext == "png" ) {
+		LoadSTB( name.c_str(), pic, width, height, timestamp );
+		format = IMAGE_LOAD_PNG;
+	}
+
+	if ( !prefetched && pic && *pic && width && height ) {
+		R_CountImageLoad( format, *width * *height, Sys_Milliseconds() - start, false );
 	}
 
 	if ( ( width && *width < 1 ) || ( height && *height < 1 ) ) {
@@ -63,9 +63,12 @@ idCVar idImageManager::image_writeNormalTGAPalletized( "image_writeNormalTGAPall
 idCVar idImageManager::image_writeTGA( "image_writeTGA", "0", CVAR_RENDERER | CVAR_BOOL, "write .tgas of the non normal maps for debugging" );
 idCVar idImageManager::image_useOffLineCompression( "image_useOfflineCompression", "0", CVAR_RENDERER | CVAR_BOOL, "write a batch file for offline compression of DDS files" );
 idCVar idImageManager::image_cacheMinK( "image_cacheMinK", "200", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "maximum KB of precompressed files to read at specification time" );
-idCVar idImageManager::image_cacheMegs( "image_cacheMegs", "20", CVAR_RENDERER | CVAR_ARCHIVE, "maximum MB set aside for temporary loading of full-sized precompressed images" );
-idCVar idImageManager::image_useCache( "image_useCache", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "1 = do background load image caching" );
-idCVar idImageManager::image_showBackgroundLoads( "image_showBackgroundLoads", "0", CVAR_RENDERER | CVAR_BOOL, "1 = print number of outstanding background loads" );
+idCVar idImageManager::image_cacheMegs( "image_cacheMegs", "256", CVAR_RENDERER | CVAR_ARCHIVE, "maximum MB of full-sized streamed images kept resident" );
+idCVar idImageManager::image_useCache( "image_useCache", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "1 = stream images: load shrunken versions at level load and the full-sized images when they're used" );
+idCVar idImageManager::image_streamPartialSize( "image_streamPartialSize", "64", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "maximum width and height of the shrunken versions of streamed images", 1, 4096 );
+idCVar idImageManager::image_streamMsec( "image_streamMsec", "4", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "milliseconds per frame spent loading streamed images from the packed image cache, at least one is loaded per frame", 0, 100 );
+idCVar idImageManager::image_usePackedCache( "image_usePackedCache", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "use the up to date images in the packed image cache written by makeImageCache" );
+idCVar idImageManager::image_showBackgroundLoads( "image_showBackgroundLoads", "0", CVAR_RENDERER | CVAR_BOOL, "1 = print streamed image loads and purges, and the pending and resident totals when they change" );
 idCVar idImageManager::image_downSizeSpecular( "image_downSizeSpecular", "0", CVAR_RENDERER | CVAR_ARCHIVE, "controls specular downsampling" );
 idCVar idImageManager::image_downSizeBump( "image_downSizeBump", "0", CVAR_RENDERER | CVAR_ARCHIVE, "controls normal map downsampling" );
 idCVar idImageManager::image_downSizeSpecularLimit( "image_downSizeSpecularLimit", "64", CVAR_RENDERER | CVAR_ARCHIVE, "controls specular downsampled limit" );
@@ -1628,9 +1631,6 @@ idImage	*idImageManager::ImageFromFile( const char *_name, textureFilter_t filte
 		image->partialImage->imgName = image->imgName;
 		image->partialImage->isPartialImage = true;
 
-		// let the background file loader know that we can load
-		image->precompressedFile = true;
-
 		if ( image_preload.GetBool() && !insideLevelLoad ) {
 			image->partialImage->ActuallyLoadImage( true, false );	// check for precompressed, load is from front end
 			declManager->MediaPrint( "%ix%i %s\n", image->partialImage->uploadWidth, image->partialImage->uploadHeight, image->imgName.c_str() );
@@ -1802,24 +1802,36 @@ void R_CombineCubeImages_f( const idCmdArgs &args ) {
 /*
 ==================
 idImage::StartBackgroundImageLoad
+
+Precompressed files are read by the file system's background thread,
+images from the packed image cache are queued to be loaded a few per frame
+by CompleteBackgroundImageLoads(). Sources without precompressed mips are
+never streamed, the partial image already is the complete one.
 ==================
 */
 void idImage::StartBackgroundImageLoad() {
-	if ( imageManager.numActiveBackgroundImageLoads >= idImageManager::MAX_BACKGROUND_IMAGE_LOADS ) {
+	// the shrunken version already is the complete image
+	if ( partialImage->partialIsComplete ) {
 		return;
 	}
-	if ( globalImages->image_showBackgroundLoads.GetBool() ) {
-		common->Printf( "idImage::StartBackgroundImageLoad: %s\n", imgName.c_str() );
-	}
-	backgroundLoadInProgress = true;
 
-	if ( !precompressedFile ) {
-		common->Warning( "idImageManager::StartBackgroundImageLoad: %s wasn't a precompressed file", imgName.c_str() );
+	if ( !partialImage->precompressedFile || globalImages->FindCachedImage( this ) != -1 ) {
+		if ( globalImages->image_showBackgroundLoads.GetBool() ) {
+			common->Printf( "idImage::StartBackgroundImageLoad: queued %s\n", imgName.c_str() );
+		}
+		backgroundLoadInProgress = true;
+		globalImages->streamQueue.Append( this );
 		return;
 	}
 
-	bglNext = globalImages->backgroundImageLoads;
-	globalImages->backgroundImageLoads = this;
+	if ( globalImages->numActiveBackgroundImageLoads >= idImageManager::MAX_BACKGROUND_IMAGE_LOADS ) {
+		return;
+	}
+	if ( globalImages->image_showBackgroundLoads.GetBool() ) {
+		common->Printf( "idImage::StartBackgroundImageLoad: %s\n", imgName.c_str() );
+	}
+	// also set on failure, so we don't try again every frame
+	backgroundLoadInProgress = true;
 
 	char	filename[MAX_IMAGE_NAME];
 	ImageProgramStringToCompressedFileName( imgName, filename );
@@ -1832,35 +1844,75 @@ void idImage::StartBackgroundImageLoad() {
 	}
 	bgl.file.position = 0;
 	bgl.file.length = bgl.f->Length();
-	if ( bgl.file.length < sizeof( ddsFileHeader_t ) ) {
+	if ( bgl.file.length < (int)sizeof( ddsFileHeader_t ) ) {
 		common->Warning( "idImageManager::StartBackgroundImageLoad: %s had a bad file length", imgName.c_str() );
+		fileSystem->CloseFile( bgl.f );
+		bgl.f = NULL;
 		return;
 	}
 
+	// make room for it, the file size is close enough to what the texture will need
+	globalImages->PurgeStreamedImages( bgl.file.length );
+
 	bgl.file.buffer = R_StaticAlloc( bgl.file.length );
 
+	bglNext = globalImages->backgroundImageLoads;
+	globalImages->backgroundImageLoads = this;
+
 	fileSystem->BackgroundDownload( &bgl );
 
-	imageManager.numActiveBackgroundImageLoads++;
+	globalImages->numActiveBackgroundImageLoads++;
+}
 
-	// purge some images if necessary
-	int		totalSize = 0;
-	for ( idImage *check = globalImages->cacheLRU.cacheUsageNext ; check != &globalImages->cacheLRU ; check = check->cacheUsageNext ) {
-		totalSize += check->StorageSize();
+/*
+==================
+idImageManager::StreamedImagesSize
+
+Returns the number of bytes used by the resident full-sized streamed images
+==================
+*/
+int idImageManager::StreamedImagesSize() const {
+	int totalSize = 0;
+	for ( idImage *check = cacheLRU.cacheUsageNext ; check != &cacheLRU ; check = check->cacheUsageNext ) {
+		if ( check->texnum != idImage::TEXTURE_NOT_LOADED ) {
+			totalSize += check->StorageSize();
+		}
 	}
-	int	needed = this->StorageSize();
+	return totalSize;
+}
+
+/*
+==================
+idImageManager::PurgeStreamedImages
+
+Purges the least recently used full-sized streamed images until there
+is room for needed more bytes in the image_cacheMegs budget. Images
+that were used in this or the previous frame are kept, so a view that
+needs more than the budget degrades to the shrunken versions instead
+of reloading images every frame.
+==================
+*/
+void idImageManager::PurgeStreamedImages( int needed ) {
+	int		budget = image_cacheMegs.GetFloat() * 1024 * 1024;
+	int		totalSize = StreamedImagesSize();
+	idImage	*prev;
+
+	for ( idImage *check = cacheLRU.cacheUsagePrev ; check != &cacheLRU && totalSize + needed > budget ; check = prev ) {
+		prev = check->cacheUsagePrev;
 
-	while ( ( totalSize + needed ) > globalImages->image_cacheMegs.GetFloat() * 1024 * 1024 ) {
-		// purge the least recently used
-		idImage	*check = globalImages->cacheLRU.cacheUsagePrev;
-		if ( check->texnum != TEXTURE_NOT_LOADED ) {
+		if ( check->backgroundLoadInProgress || check->frameUsed >= backEnd.frameCount - 1 ) {
+			continue;
+		}
+
+		if ( check->texnum != idImage::TEXTURE_NOT_LOADED ) {
 			totalSize -= check->StorageSize();
-			if ( globalImages->image_showBackgroundLoads.GetBool() ) {
+			if ( image_showBackgroundLoads.GetBool() ) {
 				common->Printf( "purging %s\n", check->imgName.c_str() );
 			}
 			check->PurgeImage();
 		}
-		// remove it from the cached list
+
+		// remove it from the cached list, the next Bind() will link it in again
 		check->cacheUsageNext->cacheUsagePrev = check->cacheUsagePrev;
 		check->cacheUsagePrev->cacheUsageNext = check->cacheUsageNext;
 		check->cacheUsageNext = NULL;
@@ -1868,6 +1920,9 @@ void idImage::StartBackgroundImageLoad() {
 	}
 }
 
+// number of queued images whose source files are decoded together by R_PrefetchImages()
+static const int STREAM_PREFETCH_BATCH = 4;
+
 /*
 ==================
 R_CompleteBackgroundImageLoads
@@ -1878,15 +1933,21 @@ Do we need to worry about vid_restarts here?
 void idImageManager::CompleteBackgroundImageLoads() {
 	idImage	*remainingList = NULL;
 	idImage	*next;
+	bool	loaded = false;
 
 	for ( idImage *image = backgroundImageLoads ; image ; image = next ) {
 		next = image->bglNext;
 		if ( image->bgl.completed ) {
 			numActiveBackgroundImageLoads--;
 			fileSystem->CloseFile( image->bgl.f );
+			image->bgl.f = NULL;
 			// upload the image
 			image->UploadPrecompressedImage( (byte *)image->bgl.file.buffer, image->bgl.file.length );
 			R_StaticFree( image->bgl.file.buffer );
+			image->bgl.file.buffer = NULL;
+			image->backgroundLoadInProgress = false;
+			image->bglNext = NULL;
+			loaded = true;
 			if ( image_showBackgroundLoads.GetBool() ) {
 				common->Printf( "R_CompleteBackgroundImageLoad: %s\n", image->imgName.c_str() );
 			}
@@ -1895,15 +1956,55 @@ void idImageManager::CompleteBackgroundImageLoads() {
 			remainingList = image;
 		}
 	}
-	if ( image_showBackgroundLoads.GetBool() ) {
-		static int prev;
-		if ( numActiveBackgroundImageLoads != prev ) {
-			prev = numActiveBackgroundImageLoads;
-			common->Printf( "background Loads: %i\n", numActiveBackgroundImageLoads );
+	backgroundImageLoads = remainingList;
+
+	// load the queued images a batch at a time, anything that still has to
+	// be decoded is only read here and decoded on the job threads, then
+	// uploaded here
+	int start = Sys_Milliseconds();
+	int queueLoads = 0;
+	while ( streamQueue.Num() > 0 ) {
+		if ( queueLoads > 0 && Sys_Milliseconds() - start >= image_streamMsec.GetInteger() ) {
+			break;
+		}
+		int num = Min( STREAM_PREFETCH_BATCH, streamQueue.Num() );
+		R_PrefetchImages( streamQueue.Ptr(), num );
+
+		for ( int i = 0 ; i < num ; i++ ) {
+			idImage *image = streamQueue[i];
+			image->backgroundLoadInProgress = false;
+			if ( image->texnum != idImage::TEXTURE_NOT_LOADED ) {
+				continue;
+			}
+			image->ActuallyLoadImage( true, true );
+			queueLoads++;
+			loaded = true;
+			if ( image_showBackgroundLoads.GetBool() ) {
+				common->Printf( "R_CompleteBackgroundImageLoad: %s\n", image->imgName.c_str() );
+			}
+		}
+		R_PurgePrefetchedImages();
+
+		for ( int i = 0 ; i < num ; i++ ) {
+			streamQueue.RemoveIndex( 0 );
 		}
 	}
 
-	backgroundImageLoads = remainingList;
+	if ( loaded ) {
+		PurgeStreamedImages( 0 );
+	}
+
+	if ( image_showBackgroundLoads.GetBool() ) {
+		static int prevPending = -1, prevResident = -1;
+		int pending = numActiveBackgroundImageLoads + streamQueue.Num();
+		int resident = StreamedImagesSize();
+		if ( pending != prevPending || resident != prevResident ) {
+			prevPending = pending;
+			prevResident = resident;
+			common->Printf( "background Loads: %i pending, %5.1f of %5.1f MB resident\n", pending,
+							resident / ( 1024 * 1024.0f ), image_cacheMegs.GetFloat() );
+		}
+	}
 }
 
 /*
@@ -2011,6 +2112,8 @@ void idImageManager::Init() {
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "testImageProcessing", R_TestImageProcessing_f, CMD_FL_RENDERER, "benchmarks mipmap generation and resampling on the given images", idCmdSystem::ArgCompletion_ImageName );
+	cmdSystem->AddCommand( "makeImageCache", R_MakeImageCache_f, CMD_FL_RENDERER, "writes the images of all materials, processed and compressed, to the packed image cache" );
 
 	// should forceLoadImages be here?
 }
@@ -2037,6 +2140,17 @@ loading the actual data.
 void idImageManager::BeginLevelLoad() {
 	insideLevelLoad = true;
 
+	// the queued streamed images may not be needed anymore
+	for ( int i = 0 ; i < streamQueue.Num() ; i++ ) {
+		streamQueue[i]->backgroundLoadInProgress = false;
+	}
+	streamQueue.Clear();
+
+	// pick up a rebuilt image cache
+	LoadImageCacheIndex();
+
+	R_ClearImageLoadStats();
+
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
 
@@ -2053,6 +2167,9 @@ void idImageManager::BeginLevelLoad() {
 	}
 }
 
+// number of images whose source files are decoded together by R_PrefetchImages()
+static const int IMAGE_PREFETCH_BATCH = 32;
+
 /*
 ====================
 EndLevelLoad
@@ -2099,6 +2216,7 @@ void idImageManager::EndLevelLoad() {
 	}
 
 	// load the ones we do need, if we are preloading
+	idList<idImage *> needed;
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
 		if ( image->generatorFunction ) {
@@ -2106,21 +2224,34 @@ void idImageManager::EndLevelLoad() {
 		}
 
 		if ( image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage ) {
-//			common->Printf( "Loading %s\n", image->imgName.c_str() );
+			needed.Append( image );
+		}
+	}
+
+	// the source images of each batch are decoded on the job threads
+	// before they are turned into textures one by one
+	for ( int first = 0 ; first < needed.Num() ; first += IMAGE_PREFETCH_BATCH ) {
+		int num = Min( IMAGE_PREFETCH_BATCH, needed.Num() - first );
+		R_PrefetchImages( needed.Ptr() + first, num );
+
+		for ( int i = first ; i < first + num ; i++ ) {
+//			common->Printf( "Loading %s\n", needed[i]->imgName.c_str() );
 			loadCount++;
-			image->ActuallyLoadImage( true, false );
+			needed[i]->ActuallyLoadImage( true, false );
 
 			if ( ( loadCount & 15 ) == 0 ) {
 				session->PacifierUpdate();
 			}
 		}
 	}
+	R_PurgePrefetchedImages();
 
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i purged from previous\n", purgeCount );
 	common->Printf( "%5i kept from previous\n", keepCount );
 	common->Printf( "%5i new loaded\n", loadCount );
 	common->Printf( "all images loaded in %5.1f seconds\n", (end-start) * 0.001 );
+	R_PrintImageLoadStats();
 }
 
 /*
@@ -36,7 +36,7 @@ If you have questions concerning this license or the applicable additional terms
 PROBLEM: compressed textures may break the zero clamp rule!
 */
 
-static bool FormatIsDXT( int internalFormat ) {
+bool FormatIsDXT( int internalFormat ) {
 	if ( internalFormat < GL_COMPRESSED_RGB_S3TC_DXT1_EXT
 	|| internalFormat > GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ) {
 		return false;
@@ -1254,15 +1254,15 @@ void idImage::WritePrecompressedImage() {
 ================
 ShouldImageBePartialCached
 
-Returns true if there is a precompressed image, and it is large enough
-to be worth caching
+Returns true if the image should be streamed: only a shrunken version
+is loaded at level load time and the full sized image is loaded when it
+is first bound, subject to the image_cacheMegs budget.
+
+Images with a precompressed file are only streamed if the file is large
+enough to be worth it, images without one are always streamed.
 ================
 */
 bool idImage::ShouldImageBePartialCached() {
-	if ( !glConfig.textureCompressionAvailable ) {
-		return false;
-	}
-
 	if ( !globalImages->image_useCache.GetBool() ) {
 		return false;
 	}
@@ -1272,7 +1272,8 @@ bool idImage::ShouldImageBePartialCached() {
 		return false;
 	}
 
-	if ( globalImages->image_cacheMinK.GetInteger() <= 0 ) {
+	// cube maps are always loaded completely
+	if ( cubeFiles != CF_2D ) {
 		return false;
 	}
 
@@ -1281,22 +1282,19 @@ bool idImage::ShouldImageBePartialCached() {
 		return false;
 	}
 
+	if ( !glConfig.textureCompressionAvailable || !globalImages->image_usePrecompressedTextures.GetBool() ) {
+		return true;
+	}
+
 	char	filename[MAX_IMAGE_NAME];
 	ImageProgramStringToCompressedFileName( imgName, filename );
 
-	// get the file timestamp
-	fileSystem->ReadFile( filename, NULL, &timestamp );
-
-	if ( timestamp == FILE_NOT_FOUND_TIMESTAMP ) {
-		return false;
-	}
-
 	// open it and get the file size
 	idFile *f;
 
 	f = fileSystem->OpenFileRead( filename );
 	if ( !f ) {
-		return false;
+		return true;
 	}
 
 	int	len = f->Length();
@@ -1310,6 +1308,78 @@ bool idImage::ShouldImageBePartialCached() {
 	return true;
 }
 
+/*
+================
+R_ClampToStreamPartialSize
+
+Halves the size until it fits image_streamPartialSize, the same way
+the mip levels of a precompressed image shrink
+================
+*/
+static void R_ClampToStreamPartialSize( int &width, int &height ) {
+	int maxSize = Max( globalImages->image_streamPartialSize.GetInteger(), 1 );
+
+	while ( width > maxSize || height > maxSize ) {
+		width = Max( width >> 1, 1 );
+		height = Max( height >> 1, 1 );
+	}
+}
+
+/*
+================
+R_PartialPrecompressedSkip
+
+Returns the number of bytes of mip level data following the header of a
+precompressed image that are too large for the partial version, so they
+don't need to be read. The header is still in file byte order.
+================
+*/
+static int R_PartialPrecompressedSkip( const ddsFileHeader_t *header ) {
+	int flags = LittleInt( header->ddspf.dwFlags );
+	int blockBytes = 0;
+	int pixelBytes = 0;
+
+	if ( flags & DDSF_FOURCC ) {
+		switch ( LittleInt( header->ddspf.dwFourCC ) ) {
+		case DDS_MAKEFOURCC( 'D', 'X', 'T', '1' ):
+			blockBytes = 8;
+			break;
+		case DDS_MAKEFOURCC( 'D', 'X', 'T', '3' ):
+		case DDS_MAKEFOURCC( 'D', 'X', 'T', '5' ):
+		case DDS_MAKEFOURCC( 'R', 'X', 'G', 'B' ):
+			blockBytes = 16;
+			break;
+		default:
+			return 0;
+		}
+	} else {
+		pixelBytes = LittleInt( header->ddspf.dwRGBBitCount ) / 8;
+	}
+
+	int numMipmaps = 1;
+	if ( LittleInt( header->dwFlags ) & DDSF_MIPMAPCOUNT ) {
+		numMipmaps = LittleInt( header->dwMipMapCount );
+	}
+
+	int uw = LittleInt( header->dwWidth );
+	int uh = LittleInt( header->dwHeight );
+	int maxWidth = uw;
+	int maxHeight = uh;
+	R_ClampToStreamPartialSize( maxWidth, maxHeight );
+
+	int skip = 0;
+	for ( int i = 0 ; i < numMipmaps && ( uw > maxWidth || uh > maxHeight ) ; i++ ) {
+		if ( blockBytes ) {
+			skip += ( ( uw + 3 ) / 4 ) * ( ( uh + 3 ) / 4 ) * blockBytes;
+		} else {
+			skip += uw * uh * pixelBytes;
+		}
+		uw = Max( uw >> 1, 1 );
+		uh = Max( uh >> 1, 1 );
+	}
+	return skip;
+}
+
 /*
 ================
 CheckPrecompressedImage
@@ -1322,6 +1392,8 @@ bool idImage::CheckPrecompressedImage( bool fullLoad ) {
 		return false;
 	}
 
+	int start = Sys_Milliseconds();
+
 #if 1 // ( _D3XP had disabled ) - Allow grabbing of DDS's from original Doom pak files
 	// if we are doing a copyFiles, make sure the original images are referenced
 	if ( fileSystem->PerformingCopyFiles() ) {
@@ -1385,7 +1457,23 @@ bool idImage::CheckPrecompressedImage( bool fullLoad ) {
 
 	byte *data = (byte *)R_StaticAlloc( len );
 
-	f->Read( data, len );
+	if ( fullLoad ) {
+		f->Read( data, len );
+	} else {
+		// only read the mip levels that the partial image will use,
+		// UploadPrecompressedImage() never touches the skipped part of the buffer
+		int headerSize = sizeof( ddsFileHeader_t ) + 4;
+		f->Read( data, headerSize );
+		int skip = 0;
+		if ( LittleInt( *(unsigned int *)data ) == DDS_MAKEFOURCC('D', 'D', 'S', ' ') ) {
+			skip = R_PartialPrecompressedSkip( (ddsFileHeader_t *)(data + 4) );
+		}
+		if ( skip <= 0 || headerSize + skip >= len || f->Seek( skip, FS_SEEK_CUR ) != 0 ) {
+			skip = 0;
+			f->Seek( headerSize, FS_SEEK_SET );
+		}
+		f->Read( data + headerSize + skip, len - headerSize - skip );
+	}
 
 	fileSystem->CloseFile( f );
 
@@ -1411,6 +1499,8 @@ bool idImage::CheckPrecompressedImage( bool fullLoad ) {
 
 	R_StaticFree( data );
 
+	R_CountImageLoad( IMAGE_LOAD_DDS, uploadWidth * uploadHeight, Sys_Milliseconds() - start );
+
 	return true;
 }
 
@@ -1514,6 +1604,9 @@ void idImage::UploadPrecompressedImage( byte *data, int len ) {
 	// We may skip some mip maps if we are downsizing
 	int skipMip = 0;
 	GetDownsize( uploadWidth, uploadHeight );
+	if ( isPartialImage ) {
+		R_ClampToStreamPartialSize( uploadWidth, uploadHeight );
+	}
 
 	byte *imagedata = data + sizeof(ddsFileHeader_t) + 4;
 
@@ -1568,13 +1661,30 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 		return;
 	}
 
-	// if we are a partial image, we are only going to load from a compressed file
+	// if we are a partial image, only load the small mip levels of a precompressed
+	// file. Only sources with precompressed mips are streamed, anything else is
+	// loaded in full right away instead of being decoded again when it streams in.
 	if ( isPartialImage ) {
-		if ( CheckPrecompressedImage( false ) ) {
+		if ( globalImages->LoadCachedImage( this ) ) {
 			return;
 		}
-		// this is an error -- the partial image failed to load
-		MakeDefault();
+		if ( globalImages->image_usePrecompressedTextures.GetBool() && CheckPrecompressedImage( false ) ) {
+			return;
+		}
+
+		R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
+
+		if ( pic == NULL ) {
+			common->Warning( "Couldn't load image: %s", imgName.c_str() );
+			MakeDefault();
+			return;
+		}
+
+		partialIsComplete = true;
+
+		GenerateImage( pic, width, height, filter, allowDownSize, repeat, depth );
+		precompressedFile = false;
+		R_StaticFree( pic );
 		return;
 	}
 
@@ -1602,6 +1712,12 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 			}
 		}
 	} else {
+		// the packed image cache has the image program output with all
+		// mip levels, ready to upload
+		if ( checkForPrecompressed && globalImages->LoadCachedImage( this ) ) {
+			return;
+		}
+
 		// see if we have a pre-generated image file that is
 		// already image processed and compressed
 		if ( checkForPrecompressed && globalImages->image_usePrecompressedTextures.GetBool() ) {
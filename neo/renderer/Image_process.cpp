@@ -26,11 +26,128 @@ If you have questions concerning this license or the applicable additional terms
 ===========================================================================
 */
 
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "sys/platform.h"
 #include "renderer/tr_local.h"
 
 #include "renderer/Image.h"
 
+/*
+================
+R_RunImageJobs
+
+Splits numRows rows into jobs for Sys_RunJobs(), small images aren't worth
+the overhead and are processed on the calling thread.
+================
+*/
+#define IMAGE_JOB_MIN_PIXELS	( 128 * 128 )
+
+typedef enum {
+	IMAGE_PROCESS_GENERIC,		// plain C, calling thread only
+	IMAGE_PROCESS_SIMD,			// SIMD (if available), calling thread only
+	IMAGE_PROCESS_JOBS			// SIMD (if available), rows spread over the job threads
+} imageProcessMode_t;
+
+typedef struct imageJob_s {
+	void		(*processRows)( const struct imageJob_s *job, int firstRow, int numRows );
+	const byte *in;
+	int			inWidth;
+	int			inHeight;
+	byte *		out;
+	int			outWidth;
+	int			outHeight;
+	const unsigned int *p1;		// R_ResampleTexture column offsets
+	const unsigned int *p2;
+	bool		simd;
+	int			rowsPerJob;
+} imageJob_t;
+
+static void R_ImageJob( void *data, int jobNum ) {
+	const imageJob_t *job = (const imageJob_t *)data;
+	int firstRow = jobNum * job->rowsPerJob;
+	int numRows = Min( job->rowsPerJob, job->outHeight - firstRow );
+	job->processRows( job, firstRow, numRows );
+}
+
+static void R_RunImageJobs( imageJob_t &job, imageProcessMode_t mode ) {
+	job.simd = ( mode != IMAGE_PROCESS_GENERIC );
+
+	int numJobs = 1;
+	if ( mode == IMAGE_PROCESS_JOBS && job.outWidth * job.outHeight >= IMAGE_JOB_MIN_PIXELS ) {
+		// a few jobs per thread so uneven progress doesn't leave threads idle
+		numJobs = Min( job.outHeight, ( Sys_NumJobThreads() + 1 ) * 4 );
+	}
+	job.rowsPerJob = ( job.outHeight + numJobs - 1 ) / numJobs;
+	numJobs = ( job.outHeight + job.rowsPerJob - 1 ) / job.rowsPerJob;
+
+	if ( numJobs <= 1 ) {
+		job.processRows( &job, 0, job.outHeight );
+	} else {
+		Sys_RunJobs( R_ImageJob, &job, numJobs );
+	}
+}
+
+/*
+================
+R_ResampleTextureRows
+================
+*/
+static void R_ResampleTextureRows( const imageJob_t *job, int firstRow, int numRows ) {
+	const int inwidth = job->inWidth;
+	const int inheight = job->inHeight;
+	const int outwidth = job->outWidth;
+	const int outheight = job->outHeight;
+	const unsigned int *p1 = job->p1;
+	const unsigned int *p2 = job->p2;
+	const byte		*inrow, *inrow2;
+	const byte		*pix1, *pix2, *pix3, *pix4;
+	byte			*out_p;
+
+	out_p = job->out + firstRow * outwidth * 4;
+
+	for ( int i = firstRow ; i < firstRow + numRows ; i++, out_p += outwidth*4 ) {
+		inrow = job->in + 4 * inwidth * (int)( ( i + 0.25f ) * inheight / outheight );
+		inrow2 = job->in + 4 * inwidth * (int)( ( i + 0.75f ) * inheight / outheight );
+		int j = 0;
+#if defined(__GNUC__) && defined(__SSE2__)
+		if ( job->simd ) {
+			const __m128i zero = _mm_setzero_si128();
+			for ( ; j + 4 <= outwidth ; j += 4 ) {
+				// gather four texels from each of the four source points, sum in 16 bit
+				__m128i a = _mm_set_epi32( *(const int *)( inrow + p1[j+3] ), *(const int *)( inrow + p1[j+2] ),
+											*(const int *)( inrow + p1[j+1] ), *(const int *)( inrow + p1[j+0] ) );
+				__m128i b = _mm_set_epi32( *(const int *)( inrow + p2[j+3] ), *(const int *)( inrow + p2[j+2] ),
+											*(const int *)( inrow + p2[j+1] ), *(const int *)( inrow + p2[j+0] ) );
+				__m128i c = _mm_set_epi32( *(const int *)( inrow2 + p1[j+3] ), *(const int *)( inrow2 + p1[j+2] ),
+											*(const int *)( inrow2 + p1[j+1] ), *(const int *)( inrow2 + p1[j+0] ) );
+				__m128i d = _mm_set_epi32( *(const int *)( inrow2 + p2[j+3] ), *(const int *)( inrow2 + p2[j+2] ),
+											*(const int *)( inrow2 + p2[j+1] ), *(const int *)( inrow2 + p2[j+0] ) );
+				__m128i lo = _mm_add_epi16( _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) ),
+											_mm_add_epi16( _mm_unpacklo_epi8( c, zero ), _mm_unpacklo_epi8( d, zero ) ) );
+				__m128i hi = _mm_add_epi16( _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) ),
+											_mm_add_epi16( _mm_unpackhi_epi8( c, zero ), _mm_unpackhi_epi8( d, zero ) ) );
+				lo = _mm_srli_epi16( lo, 2 );
+				hi = _mm_srli_epi16( hi, 2 );
+				_mm_storeu_si128( (__m128i *)( out_p + j*4 ), _mm_packus_epi16( lo, hi ) );
+			}
+		}
+#endif
+		for ( ; j<outwidth ; j++) {
+			pix1 = inrow + p1[j];
+			pix2 = inrow + p2[j];
+			pix3 = inrow2 + p1[j];
+			pix4 = inrow2 + p2[j];
+			out_p[j*4+0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0])>>2;
+			out_p[j*4+1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1])>>2;
+			out_p[j*4+2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2])>>2;
+			out_p[j*4+3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3])>>2;
+		}
+	}
+}
+
 /*
 ================
 R_ResampleTexture
@@ -45,14 +162,12 @@ after resampling to the next lower power of two.
 ================
 */
 #define	MAX_DIMENSION	4096
-byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
-							int outwidth, int outheight ) {
-	int		i, j;
-	const byte	*inrow, *inrow2;
+static byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
+							int outwidth, int outheight, imageProcessMode_t mode ) {
+	int		i;
 	unsigned int	frac, fracstep;
 	unsigned int	p1[MAX_DIMENSION], p2[MAX_DIMENSION];
-	const byte		*pix1, *pix2, *pix3, *pix4;
-	byte		*out, *out_p;
+	imageJob_t		job;
 
 	if ( outwidth > MAX_DIMENSION ) {
 		outwidth = MAX_DIMENSION;
@@ -61,9 +176,6 @@ byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
 		outheight = MAX_DIMENSION;
 	}
 
-	out = (byte *)R_StaticAlloc( outwidth * outheight * 4 );
-	out_p = out;
-
 	fracstep = inwidth*0x10000/outwidth;
 
 	frac = fracstep>>2;
@@ -77,23 +189,24 @@ byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
 		frac += fracstep;
 	}
 
-	for (i=0 ; i<outheight ; i++, out_p += outwidth*4 ) {
-		inrow = in + 4 * inwidth * (int)( ( i + 0.25f ) * inheight / outheight );
-		inrow2 = in + 4 * inwidth * (int)( ( i + 0.75f ) * inheight / outheight );
-		frac = fracstep >> 1;
-		for (j=0 ; j<outwidth ; j++) {
-			pix1 = inrow + p1[j];
-			pix2 = inrow + p2[j];
-			pix3 = inrow2 + p1[j];
-			pix4 = inrow2 + p2[j];
-			out_p[j*4+0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0])>>2;
-			out_p[j*4+1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1])>>2;
-			out_p[j*4+2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2])>>2;
-			out_p[j*4+3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3])>>2;
-		}
-	}
+	job.processRows = R_ResampleTextureRows;
+	job.in = in;
+	job.inWidth = inwidth;
+	job.inHeight = inheight;
+	job.out = (byte *)R_StaticAlloc( outwidth * outheight * 4 );
+	job.outWidth = outwidth;
+	job.outHeight = outheight;
+	job.p1 = p1;
+	job.p2 = p2;
 
-	return out;
+	R_RunImageJobs( job, mode );
+
+	return job.out;
+}
+
+byte *R_ResampleTexture( const byte *in, int inwidth, int inheight,
+							int outwidth, int outheight ) {
+	return R_ResampleTexture( in, inwidth, inheight, outwidth, outheight, IMAGE_PROCESS_JOBS );
 }
 
 /*
@@ -378,6 +491,58 @@ byte *R_MipMapWithAlphaSpecularity( const byte *in, int width, int height ) {
 	return out;
 }
 
+/*
+================
+R_MipMapRows
+
+Box filters rows of a mipmap, numRows output rows starting at firstRow.
+================
+*/
+static void R_MipMapRows( const imageJob_t *job, int firstRow, int numRows ) {
+	const int	width = job->outWidth;
+	const int	row = job->inWidth * 4;
+	// two input rows per output row, but mind that odd input widths skip the last texel
+	const int	inRowStep = width * 8 + row;
+	const byte	*in_p = job->in + firstRow * inRowStep;
+	byte		*out_p = job->out + firstRow * width * 4;
+
+	for ( int i = 0 ; i < numRows ; i++, in_p += row ) {
+		int j = 0;
+#if defined(__GNUC__) && defined(__SSE2__)
+		if ( job->simd ) {
+			// four output texels from 2x8 input texels per iteration, 16 bit sums truncate just like the C code
+			const __m128i zero = _mm_setzero_si128();
+			for ( ; j + 4 <= width ; j += 4, out_p += 16, in_p += 32 ) {
+				__m128i r0a = _mm_loadu_si128( (const __m128i *)( in_p ) );
+				__m128i r0b = _mm_loadu_si128( (const __m128i *)( in_p + 16 ) );
+				__m128i r1a = _mm_loadu_si128( (const __m128i *)( in_p + row ) );
+				__m128i r1b = _mm_loadu_si128( (const __m128i *)( in_p + row + 16 ) );
+
+				// vertical sums, texels 0 1 | 2 3 | 4 5 | 6 7
+				__m128i s01 = _mm_add_epi16( _mm_unpacklo_epi8( r0a, zero ), _mm_unpacklo_epi8( r1a, zero ) );
+				__m128i s23 = _mm_add_epi16( _mm_unpackhi_epi8( r0a, zero ), _mm_unpackhi_epi8( r1a, zero ) );
+				__m128i s45 = _mm_add_epi16( _mm_unpacklo_epi8( r0b, zero ), _mm_unpacklo_epi8( r1b, zero ) );
+				__m128i s67 = _mm_add_epi16( _mm_unpackhi_epi8( r0b, zero ), _mm_unpackhi_epi8( r1b, zero ) );
+
+				// horizontal sums of neighboring texels
+				__m128i lo = _mm_add_epi16( _mm_unpacklo_epi64( s01, s23 ), _mm_unpackhi_epi64( s01, s23 ) );
+				__m128i hi = _mm_add_epi16( _mm_unpacklo_epi64( s45, s67 ), _mm_unpackhi_epi64( s45, s67 ) );
+
+				lo = _mm_srli_epi16( lo, 2 );
+				hi = _mm_srli_epi16( hi, 2 );
+				_mm_storeu_si128( (__m128i *)out_p, _mm_packus_epi16( lo, hi ) );
+			}
+		}
+#endif
+		for ( ; j<width ; j++, out_p+=4, in_p+=8) {
+			out_p[0] = (in_p[0] + in_p[4] + in_p[row+0] + in_p[row+4])>>2;
+			out_p[1] = (in_p[1] + in_p[5] + in_p[row+1] + in_p[row+5])>>2;
+			out_p[2] = (in_p[2] + in_p[6] + in_p[row+2] + in_p[row+6])>>2;
+			out_p[3] = (in_p[3] + in_p[7] + in_p[row+3] + in_p[row+7])>>2;
+		}
+	}
+}
+
 /*
 ================
 R_MipMap
@@ -391,11 +556,10 @@ will result in a slight shrinking of the texture as it mips, but better than
 smeared clamps...
 ================
 */
-byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
-	int		i, j;
+static byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder, imageProcessMode_t mode ) {
+	int		i;
 	const byte	*in_p;
 	byte	*out, *out_p;
-	int		row;
 	byte	border[4];
 	int		newWidth, newHeight;
 
@@ -408,8 +572,6 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 	border[2] = in[2];
 	border[3] = in[3];
 
-	row = width * 4;
-
 	newWidth = width >> 1;
 	newHeight = height >> 1;
 	if ( !newWidth ) {
@@ -423,11 +585,8 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 
 	in_p = in;
 
-	width >>= 1;
-	height >>= 1;
-
-	if ( width == 0 || height == 0 ) {
-		width += height;	// get largest
+	if ( ( width >> 1 ) == 0 || ( height >> 1 ) == 0 ) {
+		width = ( width >> 1 ) + ( height >> 1 );	// get largest
 		if ( preserveBorder ) {
 			for (i=0 ; i<width ; i++, out_p+=4 ) {
 				out_p[0] = border[0];
@@ -446,23 +605,30 @@ byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
 		return out;
 	}
 
-	for (i=0 ; i<height ; i++, in_p+=row) {
-		for (j=0 ; j<width ; j++, out_p+=4, in_p+=8) {
-			out_p[0] = (in_p[0] + in_p[4] + in_p[row+0] + in_p[row+4])>>2;
-			out_p[1] = (in_p[1] + in_p[5] + in_p[row+1] + in_p[row+5])>>2;
-			out_p[2] = (in_p[2] + in_p[6] + in_p[row+2] + in_p[row+6])>>2;
-			out_p[3] = (in_p[3] + in_p[7] + in_p[row+3] + in_p[row+7])>>2;
-		}
-	}
+	imageJob_t job;
+	job.processRows = R_MipMapRows;
+	job.in = in;
+	job.inWidth = width;
+	job.inHeight = height;
+	job.out = out;
+	job.outWidth = newWidth;
+	job.outHeight = newHeight;
+	job.p1 = job.p2 = NULL;
+
+	R_RunImageJobs( job, mode );
 
 	// copy the old border texel back around if desired
 	if ( preserveBorder ) {
-		R_SetBorderTexels( out, width, height, border );
+		R_SetBorderTexels( out, newWidth, newHeight, border );
 	}
 
 	return out;
 }
 
+byte *R_MipMap( const byte *in, int width, int height, bool preserveBorder ) {
+	return R_MipMap( in, width, height, preserveBorder, IMAGE_PROCESS_JOBS );
+}
+
 /*
 ================
 R_MipMap3D
@@ -616,3 +782,126 @@ void R_RotatePic( byte *data, int width ) {
 
 	R_StaticFree( temp );
 }
+
+/*
+==================
+R_TestImageProcessing_f
+
+testImageProcessing <image> [image ...]
+
+Runs the mipmap and resample filters over the given images with the plain C code,
+with SIMD and with SIMD on the job threads, prints the timings and checks
+that all of them produce the same texels.
+==================
+*/
+void R_TestImageProcessing_f( const idCmdArgs &args ) {
+	static const int		NUM_RUNS = 10;
+	static const char *		modeNames[] = { "generic", "simd", "simd+jobs" };
+	int						totalMipMs[3] = { 0, 0, 0 };
+	int						totalResampleMs[3] = { 0, 0, 0 };
+
+	if ( args.Argc() < 2 ) {
+		common->Printf( "USAGE: testImageProcessing <image> [image ...]\n" );
+		return;
+	}
+
+	common->Printf( "%d job threads, %d runs per image\n", Sys_NumJobThreads(), NUM_RUNS );
+
+	for ( int arg = 1; arg < args.Argc(); arg++ ) {
+		byte	*pic;
+		int		width, height;
+
+		R_LoadImage( args.Argv( arg ), &pic, &width, &height, NULL, false );
+		if ( !pic ) {
+			common->Printf( "couldn't load %s\n", args.Argv( arg ) );
+			continue;
+		}
+		if ( width < 2 || height < 2 ) {
+			common->Printf( "%s is too small (%dx%d)\n", args.Argv( arg ), width, height );
+			R_StaticFree( pic );
+			continue;
+		}
+
+		// the generic results are the reference for the other modes
+		idList<byte *>	reference;
+		bool			mipsMatch = true;
+		bool			resampleMatch = true;
+		int				mipMs[3], resampleMs[3];
+
+		for ( int mode = IMAGE_PROCESS_GENERIC; mode <= IMAGE_PROCESS_JOBS; mode++ ) {
+			// build the whole mip chain
+			int start = Sys_Milliseconds();
+			for ( int run = 0; run < NUM_RUNS; run++ ) {
+				const byte *level = pic;
+				int w = width;
+				int h = height;
+				int levelNum = 0;
+				while ( w > 1 || h > 1 ) {
+					byte *mip = R_MipMap( level, w, h, false, (imageProcessMode_t)mode );
+					if ( level != pic ) {
+						R_StaticFree( (byte *)level );
+					}
+					w = Max( w >> 1, 1 );
+					h = Max( h >> 1, 1 );
+					if ( run == 0 ) {
+						if ( mode == IMAGE_PROCESS_GENERIC ) {
+							byte *copy = (byte *)R_StaticAlloc( w * h * 4 );
+							memcpy( copy, mip, w * h * 4 );
+							reference.Append( copy );
+						} else if ( memcmp( reference[levelNum], mip, w * h * 4 ) != 0 ) {
+							mipsMatch = false;
+						}
+					}
+					level = mip;
+					levelNum++;
+				}
+				if ( level != pic ) {
+					R_StaticFree( (byte *)level );
+				}
+			}
+			mipMs[mode] = Sys_Milliseconds() - start;
+
+			// resample to 3/4 of the size
+			const int rw = Max( width * 3 / 4, 1 );
+			const int rh = Max( height * 3 / 4, 1 );
+			start = Sys_Milliseconds();
+			for ( int run = 0; run < NUM_RUNS; run++ ) {
+				byte *resampled = R_ResampleTexture( pic, width, height, rw, rh, (imageProcessMode_t)mode );
+				if ( run == 0 ) {
+					if ( mode == IMAGE_PROCESS_GENERIC ) {
+						reference.Append( resampled );
+						resampled = NULL;
+					} else if ( memcmp( reference[reference.Num() - 1], resampled, rw * rh * 4 ) != 0 ) {
+						resampleMatch = false;
+					}
+				}
+				R_StaticFree( resampled );
+			}
+			resampleMs[mode] = Sys_Milliseconds() - start;
+
+			totalMipMs[mode] += mipMs[mode];
+			totalResampleMs[mode] += resampleMs[mode];
+		}
+
+		common->Printf( "%s (%dx%d):\n", args.Argv( arg ), width, height );
+		for ( int mode = IMAGE_PROCESS_GENERIC; mode <= IMAGE_PROCESS_JOBS; mode++ ) {
+			common->Printf( "  %-10s mipmaps %5d msec, resample %5d msec\n", modeNames[mode], mipMs[mode], resampleMs[mode] );
+		}
+		if ( !mipsMatch ) {
+			common->Warning( "%s: mipmaps differ from the generic code", args.Argv( arg ) );
+		}
+		if ( !resampleMatch ) {
+			common->Warning( "%s: resampled image differs from the generic code", args.Argv( arg ) );
+		}
+
+		for ( int i = 0; i < reference.Num(); i++ ) {
+			R_StaticFree( reference[i] );
+		}
+		R_StaticFree( pic );
+	}
+
+	common->Printf( "total:\n" );
+	for ( int mode = IMAGE_PROCESS_GENERIC; mode <= IMAGE_PROCESS_JOBS; mode++ ) {
+		common->Printf( "  %-10s mipmaps %5d msec, resample %5d msec\n", modeNames[mode], totalMipMs[mode], totalResampleMs[mode] );
+	}
+}
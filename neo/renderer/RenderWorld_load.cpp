@@ -111,6 +111,140 @@ void idRenderWorldLocal::TouchWorldModels( void ) {
 	}
 }
 
+/*
+================
+R_AreaBatchBoundsArea
+
+half the surface area of the bounds, expanded a bit so flat and thin surfaces count
+================
+*/
+static float R_AreaBatchBoundsArea( const idBounds &bounds ) {
+	idVec3 size = bounds[1] - bounds[0] + idVec3( 2.0f, 2.0f, 2.0f );
+	return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+/*
+================
+R_MergeAreaSurfaces
+
+dmap never merges surfaces across optimize groups, so an area frequently
+ends up with many small surfaces sharing a material, each of which costs a
+draw surface, an interaction and a draw call every frame.  Greedily batch
+same-material surfaces into larger triangle lists, but keep each batch
+within r_areaBatchSize units and AREA_BATCH_MAX_VERTS vertexes so light
+interactions can still reject batches by bounds and the per-vertex cull
+work of a light touching one corner of a batch stays bounded.
+
+Light interactions only see the bounds of the batch, so a surface is only
+added when the batch bounds stay close to the bounds of its surfaces: the
+surface area of the batch bounds may be at most AREA_BATCH_MAX_GROWTH times
+the summed surface areas of the surface bounds.  Surfaces that tile a wall
+or floor are batched, surfaces far apart or at an angle to each other are
+not, as a light in the empty space of their combined bounds would create
+interactions the separate surfaces don't have.
+================
+*/
+static const int AREA_BATCH_MAX_VERTS = 16384;
+static const float AREA_BATCH_MAX_GROWTH = 1.25f;
+
+static int	r_numAreaSurfacesParsed;
+static int	r_numAreaSurfacesBatched;
+
+static void R_MergeAreaSurfaces( idList<modelSurface_t> &surfaces ) {
+	idList<modelSurface_t>	merged;
+	idList<int>				batch;
+	idList<bool>			used;
+	int						i, j, k;
+
+	const float maxSize = r_areaBatchSize.GetFloat();
+
+	used.SetNum( surfaces.Num() );
+	for ( i = 0 ; i < surfaces.Num() ; i++ ) {
+		R_BoundTriSurf( surfaces[i].geometry );
+		used[i] = false;
+	}
+
+	for ( i = 0 ; i < surfaces.Num() ; i++ ) {
+		if ( used[i] ) {
+			continue;
+		}
+		used[i] = true;
+
+		modelSurface_t	&surf = surfaces[i];
+		if ( surf.shader->IsDiscrete() ) {
+			merged.Append( surf );
+			continue;
+		}
+
+		// gather every later surface with the same material that keeps the batch compact
+		idBounds	bounds = surf.geometry->bounds;
+		float		surfaceArea = R_AreaBatchBoundsArea( bounds );
+		int			numVerts = surf.geometry->numVerts;
+		int			numIndexes = surf.geometry->numIndexes;
+
+		batch.SetNum( 0, false );
+		batch.Append( i );
+		for ( j = i + 1 ; j < surfaces.Num() ; j++ ) {
+			if ( used[j] || surfaces[j].shader != surf.shader ) {
+				continue;
+			}
+			const srfTriangles_t *other = surfaces[j].geometry;
+			if ( numVerts + other->numVerts > AREA_BATCH_MAX_VERTS ) {
+				continue;
+			}
+			idBounds combined = bounds + other->bounds;
+			idVec3 size = combined[1] - combined[0];
+			if ( size[0] > maxSize || size[1] > maxSize || size[2] > maxSize ) {
+				continue;
+			}
+			// don't let lights see much more than the surfaces themselves
+			float otherArea = R_AreaBatchBoundsArea( other->bounds );
+			if ( R_AreaBatchBoundsArea( combined ) > AREA_BATCH_MAX_GROWTH * ( surfaceArea + otherArea ) ) {
+				continue;
+			}
+			bounds = combined;
+			surfaceArea += otherArea;
+			numVerts += other->numVerts;
+			numIndexes += other->numIndexes;
+			batch.Append( j );
+			used[j] = true;
+		}
+
+		if ( batch.Num() == 1 ) {
+			merged.Append( surf );
+			continue;
+		}
+
+		srfTriangles_t *tri = R_AllocStaticTriSurf();
+		R_AllocStaticTriSurfVerts( tri, numVerts );
+		R_AllocStaticTriSurfIndexes( tri, numIndexes );
+
+		for ( j = 0 ; j < batch.Num() ; j++ ) {
+			srfTriangles_t *src = surfaces[batch[j]].geometry;
+
+			for ( k = 0 ; k < src->numIndexes ; k++ ) {
+				tri->indexes[tri->numIndexes + k] = src->indexes[k] + tri->numVerts;
+			}
+			memcpy( tri->verts + tri->numVerts, src->verts, src->numVerts * sizeof( tri->verts[0] ) );
+			tri->numVerts += src->numVerts;
+			tri->numIndexes += src->numIndexes;
+
+			R_FreeStaticTriSurf( src );
+		}
+		tri->bounds = bounds;
+
+		modelSurface_t	batched;
+		batched.id = 0;
+		batched.shader = surf.shader;
+		batched.geometry = tri;
+		merged.Append( batched );
+
+		r_numAreaSurfacesBatched += batch.Num() - 1;
+	}
+
+	surfaces = merged;
+}
+
 /*
 ================
 idRenderWorldLocal::ParseModel
@@ -136,6 +270,10 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		src->Error( "R_ParseModel: bad numSurfaces" );
 	}
 
+	// world area surfaces are batched by material before being added to the model
+	const bool mergeSurfaces = r_mergeAreaSurfaces.GetBool() && model->IsStaticWorldModel();
+	idList<modelSurface_t> areaSurfaces;
+
 	for ( i = 0 ; i < numSurfaces ; i++ ) {
 		src->ExpectTokenString( "{" );
 
@@ -173,12 +311,25 @@ idRenderModel *idRenderWorldLocal::ParseModel( idLexer *src ) {
 		}
 		src->ExpectTokenString( "}" );
 
+		if ( mergeSurfaces ) {
+			areaSurfaces.Append( surf );
+			continue;
+		}
+
 		// add the completed surface to the model
 		model->AddSurface( surf );
 	}
 
 	src->ExpectTokenString( "}" );
 
+	if ( mergeSurfaces ) {
+		r_numAreaSurfacesParsed += areaSurfaces.Num();
+		R_MergeAreaSurfaces( areaSurfaces );
+		for ( i = 0 ; i < areaSurfaces.Num() ; i++ ) {
+			model->AddSurface( areaSurfaces[i] );
+		}
+	}
+
 	model->FinishSurfaces();
 
 	return model;
@@ -537,6 +688,9 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 		return false;
 	}
 
+	r_numAreaSurfacesParsed = 0;
+	r_numAreaSurfacesBatched = 0;
+
 	// parse the file
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
@@ -580,6 +734,11 @@ bool idRenderWorldLocal::InitFromMap( const char *name ) {
 
 	delete src;
 
+	if ( r_numAreaSurfacesBatched ) {
+		common->Printf( "%i area surfaces batched into %i\n", r_numAreaSurfacesParsed,
+			r_numAreaSurfacesParsed - r_numAreaSurfacesBatched );
+	}
+
 	// if it was a trivial map without any areas, create a single area
 	if ( !numPortalAreas ) {
 		ClearWorld();
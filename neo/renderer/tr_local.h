@@ -858,6 +858,8 @@ extern idCVar r_useLightScissors;		// 1 = use custom scissor rectangle for each
 extern idCVar r_useClippedLightScissors;// 0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always
 extern idCVar r_useEntityCulling;		// 0 = none, 1 = box
 extern idCVar r_useEntityScissors;		// 1 = use custom scissor rectangle for each entity
+extern idCVar r_mergeAreaSurfaces;		// batch same-material world area surfaces at map load
+extern idCVar r_areaBatchSize;			// maximum extent of a batched world area surface
 extern idCVar r_useInteractionCulling;	// 1 = cull interactions
 extern idCVar r_useInteractionScissors;	// 1 = use a custom scissor rectangle for each interaction
 extern idCVar r_useFrustumFarDistance;	// if != 0 force the view frustum far distance to this distance
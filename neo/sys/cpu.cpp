@@ -60,6 +60,13 @@ void Sys_FPU_SetDAZ(bool enable) {
 
 void Sys_FPU_SetFTZ(bool enable) {
 }
+
+int Sys_FPU_GetSSEModes(void) {
+	return 0;
+}
+
+void Sys_FPU_SetSSEModes(int modes) {
+}
 #else
 
 #if defined(__GNUC__)
@@ -188,6 +195,39 @@ Sys_FPU_SetFTZ
 void Sys_FPU_SetFTZ(bool enable) {
 	EnableMXCSRFlag(MXCSR_FTZ, enable, "Flush-To-Zero");
 }
+
+#define MXCSR_STATUS_FLAGS	0x3f
+
+/*
+================
+Sys_FPU_GetSSEModes
+
+  the control bits of the MXCSR register (rounding, exception masks, DAZ and FTZ)
+================
+*/
+int Sys_FPU_GetSSEModes(void) {
+	int sse_mode;
+
+	STREFLOP_STMXCSR(sse_mode);
+
+	return sse_mode & ~MXCSR_STATUS_FLAGS;
+}
+
+/*
+================
+Sys_FPU_SetSSEModes
+================
+*/
+void Sys_FPU_SetSSEModes(int modes) {
+	int sse_mode;
+
+	STREFLOP_STMXCSR(sse_mode);
+
+	if ((sse_mode & ~MXCSR_STATUS_FLAGS) != modes) {
+		sse_mode = (sse_mode & MXCSR_STATUS_FLAGS) | modes;
+		STREFLOP_LDMXCSR(sse_mode);
+	}
+}
 #endif
 
 /*
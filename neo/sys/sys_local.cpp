@@ -113,6 +113,18 @@ sysEvent_t idSysLocal::GenerateMouseMoveEvent( int deltax, int deltay ) {
 	return ev;
 }
 
+void idSysLocal::RunJobs( xjob_t function, void *data, int numJobs ) {
+	Sys_RunJobs( function, data, numJobs );
+}
+
+int idSysLocal::GetNumJobThreads( void ) {
+	return Sys_NumJobThreads();
+}
+
+int idSysLocal::GetJobThreadNum( void ) {
+	return Sys_JobThreadNum();
+}
+
 /*
 =================
 Sys_TimeStampToStr
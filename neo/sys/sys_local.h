@@ -64,6 +64,10 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit );
 	virtual void			StartProcess( const char *exeName, bool quit );
+
+	virtual void			RunJobs( xjob_t function, void *data, int numJobs );
+	virtual int				GetNumJobThreads( void );
+	virtual int				GetJobThreadNum( void );
 };
 
 #endif /* !__SYS_LOCAL__ */
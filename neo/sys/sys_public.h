@@ -175,6 +175,10 @@ void			Sys_FPU_SetFTZ( bool enable );
 // sets Denormals-Are-Zero mode
 void			Sys_FPU_SetDAZ( bool enable );
 
+// gets and sets the SSE floating point modes, so job threads can compute exactly like the main thread
+int				Sys_FPU_GetSSEModes( void );
+void			Sys_FPU_SetSSEModes( int modes );
+
 // returns amount of system ram
 int				Sys_GetSystemRam( void );
 
@@ -411,6 +415,16 @@ enum {
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+typedef void (*xjob_t)( void *data, int jobNum );
+
+// runs function( data, jobNum ) for jobNum = 0 .. numJobs-1 on the worker threads and the calling thread,
+// returns once all jobs are done. jobs may run in any order and must not depend on each other.
+void				Sys_RunJobs( xjob_t function, void *data, int numJobs );
+// number of worker threads available to Sys_RunJobs(), not counting the calling thread
+int					Sys_NumJobThreads( void );
+// 1 .. Sys_NumJobThreads() when called from a job thread, 0 on any other thread
+int					Sys_JobThreadNum( void );
+
 /*
 ==============================================================
 
@@ -442,6 +456,10 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit ) = 0;
 	virtual void			StartProcess( const char *exePath, bool quit ) = 0;
+
+	virtual void			RunJobs( xjob_t function, void *data, int numJobs ) = 0;
+	virtual int				GetNumJobThreads( void ) = 0;
+	virtual int				GetJobThreadNum( void ) = 0;
 };
 
 extern idSys *				sys;
@@ -30,9 +30,14 @@ If you have questions concerning this license or the applicable additional terms
 #include <SDL_mutex.h>
 #include <SDL_thread.h>
 #include <SDL_timer.h>
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+#include <SDL_cpuinfo.h>
+#endif
 
 #include "sys/platform.h"
+#include "idlib/math/Math.h"
 #include "framework/Common.h"
+#include "framework/CVarSystem.h"
 
 #include "sys/sys_public.h"
 
@@ -116,12 +121,16 @@ void Sys_InitThreads() {
 	thread_count = 0;
 }
 
+static void Sys_ShutdownJobThreads();
+
 /*
 ==================
 Sys_ShutdownThreads
 ==================
 */
 void Sys_ShutdownThreads() {
+	Sys_ShutdownJobThreads();
+
 	// threads
 	for (int i = 0; i < MAX_THREADS; i++) {
 		if (!thread[i])
@@ -347,3 +356,223 @@ bool Sys_IsMainThread() {
 	// any threads yet so it should be the main thread
 	return true;
 }
+
+/*
+======================================================
+worker threads for parallel jobs
+
+Sys_RunJobs() hands out job numbers to the worker threads one at a time,
+the calling thread helps out and only returns once all jobs are done.
+only one batch of jobs is in flight at any time: if another thread (or a job itself)
+calls Sys_RunJobs() while a batch is running, those jobs are run serially on the calling thread.
+the worker threads are started on first use, so sys_jobThreads is only read once.
+======================================================
+*/
+
+static idCVar sys_jobThreads( "sys_jobThreads", "-1", CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_INTEGER,
+	"number of worker threads for parallel jobs, -1 = number of CPU cores - 1, 0 = run jobs on the calling thread (needs restart)" );
+
+static xthreadInfo	jobThreads[MAX_JOB_THREADS] = { };
+static char			jobThreadNames[MAX_JOB_THREADS][16];
+static int			numJobThreads = -1;		// -1 = not started yet
+static SDL_mutex	*jobMutex = NULL;
+static SDL_cond		*jobStartCond = NULL;
+static SDL_cond		*jobDoneCond = NULL;
+
+// all of these are protected by jobMutex
+static xjob_t		jobFunction = NULL;
+static void			*jobData = NULL;
+static int			jobCount = 0;
+static int			jobNext = 0;
+static int			jobsDone = 0;
+static int			jobFPUModes = 0;		// SSE modes of the thread that started the batch
+static bool			jobsBusy = false;
+static bool			jobsQuit = false;
+
+// number of the job thread the code runs on, 0 for all other threads
+#ifdef _MSC_VER
+static __declspec( thread ) int	jobThreadNum = 0;
+#else
+static __thread int				jobThreadNum = 0;
+#endif
+
+/*
+==================
+Sys_JobThread
+==================
+*/
+static int Sys_JobThread( void *parms ) {
+	jobThreadNum = (int)(intptr_t)parms;
+
+	SDL_LockMutex( jobMutex );
+
+	while ( !jobsQuit ) {
+		if ( jobFunction == NULL || jobNext >= jobCount ) {
+			SDL_CondWait( jobStartCond, jobMutex );
+			continue;
+		}
+
+		int jobNum = jobNext++;
+		xjob_t function = jobFunction;
+		void *data = jobData;
+		int fpuModes = jobFPUModes;
+
+		SDL_UnlockMutex( jobMutex );
+		// compute exactly like the calling thread, e.g. with the same denormal handling
+		Sys_FPU_SetSSEModes( fpuModes );
+		function( data, jobNum );
+		SDL_LockMutex( jobMutex );
+
+		if ( ++jobsDone == jobCount ) {
+			SDL_CondSignal( jobDoneCond );
+		}
+	}
+
+	SDL_UnlockMutex( jobMutex );
+
+	return 0;
+}
+
+/*
+==================
+Sys_StartJobThreads
+==================
+*/
+static void Sys_StartJobThreads() {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_SYS );
+
+	if ( numJobThreads >= 0 ) {
+		// another thread was faster
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+		return;
+	}
+
+	int num = sys_jobThreads.GetInteger();
+	if ( num < 0 ) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		num = SDL_GetCPUCount() - 1;
+#else
+		num = 0; // SDL1.2 can't tell us the number of cores
+#endif
+	}
+	num = idMath::ClampInt( 0, MAX_JOB_THREADS, num );
+
+	if ( num > 0 ) {
+		jobMutex = SDL_CreateMutex();
+		jobStartCond = SDL_CreateCond();
+		jobDoneCond = SDL_CreateCond();
+
+		if ( !jobMutex || !jobStartCond || !jobDoneCond ) {
+			Sys_Printf( "ERROR: couldn't create mutex or condition for job threads, running jobs serially\n" );
+			num = 0;
+		}
+	}
+
+	for ( int i = 0; i < num; i++ ) {
+		idStr::snPrintf( jobThreadNames[i], sizeof( jobThreadNames[i] ), "job%d", i );
+		Sys_CreateThread( Sys_JobThread, (void *)(intptr_t)( i + 1 ), jobThreads[i], jobThreadNames[i] );
+	}
+
+	numJobThreads = num;
+	common->Printf( "Started %d job threads\n", num );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_SYS );
+}
+
+/*
+==================
+Sys_ShutdownJobThreads
+==================
+*/
+static void Sys_ShutdownJobThreads() {
+	if ( numJobThreads > 0 ) {
+		SDL_LockMutex( jobMutex );
+		jobsQuit = true;
+		SDL_CondBroadcast( jobStartCond );
+		SDL_UnlockMutex( jobMutex );
+
+		for ( int i = 0; i < numJobThreads; i++ ) {
+			Sys_DestroyThread( jobThreads[i] );
+		}
+	}
+
+	SDL_DestroyCond( jobStartCond );
+	SDL_DestroyCond( jobDoneCond );
+	SDL_DestroyMutex( jobMutex );
+	jobStartCond = NULL;
+	jobDoneCond = NULL;
+	jobMutex = NULL;
+
+	numJobThreads = -1;
+	jobsQuit = false;
+}
+
+/*
+==================
+Sys_NumJobThreads
+==================
+*/
+int Sys_NumJobThreads() {
+	if ( numJobThreads < 0 ) {
+		Sys_StartJobThreads();
+	}
+	return numJobThreads;
+}
+
+/*
+==================
+Sys_JobThreadNum
+==================
+*/
+int Sys_JobThreadNum() {
+	return jobThreadNum;
+}
+
+/*
+==================
+Sys_RunJobs
+==================
+*/
+void Sys_RunJobs( xjob_t function, void *data, int numJobs ) {
+	if ( numJobs > 1 && Sys_NumJobThreads() > 0 ) {
+		SDL_LockMutex( jobMutex );
+
+		if ( !jobsBusy ) {
+			jobsBusy = true;
+			jobFunction = function;
+			jobData = data;
+			jobCount = numJobs;
+			jobNext = 0;
+			jobsDone = 0;
+			jobFPUModes = Sys_FPU_GetSSEModes();
+			SDL_CondBroadcast( jobStartCond );
+
+			// help out until all jobs are taken
+			while ( jobNext < jobCount ) {
+				int jobNum = jobNext++;
+				SDL_UnlockMutex( jobMutex );
+				function( data, jobNum );
+				SDL_LockMutex( jobMutex );
+				jobsDone++;
+			}
+
+			// wait for the jobs still running on the workers
+			while ( jobsDone < jobCount ) {
+				SDL_CondWait( jobDoneCond, jobMutex );
+			}
+
+			jobFunction = NULL;
+			jobData = NULL;
+			jobsBusy = false;
+
+			SDL_UnlockMutex( jobMutex );
+			return;
+		}
+
+		SDL_UnlockMutex( jobMutex );
+	}
+
+	for ( int i = 0; i < numJobs; i++ ) {
+		function( data, i );
+	}
+}
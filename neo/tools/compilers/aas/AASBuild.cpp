@@ -779,6 +779,7 @@ bool idAASBuild::Build( const idStr &fileName, const idAASSettings *settings ) {
 	// write the file
 	name.SetFileExtension( aasSettings->fileExtension );
 	file->Write( name, mapFile->GetGeometryCRC() );
+	idAASFileLocal::WriteBinaryFromText( name, mapFile->GetGeometryCRC() );
 
 	// delete the map file
 	delete mapFile;
@@ -833,6 +834,7 @@ bool idAASBuild::BuildReachability( const idStr &fileName, const idAASSettings *
 
 	// write the file
 	file->Write( name, mapFile->GetGeometryCRC() );
+	idAASFileLocal::WriteBinaryFromText( name, mapFile->GetGeometryCRC() );
 
 	// delete the map file
 	delete mapFile;
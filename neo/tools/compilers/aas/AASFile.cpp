@@ -29,9 +29,13 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys/platform.h"
 #include "framework/FileSystem.h"
 #include "framework/DeclEntityDef.h"
+#include "framework/Game.h"
+#include "tools/compilers/compiler_public.h"
 
 #include "tools/compilers/aas/AASFile_local.h"
 
+idCVar aas_binaryCache( "aas_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "load AAS files from and write them to binary files next to the text AAS files" );
+
 /*
 ===============================================================================
 
@@ -494,6 +498,84 @@ bool idAASSettings::WriteToFile( idFile *fp ) const {
 	return true;
 }
 
+/*
+============
+idAASSettings::FromBinary
+============
+*/
+bool idAASSettings::FromBinary( idFile *fp ) {
+	int i, value;
+
+	numBoundingBoxes = 0;
+	fp->ReadInt( numBoundingBoxes );
+	if ( numBoundingBoxes <= 0 || numBoundingBoxes > MAX_AAS_BOUNDING_BOXES ) {
+		return false;
+	}
+	for ( i = 0; i < numBoundingBoxes; i++ ) {
+		fp->ReadVec3( boundingBoxes[i][0] );
+		fp->ReadVec3( boundingBoxes[i][1] );
+	}
+	fp->ReadInt( value );
+	usePatches = ( value != 0 );
+	fp->ReadInt( value );
+	writeBrushMap = ( value != 0 );
+	fp->ReadInt( value );
+	playerFlood = ( value != 0 );
+	fp->ReadInt( value );
+	allowSwimReachabilities = ( value != 0 );
+	fp->ReadInt( value );
+	allowFlyReachabilities = ( value != 0 );
+	fp->ReadString( fileExtension );
+	fp->ReadVec3( gravity );
+	gravityDir = gravity;
+	gravityValue = gravityDir.Normalize();
+	invGravityDir = -gravityDir;
+	fp->ReadFloat( maxStepHeight );
+	fp->ReadFloat( maxBarrierHeight );
+	fp->ReadFloat( maxWaterJumpHeight );
+	fp->ReadFloat( maxFallHeight );
+	fp->ReadFloat( minFloorCos );
+	fp->ReadInt( tt_barrierJump );
+	fp->ReadInt( tt_startCrouching );
+	fp->ReadInt( tt_waterJump );
+	fp->ReadInt( tt_startWalkOffLedge );
+	return true;
+}
+
+/*
+============
+idAASSettings::WriteToBinary
+
+  writes the same settings as WriteToFile
+============
+*/
+bool idAASSettings::WriteToBinary( idFile *fp ) const {
+	int i;
+
+	fp->WriteInt( numBoundingBoxes );
+	for ( i = 0; i < numBoundingBoxes; i++ ) {
+		fp->WriteVec3( boundingBoxes[i][0] );
+		fp->WriteVec3( boundingBoxes[i][1] );
+	}
+	fp->WriteInt( usePatches );
+	fp->WriteInt( writeBrushMap );
+	fp->WriteInt( playerFlood );
+	fp->WriteInt( allowSwimReachabilities );
+	fp->WriteInt( allowFlyReachabilities );
+	fp->WriteString( fileExtension );
+	fp->WriteVec3( gravity );
+	fp->WriteFloat( maxStepHeight );
+	fp->WriteFloat( maxBarrierHeight );
+	fp->WriteFloat( maxWaterJumpHeight );
+	fp->WriteFloat( maxFallHeight );
+	fp->WriteFloat( minFloorCos );
+	fp->WriteInt( tt_barrierJump );
+	fp->WriteInt( tt_startCrouching );
+	fp->WriteInt( tt_waterJump );
+	fp->WriteInt( tt_startWalkOffLedge );
+	return true;
+}
+
 /*
 ============
 idAASSettings::ValidForBounds
@@ -1098,9 +1180,40 @@ void idAASFileLocal::FinishAreas( void ) {
 /*
 ================
 idAASFileLocal::Load
+
+  loads the binary file next to the text file if it is up to date,
+  otherwise the text file is loaded and the binary file is written
 ================
 */
 bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
+
+	common->Printf( "[Load AAS]\n" );
+	common->Printf( "loading %s\n", fileName.c_str() );
+
+	if ( aas_binaryCache.GetBool() && LoadBinary( fileName, mapFileCRC ) ) {
+		common->Printf( "done.\n" );
+		return true;
+	}
+
+	if ( !LoadText( fileName, mapFileCRC ) ) {
+		return false;
+	}
+
+	if ( aas_binaryCache.GetBool() ) {
+		WriteBinary( fileName );
+	}
+
+	common->Printf( "done.\n" );
+
+	return true;
+}
+
+/*
+================
+idAASFileLocal::LoadText
+================
+*/
+bool idAASFileLocal::LoadText( const idStr &fileName, unsigned int mapFileCRC ) {
 	idLexer src( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGESCAPECHARS | LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWPATHNAMES );
 	idToken token;
 	int depth;
@@ -1109,9 +1222,6 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 	name = fileName;
 	crc = mapFileCRC;
 
-	common->Printf( "[Load AAS]\n" );
-	common->Printf( "loading %s\n", name.c_str() );
-
 	if ( !src.LoadFile( name ) ) {
 		return false;
 	}
@@ -1136,6 +1246,8 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 		common->Warning( "AAS file '%s' is out of date", name.c_str() );
 		return false;
 	}
+	// keep the CRC of the file, mapFileCRC is 0 when it isn't checked
+	crc = c;
 
 	// clear the file in memory
 	Clear();
@@ -1195,11 +1307,626 @@ bool idAASFileLocal::Load( const idStr &fileName, unsigned int mapFileCRC ) {
 		src.Error( "idAASFileLocal::Load: tree depth = %d", depth );
 	}
 
-	common->Printf( "done.\n" );
+	return true;
+}
+
+/*
+===============================================================================
+
+	Binary AAS file
+
+	The binary file stores the file exactly as the text loader leaves it in memory,
+	including the order of the reachabilities and the area bounds and centers, so it
+	is loaded with a single read and a few copies without any parsing.
 
+===============================================================================
+*/
+
+/*
+================
+AAS_BinaryHasData
+
+  returns true if count elements of the given size can still be read
+================
+*/
+static bool AAS_BinaryHasData( idFile *fp, int count, int size ) {
+	return ( count >= 0 && count <= ( fp->Length() - fp->Tell() ) / size );
+}
+
+/*
+================
+AAS_ReadBinaryArray
+
+  reads an array of elements that only consist of 32 bit values
+================
+*/
+template<class type>
+static bool AAS_ReadBinaryArray( idFile *fp, idList<type> &list ) {
+	int num;
+
+	num = -1;
+	fp->ReadInt( num );
+	if ( !AAS_BinaryHasData( fp, num, sizeof( type ) ) ) {
+		return false;
+	}
+	list.SetNum( num, false );
+	fp->Read( list.Ptr(), num * sizeof( type ) );
+	LittleRevBytes( list.Ptr(), 4, num * sizeof( type ) / 4 );
 	return true;
 }
 
+/*
+================
+AAS_WriteBinaryArray
+================
+*/
+template<class type>
+static void AAS_WriteBinaryArray( idFile *fp, const idList<type> &list ) {
+	int i;
+	const int *values = (const int *) list.Ptr();
+
+	fp->WriteInt( list.Num() );
+	for ( i = 0; i < list.Num() * (int)( sizeof( type ) / 4 ); i++ ) {
+		fp->WriteInt( values[i] );
+	}
+}
+
+/*
+================
+idAASFileLocal::WriteBinary
+================
+*/
+bool idAASFileLocal::WriteBinary( const idStr &fileName ) const {
+	int i, j, num;
+	idFile *fp;
+	idStr binaryFileName;
+	idReachability *reach;
+	const idReachability_Special *special;
+
+	binaryFileName = fileName + AAS_BINARY_FILE_SUFFIX;
+	fp = fileSystem->OpenFileWrite( binaryFileName, "fs_devpath" );
+	if ( !fp ) {
+		common->Warning( "idAASFileLocal::WriteBinary: Error opening file %s", binaryFileName.c_str() );
+		return false;
+	}
+
+	fp->WriteInt( AAS_BINARY_FILEID );
+	fp->WriteInt( AAS_BINARY_FILEVERSION );
+	fp->WriteUnsignedInt( crc );
+
+	settings.WriteToBinary( fp );
+
+	AAS_WriteBinaryArray( fp, planeList );
+	AAS_WriteBinaryArray( fp, vertices );
+	AAS_WriteBinaryArray( fp, edges );
+	AAS_WriteBinaryArray( fp, edgeIndex );
+
+	fp->WriteInt( faces.Num() );
+	for ( i = 0; i < faces.Num(); i++ ) {
+		fp->WriteUnsignedShort( faces[i].planeNum );
+		fp->WriteUnsignedShort( faces[i].flags );
+		fp->WriteInt( faces[i].numEdges );
+		fp->WriteInt( faces[i].firstEdge );
+		fp->WriteShort( faces[i].areas[0] );
+		fp->WriteShort( faces[i].areas[1] );
+	}
+
+	AAS_WriteBinaryArray( fp, faceIndex );
+
+	fp->WriteInt( areas.Num() );
+	for ( i = 0; i < areas.Num(); i++ ) {
+		fp->WriteInt( areas[i].numFaces );
+		fp->WriteInt( areas[i].firstFace );
+		fp->WriteVec3( areas[i].bounds[0] );
+		fp->WriteVec3( areas[i].bounds[1] );
+		fp->WriteVec3( areas[i].center );
+		fp->WriteUnsignedShort( areas[i].flags );
+		fp->WriteUnsignedShort( areas[i].contents );
+		fp->WriteShort( areas[i].cluster );
+		fp->WriteShort( areas[i].clusterAreaNum );
+
+		for ( num = 0, reach = areas[i].reach; reach; reach = reach->next ) {
+			num++;
+		}
+		fp->WriteInt( num );
+		for ( reach = areas[i].reach; reach; reach = reach->next ) {
+			fp->WriteInt( reach->travelType );
+			fp->WriteShort( reach->toAreaNum );
+			fp->WriteVec3( reach->start );
+			fp->WriteVec3( reach->end );
+			fp->WriteInt( reach->edgeNum );
+			fp->WriteUnsignedShort( reach->travelTime );
+			if ( reach->travelType == TFL_SPECIAL ) {
+				special = static_cast<const idReachability_Special *>( reach );
+				fp->WriteInt( special->dict.GetNumKeyVals() );
+				for ( j = 0; j < special->dict.GetNumKeyVals(); j++ ) {
+					fp->WriteString( special->dict.GetKeyVal( j )->GetKey() );
+					fp->WriteString( special->dict.GetKeyVal( j )->GetValue() );
+				}
+			}
+		}
+	}
+
+	fp->WriteInt( nodes.Num() );
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		fp->WriteUnsignedShort( nodes[i].planeNum );
+		fp->WriteInt( nodes[i].children[0] );
+		fp->WriteInt( nodes[i].children[1] );
+	}
+
+	fp->WriteInt( portals.Num() );
+	for ( i = 0; i < portals.Num(); i++ ) {
+		fp->WriteShort( portals[i].areaNum );
+		fp->WriteShort( portals[i].clusters[0] );
+		fp->WriteShort( portals[i].clusters[1] );
+		fp->WriteShort( portals[i].clusterAreaNum[0] );
+		fp->WriteShort( portals[i].clusterAreaNum[1] );
+	}
+
+	AAS_WriteBinaryArray( fp, portalIndex );
+	AAS_WriteBinaryArray( fp, clusters );
+
+	fileSystem->CloseFile( fp );
+
+	return true;
+}
+
+/*
+================
+idAASFileLocal::WriteBinaryFromText
+
+  the compiler keeps the reachabilities in a different order than the text
+  loader so the binary file is written from the text file that was just written
+================
+*/
+void idAASFileLocal::WriteBinaryFromText( const idStr &fileName, unsigned int mapFileCRC ) {
+	idAASFileLocal file;
+
+	if ( !aas_binaryCache.GetBool() ) {
+		return;
+	}
+	if ( file.LoadText( fileName, mapFileCRC ) ) {
+		file.WriteBinary( fileName );
+	}
+}
+
+/*
+================
+idAASFileLocal::ReadBinaryReachabilities
+
+  keeps the reachabilities in the order they were written
+================
+*/
+bool idAASFileLocal::ReadBinaryReachabilities( idFile *fp, int areaNum ) {
+	int i, j, num, numKeyVals;
+	aasArea_t *area;
+	idReachability reach, *newReach, *lastReach;
+	idReachability_Special *special;
+	idStr key, value;
+
+	area = &areas[areaNum];
+	area->reach = NULL;
+	area->rev_reach = NULL;
+	area->travelFlags = AreaContentsTravelFlags( areaNum );
+
+	num = -1;
+	fp->ReadInt( num );
+	if ( !AAS_BinaryHasData( fp, num, 36 ) ) {
+		return false;
+	}
+	lastReach = NULL;
+	for ( i = 0; i < num; i++ ) {
+		fp->ReadInt( reach.travelType );
+		fp->ReadShort( reach.toAreaNum );
+		fp->ReadVec3( reach.start );
+		fp->ReadVec3( reach.end );
+		fp->ReadInt( reach.edgeNum );
+		fp->ReadUnsignedShort( reach.travelTime );
+		if ( reach.toAreaNum < 0 || reach.toAreaNum >= areas.Num() ) {
+			return false;
+		}
+		switch( reach.travelType ) {
+			case TFL_SPECIAL:
+				newReach = special = new idReachability_Special();
+				numKeyVals = -1;
+				fp->ReadInt( numKeyVals );
+				if ( !AAS_BinaryHasData( fp, numKeyVals, 2 * sizeof( int ) ) ) {
+					delete special;
+					return false;
+				}
+				for ( j = 0; j < numKeyVals; j++ ) {
+					fp->ReadString( key );
+					fp->ReadString( value );
+					special->dict.Set( key, value );
+				}
+				break;
+			default:
+				newReach = new idReachability();
+				break;
+		}
+		newReach->CopyBase( reach );
+		newReach->fromAreaNum = areaNum;
+		newReach->next = NULL;
+		if ( lastReach ) {
+			lastReach->next = newReach;
+		} else {
+			area->reach = newReach;
+		}
+		lastReach = newReach;
+	}
+	return true;
+}
+
+/*
+================
+idAASFileLocal::LoadBinary
+================
+*/
+bool idAASFileLocal::LoadBinary( const idStr &fileName, unsigned int mapFileCRC ) {
+	int i, length, fileId, version, num, depth;
+	unsigned int c;
+	idStr binaryFileName;
+	ID_TIME_T timestamp, textTimestamp;
+	void *buffer;
+	bool ok;
+
+	binaryFileName = fileName + AAS_BINARY_FILE_SUFFIX;
+	length = fileSystem->ReadFile( binaryFileName, &buffer, &timestamp );
+	if ( length <= 0 ) {
+		return false;
+	}
+
+	// don't use the binary file if the text file was changed after it was written
+	if ( fileSystem->ReadFile( fileName, NULL, &textTimestamp ) > 0 && textTimestamp > timestamp ) {
+		common->Printf( "%s is older than %s\n", binaryFileName.c_str(), fileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	idFile_Memory fp( binaryFileName, (const char *)buffer, length );
+
+	fileId = version = 0;
+	fp.ReadInt( fileId );
+	fp.ReadInt( version );
+	if ( fileId != AAS_BINARY_FILEID || version != AAS_BINARY_FILEVERSION ) {
+		common->Printf( "%s has a different version\n", binaryFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	c = 0;
+	fp.ReadUnsignedInt( c );
+	if ( mapFileCRC && c != mapFileCRC ) {
+		common->Printf( "%s is out of date\n", binaryFileName.c_str() );
+		fileSystem->FreeFile( buffer );
+		return false;
+	}
+
+	name = fileName;
+	crc = c;
+
+	// clear the file in memory
+	DeleteReachabilities();
+	Clear();
+
+	ok = settings.FromBinary( &fp );
+	ok = ok && AAS_ReadBinaryArray( &fp, planeList );
+	ok = ok && AAS_ReadBinaryArray( &fp, vertices );
+	ok = ok && AAS_ReadBinaryArray( &fp, edges );
+	ok = ok && AAS_ReadBinaryArray( &fp, edgeIndex );
+
+	if ( ok ) {
+		num = -1;
+		fp.ReadInt( num );
+		ok = AAS_BinaryHasData( &fp, num, 16 );
+	}
+	if ( ok ) {
+		faces.SetNum( num, false );
+		for ( i = 0; i < num; i++ ) {
+			fp.ReadUnsignedShort( faces[i].planeNum );
+			fp.ReadUnsignedShort( faces[i].flags );
+			fp.ReadInt( faces[i].numEdges );
+			fp.ReadInt( faces[i].firstEdge );
+			fp.ReadShort( faces[i].areas[0] );
+			fp.ReadShort( faces[i].areas[1] );
+		}
+	}
+
+	ok = ok && AAS_ReadBinaryArray( &fp, faceIndex );
+
+	if ( ok ) {
+		num = -1;
+		fp.ReadInt( num );
+		ok = AAS_BinaryHasData( &fp, num, 56 );
+	}
+	if ( ok ) {
+		areas.SetNum( num, false );
+		memset( areas.Ptr(), 0, num * sizeof( aasArea_t ) );
+		for ( i = 0; i < num && ok; i++ ) {
+			fp.ReadInt( areas[i].numFaces );
+			fp.ReadInt( areas[i].firstFace );
+			fp.ReadVec3( areas[i].bounds[0] );
+			fp.ReadVec3( areas[i].bounds[1] );
+			fp.ReadVec3( areas[i].center );
+			fp.ReadUnsignedShort( areas[i].flags );
+			fp.ReadUnsignedShort( areas[i].contents );
+			fp.ReadShort( areas[i].cluster );
+			fp.ReadShort( areas[i].clusterAreaNum );
+			ok = ReadBinaryReachabilities( &fp, i );
+		}
+	}
+
+	if ( ok ) {
+		num = -1;
+		fp.ReadInt( num );
+		ok = AAS_BinaryHasData( &fp, num, 10 );
+	}
+	if ( ok ) {
+		nodes.SetNum( num, false );
+		for ( i = 0; i < num; i++ ) {
+			fp.ReadUnsignedShort( nodes[i].planeNum );
+			fp.ReadInt( nodes[i].children[0] );
+			fp.ReadInt( nodes[i].children[1] );
+		}
+	}
+
+	if ( ok ) {
+		num = -1;
+		fp.ReadInt( num );
+		ok = AAS_BinaryHasData( &fp, num, 10 );
+	}
+	if ( ok ) {
+		portals.SetNum( num, false );
+		for ( i = 0; i < num; i++ ) {
+			fp.ReadShort( portals[i].areaNum );
+			fp.ReadShort( portals[i].clusters[0] );
+			fp.ReadShort( portals[i].clusters[1] );
+			fp.ReadShort( portals[i].clusterAreaNum[0] );
+			fp.ReadShort( portals[i].clusterAreaNum[1] );
+			portals[i].maxAreaTravelTime = 0;
+		}
+	}
+
+	ok = ok && AAS_ReadBinaryArray( &fp, portalIndex );
+	ok = ok && AAS_ReadBinaryArray( &fp, clusters );
+
+	fileSystem->FreeFile( buffer );
+
+	if ( !ok ) {
+		common->Warning( "%s is corrupt", binaryFileName.c_str() );
+		DeleteReachabilities();
+		Clear();
+		return false;
+	}
+
+	LinkReversedReachability();
+
+	depth = MaxTreeDepth();
+	if ( depth > MAX_AAS_TREE_DEPTH ) {
+		common->Warning( "idAASFileLocal::LoadBinary: tree depth = %d", depth );
+		DeleteReachabilities();
+		Clear();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+================
+AAS_BinaryArraysEqual
+================
+*/
+template<class type>
+static bool AAS_BinaryArraysEqual( const idList<type> &list1, const idList<type> &list2 ) {
+	return ( list1.Num() == list2.Num() && memcmp( list1.Ptr(), list2.Ptr(), list1.Num() * sizeof( type ) ) == 0 );
+}
+
+/*
+================
+idAASFileLocal::Compare
+
+  returns true if both files are the same in memory, otherwise the first difference is printed
+================
+*/
+bool idAASFileLocal::Compare( const idAASFileLocal &other ) const {
+	int i, j;
+	const idReachability *r1, *r2;
+	const idAASSettings &s1 = settings, &s2 = other.settings;
+
+	if ( s1.numBoundingBoxes != s2.numBoundingBoxes || s1.usePatches != s2.usePatches || s1.writeBrushMap != s2.writeBrushMap ||
+			s1.playerFlood != s2.playerFlood || s1.allowSwimReachabilities != s2.allowSwimReachabilities ||
+			s1.allowFlyReachabilities != s2.allowFlyReachabilities || s1.fileExtension != s2.fileExtension ||
+			s1.gravity != s2.gravity || s1.maxStepHeight != s2.maxStepHeight || s1.maxBarrierHeight != s2.maxBarrierHeight ||
+			s1.maxWaterJumpHeight != s2.maxWaterJumpHeight || s1.maxFallHeight != s2.maxFallHeight || s1.minFloorCos != s2.minFloorCos ||
+			s1.tt_barrierJump != s2.tt_barrierJump || s1.tt_startCrouching != s2.tt_startCrouching ||
+			s1.tt_waterJump != s2.tt_waterJump || s1.tt_startWalkOffLedge != s2.tt_startWalkOffLedge ) {
+		common->Warning( "%s: settings differ", name.c_str() );
+		return false;
+	}
+	for ( i = 0; i < s1.numBoundingBoxes; i++ ) {
+		if ( s1.boundingBoxes[i] != s2.boundingBoxes[i] ) {
+			common->Warning( "%s: settings differ", name.c_str() );
+			return false;
+		}
+	}
+
+	if ( !AAS_BinaryArraysEqual( planeList, other.planeList ) ) {
+		common->Warning( "%s: planes differ", name.c_str() );
+		return false;
+	}
+	if ( !AAS_BinaryArraysEqual( vertices, other.vertices ) ) {
+		common->Warning( "%s: vertices differ", name.c_str() );
+		return false;
+	}
+	if ( !AAS_BinaryArraysEqual( edges, other.edges ) ) {
+		common->Warning( "%s: edges differ", name.c_str() );
+		return false;
+	}
+	if ( !AAS_BinaryArraysEqual( edgeIndex, other.edgeIndex ) || !AAS_BinaryArraysEqual( faceIndex, other.faceIndex ) ||
+			!AAS_BinaryArraysEqual( portalIndex, other.portalIndex ) ) {
+		common->Warning( "%s: indexes differ", name.c_str() );
+		return false;
+	}
+
+	if ( faces.Num() != other.faces.Num() ) {
+		common->Warning( "%s: faces differ", name.c_str() );
+		return false;
+	}
+	for ( i = 0; i < faces.Num(); i++ ) {
+		const aasFace_t &f1 = faces[i], &f2 = other.faces[i];
+		if ( f1.planeNum != f2.planeNum || f1.flags != f2.flags || f1.numEdges != f2.numEdges || f1.firstEdge != f2.firstEdge ||
+				f1.areas[0] != f2.areas[0] || f1.areas[1] != f2.areas[1] ) {
+			common->Warning( "%s: face %d differs", name.c_str(), i );
+			return false;
+		}
+	}
+
+	if ( areas.Num() != other.areas.Num() ) {
+		common->Warning( "%s: areas differ", name.c_str() );
+		return false;
+	}
+	for ( i = 0; i < areas.Num(); i++ ) {
+		const aasArea_t &a1 = areas[i], &a2 = other.areas[i];
+		if ( a1.numFaces != a2.numFaces || a1.firstFace != a2.firstFace || a1.bounds != a2.bounds || a1.center != a2.center ||
+				a1.flags != a2.flags || a1.contents != a2.contents || a1.cluster != a2.cluster || a1.clusterAreaNum != a2.clusterAreaNum ||
+				a1.travelFlags != a2.travelFlags ) {
+			common->Warning( "%s: area %d differs", name.c_str(), i );
+			return false;
+		}
+		for ( r1 = a1.reach, r2 = a2.reach; r1 && r2; r1 = r1->next, r2 = r2->next ) {
+			if ( r1->travelType != r2->travelType || r1->toAreaNum != r2->toAreaNum || r1->fromAreaNum != r2->fromAreaNum ||
+					r1->start != r2->start || r1->end != r2->end || r1->edgeNum != r2->edgeNum || r1->travelTime != r2->travelTime ) {
+				break;
+			}
+			if ( r1->travelType == TFL_SPECIAL ) {
+				const idDict &d1 = static_cast<const idReachability_Special *>( r1 )->dict;
+				const idDict &d2 = static_cast<const idReachability_Special *>( r2 )->dict;
+				if ( d1.GetNumKeyVals() != d2.GetNumKeyVals() ) {
+					break;
+				}
+				for ( j = 0; j < d1.GetNumKeyVals(); j++ ) {
+					if ( d1.GetKeyVal( j )->GetKey() != d2.GetKeyVal( j )->GetKey() || d1.GetKeyVal( j )->GetValue() != d2.GetKeyVal( j )->GetValue() ) {
+						break;
+					}
+				}
+				if ( j < d1.GetNumKeyVals() ) {
+					break;
+				}
+			}
+		}
+		if ( r1 || r2 ) {
+			common->Warning( "%s: reachabilities of area %d differ", name.c_str(), i );
+			return false;
+		}
+		for ( r1 = a1.rev_reach, r2 = a2.rev_reach; r1 && r2; r1 = r1->rev_next, r2 = r2->rev_next ) {
+			if ( r1->fromAreaNum != r2->fromAreaNum || r1->toAreaNum != r2->toAreaNum ) {
+				break;
+			}
+		}
+		if ( r1 || r2 ) {
+			common->Warning( "%s: reversed reachabilities of area %d differ", name.c_str(), i );
+			return false;
+		}
+	}
+
+	if ( nodes.Num() != other.nodes.Num() ) {
+		common->Warning( "%s: nodes differ", name.c_str() );
+		return false;
+	}
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		if ( nodes[i].planeNum != other.nodes[i].planeNum || nodes[i].children[0] != other.nodes[i].children[0] || nodes[i].children[1] != other.nodes[i].children[1] ) {
+			common->Warning( "%s: node %d differs", name.c_str(), i );
+			return false;
+		}
+	}
+
+	if ( portals.Num() != other.portals.Num() ) {
+		common->Warning( "%s: portals differ", name.c_str() );
+		return false;
+	}
+	for ( i = 0; i < portals.Num(); i++ ) {
+		const aasPortal_t &p1 = portals[i], &p2 = other.portals[i];
+		if ( p1.areaNum != p2.areaNum || p1.clusters[0] != p2.clusters[0] || p1.clusters[1] != p2.clusters[1] ||
+				p1.clusterAreaNum[0] != p2.clusterAreaNum[0] || p1.clusterAreaNum[1] != p2.clusterAreaNum[1] ) {
+			common->Warning( "%s: portal %d differs", name.c_str(), i );
+			return false;
+		}
+	}
+
+	if ( !AAS_BinaryArraysEqual( clusters, other.clusters ) ) {
+		common->Warning( "%s: clusters differ", name.c_str() );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+================
+ConvertAAS_f
+
+  writes the binary files for the AAS files of a map and checks that
+  they load exactly the same as the text files
+================
+*/
+void ConvertAAS_f( const idCmdArgs &args ) {
+	idAASFileLocal *textFile, *binaryFile;
+	idStr mapName, fileName;
+	int startTime;
+
+	if ( args.Argc() <= 1 ) {
+		common->Printf( "convertAAS <mapfile>\n" );
+		return;
+	}
+
+	// get the aas settings definitions
+	const idDict *dict = gameEdit->FindEntityDefDict( "aas_types", false );
+	if ( !dict ) {
+		common->Warning( "Unable to find entityDef for 'aas_types'" );
+		return;
+	}
+
+	mapName = args.Argv( 1 );
+	mapName.BackSlashesToSlashes();
+	if ( mapName.Icmpn( "maps/", 4 ) != 0 ) {
+		mapName = "maps/" + mapName;
+	}
+
+	for ( const idKeyValue *kv = dict->MatchPrefix( "type" ); kv != NULL; kv = dict->MatchPrefix( "type", kv ) ) {
+		const idDict *settingsDict = gameEdit->FindEntityDefDict( kv->GetValue(), false );
+		if ( !settingsDict ) {
+			continue;
+		}
+		fileName = mapName;
+		fileName.SetFileExtension( settingsDict->GetString( "fileExtension" ) );
+
+		textFile = new idAASFileLocal();
+		binaryFile = new idAASFileLocal();
+
+		startTime = Sys_Milliseconds();
+		if ( !textFile->LoadText( fileName, 0 ) ) {
+			common->Printf( "couldn't load %s\n", fileName.c_str() );
+		} else {
+			common->Printf( "%s: %d msec to load the text file\n", fileName.c_str(), Sys_Milliseconds() - startTime );
+			if ( textFile->WriteBinary( fileName ) ) {
+				startTime = Sys_Milliseconds();
+				if ( !binaryFile->LoadBinary( fileName, 0 ) ) {
+					common->Warning( "couldn't load %s%s", fileName.c_str(), AAS_BINARY_FILE_SUFFIX );
+				} else {
+					common->Printf( "%s: %d msec to load the binary file\n", fileName.c_str(), Sys_Milliseconds() - startTime );
+					if ( textFile->Compare( *binaryFile ) ) {
+						common->Printf( "%s: binary file loads the same as the text file\n", fileName.c_str() );
+					}
+				}
+			}
+		}
+
+		delete textFile;
+		delete binaryFile;
+	}
+}
+
 /*
 ================
 idAASFileLocal::MemorySize
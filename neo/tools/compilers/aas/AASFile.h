@@ -44,6 +44,10 @@ If you have questions concerning this license or the applicable additional terms
 #define AAS_FILEID					"DewmAAS"
 #define AAS_FILEVERSION				"1.07"
 
+#define AAS_BINARY_FILE_SUFFIX		"b"
+#define AAS_BINARY_FILEID			( ( 'A' << 24 ) | ( 'A' << 16 ) | ( 'S' << 8 ) | 'B' )
+#define AAS_BINARY_FILEVERSION		1
+
 // travel flags
 #define TFL_INVALID					BIT(0)		// not valid
 #define TFL_WALK					BIT(1)		// walking
@@ -247,6 +251,8 @@ public:
 	bool						FromParser( idLexer &src );
 	bool						FromDict( const char *name, const idDict *dict );
 	bool						WriteToFile( idFile *fp ) const;
+	bool						FromBinary( idFile *fp );
+	bool						WriteToBinary( idFile *fp ) const;
 	bool						ValidForBounds( const idBounds &bounds ) const;
 	bool						ValidEntity( const char *classname ) const;
 
@@ -65,7 +65,12 @@ public:
 
 public:
 	bool						Load( const idStr &fileName, unsigned int mapFileCRC );
+	bool						LoadText( const idStr &fileName, unsigned int mapFileCRC );
+	bool						LoadBinary( const idStr &fileName, unsigned int mapFileCRC );
 	bool						Write( const idStr &fileName, unsigned int mapFileCRC );
+	bool						WriteBinary( const idStr &fileName ) const;
+	static void					WriteBinaryFromText( const idStr &fileName, unsigned int mapFileCRC );
+	bool						Compare( const idAASFileLocal &other ) const;
 
 	int							MemorySize( void ) const;
 	void						ReportRoutingEfficiency( void ) const;
@@ -88,6 +93,7 @@ private:
 	bool						ParseNodes( idLexer &src );
 	bool						ParsePortals( idLexer &src );
 	bool						ParseClusters( idLexer &src );
+	bool						ReadBinaryReachabilities( idFile *fp, int areaNum );
 
 private:
 	int							BoundsReachableAreaNum_r( int nodeNum, const idBounds &bounds, const int areaFlags, const int excludeTravelFlags ) const;